@@ -19,6 +19,7 @@
 #include "kis_composition_benchmark.h"
 #include <simpletest.h>
 #include <QElapsedTimer>
+#include <QScopedPointer>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOp.h>
@@ -28,6 +29,8 @@
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -316,6 +319,30 @@ struct PixelEqualPremultiplied
     }
 };
 
+/**
+ * The vectorized blending functions for floating point channels are not
+ * clamped, so the results of color dodge and burn can be huge. Compare
+ * such values relatively.
+ */
+template<typename channel_type>
+struct PixelEqualPremultipliedRelative : public PixelEqualPremultiplied<channel_type>
+{
+};
+
+template<>
+struct PixelEqualPremultipliedRelative<float>
+{
+    bool operator() (float c1, float a1,
+                     float c2, float a2,
+                     float prec) {
+
+        c1 *= a1;
+        c2 *= a2;
+
+        return fuzzyCompare(c1, c2, prec * qMax(1.0f, qMax(qAbs(c1), qAbs(c2))));
+    }
+};
+
 template <typename channel_type, template<typename> class Compare = PixelEqualDirect>
 inline bool comparePixels(channel_type *p1, channel_type *p2, channel_type prec) {
     Compare<channel_type> comp;
@@ -407,6 +434,63 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     return compareResult;
 }
 
+template<class Traits>
+QVector<KoCompositeOp*> createLegacyGenericOps(const KoColorSpace *cs)
+{
+    using T = typename Traits::channels_type;
+
+    QVector<KoCompositeOp*> ops;
+
+    ops << new KoCompositeOpGenericSC<Traits, &cfMultiply<T>>(cs, COMPOSITE_MULT, KoCompositeOp::categoryArithmetic());
+    ops << new KoCompositeOpGenericSC<Traits, &cfScreen<T>>(cs, COMPOSITE_SCREEN, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfOverlay<T>>(cs, COMPOSITE_OVERLAY, KoCompositeOp::categoryMix());
+    ops << new KoCompositeOpGenericSC<Traits, &cfHardLight<T>>(cs, COMPOSITE_HARD_LIGHT, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfSoftLight<T>>(cs, COMPOSITE_SOFT_LIGHT_PHOTOSHOP, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<T>>(cs, COMPOSITE_DARKEN, KoCompositeOp::categoryDark());
+    ops << new KoCompositeOpGenericSC<Traits, &cfLightenOnly<T>>(cs, COMPOSITE_LIGHTEN, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfAddition<T>>(cs, COMPOSITE_ADD, KoCompositeOp::categoryArithmetic());
+    ops << new KoCompositeOpGenericSC<Traits, &cfSubtract<T>>(cs, COMPOSITE_SUBTRACT, KoCompositeOp::categoryArithmetic());
+    ops << new KoCompositeOpGenericSC<Traits, &cfInverseSubtract<T>>(cs, COMPOSITE_INVERSE_SUBTRACT, KoCompositeOp::categoryArithmetic());
+    ops << new KoCompositeOpGenericSC<Traits, &cfDifference<T>>(cs, COMPOSITE_DIFF, KoCompositeOp::categoryNegative());
+    ops << new KoCompositeOpGenericSC<Traits, &cfExclusion<T>>(cs, COMPOSITE_EXCLUSION, KoCompositeOp::categoryNegative());
+    ops << new KoCompositeOpGenericSC<Traits, &cfLinearBurn<T>>(cs, COMPOSITE_LINEAR_BURN, KoCompositeOp::categoryDark());
+    ops << new KoCompositeOpGenericSC<Traits, &cfLinearLight<T>>(cs, COMPOSITE_LINEAR_LIGHT, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfGrainMerge<T>>(cs, COMPOSITE_GRAIN_MERGE, KoCompositeOp::categoryMix());
+    ops << new KoCompositeOpGenericSC<Traits, &cfGrainExtract<T>>(cs, COMPOSITE_GRAIN_EXTRACT, KoCompositeOp::categoryMix());
+    ops << new KoCompositeOpGenericSC<Traits, &cfAllanon<T>>(cs, COMPOSITE_ALLANON, KoCompositeOp::categoryMix());
+    ops << new KoCompositeOpGenericSC<Traits, &cfColorDodge<T>>(cs, COMPOSITE_DODGE, KoCompositeOp::categoryLight());
+    ops << new KoCompositeOpGenericSC<Traits, &cfColorBurn<T>>(cs, COMPOSITE_BURN, KoCompositeOp::categoryDark());
+
+    return ops;
+}
+
+template<class Traits>
+bool compareGenericOps(const KoColorSpace *cs,
+                       KoCompositeOp* (*createOptimizedOp)(const KoColorSpace*, const QString&, const QString&))
+{
+    bool result = true;
+
+    QVector<KoCompositeOp*> legacyOps = createLegacyGenericOps<Traits>(cs);
+
+    Q_FOREACH (KoCompositeOp *opExp, legacyOps) {
+        QScopedPointer<KoCompositeOp> opAct(createOptimizedOp(cs, opExp->id(), opExp->category()));
+
+        // the CPU has no vector instructions
+        if (!opAct) continue;
+
+        Q_FOREACH (bool haveMask, QVector<bool>({false, true})) {
+            if (!compareTwoOps<PixelEqualPremultipliedRelative>(haveMask, opAct.data(), opExp)) {
+                qDebug() << "Failed op:" << opExp->id() << "haveMask:" << haveMask;
+                result = false;
+            }
+        }
+    }
+
+    qDeleteAll(legacyOps);
+
+    return result;
+}
+
 QString getTestName(bool haveMask,
                     const int srcAlignmentShift,
                     const int dstAlignmentShift,
@@ -885,6 +969,24 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbU8GenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(compareGenericOps<KoBgrU8Traits>(cs, &KoOptimizedCompositeOpFactory::createGenericOp32));
+}
+
+void KisCompositionBenchmark::compareRgbU16GenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    QVERIFY(compareGenericOps<KoBgrU16Traits>(cs, &KoOptimizedCompositeOpFactory::createGenericOpU64));
+}
+
+void KisCompositionBenchmark::compareRgbF32GenericOps()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+    QVERIFY(compareGenericOps<KoRgbF32Traits>(cs, &KoOptimizedCompositeOpFactory::createGenericOp128));
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
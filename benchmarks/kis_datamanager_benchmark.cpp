@@ -8,6 +8,7 @@
 #include "kis_benchmark_values.h"
 
 #include <simpletest.h>
+#include <QThreadPool>
 #include <kis_datamanager.h>
 
 // RGBA
@@ -186,5 +187,80 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+/**
+ * Emulates the access pattern of the update threads: every thread
+ * fetches the tiles of its own part of the image for reading and
+ * for writing, so the only shared object is the tile hash table.
+ */
+class KisTileAccessJob : public QRunnable
+{
+public:
+    KisTileAccessJob(KisDataManager &dm, int numColumns, int numRows,
+                     int firstAccess, int numAccesses)
+        : m_dm(dm),
+          m_numColumns(numColumns),
+          m_numRows(numRows),
+          m_firstAccess(firstAccess),
+          m_numAccesses(numAccesses)
+    {
+    }
+
+    void run() override {
+        for (int i = m_firstAccess; i < m_firstAccess + m_numAccesses; i++) {
+            const int tileIndex = i % (m_numColumns * m_numRows);
+            const int col = tileIndex % m_numColumns;
+            const int row = tileIndex / m_numColumns;
+
+            KisTileSP tile = m_dm.getTile(col, row, (i & 0x7) == 0);
+            Q_UNUSED(tile);
+        }
+    }
+
+private:
+    KisDataManager &m_dm;
+    int m_numColumns;
+    int m_numRows;
+    int m_firstAccess;
+    int m_numAccesses;
+};
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 32; numThreads *= 2) {
+        QTest::addRow("%d threads", numThreads) << numThreads;
+    }
+}
+
+void KisDatamanagerBenchmark::benchmarkConcurrentTileAccess()
+{
+    QFETCH(int, numThreads);
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    const int numColumns = TEST_IMAGE_WIDTH / 64;
+    const int numRows = TEST_IMAGE_HEIGHT / 64;
+
+    // the total amount of work is the same for every number of threads
+    const int numAccesses = 1 << 21;
+    const int accessesPerThread = numAccesses / numThreads;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new KisTileAccessJob(dm, numColumns, numRows,
+                                            i * accessesPerThread, accessesPerThread));
+        }
+        pool.waitForDone();
+    }
+
+    delete[] p;
+}
+
 
 SIMPLE_TEST_MAIN(KisDatamanagerBenchmark)
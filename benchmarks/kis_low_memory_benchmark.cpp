@@ -49,6 +49,7 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
                                               int hardLimitMiB,
                                               int softLimitMiB,
                                               int poolLimitMiB,
+                                              bool adaptiveSwapPolicy,
                                               int index)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(QString(FILES_DATA_DIR) + '/' + presetFileName));
@@ -83,23 +84,29 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
     qreal oldHardLimit = config.memoryHardLimitPercent();
     qreal oldSoftLimit = config.memorySoftLimitPercent();
     qreal oldPoolLimit = config.memoryPoolLimitPercent();
+    bool oldAdaptiveSwapPolicy = config.useAdaptiveSwapPolicy();
     const qreal _MiB = 100.0 / KisImageConfig::totalRAM();
 
     config.setMemoryHardLimitPercent(hardLimitMiB * _MiB);
     config.setMemorySoftLimitPercent(softLimitMiB * _MiB);
     config.setMemoryPoolLimitPercent(poolLimitMiB * _MiB);
+    config.setUseAdaptiveSwapPolicy(adaptiveSwapPolicy);
 
     KisTileDataStore::instance()->testingRereadConfig();
 
+    const qint32 initialSwapIns = KisTileDataStore::instance()->numSwapIns();
+    const qint32 initialSwapOuts = KisTileDataStore::instance()->numSwapOuts();
+
     /**
      * Create an empty the log file
      */
     QString fileName;
-    fileName = QString("log_%1_%2_%3_%4_%5.txt")
+    fileName = QString("log_%1_%2_%3_%4_%5_%6.txt")
         .arg(createTransaction)
         .arg(hardLimitMiB)
         .arg(softLimitMiB)
         .arg(poolLimitMiB)
+        .arg(adaptiveSwapPolicy ? "adaptive" : "clock")
         .arg(index);
 
     QFile logFile(fileName);
@@ -161,12 +168,27 @@ void KisLowMemoryBenchmark::benchmarkWideArea(const QString presetFileName,
                   << createTransaction
                   << config.memoryHardLimitPercent() / _MiB
                   << config.memorySoftLimitPercent() / _MiB
-                  << config.memoryPoolLimitPercent() / _MiB  << endl;
+                  << config.memoryPoolLimitPercent() / _MiB
+                  << KisTileDataStore::instance()->numSwapIns() - initialSwapIns
+                  << KisTileDataStore::instance()->numSwapOuts() - initialSwapOuts << endl;
     }
 
+    /**
+     * Every swap-in is a miss of the swapper policy: the tile has
+     * been swapped out, but it was needed again
+     */
+    const qint32 swapIns = KisTileDataStore::instance()->numSwapIns() - initialSwapIns;
+    const qint32 swapOuts = KisTileDataStore::instance()->numSwapOuts() - initialSwapOuts;
+
+    qDebug() << "Swap policy:" << (adaptiveSwapPolicy ? "adaptive" : "clock")
+             << "swap outs:" << swapOuts
+             << "swap ins (misses):" << swapIns
+             << "miss rate:" << (swapOuts ? qreal(swapIns) / swapOuts : 0.0);
+
     config.setMemoryHardLimitPercent(oldHardLimit * _MiB);
     config.setMemorySoftLimitPercent(oldSoftLimit * _MiB);
     config.setMemoryPoolLimitPercent(oldPoolLimit * _MiB);
+    config.setUseAdaptiveSwapPolicy(oldAdaptiveSwapPolicy);
 
     delete painter;
 }
@@ -180,7 +202,7 @@ void KisLowMemoryBenchmark::unlimitedMemoryNoHistoryNoPool()
     int numCycles = 20;
 
     benchmarkWideArea(presetFileName, rect, step, numCycles, false,
-                      3000, 3000, 0, 0);
+                      3000, 3000, 0, true, 0);
 }
 
 void KisLowMemoryBenchmark::unlimitedMemoryHistoryNoPool()
@@ -192,7 +214,7 @@ void KisLowMemoryBenchmark::unlimitedMemoryHistoryNoPool()
     int numCycles = 20;
 
     benchmarkWideArea(presetFileName, rect, step, numCycles, true,
-                      3000, 3000, 0, 0);
+                      3000, 3000, 0, true, 0);
 }
 
 void KisLowMemoryBenchmark::unlimitedMemoryHistoryPool50()
@@ -204,7 +226,7 @@ void KisLowMemoryBenchmark::unlimitedMemoryHistoryPool50()
     int numCycles = 20;
 
     benchmarkWideArea(presetFileName, rect, step, numCycles, true,
-                      3000, 3000, 50, 0);
+                      3000, 3000, 50, true, 0);
 }
 
 void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
@@ -216,7 +238,20 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
     int numCycles = 10;
 
     benchmarkWideArea(presetFileName, rect, step, numCycles, true,
-                      2000, 600, 500, 0);
+                      2000, 600, 500, true, 0);
+}
+
+void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrushClockPolicy()
+{
+    QString presetFileName = "BIG_TESTING.kpp";
+    // the same as memory2000History100Pool500HugeBrush(), but with
+    // the old clock sweep swapper policy for comparison
+    QRectF rect(150,150,7850,7850);
+    qreal step = 250;
+    int numCycles = 10;
+
+    benchmarkWideArea(presetFileName, rect, step, numCycles, true,
+                      2000, 600, 500, false, 0);
 }
 
 SIMPLE_TEST_MAIN(KisLowMemoryBenchmark)
@@ -18,6 +18,7 @@ private Q_SLOTS:
     void unlimitedMemoryHistoryPool50();
 
     void memory2000History100Pool500HugeBrush();
+    void memory2000History100Pool500HugeBrushClockPolicy();
 
 private:
     void benchmarkWideArea(const QString presetFileName,
@@ -27,6 +28,7 @@ private:
                            int hardLimitMiB,
                            int softLimitMiB,
                            int poolLimitMiB,
+                           bool adaptiveSwapPolicy,
                            int index);
 };
 
@@ -15,6 +15,16 @@
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisPart.h>
+#include <kis_image_config.h>
+#include <KisImageConfigNotifier.h>
+#include <kis_update_scheduler.h>
+#include <kis_adjustment_layer.h>
+#include <filter/kis_filter.h>
+#include <filter/kis_filter_configuration.h>
+#include <filter/kis_filter_registry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include <QElapsedTimer>
 
 void KisProjectionBenchmark::initTestCase()
 {
@@ -46,5 +56,109 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+void KisProjectionBenchmark::benchmarkProjectionThreadAffinity_data()
+{
+    QTest::addColumn<bool>("threadAffinity");
+
+    QTest::newRow("affinity-off") << false;
+    QTest::newRow("affinity-on") << true;
+}
+
+void KisProjectionBenchmark::benchmarkProjectionThreadAffinity()
+{
+    QFETCH(bool, threadAffinity);
+
+    KisImageConfig config(false);
+    const bool oldThreadAffinity = config.updaterThreadAffinity();
+    config.setUpdaterThreadAffinity(threadAffinity);
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + '/' + "load_test.kra");
+    KisImageSP image = doc->image();
+
+    // the first pass creates the projection tiles, so that their
+    // memory is allocated according to the affinity mode
+    image->refreshGraph();
+
+    const int numCycles = 10;
+    const qint64 numPixels = qint64(image->width()) * image->height() * numCycles;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < numCycles; i++) {
+        image->refreshGraph();
+    }
+
+    const qint64 elapsed = qMax(qint64(1), timer.elapsed());
+    qDebug() << "Thread affinity:" << threadAffinity
+             << "throughput:" << qreal(numPixels) / elapsed / 1000.0 << "MPix/s";
+
+    QBENCHMARK {
+        image->refreshGraph();
+    }
+
+    image.clear();
+    delete doc;
+
+    config.setUpdaterThreadAffinity(oldThreadAffinity);
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+}
+
+void KisProjectionBenchmark::benchmarkProjectionLoadBalance_data()
+{
+    QTest::addColumn<bool>("adaptivePatches");
+
+    QTest::newRow("fixed-patches") << false;
+    QTest::newRow("adaptive-patches") << true;
+}
+
+void KisProjectionBenchmark::benchmarkProjectionLoadBalance()
+{
+    QFETCH(bool, adaptivePatches);
+
+    KisImageConfig config(false);
+    const bool oldAdaptivePatches = config.adaptiveUpdatePatches();
+    config.setAdaptiveUpdatePatches(adaptivePatches);
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->loadNativeFormat(QString(FILES_DATA_DIR) + '/' + "load_test.kra");
+    KisImageSP image = doc->image();
+
+    // a heavy filter over a part of the stack makes the cost of the patches uneven
+    KisFilterSP filter = KisFilterRegistry::instance()->value("gaussian blur");
+    if (filter) {
+        KisFilterConfigurationSP filterConfig =
+            filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+        KisAdjustmentLayerSP adjustmentLayer =
+            new KisAdjustmentLayer(image, "blur", filterConfig->cloneWithResourcesSnapshot(), 0);
+
+        image->barrierLock();
+        image->addNode(adjustmentLayer, image->rootLayer());
+        image->unlock();
+    }
+
+    image->waitForDone();
+
+    KisUpdateScheduler scheduler(image.data());
+    const QRect rect = image->bounds();
+
+    scheduler.resetLoadBalanceStatistics();
+
+    QBENCHMARK {
+        scheduler.fullRefreshAsync(image->root(), {rect}, rect);
+        scheduler.waitForDone();
+    }
+
+    qDebug() << "Adaptive patches:" << adaptivePatches
+             << "threads:" << scheduler.threadsLimit()
+             << "load balance:" << scheduler.mergeLoadBalance();
+
+    image.clear();
+    delete doc;
+
+    config.setAdaptiveUpdatePatches(oldAdaptivePatches);
+}
 
 SIMPLE_TEST_MAIN(KisProjectionBenchmark)
@@ -20,6 +20,12 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkProjectionThreadAffinity_data();
+    void benchmarkProjectionThreadAffinity();
+
+    void benchmarkProjectionLoadBalance_data();
+    void benchmarkProjectionLoadBalance();
 };
 
 #endif
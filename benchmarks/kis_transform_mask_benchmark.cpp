@@ -0,0 +1,137 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <simpletest.h>
+
+#include "kis_transform_mask_benchmark.h"
+
+#include <QElapsedTimer>
+#include <QScopedPointer>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_global.h>
+#include <kis_pointer_utils.h>
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+#include <kis_transform_mask.h>
+#include <kis_transform_mask_params_interface.h>
+#include <kis_transform_worker.h>
+#include <kis_filter_strategy.h>
+#include <kis_recalculate_transform_mask_job.h>
+
+
+namespace {
+
+const QRect imageRect(0, 0, 4096, 4096);
+const QRect editRect(0, 0, 64, 64);
+
+/**
+ * Rotates and scales the source with a full-quality resampling
+ * filter, like the free transform of the transform tool does
+ */
+class RotatingTransformMaskParams : public KisDumbTransformMaskParams
+{
+public:
+    RotatingTransformMaskParams()
+        : KisDumbTransformMaskParams(QScopedPointer<KisTransformWorker>(createWorker(0))->transform())
+    {
+    }
+
+    void transformDevice(KisNodeSP node, KisPaintDeviceSP src, KisPaintDeviceSP dst) const override {
+        Q_UNUSED(node);
+
+        dst->makeCloneFromRough(src, src->extent());
+        QScopedPointer<KisTransformWorker>(createWorker(dst))->run();
+    }
+
+    KisTransformMaskParamsInterfaceSP clone() const override {
+        return toQShared(new RotatingTransformMaskParams());
+    }
+
+private:
+    static KisTransformWorker* createWorker(KisPaintDeviceSP device) {
+        return new KisTransformWorker(device,
+                                      0.8, 0.8,
+                                      0.0, 0.0,
+                                      0.0, 0.0,
+                                      M_PI / 12,
+                                      1024, 0,
+                                      0,
+                                      KisFilterStrategyRegistry::instance()->value("Bicubic"));
+    }
+};
+
+struct MaskedLayer
+{
+    MaskedLayer() {
+        const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+        image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "benchmark");
+        layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8);
+        image->addNode(layer);
+
+        layer->paintDevice()->fill(imageRect.adjusted(256, 256, -256, -256), KoColor(Qt::red, cs));
+
+        mask = new KisTransformMask(image, "mask");
+        mask->setTransformParams(toQShared(new RotatingTransformMaskParams()));
+        image->addNode(mask, layer);
+
+        layer->setDirty(imageRect);
+        image->waitForDone();
+
+        recalculate();
+    }
+
+    void recalculate() {
+        image->addSpontaneousJob(new KisRecalculateTransformMaskJob(mask));
+        image->waitForDone();
+    }
+
+    KisImageSP image;
+    KisPaintLayerSP layer;
+    KisTransformMaskSP mask;
+};
+
+}
+
+void KisTransformMaskBenchmark::benchmarkFullRecalculation()
+{
+    MaskedLayer p;
+
+    QBENCHMARK {
+        // a change of the transformation invalidates the whole static image
+        p.mask->setTransformParams(toQShared(new RotatingTransformMaskParams()));
+        p.recalculate();
+    }
+}
+
+void KisTransformMaskBenchmark::benchmarkSmallEdits()
+{
+    MaskedLayer p;
+    const KoColorSpace *cs = p.layer->colorSpace();
+
+    QElapsedTimer timer;
+    int numEdits = 0;
+
+    QBENCHMARK {
+        const QRect rc = editRect.translated(512 + 37 * (numEdits % 64), 512 + 29 * (numEdits % 97));
+        p.layer->paintDevice()->fill(rc, KoColor(numEdits & 0x1 ? Qt::blue : Qt::green, cs));
+        p.layer->setDirty(rc);
+        p.image->waitForDone();
+
+        timer.start();
+        p.recalculate();
+        numEdits++;
+    }
+
+    qDebug() << "Last static image update took" << timer.elapsed() << "ms";
+}
+
+SIMPLE_TEST_MAIN(KisTransformMaskBenchmark)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_TRANSFORM_MASK_BENCHMARK_H
+#define KIS_TRANSFORM_MASK_BENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures the regeneration of the static image of a transform mask
+class KisTransformMaskBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkFullRecalculation();
+    void benchmarkSmallEdits();
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <simpletest.h>
+
+#include "kis_work_stealing_executor_benchmark.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QThread>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <KisWorkStealingExecutor.h>
+
+
+namespace {
+
+void addThreadCountRows()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QList<int> threadCounts({1, 2, 4, 8, 16, 32, 64});
+    if (!threadCounts.contains(QThread::idealThreadCount())) {
+        threadCounts << QThread::idealThreadCount();
+    }
+
+    Q_FOREACH (int threadCount, threadCounts) {
+        QTest::newRow(QString("threads-%1").arg(threadCount).toLatin1().constData()) << threadCount;
+    }
+}
+
+void reportStatistics(const QString &name, int threadCount,
+                      const KisWorkStealingExecutor::Statistics &stats)
+{
+    qDebug() << qPrintable(name)
+             << "threads:" << threadCount
+             << "utilization:" << QString::number(100.0 * stats.utilization(), 'f', 1) + "%"
+             << "tasks:" << stats.numTasks
+             << "steals:" << stats.numSteals;
+}
+
+class SpinningRunnable : public QRunnable
+{
+public:
+    SpinningRunnable(QAtomicInt *sink) : m_sink(sink) {}
+
+    void run() override {
+        int value = 0;
+        for (int i = 0; i < 2000; i++) {
+            value += i * i;
+        }
+        m_sink->fetchAndAddRelaxed(value & 0x1);
+    }
+
+private:
+    QAtomicInt *m_sink;
+};
+
+class CompositionRunnable : public QRunnable
+{
+public:
+    CompositionRunnable(KisWorkStealingExecutor *executor,
+                        KisPaintDeviceSP src, KisPaintDeviceSP dst,
+                        const QRect &rect)
+        : m_executor(executor), m_src(src), m_dst(dst), m_rect(rect)
+    {
+    }
+
+    void run() override {
+        m_executor->runSplitJob(m_rect,
+            [this] (const QRect &rc) {
+                KisPainter gc(m_dst);
+                gc.setCompositeOpId(COMPOSITE_OVER);
+                gc.setOpacity(OPACITY_HALF_U8);
+                gc.bitBlt(rc.topLeft(), m_src, rc);
+            });
+    }
+
+private:
+    KisWorkStealingExecutor *m_executor;
+    KisPaintDeviceSP m_src;
+    KisPaintDeviceSP m_dst;
+    QRect m_rect;
+};
+
+}
+
+void KisWorkStealingExecutorBenchmark::benchmarkSmallTasks_data()
+{
+    addThreadCountRows();
+}
+
+void KisWorkStealingExecutorBenchmark::benchmarkSmallTasks()
+{
+    QFETCH(int, threadCount);
+
+    KisWorkStealingExecutor executor(threadCount);
+    QAtomicInt sink;
+
+    const int numTasks = 100000;
+
+    QBENCHMARK {
+        executor.resetStatistics();
+
+        for (int i = 0; i < numTasks; i++) {
+            executor.start(new SpinningRunnable(&sink));
+        }
+        executor.waitForDone();
+    }
+
+    reportStatistics("Small tasks", threadCount, executor.statistics());
+}
+
+void KisWorkStealingExecutorBenchmark::benchmarkSplitComposition_data()
+{
+    addThreadCountRows();
+}
+
+void KisWorkStealingExecutorBenchmark::benchmarkSplitComposition()
+{
+    QFETCH(int, threadCount);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 4096, 4096);
+
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    src->fill(imageRect, KoColor(Qt::red, cs));
+
+    KisPaintDeviceSP dst = new KisPaintDevice(cs);
+    dst->fill(imageRect, KoColor(Qt::blue, cs));
+
+    KisWorkStealingExecutor executor(threadCount);
+
+    /**
+     * A few jobs of uneven size, like a merge job for a big stroke
+     * and some small ones for the tool outline: the workers that are
+     * done with the small jobs steal the patches of the big one
+     */
+    const QVector<QRect> jobRects({QRect(0, 0, 4096, 3072),
+                                   QRect(0, 3072, 1024, 1024),
+                                   QRect(1024, 3072, 256, 256),
+                                   QRect(2048, 3072, 64, 64)});
+
+    qint64 numPixels = 0;
+    Q_FOREACH (const QRect &rc, jobRects) {
+        numPixels += qint64(rc.width()) * rc.height();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int numCycles = 0;
+
+    QBENCHMARK {
+        executor.resetStatistics();
+
+        Q_FOREACH (const QRect &rc, jobRects) {
+            executor.start(new CompositionRunnable(&executor, src, dst, rc));
+        }
+        executor.waitForDone();
+
+        numCycles++;
+    }
+
+    const qint64 elapsed = qMax(qint64(1), timer.elapsed());
+
+    reportStatistics("Split composition", threadCount, executor.statistics());
+    qDebug() << "    throughput:" << qreal(numPixels) * numCycles / elapsed / 1000.0 << "MPix/s";
+}
+
+SIMPLE_TEST_MAIN(KisWorkStealingExecutorBenchmark)
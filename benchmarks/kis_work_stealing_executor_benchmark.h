@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_WORK_STEALING_EXECUTOR_BENCHMARK_H
+#define KIS_WORK_STEALING_EXECUTOR_BENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures the throughput and the core utilization of the updater's executor
+class KisWorkStealingExecutorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkSmallTasks_data();
+    void benchmarkSmallTasks();
+
+    void benchmarkSplitComposition_data();
+    void benchmarkSplitComposition();
+};
+
+#endif
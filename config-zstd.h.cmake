@@ -0,0 +1,4 @@
+/* config-zstd.h.  Generated by cmake from config-zstd.h.cmake */
+
+/* Define if you have zstd, the Zstandard compression library */
+#cmakedefine HAVE_ZSTD 1
@@ -0,0 +1,151 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBelowStackCache.h"
+
+#include <QAtomicInt>
+
+#include "kis_node.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+
+namespace {
+QAtomicInt s_enabled(1);
+QAtomicInt s_generation(0);
+}
+
+KisBelowStackCache::KisBelowStackCache()
+{
+}
+
+KisBelowStackCache::~KisBelowStackCache()
+{
+}
+
+bool KisBelowStackCache::load(KisNodeSP pivot, int graphSequenceNumber, const QRect &rect, KisPaintDeviceSP dst)
+{
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_lock);
+
+        if (!m_device ||
+            !isCurrentPivot(pivot) ||
+            m_graphSequenceNumber != graphSequenceNumber ||
+            m_generation != s_generation.loadAcquire() ||
+            !(QRegion(rect) - m_validRegion).isEmpty()) {
+
+            return false;
+        }
+
+        device = m_device;
+    }
+
+    if (!dst->fastBitBltPossible(device)) return false;
+
+    /**
+     * The walkers guarantee that no other job accesses the same
+     * rect of the group, so the data cannot change under our feet
+     */
+    KisPainter::copyAreaOptimized(rect.topLeft(), device, dst, rect);
+
+    return true;
+}
+
+void KisBelowStackCache::store(KisNodeSP pivot, int graphSequenceNumber, const QRect &rect, KisPaintDeviceSP src)
+{
+    KisPaintDeviceSP device;
+
+    {
+        QMutexLocker l(&m_lock);
+
+        const int generation = s_generation.loadAcquire();
+
+        if (!isCurrentPivot(pivot) ||
+            m_graphSequenceNumber != graphSequenceNumber ||
+            m_generation != generation) {
+
+            m_pivot = pivot.data();
+            m_graphSequenceNumber = graphSequenceNumber;
+            m_generation = generation;
+            m_validRegion = QRegion();
+
+            // don't keep the stale tiles of the previous pivot around
+            m_device = 0;
+        }
+
+        if (!m_device || !m_device->fastBitBltPossible(src)) {
+            m_device = new KisPaintDevice(src->colorSpace());
+            m_device->prepareClone(src);
+            m_validRegion = QRegion();
+        }
+
+        device = m_device;
+    }
+
+    KisPainter::copyAreaOptimized(rect.topLeft(), src, device, rect);
+
+    QMutexLocker l(&m_lock);
+
+    // the cache might have been reset while we were copying
+    if (m_device == device && isCurrentPivot(pivot) &&
+        m_graphSequenceNumber == graphSequenceNumber) {
+
+        m_validRegion += rect;
+    }
+}
+
+void KisBelowStackCache::invalidate(const QRect &rect)
+{
+    QMutexLocker l(&m_lock);
+    m_validRegion -= rect;
+
+    /**
+     * Nothing useful is left in the device, so release the memory
+     * instead of keeping the stale tiles till the next store()
+     */
+    if (m_validRegion.isEmpty()) {
+        m_device = 0;
+    }
+}
+
+void KisBelowStackCache::invalidateAll()
+{
+    QMutexLocker l(&m_lock);
+
+    m_pivot = 0;
+    m_graphSequenceNumber = -1;
+    m_generation = -1;
+    m_validRegion = QRegion();
+    m_device = 0;
+}
+
+bool KisBelowStackCache::isCurrentPivot(KisNodeSP pivot) const
+{
+    /**
+     * The weak pointer is checked for validity, because a new node
+     * may be allocated at the address of the deleted pivot
+     */
+    return m_pivot.isValid() && m_pivot == pivot.data();
+}
+
+KisNodeSP KisBelowStackCache::pivot() const
+{
+    QMutexLocker l(&m_lock);
+    return KisNodeSP(m_pivot);
+}
+
+void KisBelowStackCache::setEnabled(bool value)
+{
+    if (s_enabled.fetchAndStoreOrdered(value) != int(value) && value) {
+        s_generation.ref();
+    }
+}
+
+bool KisBelowStackCache::isEnabled()
+{
+    return s_enabled.loadAcquire();
+}
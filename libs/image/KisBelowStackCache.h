@@ -0,0 +1,97 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBELOWSTACKCACHE_H
+#define KISBELOWSTACKCACHE_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+#include <QMutex>
+#include <QRegion>
+
+/**
+ * A cache of the partial composite of a group layer.
+ *
+ * When a child of a group is being changed (e.g. a stroke is painted
+ * on it), all the merge jobs of the group recomposite the same set
+ * of unchanged children below it. KisAsyncMerger stores the composite
+ * of these children right before compositing the changed child (the
+ * "pivot"), and the following merge jobs with the same pivot just
+ * copy the stored result.
+ *
+ * The cache is invalidated by the merge walks themselves: every
+ * change of a child of the group produces a walk through the group,
+ * and the merger drops the area of the walk if the changed child lies
+ * below the pivot. Any change of the structure of the graph drops the
+ * whole cache.
+ *
+ * The cache is used for level of detail 0 only.
+ */
+class KRITAIMAGE_EXPORT KisBelowStackCache
+{
+public:
+    /**
+     * The minimal number of the layers below the pivot that makes
+     * caching worth the memory
+     */
+    static const int MIN_CACHED_LAYERS = 3;
+
+public:
+    KisBelowStackCache();
+    ~KisBelowStackCache();
+
+    /**
+     * Copies the cached composite of the layers below \p pivot into
+     * \p dst. Returns false if \p rect is not cached for this pivot.
+     */
+    bool load(KisNodeSP pivot, int graphSequenceNumber, const QRect &rect, KisPaintDeviceSP dst);
+
+    /**
+     * Stores \p rect of \p src as the composite of the layers below
+     * \p pivot. If the pivot differs from the currently cached one,
+     * the cache is reset.
+     */
+    void store(KisNodeSP pivot, int graphSequenceNumber, const QRect &rect, KisPaintDeviceSP src);
+
+    /**
+     * Drops \p rect from the cache. When nothing valid is left, the
+     * memory is released.
+     */
+    void invalidate(const QRect &rect);
+
+    /**
+     * Drops the whole cache and releases the memory
+     */
+    void invalidateAll();
+
+    /**
+     * Returns the node the cache is currently built for or null if
+     * the cache is empty
+     */
+    KisNodeSP pivot() const;
+
+    /**
+     * Globally enables or disables the caches of all the groups. The
+     * caches are not invalidated while disabled, so re-enabling them
+     * drops all the previously cached data.
+     */
+    static void setEnabled(bool value);
+    static bool isEnabled();
+
+private:
+    bool isCurrentPivot(KisNodeSP pivot) const;
+
+private:
+    mutable QMutex m_lock;
+    KisNodeWSP m_pivot;
+    int m_graphSequenceNumber {-1};
+    int m_generation {-1};
+    QRegion m_validRegion;
+    KisPaintDeviceSP m_device;
+};
+
+#endif // KISBELOWSTACKCACHE_H
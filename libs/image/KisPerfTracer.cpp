@@ -0,0 +1,347 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPerfTracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGlobalStatic>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRect>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+
+Q_GLOBAL_STATIC(KisPerfTracer, s_instance)
+
+
+struct KisPerfTracer::Event
+{
+    const char *category;
+    QByteArray name;
+    qint64 startTime;
+
+    /// negative for instant events
+    qint64 duration;
+
+    QVariantMap args;
+};
+
+struct KisPerfTracer::ThreadBuffer
+{
+    /**
+     * The lock is taken by the owning thread on every event and
+     * by the tracer when the events are written, so it is contended
+     * only while the trace is being saved.
+     */
+    QMutex lock;
+    QVector<Event> events;
+
+    int threadId = 0;
+    QString threadName;
+
+    /// the tracing session the buffer belongs to
+    int session = 0;
+};
+
+struct KisPerfTracer::Private
+{
+    mutable QMutex lock;
+    QString fileName;
+    QString configFileName;
+    QElapsedTimer timer;
+
+    /// the value of the timer when the current session has started
+    std::atomic<qint64> sessionStartTime {0};
+
+    QVector<QSharedPointer<ThreadBuffer>> buffers;
+    std::atomic<int> session {0};
+    std::atomic<int> numEvents {0};
+
+    ThreadBuffer* currentBuffer();
+    bool writeTrace(const QString &fileName, const QVector<QSharedPointer<ThreadBuffer>> &buffers);
+};
+
+KisPerfTracer::ThreadBuffer* KisPerfTracer::Private::currentBuffer()
+{
+    thread_local QSharedPointer<ThreadBuffer> buffer;
+
+    const int currentSession = session.load();
+
+    if (!buffer || buffer->session != currentSession) {
+        buffer.reset(new ThreadBuffer);
+        buffer->session = currentSession;
+
+        QThread *thread = QThread::currentThread();
+        buffer->threadName = thread ? thread->objectName() : QString();
+
+        QMutexLocker l(&lock);
+        buffer->threadId = buffers.size() + 1;
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QString("Thread %1").arg(buffer->threadId);
+        }
+        buffers.append(buffer);
+    }
+
+    return buffer.data();
+}
+
+bool KisPerfTracer::Private::writeTrace(const QString &fileName,
+                                        const QVector<QSharedPointer<ThreadBuffer>> &buffers)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+
+    Q_FOREACH (QSharedPointer<ThreadBuffer> buffer, buffers) {
+        QMutexLocker l(&buffer->lock);
+
+        QJsonObject threadName;
+        threadName["name"] = "thread_name";
+        threadName["ph"] = "M";
+        threadName["pid"] = pid;
+        threadName["tid"] = buffer->threadId;
+        threadName["args"] = QJsonObject({{"name", buffer->threadName}});
+        traceEvents.append(threadName);
+
+        Q_FOREACH (const Event &event, buffer->events) {
+            QJsonObject object;
+            object["name"] = QString::fromUtf8(event.name);
+            object["cat"] = QString::fromLatin1(event.category);
+            object["pid"] = pid;
+            object["tid"] = buffer->threadId;
+            object["ts"] = event.startTime / 1000.0;
+
+            if (event.duration >= 0) {
+                object["ph"] = "X";
+                object["dur"] = event.duration / 1000.0;
+            } else {
+                object["ph"] = "i";
+                object["s"] = "t";
+            }
+
+            if (!event.args.isEmpty()) {
+                object["args"] = QJsonObject::fromVariantMap(event.args);
+            }
+
+            traceEvents.append(object);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        warnImage << "KisPerfTracer: failed to open the trace file" << fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+
+namespace {
+inline bool tracerIsEnabled() {
+    // the tracer may already be destroyed on application exit
+    KisPerfTracer *tracer = KisPerfTracer::instance();
+    return tracer && tracer->isEnabled();
+}
+}
+
+KisPerfTracer::Scope::Scope(const char *category, const char *name)
+    : m_isActive(tracerIsEnabled())
+{
+    if (!m_isActive) return;
+
+    m_category = category;
+    m_name = QByteArray(name);
+    m_startTime = KisPerfTracer::instance()->timestamp();
+}
+
+KisPerfTracer::Scope::Scope(const char *category, const QString &name)
+    : m_isActive(tracerIsEnabled())
+{
+    if (!m_isActive) return;
+
+    m_category = category;
+    m_name = name.toUtf8();
+    m_startTime = KisPerfTracer::instance()->timestamp();
+}
+
+KisPerfTracer::Scope::~Scope()
+{
+    if (!m_isActive) return;
+
+    KisPerfTracer *tracer = KisPerfTracer::instance();
+    if (!tracer) return;
+
+    tracer->addCompleteEvent(m_category, m_name, m_startTime,
+                             tracer->timestamp() - m_startTime, m_args);
+}
+
+void KisPerfTracer::Scope::setName(const QString &name)
+{
+    if (!m_isActive) return;
+    m_name = name.toUtf8();
+}
+
+void KisPerfTracer::Scope::addArg(const QString &name, const QVariant &value)
+{
+    if (!m_isActive) return;
+    m_args.insert(name, value);
+}
+
+void KisPerfTracer::Scope::addRectArgs(const QRect &rect)
+{
+    if (!m_isActive) return;
+
+    m_args.insert("rect", QString("%1,%2 %3x%4")
+                  .arg(rect.x()).arg(rect.y())
+                  .arg(rect.width()).arg(rect.height()));
+    m_args.insert("area", qint64(rect.width()) * rect.height());
+}
+
+
+KisPerfTracer::KisPerfTracer()
+    : m_d(new Private)
+{
+    m_d->timer.start();
+
+    const QString fileName = qEnvironmentVariable("KRITA_PERF_TRACE_FILE");
+    if (!fileName.isEmpty()) {
+        setTraceFile(fileName);
+    }
+}
+
+KisPerfTracer::~KisPerfTracer()
+{
+    if (isEnabled()) {
+        stop();
+    }
+}
+
+KisPerfTracer* KisPerfTracer::instance()
+{
+    return s_instance;
+}
+
+void KisPerfTracer::setTraceFile(const QString &fileName)
+{
+    {
+        QMutexLocker l(&m_d->lock);
+        if (fileName == m_d->fileName) return;
+    }
+
+    if (isEnabled()) {
+        stop();
+    }
+
+    if (fileName.isEmpty()) return;
+
+    QMutexLocker l(&m_d->lock);
+
+    m_d->fileName = fileName;
+    m_d->buffers.clear();
+    m_d->numEvents = 0;
+    m_d->session++;
+    m_d->sessionStartTime = m_d->timer.nsecsElapsed();
+
+    m_isEnabled = true;
+}
+
+QString KisPerfTracer::traceFile() const
+{
+    QMutexLocker l(&m_d->lock);
+    return m_d->fileName;
+}
+
+void KisPerfTracer::updateSettings()
+{
+    const QString fileName = KisImageConfig(true).perfTraceFile();
+
+    {
+        QMutexLocker l(&m_d->lock);
+        if (fileName == m_d->configFileName) return;
+        m_d->configFileName = fileName;
+    }
+
+    setTraceFile(fileName);
+}
+
+bool KisPerfTracer::stop()
+{
+    QString fileName;
+    QVector<QSharedPointer<ThreadBuffer>> buffers;
+
+    {
+        QMutexLocker l(&m_d->lock);
+
+        if (!m_isEnabled) return true;
+        m_isEnabled = false;
+
+        /**
+         * The threads that are still inside addCompleteEvent() will
+         * push their events into the buffers of the old session, which
+         * are kept alive by the shared pointers, so we don't need to
+         * wait for them.
+         */
+        m_d->session++;
+
+        std::swap(fileName, m_d->fileName);
+        std::swap(buffers, m_d->buffers);
+    }
+
+    return m_d->writeTrace(fileName, buffers);
+}
+
+qint64 KisPerfTracer::timestamp() const
+{
+    return m_d->timer.nsecsElapsed() - m_d->sessionStartTime;
+}
+
+void KisPerfTracer::addCompleteEvent(const char *category,
+                                     const QByteArray &name,
+                                     qint64 startTime,
+                                     qint64 duration,
+                                     const QVariantMap &args)
+{
+    if (!isEnabled()) return;
+    if (m_d->numEvents.fetch_add(1) >= MAX_EVENTS) return;
+
+    ThreadBuffer *buffer = m_d->currentBuffer();
+
+    QMutexLocker l(&buffer->lock);
+    buffer->events.append({category, name, startTime, qMax(qint64(0), duration), args});
+}
+
+void KisPerfTracer::addInstantEvent(const char *category,
+                                    const QByteArray &name,
+                                    const QVariantMap &args)
+{
+    if (!isEnabled()) return;
+    if (m_d->numEvents.fetch_add(1) >= MAX_EVENTS) return;
+
+    ThreadBuffer *buffer = m_d->currentBuffer();
+
+    QMutexLocker l(&buffer->lock);
+    buffer->events.append({category, name, timestamp(), -1, args});
+}
+
+int KisPerfTracer::numRecordedEvents() const
+{
+    return m_d->numEvents;
+}
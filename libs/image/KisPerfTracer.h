@@ -0,0 +1,161 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPERFTRACER_H
+#define KISPERFTRACER_H
+
+#include "kritaimage_export.h"
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+#include <QVariantMap>
+
+class QRect;
+
+/**
+ * A recorder of the timing events of the image updates, strokes and
+ * canvas frames.
+ *
+ * The tracer is always compiled in, but records nothing until a trace
+ * file is set, so the only overhead of a disabled tracer is one atomic
+ * load per traced scope. When a trace file is set (either via the
+ * "perfTraceFile" option of KisImageConfig or with the
+ * KRITA_PERF_TRACE_FILE environment variable), the events are recorded
+ * into per-thread buffers. They are written into the file in Chrome
+ * trace event format when the tracing is stopped or the file is
+ * changed. The file can be opened with chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * Usage:
+ *
+ * \code{.cpp}
+ * KisPerfTracer::Scope scope("update", "merge");
+ * if (scope.isActive()) {
+ *     scope.addRectArgs(rect);
+ * }
+ * \endcode
+ */
+class KRITAIMAGE_EXPORT KisPerfTracer
+{
+public:
+    /**
+     * Measures the time between its construction and destruction and
+     * records it as a single event. If the tracer is disabled on
+     * construction, the scope does nothing.
+     */
+    class KRITAIMAGE_EXPORT Scope
+    {
+    public:
+        Scope(const char *category, const char *name);
+        Scope(const char *category, const QString &name);
+        ~Scope();
+
+        inline bool isActive() const {
+            return m_isActive;
+        }
+
+        /**
+         * Replaces the name of the event. Use it when the name is
+         * expensive to generate and should be generated only when
+         * the scope is active.
+         */
+        void setName(const QString &name);
+
+        void addArg(const QString &name, const QVariant &value);
+
+        /**
+         * Adds the rect and its area in pixels to the arguments of the event
+         */
+        void addRectArgs(const QRect &rect);
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        const bool m_isActive;
+        const char *m_category {0};
+        QByteArray m_name;
+        qint64 m_startTime {0};
+        QVariantMap m_args;
+    };
+
+public:
+    KisPerfTracer();
+    ~KisPerfTracer();
+
+    static KisPerfTracer* instance();
+
+    inline bool isEnabled() const {
+        return m_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Starts recording the events that will be written into \p fileName.
+     * If the tracer has already been recording into another file, that
+     * file is written first. An empty \p fileName stops the tracing.
+     */
+    void setTraceFile(const QString &fileName);
+    QString traceFile() const;
+
+    /**
+     * Applies the "perfTraceFile" option of KisImageConfig if it
+     * has changed since the last call. The tracing started by the
+     * environment variable is not affected until the option changes.
+     */
+    void updateSettings();
+
+    /**
+     * Writes the recorded events into the trace file and disables the
+     * tracer. Returns false if the file could not be written.
+     */
+    bool stop();
+
+    /**
+     * Time in nanoseconds since the tracing has been started
+     */
+    qint64 timestamp() const;
+
+    /**
+     * Records an event that started at \p startTime and lasted for
+     * \p duration nanoseconds on the calling thread.
+     */
+    void addCompleteEvent(const char *category,
+                          const QByteArray &name,
+                          qint64 startTime,
+                          qint64 duration,
+                          const QVariantMap &args = QVariantMap());
+
+    /**
+     * Records an event with no duration on the calling thread
+     */
+    void addInstantEvent(const char *category,
+                         const QByteArray &name,
+                         const QVariantMap &args = QVariantMap());
+
+    /**
+     * The number of the events recorded since the tracing has been
+     * started, including the dropped ones
+     */
+    int numRecordedEvents() const;
+
+    /**
+     * The maximum number of the events kept in memory. All the events
+     * recorded after the limit is reached are dropped.
+     */
+    static const int MAX_EVENTS = 1 << 20;
+
+private:
+    struct Event;
+    struct ThreadBuffer;
+    struct Private;
+    const QScopedPointer<Private> m_d;
+
+    std::atomic<bool> m_isEnabled {false};
+};
+
+#endif // KISPERFTRACER_H
@@ -11,6 +11,9 @@
 
 #include "KisRunnableStrokeJobData.h"
 #include "KisRunnableStrokeJobsInterface.h"
+#include "KisRunnableStrokeJobUtils.h"
+#include "kis_lod_transform.h"
+#include "krita_utils.h"
 
 struct KisRunnableBasedStrokeStrategy::JobsInterface : public KisRunnableStrokeJobsInterface
 {
@@ -43,7 +46,9 @@ KisRunnableBasedStrokeStrategy::KisRunnableBasedStrokeStrategy(const QLatin1Stri
 
 KisRunnableBasedStrokeStrategy::KisRunnableBasedStrokeStrategy(const KisRunnableBasedStrokeStrategy &rhs)
     : KisSimpleStrokeStrategy(rhs),
-      m_jobsInterface(new JobsInterface(this))
+      m_jobsInterface(new JobsInterface(this)),
+      m_lodPreviewEnabled(rhs.m_lodPreviewEnabled),
+      m_previewLevelOfDetail(rhs.m_previewLevelOfDetail)
 {
 }
 
@@ -65,3 +70,60 @@ KisRunnableStrokeJobsInterface *KisRunnableBasedStrokeStrategy::runnableJobsInte
 {
     return m_jobsInterface.data();
 }
+
+KisStrokeStrategy* KisRunnableBasedStrokeStrategy::createLodClone(int levelOfDetail)
+{
+    if (!m_lodPreviewEnabled || levelOfDetail <= 0) return 0;
+
+    KisRunnableBasedStrokeStrategy *clone = createLodPreviewClone(levelOfDetail);
+    if (clone) {
+        clone->m_previewLevelOfDetail = levelOfDetail;
+    }
+
+    return clone;
+}
+
+void KisRunnableBasedStrokeStrategy::enableLodPreview(bool forceLodMode)
+{
+    m_lodPreviewEnabled = true;
+    setForceLodModeIfPossible(forceLodMode);
+}
+
+bool KisRunnableBasedStrokeStrategy::lodPreviewEnabled() const
+{
+    return m_lodPreviewEnabled;
+}
+
+KisRunnableBasedStrokeStrategy* KisRunnableBasedStrokeStrategy::createLodPreviewClone(int levelOfDetail)
+{
+    Q_UNUSED(levelOfDetail);
+    return 0;
+}
+
+int KisRunnableBasedStrokeStrategy::previewLevelOfDetail() const
+{
+    return m_previewLevelOfDetail;
+}
+
+void KisRunnableBasedStrokeStrategy::addTiledJobs(QVector<KisStrokeJobData*> &jobs,
+                                                  const QRect &rect,
+                                                  std::function<void(const QRect&)> func,
+                                                  const QSize &patchSize) const
+{
+    const int lod = m_previewLevelOfDetail;
+
+    const QRect lodRect = lod > 0 ?
+        KisLodTransform::scaledRect(KisLodTransform::alignedRect(rect, lod), lod) :
+        rect;
+
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(lodRect,
+                                         patchSize.isValid() ?
+                                             patchSize : KritaUtils::optimalPatchSize());
+
+    Q_FOREACH (const QRect &patch, patches) {
+        KritaUtils::addJobConcurrent(jobs, [func, patch] () {
+            func(patch);
+        });
+    }
+}
@@ -9,7 +9,11 @@
 
 #include "kis_simple_stroke_strategy.h"
 
+#include <functional>
+#include <QSize>
+
 class KisRunnableStrokeJobsInterface;
+class QRect;
 
 class KRITAIMAGE_EXPORT KisRunnableBasedStrokeStrategy : public KisSimpleStrokeStrategy
 {
@@ -25,8 +29,66 @@ public:
 
     KisRunnableStrokeJobsInterface *runnableJobsInterface() const;
 
+    /**
+     * Creates the LoD preview of the stroke with createLodPreviewClone()
+     * if the stroke has opted in with enableLodPreview(). Don't override
+     * it in the descendants, override createLodPreviewClone() instead.
+     */
+    KisStrokeStrategy* createLodClone(int levelOfDetail) override;
+
+protected:
+    /**
+     * Opts the stroke in to the speculative LoD preview. When the image
+     * has a non-zero desired level of detail, the stroke is first
+     * executed on a clone created by createLodPreviewClone(), which
+     * renders a preview at the reduced resolution, and only after that
+     * the stroke itself renders the full-resolution result.
+     *
+     * The strategy should generate all its jobs itself (e.g. in
+     * initStrokeCallback()), because the jobs added to the stroke with
+     * KisStrokesFacade::addJob() are cloned for the preview only if they
+     * implement KisStrokeJobData::createLodClone().
+     *
+     * By default the preview is rendered only if the user has preferred
+     * the instant preview mode. If \p forceLodMode is true, the preview
+     * is rendered whenever the level of detail is supported.
+     */
+    void enableLodPreview(bool forceLodMode = false);
+    bool lodPreviewEnabled() const;
+
+    /**
+     * Creates a copy of the strategy that will render the stroke at
+     * \p levelOfDetail. Return null if the preview is not possible.
+     * The default implementation returns null.
+     */
+    virtual KisRunnableBasedStrokeStrategy* createLodPreviewClone(int levelOfDetail);
+
+    /**
+     * The level of detail the stroke renders at: zero for the
+     * full-resolution stroke and non-zero for its LoD preview
+     */
+    int previewLevelOfDetail() const;
+
+    /**
+     * Adds concurrent jobs that call \p func for every patch of \p rect.
+     * The rect is passed in image coordinates and is mapped into the
+     * coordinates of previewLevelOfDetail(), so the same code can be used
+     * to generate the jobs for both the preview and the full-resolution
+     * stroke. Issue the update of the patch right from \p func to let
+     * the result be shown patch by patch.
+     *
+     * If \p patchSize is not valid, KritaUtils::optimalPatchSize() is used.
+     */
+    void addTiledJobs(QVector<KisStrokeJobData*> &jobs,
+                      const QRect &rect,
+                      std::function<void(const QRect&)> func,
+                      const QSize &patchSize = QSize()) const;
+
 private:
     const QScopedPointer<KisRunnableStrokeJobsInterface> m_jobsInterface;
+
+    bool m_lodPreviewEnabled = false;
+    int m_previewLevelOfDetail = 0;
 };
 
 #endif // KISRUNNABLEBASEDSTROKESTRATEGY_H
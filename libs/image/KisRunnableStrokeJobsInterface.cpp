@@ -8,6 +8,9 @@
 
 #include <QVector>
 
+#include "krita_utils.h"
+#include "KisWorkStealingExecutor.h"
+
 KisRunnableStrokeJobsInterface::~KisRunnableStrokeJobsInterface()
 {
 
@@ -17,3 +20,18 @@ void KisRunnableStrokeJobsInterface::addRunnableJob(KisRunnableStrokeJobDataBase
 {
     addRunnableJobs({data});
 }
+
+void KisRunnableStrokeJobsInterface::runSplitJob(const QRect &rect, std::function<void(const QRect&)> func,
+                                                 const QSize &patchSize)
+{
+    const QSize size = !patchSize.isEmpty() ? patchSize : KisWorkStealingExecutor::defaultPatchSize();
+    KisWorkStealingExecutor *executor = KisWorkStealingExecutor::currentExecutor();
+
+    if (executor) {
+        executor->runSplitJob(rect, func, size);
+    } else {
+        Q_FOREACH (const QRect &rc, KritaUtils::splitRectIntoPatches(rect, size)) {
+            func(rc);
+        }
+    }
+}
@@ -9,9 +9,12 @@
 
 #include "kritaimage_export.h"
 #include <QtGlobal>
+#include <QSize>
+#include <functional>
 #include "kis_pointer_utils.h"
 
 class KisRunnableStrokeJobDataBase;
+class QRect;
 
 
 class KRITAIMAGE_EXPORT KisRunnableStrokeJobsInterface
@@ -26,6 +29,20 @@ public:
     void addRunnableJobs(const QVector<T*> &list) {
         this->addRunnableJobs(implicitCastList<KisRunnableStrokeJobDataBase*>(list));
     }
+
+    /**
+     * Runs \p func for every patch of \p rect right in the context of
+     * the currently running job. When called from a worker of the
+     * updater context, the patches are shared with the idle workers,
+     * otherwise they are processed sequentially. Unlike addRunnableJobs(),
+     * the call returns only when all the patches are processed.
+     *
+     * If \p patchSize is empty, the patches have the size of a tile.
+     *
+     * \see KisWorkStealingExecutor::runSplitJob()
+     */
+    void runSplitJob(const QRect &rect, std::function<void(const QRect&)> func,
+                     const QSize &patchSize = QSize());
 };
 
 #endif // KISRUNNABLESTROKEJOBSINTERFACE_H
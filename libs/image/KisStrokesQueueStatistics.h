@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSTROKESQUEUESTATISTICS_H
+#define KISSTROKESQUEUESTATISTICS_H
+
+#include <QtGlobal>
+
+/**
+ * The depth of the strokes queue at some moment of time
+ *
+ * \see KisStrokesQueue::statistics()
+ */
+struct KisStrokesQueueStatistics
+{
+    /// the number of strokes in the queue, including the running one
+    int numStrokes = 0;
+
+    /// the number of strokes that have been started, but not ended yet
+    int numOpenedStrokes = 0;
+
+    /// the number of jobs waiting in all the queued strokes
+    int numPendingJobs = 0;
+
+    /// the number of strokes finished or cancelled since the queue creation
+    qint64 numFinishedStrokes = 0;
+};
+
+#endif // KISSTROKESQUEUESTATISTICS_H
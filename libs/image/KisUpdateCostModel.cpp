@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdateCostModel.h"
+
+#include <QtMath>
+
+#include "kis_projection_leaf.h"
+#include "kis_abstract_projection_plane.h"
+#include "kis_layer.h"
+#include "kis_effect_mask.h"
+#include "kis_node_filter_interface.h"
+#include "kis_psd_layer_style.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "tiles3/kis_tile_data_interface.h"
+
+namespace {
+
+qreal filterCostHint(KisNodeSP node)
+{
+    KisNodeFilterInterface *filterNode = dynamic_cast<KisNodeFilterInterface*>(node.data());
+    if (!filterNode) return 0.0;
+
+    KisFilterConfigurationSP config = filterNode->filter();
+    if (!config) return 0.0;
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(config->name());
+    return filter ? filter->costHint() : 1.0;
+}
+
+qint64 area(const QRect &rc)
+{
+    return qint64(rc.width()) * rc.height();
+}
+
+}
+
+namespace KisUpdateCostModel
+{
+
+qreal filtersCostHint(KisProjectionLeafSP leaf)
+{
+    KisNodeSP node = leaf->node();
+    qreal costHint = filterCostHint(node);
+
+    KisLayer *layer = qobject_cast<KisLayer*>(node.data());
+    if (layer) {
+        Q_FOREACH (KisEffectMaskSP mask, layer->effectMasks()) {
+            costHint += filterCostHint(mask);
+        }
+
+        KisPSDLayerStyleSP style = layer->layerStyle();
+        if (style && style->isEnabled()) {
+            costHint += LAYER_STYLE_COST_HINT;
+        }
+    }
+
+    return costHint;
+}
+
+qreal estimateCost(KisBaseRectsWalkerSP walker)
+{
+    qreal cost = 0.0;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walker->leafStack()) {
+        if (item.m_applyRect.isEmpty()) continue;
+
+        cost += area(item.m_applyRect);
+
+        const qreal costHint = filtersCostHint(item.m_leaf);
+
+        if (costHint > 0.0) {
+            const QRect needRect =
+                item.m_leaf->projectionPlane()->needRect(item.m_applyRect,
+                    KisBaseRectsWalker::convertPositionToFilthy(item.m_position));
+
+            cost += costHint * area(needRect | item.m_applyRect);
+        }
+    }
+
+    return cost;
+}
+
+QSize adaptivePatchSize(qreal costDensity, const QSize &maxPatchSize, qreal referenceDensity)
+{
+    if (costDensity <= referenceDensity) return maxPatchSize;
+
+    const qreal scale = std::sqrt(referenceDensity / costDensity);
+
+    auto alignSize = [] (int size, int maxSize, int tileSize) {
+        return qMin(maxSize, qMax(tileSize, size / tileSize * tileSize));
+    };
+
+    return QSize(alignSize(qRound(maxPatchSize.width() * scale), maxPatchSize.width(), KisTileData::WIDTH),
+                 alignSize(qRound(maxPatchSize.height() * scale), maxPatchSize.height(), KisTileData::HEIGHT));
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATECOSTMODEL_H
+#define KISUPDATECOSTMODEL_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+#include "kis_base_rects_walker.h"
+
+#include <QSize>
+
+/**
+ * A rough model of the time a merge job takes.
+ *
+ * The cost is measured in "composited pixels": compositing one pixel
+ * of a plain layer costs 1.0. Every layer of the walker's merge task
+ * costs its apply rect, plus its need rect multiplied by the cost
+ * hints of the filters it runs (an adjustment layer, filter masks or
+ * a layer style).
+ *
+ * KisSimpleUpdateQueue uses the cost density of an update to shrink
+ * the patches the update is split into, so that an update under a
+ * stack of heavy filters is distributed between all the threads
+ * instead of being stuck in one of them.
+ */
+namespace KisUpdateCostModel
+{
+    /**
+     * The cost hint of a layer style, which usually runs a couple
+     * of blur-like operations
+     */
+    static const qreal LAYER_STYLE_COST_HINT = 8.0;
+
+    /**
+     * Returns the sum of the cost hints of all the filters that are
+     * applied to \p leaf. Zero for a plain layer.
+     */
+    KRITAIMAGE_EXPORT qreal filtersCostHint(KisProjectionLeafSP leaf);
+
+    /**
+     * Returns the estimated cost of the merge job of \p walker
+     */
+    KRITAIMAGE_EXPORT qreal estimateCost(KisBaseRectsWalkerSP walker);
+
+    /**
+     * Returns the size of the patches for an update with cost per
+     * pixel \p costDensity. The patch size \p maxPatchSize is used for
+     * the updates with cost density up to \p referenceDensity, the
+     * patches of more expensive updates are shrunk to keep their cost
+     * at the same level. The result is aligned to the tile size.
+     */
+    KRITAIMAGE_EXPORT QSize adaptivePatchSize(qreal costDensity,
+                                              const QSize &maxPatchSize,
+                                              qreal referenceDensity);
+}
+
+#endif // KISUPDATECOSTMODEL_H
@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisUpdaterThreadAffinity.h"
+
+#include <QRect>
+#include <QVector>
+#include <QGlobalStatic>
+
+#if defined Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#elif defined Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+/**
+ * The CPU the current thread is bound to, -1 if it is not bound
+ */
+thread_local int s_boundCpu = -1;
+
+/**
+ * The set of CPUs the process is allowed to run on. It may be
+ * restricted by the user (taskset, cgroups, job objects), so the
+ * CPU ids are not necessarily contiguous. The set is read once,
+ * before any of the threads is bound to a CPU.
+ */
+struct AllowedCpus
+{
+    AllowedCpus()
+    {
+#if defined Q_OS_LINUX
+        CPU_ZERO(&cpuSet);
+
+        if (!sched_getaffinity(0, sizeof(cpuSet), &cpuSet)) {
+            for (int i = 0; i < CPU_SETSIZE; i++) {
+                if (CPU_ISSET(i, &cpuSet)) {
+                    cpus << i;
+                }
+            }
+        }
+#elif defined Q_OS_WIN
+        DWORD_PTR systemMask = 0;
+
+        if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            // the affinity mask is limited to one processor group
+            for (int i = 0; i < int(sizeof(DWORD_PTR) * 8); i++) {
+                if (processMask & (DWORD_PTR(1) << i)) {
+                    cpus << i;
+                }
+            }
+        }
+#endif
+    }
+
+#if defined Q_OS_LINUX
+    cpu_set_t cpuSet;
+#elif defined Q_OS_WIN
+    DWORD_PTR processMask = 0;
+#endif
+
+    QVector<int> cpus;
+};
+
+Q_GLOBAL_STATIC(AllowedCpus, s_allowedCpus)
+
+bool setCurrentThreadAffinity(int cpu)
+{
+#if defined Q_OS_LINUX
+    cpu_set_t cpuSet;
+
+    if (cpu >= 0) {
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+    } else {
+        cpuSet = s_allowedCpus->cpuSet;
+    }
+
+    return !pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#elif defined Q_OS_WIN
+    const DWORD_PTR mask = cpu >= 0 ? DWORD_PTR(1) << cpu : s_allowedCpus->processMask;
+    return SetThreadAffinityMask(GetCurrentThread(), mask);
+#else
+    Q_UNUSED(cpu);
+    return false;
+#endif
+}
+
+}
+
+namespace KisUpdaterThreadAffinity
+{
+
+int preferredSlot(const QRect &rc, int numSlots)
+{
+    if (numSlots <= 0) return 0;
+
+    const int y = rc.center().y();
+    const int stripe = y >= 0 ? y / STRIPE_HEIGHT : (y - STRIPE_HEIGHT + 1) / STRIPE_HEIGHT;
+
+    const int slot = stripe % numSlots;
+    return slot >= 0 ? slot : slot + numSlots;
+}
+
+bool bindCurrentThread(int cpuIndex)
+{
+    const QVector<int> &cpus = s_allowedCpus->cpus;
+    if (cpus.isEmpty()) return false;
+
+    const int cpu = cpus[cpuIndex % cpus.size()];
+
+    if (s_boundCpu == cpu) return true;
+
+    const bool result = setCurrentThreadAffinity(cpu);
+    s_boundCpu = result ? cpu : -1;
+
+    return result;
+}
+
+void unbindCurrentThread()
+{
+    if (s_boundCpu < 0) return;
+
+    setCurrentThreadAffinity(-1);
+    s_boundCpu = -1;
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATERTHREADAFFINITY_H
+#define KISUPDATERTHREADAFFINITY_H
+
+#include "kritaimage_export.h"
+
+class QRect;
+
+/**
+ * Helpers for the thread-affine mode of KisUpdaterContext.
+ *
+ * In this mode the image is split into horizontal stripes of tiles
+ * and every stripe has a preferred job slot of the context. The
+ * thread running the slot is bound to a fixed CPU, so the same
+ * stripe is always composited on the same core (and the same NUMA
+ * node). Since the operating systems place memory pages on the node
+ * of the thread that touches them first, the tile data of the
+ * projection created by the merge jobs ends up local to the core
+ * that composites it later.
+ */
+namespace KisUpdaterThreadAffinity
+{
+    /**
+     * The height of a stripe in pixels
+     */
+    static const int STRIPE_HEIGHT = 256;
+
+    /**
+     * Returns the index of the preferred job slot for \p rc
+     */
+    KRITAIMAGE_EXPORT int preferredSlot(const QRect &rc, int numSlots);
+
+    /**
+     * Binds the current thread to the \p cpuIndex-th (modulo the
+     * number of CPUs) CPU of the set the process is allowed to run
+     * on. Does nothing if the thread is already bound to it. Returns
+     * false if the platform doesn't support that.
+     */
+    KRITAIMAGE_EXPORT bool bindCurrentThread(int cpuIndex);
+
+    /**
+     * Lets the current thread run on all the CPUs the process is
+     * allowed to run on again
+     */
+    KRITAIMAGE_EXPORT void unbindCurrentThread();
+}
+
+#endif // KISUPDATERTHREADAFFINITY_H
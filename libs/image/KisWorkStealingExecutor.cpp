@@ -0,0 +1,463 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisWorkStealingExecutor.h"
+
+#include <atomic>
+#include <deque>
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "kis_assert.h"
+#include "krita_utils.h"
+#include "kis_update_job_item.h"
+#include "tiles3/kis_tile_data_interface.h"
+
+
+qreal KisWorkStealingExecutor::Statistics::utilization() const
+{
+    const qreal availableTime = qreal(wallTime) * numWorkers;
+    return availableTime > 0 ? qBound(0.0, busyTime / availableTime, 1.0) : 0.0;
+}
+
+struct KisWorkStealingExecutor::Worker : public QThread
+{
+    Worker(KisWorkStealingExecutor *_q, int _index)
+        : q(_q), index(_index)
+    {
+    }
+
+    void run() override;
+
+    KisWorkStealingExecutor *q;
+    const int index;
+
+    /**
+     * The owner pushes and pops the tasks at the back of the deque,
+     * the thieves take them from the front. The lock is contended
+     * only when somebody steals from this worker.
+     */
+    QMutex dequeLock;
+    std::deque<QRunnable*> deque;
+
+    std::atomic<qint64> busyTime {0};
+    std::atomic<qint64> numTasks {0};
+    std::atomic<qint64> numSteals {0};
+};
+
+struct KisWorkStealingExecutor::SplitJob
+{
+    SplitJob(int _numItems, std::function<void(int)> _func)
+        : numItems(_numItems), func(_func),
+          runsStrokeJob(KisUpdateJobItem::currentThreadRunsStrokeJob())
+    {
+    }
+
+    /**
+     * Processes the items until there are no unclaimed ones left.
+     * Called by the owner of the job and by all the helpers.
+     */
+    void processItems() {
+        int numProcessed = 0;
+
+        int index;
+        while ((index = nextItem.fetch_add(1)) < numItems) {
+            func(index);
+            numProcessed++;
+        }
+
+        if (numProcessed &&
+            numDone.fetch_add(numProcessed) + numProcessed == numItems) {
+
+            QMutexLocker l(&lock);
+            doneCondition.wakeAll();
+        }
+    }
+
+    void waitForDone() {
+        QMutexLocker l(&lock);
+        while (numDone.load() < numItems) {
+            doneCondition.wait(&lock);
+        }
+    }
+
+    const int numItems;
+    const std::function<void(int)> func;
+
+    /**
+     * The thread-local context of the owner of the job. The helpers
+     * reinstate it, so that the updates requested by the items are
+     * treated the same way whatever thread processes them.
+     */
+    const bool runsStrokeJob;
+
+    std::atomic<int> nextItem {0};
+    std::atomic<int> numDone {0};
+
+    QMutex lock;
+    QWaitCondition doneCondition;
+};
+
+namespace {
+
+/**
+ * A helper task of a split job. If it is started after the owner has
+ * already claimed all the patches, it just exits, so the job is never
+ * split more than the number of idle workers allows.
+ */
+template <typename SplitJobSP>
+class SplitJobHelper : public QRunnable
+{
+public:
+    SplitJobHelper(SplitJobSP job)
+        : m_job(job)
+    {
+    }
+
+    void run() override {
+        KisUpdateJobItem::StrokeJobThreadMarker marker(m_job->runsStrokeJob);
+        m_job->processItems();
+    }
+
+private:
+    SplitJobSP m_job;
+};
+
+}
+
+struct KisWorkStealingExecutor::Private
+{
+    KisWorkStealingExecutor *q;
+
+    QVector<Worker*> workers;
+
+    QMutex injectionLock;
+    std::deque<QRunnable*> injectionQueue;
+
+    /**
+     * The number of tasks in all the deques and the injection queue
+     */
+    std::atomic<int> numQueued {0};
+
+    /**
+     * The number of the tasks that are either queued or running
+     */
+    std::atomic<int> numPending {0};
+
+    QMutex sleepLock;
+    QWaitCondition wakeCondition;
+    int numSleeping = 0;
+    bool quit = false;
+
+    QMutex doneLock;
+    QWaitCondition doneCondition;
+
+    QElapsedTimer wallTimer;
+
+    QRunnable* popTask(Worker *worker);
+    void runTask(Worker *worker, QRunnable *task);
+    void wakeOneWorker();
+    void startWorkers(int count);
+    void stopWorkers();
+};
+
+QRunnable* KisWorkStealingExecutor::Private::popTask(Worker *worker)
+{
+    QRunnable *task = 0;
+
+    {
+        QMutexLocker l(&worker->dequeLock);
+        if (!worker->deque.empty()) {
+            task = worker->deque.back();
+            worker->deque.pop_back();
+            numQueued--;
+            return task;
+        }
+    }
+
+    {
+        QMutexLocker l(&injectionLock);
+        if (!injectionQueue.empty()) {
+            task = injectionQueue.front();
+            injectionQueue.pop_front();
+            numQueued--;
+            return task;
+        }
+    }
+
+    for (int i = 1; i < workers.size(); i++) {
+        Worker *victim = workers[(worker->index + i) % workers.size()];
+
+        QMutexLocker l(&victim->dequeLock);
+        if (!victim->deque.empty()) {
+            task = victim->deque.front();
+            victim->deque.pop_front();
+            numQueued--;
+            worker->numSteals++;
+            return task;
+        }
+    }
+
+    return task;
+}
+
+void KisWorkStealingExecutor::Private::runTask(Worker *worker, QRunnable *task)
+{
+    const bool autoDelete = task->autoDelete();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    task->run();
+
+    worker->busyTime += timer.nsecsElapsed();
+    worker->numTasks++;
+
+    if (autoDelete) {
+        delete task;
+    }
+
+    if (--numPending == 0) {
+        QMutexLocker l(&doneLock);
+        doneCondition.wakeAll();
+    }
+}
+
+void KisWorkStealingExecutor::Private::wakeOneWorker()
+{
+    QMutexLocker l(&sleepLock);
+    if (numSleeping > 0) {
+        wakeCondition.wakeOne();
+    }
+}
+
+void KisWorkStealingExecutor::Private::startWorkers(int count)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(workers.isEmpty());
+
+    for (int i = 0; i < count; i++) {
+        Worker *worker = new Worker(q, i);
+        worker->setObjectName(QString("Update worker %1").arg(i));
+        workers.append(worker);
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->start();
+    }
+}
+
+void KisWorkStealingExecutor::Private::stopWorkers()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!numQueued);
+
+    {
+        QMutexLocker l(&sleepLock);
+        quit = true;
+        wakeCondition.wakeAll();
+    }
+
+    Q_FOREACH (Worker *worker, workers) {
+        worker->wait();
+    }
+
+    qDeleteAll(workers);
+    workers.clear();
+
+    quit = false;
+}
+
+void KisWorkStealingExecutor::Worker::run()
+{
+    currentWorker() = this;
+
+    Private *d = q->m_d.data();
+
+    while (1) {
+        QRunnable *task = d->popTask(this);
+
+        if (task) {
+            d->runTask(this, task);
+            continue;
+        }
+
+        QMutexLocker l(&d->sleepLock);
+
+        if (d->quit) break;
+
+        /**
+         * The producer increments the counter before taking the sleep
+         * lock, so either we see the task here or the producer sees
+         * us sleeping and wakes us up.
+         */
+        if (d->numQueued > 0) continue;
+
+        d->numSleeping++;
+        d->wakeCondition.wait(&d->sleepLock);
+        d->numSleeping--;
+    }
+
+    currentWorker() = 0;
+}
+
+
+KisWorkStealingExecutor::KisWorkStealingExecutor(int threadCount)
+    : m_d(new Private)
+{
+    m_d->q = this;
+
+    if (threadCount <= 0) {
+        threadCount = qMax(1, QThread::idealThreadCount());
+    }
+
+    m_d->startWorkers(threadCount);
+    m_d->wallTimer.start();
+}
+
+KisWorkStealingExecutor::~KisWorkStealingExecutor()
+{
+    waitForDone();
+    m_d->stopWorkers();
+}
+
+void KisWorkStealingExecutor::start(QRunnable *runnable)
+{
+    m_d->numPending++;
+
+    Worker *worker = currentWorker();
+
+    if (worker && worker->q == this) {
+        QMutexLocker l(&worker->dequeLock);
+        worker->deque.push_back(runnable);
+        m_d->numQueued++;
+    } else {
+        QMutexLocker l(&m_d->injectionLock);
+        m_d->injectionQueue.push_back(runnable);
+        m_d->numQueued++;
+    }
+
+    m_d->wakeOneWorker();
+}
+
+void KisWorkStealingExecutor::waitForDone()
+{
+    QMutexLocker l(&m_d->doneLock);
+
+    while (m_d->numPending > 0) {
+        m_d->doneCondition.wait(&m_d->doneLock);
+    }
+}
+
+void KisWorkStealingExecutor::setMaxThreadCount(int value)
+{
+    value = qMax(1, value);
+    if (value == m_d->workers.size()) return;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!currentWorker() || currentWorker()->q != this);
+
+    waitForDone();
+    m_d->stopWorkers();
+    m_d->startWorkers(value);
+    resetStatistics();
+}
+
+int KisWorkStealingExecutor::maxThreadCount() const
+{
+    return m_d->workers.size();
+}
+
+void KisWorkStealingExecutor::runSplitJob(const QRect &rect,
+                                          std::function<void(const QRect&)> func,
+                                          const QSize &patchSize)
+{
+    const QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rect, patchSize);
+
+    runIndexedJob(patches.size(),
+                  [&patches, &func] (int index) {
+                      func(patches[index]);
+                  });
+}
+
+void KisWorkStealingExecutor::runParallelJobs(const QVector<std::function<void()>> &jobs)
+{
+    runIndexedJob(jobs.size(),
+                  [&jobs] (int index) {
+                      jobs[index]();
+                  });
+}
+
+void KisWorkStealingExecutor::runIndexedJob(int numItems, std::function<void(int)> func)
+{
+    if (numItems <= 1 || m_d->workers.size() <= 1) {
+        for (int i = 0; i < numItems; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    QSharedPointer<SplitJob> job(new SplitJob(numItems, func));
+
+    /**
+     * The helpers are pushed into our own deque, so they are
+     * picked up only by the workers that have nothing else to do
+     */
+    const int numHelpers = qMin(numItems, m_d->workers.size()) - 1;
+    for (int i = 0; i < numHelpers; i++) {
+        start(new SplitJobHelper<QSharedPointer<SplitJob>>(job));
+    }
+
+    job->processItems();
+    job->waitForDone();
+}
+
+KisWorkStealingExecutor* KisWorkStealingExecutor::currentExecutor()
+{
+    Worker *worker = currentWorker();
+    return worker ? worker->q : 0;
+}
+
+QSize KisWorkStealingExecutor::defaultPatchSize()
+{
+    return QSize(KisTileData::WIDTH, KisTileData::HEIGHT);
+}
+
+KisWorkStealingExecutor::Statistics KisWorkStealingExecutor::statistics() const
+{
+    Statistics stats;
+
+    stats.numWorkers = m_d->workers.size();
+    stats.wallTime = m_d->wallTimer.nsecsElapsed();
+
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        stats.busyTime += worker->busyTime;
+        stats.numTasks += worker->numTasks;
+        stats.numSteals += worker->numSteals;
+    }
+
+    return stats;
+}
+
+void KisWorkStealingExecutor::resetStatistics()
+{
+    Q_FOREACH (Worker *worker, m_d->workers) {
+        worker->busyTime = 0;
+        worker->numTasks = 0;
+        worker->numSteals = 0;
+    }
+
+    m_d->wallTimer.restart();
+}
+
+KisWorkStealingExecutor::Worker*& KisWorkStealingExecutor::currentWorker()
+{
+    thread_local Worker *worker = 0;
+    return worker;
+}
@@ -0,0 +1,127 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISWORKSTEALINGEXECUTOR_H
+#define KISWORKSTEALINGEXECUTOR_H
+
+#include "kritaimage_export.h"
+
+#include <functional>
+
+#include <QRect>
+#include <QScopedPointer>
+#include <QSize>
+#include <QVector>
+
+class QRunnable;
+
+/**
+ * A thread pool where every worker thread owns a deque of tasks.
+ *
+ * The tasks started from within a worker are pushed into the
+ * worker's own deque and are executed in LIFO order, which keeps
+ * the data they touch hot in the cache of the core. The tasks
+ * started from the outside go into a shared injection queue. When a
+ * worker runs out of tasks, it steals the oldest task from the deque
+ * of another worker, so the load is balanced without any central
+ * scheduling.
+ *
+ * The executor is a drop-in replacement for QThreadPool in
+ * KisUpdaterContext. Besides that, any job running on a worker may
+ * split itself into tile-sized subtasks with runSplitJob(). The
+ * subtasks are distributed on demand: the idle workers pick them up,
+ * the busy ones never see them, and the caller itself processes
+ * everything that is not picked up.
+ */
+class KRITAIMAGE_EXPORT KisWorkStealingExecutor
+{
+public:
+    struct KRITAIMAGE_EXPORT Statistics
+    {
+        int numWorkers = 0;
+
+        /// time passed since the last resetStatistics(), in nanoseconds
+        qint64 wallTime = 0;
+
+        /// the sum of the time the workers spent running tasks, in nanoseconds
+        qint64 busyTime = 0;
+
+        qint64 numTasks = 0;
+        qint64 numSteals = 0;
+
+        /**
+         * The share of the available CPU time that was spent on the
+         * actual work, in range [0.0, 1.0]
+         */
+        qreal utilization() const;
+    };
+
+public:
+    KisWorkStealingExecutor(int threadCount = 0);
+    ~KisWorkStealingExecutor();
+
+    /**
+     * Queues \p runnable for execution. If the runnable has
+     * autoDelete() flag set, it is deleted after completion.
+     */
+    void start(QRunnable *runnable);
+
+    /**
+     * Blocks the caller until all the queued tasks are completed
+     */
+    void waitForDone();
+
+    /**
+     * Sets the number of the worker threads. It waits for all the
+     * queued tasks to complete, so it must not be called from a
+     * worker thread.
+     */
+    void setMaxThreadCount(int value);
+    int maxThreadCount() const;
+
+    /**
+     * Splits \p rect into tile-aligned patches of size \p patchSize
+     * and calls \p func for every patch. The idle workers help the
+     * caller to process the patches. The call returns when all the
+     * patches are processed.
+     */
+    void runSplitJob(const QRect &rect,
+                     std::function<void(const QRect&)> func,
+                     const QSize &patchSize = defaultPatchSize());
+
+    /**
+     * Runs independent \p jobs the same way as the patches of
+     * runSplitJob(): the idle workers help the caller, and the call
+     * returns when all the jobs are completed.
+     */
+    void runParallelJobs(const QVector<std::function<void()>> &jobs);
+
+    /**
+     * Returns the executor that owns the calling thread or null if
+     * the caller is not a worker thread.
+     */
+    static KisWorkStealingExecutor* currentExecutor();
+
+    /**
+     * The size of a patch for runSplitJob(), equal to the size of a tile
+     */
+    static QSize defaultPatchSize();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Worker;
+    struct SplitJob;
+    struct Private;
+    const QScopedPointer<Private> m_d;
+
+    static Worker*& currentWorker();
+
+    void runIndexedJob(int numItems, std::function<void(int)> func);
+};
+
+#endif // KISWORKSTEALINGEXECUTOR_H
@@ -17,7 +17,8 @@
 
 
 KisGenerator::KisGenerator(const KoID& _id, const KoID & category, const QString & entry)
-    : KisBaseProcessor(_id, category, entry)
+    : KisBaseProcessor(_id, category, entry),
+      m_supportsLevelOfDetail(false)
 {
     init(id() + "_generator_bookmarks");
 }
@@ -38,3 +39,15 @@ QRect KisGenerator::generatedRect(QRect _imageArea, const KisFilterConfiguration
 {
     return _imageArea;
 }
+
+bool KisGenerator::supportsLevelOfDetail(const KisFilterConfigurationSP config, int lod) const
+{
+    Q_UNUSED(config);
+    Q_UNUSED(lod);
+    return m_supportsLevelOfDetail;
+}
+
+void KisGenerator::setSupportsLevelOfDetail(bool value)
+{
+    m_supportsLevelOfDetail = value;
+}
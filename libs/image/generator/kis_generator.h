@@ -79,11 +79,21 @@ public:
      */ 
     virtual bool allowsSplittingIntoPatches() const { return true; }
 
+    /**
+     * Returns true if the generator is capable of rendering into LoD
+     * scaled planes, i.e. its result doesn't depend on the resolution
+     * of the device, when generating the preview of a fill layer.
+     */
+    virtual bool supportsLevelOfDetail(const KisFilterConfigurationSP config, int lod) const;
+
 protected:
 
     /// @return the name of config group in KConfig
     QString configEntryGroup() const;
+    void setSupportsLevelOfDetail(bool value);
 
+private:
+    bool m_supportsLevelOfDetail;
 };
 
 
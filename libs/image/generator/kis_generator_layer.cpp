@@ -104,10 +104,10 @@ void KisGeneratorLayer::slotDelayedStaticUpdate()
     }
 }
 
-void KisGeneratorLayer::requestUpdateJobsWithStroke(KisStrokeId strokeId, KisFilterConfigurationSP filterConfig)
+QRegion KisGeneratorLayer::prepareUpdate(const KisFilterConfigurationSP filterConfig, QSharedPointer<bool> cookie)
 {
     QMutexLocker locker(&m_d->mutex);
-    
+
     KisImageSP image = this->image().toStrongRef();
     const QRect updateRect = extent() | image->bounds();
 
@@ -123,27 +123,34 @@ void KisGeneratorLayer::requestUpdateJobsWithStroke(KisStrokeId strokeId, KisFil
 
     const QRegion processRegion(QRegion(updateRect) - m_d->preparedRect);
     if (processRegion.isEmpty())
-        return;
+        return processRegion;
 
-    KisGeneratorSP f = KisGeneratorRegistry::instance()->value(filterConfig->name());
-    KIS_SAFE_ASSERT_RECOVER_RETURN(f);
+    m_d->updateCookie = cookie;
+    m_d->preparedRect = updateRect;
+    m_d->preparedImageBounds = image->bounds();
+    m_d->preparedForFilter = filterConfig;
 
-    KisProcessingVisitor::ProgressHelper helper(this);
+    return processRegion;
+}
 
-    KisPaintDeviceSP originalDevice = original();
+void KisGeneratorLayer::requestUpdateJobsWithStroke(KisStrokeId strokeId, KisFilterConfigurationSP filterConfig)
+{
+    KisImageSP image = this->image().toStrongRef();
+
+    KisGeneratorSP f = KisGeneratorRegistry::instance()->value(filterConfig->name());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(f);
 
     QSharedPointer<bool> cookie(new bool(true));
 
-    auto jobs = KisGeneratorStrokeStrategy::createJobsData(this, cookie, f, originalDevice, processRegion, filterConfig);
+    const QRegion processRegion = prepareUpdate(filterConfig, cookie);
+    if (processRegion.isEmpty())
+        return;
+
+    auto jobs = KisGeneratorStrokeStrategy::createJobsData(this, cookie, f, original(), processRegion, filterConfig);
 
     Q_FOREACH (auto job, jobs) {
         image->addJob(strokeId, job);
     }
-
-    m_d->updateCookie = cookie;
-    m_d->preparedRect = updateRect;
-    m_d->preparedImageBounds = image->bounds();
-    m_d->preparedForFilter = filterConfig;
 }
 
 QWeakPointer<bool> KisGeneratorLayer::previewWithStroke(const KisStrokeId strokeId)
@@ -162,12 +169,23 @@ void KisGeneratorLayer::update()
     KisFilterConfigurationSP filterConfig = filter();
     KIS_SAFE_ASSERT_RECOVER_RETURN(filterConfig);
 
-    KisGeneratorStrokeStrategy *stroke = new KisGeneratorStrokeStrategy();
+    KisGeneratorSP f = KisGeneratorRegistry::instance()->value(filterConfig->name());
+    KIS_SAFE_ASSERT_RECOVER_RETURN(f);
 
-    KisStrokeId strokeId = image->startStroke(stroke);
+    QSharedPointer<bool> cookie(new bool(true));
 
-    requestUpdateJobsWithStroke(strokeId, filterConfig);
+    const QRegion processRegion = prepareUpdate(filterConfig, cookie);
+    if (processRegion.isEmpty())
+        return;
 
+    /**
+     * The stroke generates the jobs itself, so that it could render
+     * a LoD preview of the layer before the full-resolution result
+     */
+    KisGeneratorStrokeStrategy *stroke =
+        new KisGeneratorStrokeStrategy(this, cookie, f, original(), processRegion, filterConfig);
+
+    KisStrokeId strokeId = image->startStroke(stroke);
     image->endStroke(strokeId);
 }
 
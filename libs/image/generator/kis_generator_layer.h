@@ -11,6 +11,8 @@
 #include <KisDelayedUpdateNodeInterface.h>
 
 #include <QScopedPointer>
+#include <QRegion>
+#include <QSharedPointer>
 
 class KisFilterConfiguration;
 
@@ -89,6 +91,12 @@ private:
      * Injects render jobs into the given stroke.
      */
     void requestUpdateJobsWithStroke(const KisStrokeId stroke, const KisFilterConfigurationSP configuration);
+    /**
+     * Marks the layer as being rendered with \p configuration and
+     * returns the region that should be regenerated. The \p cookie is
+     * stored as the cookie of the running update.
+     */
+    QRegion prepareUpdate(const KisFilterConfigurationSP configuration, QSharedPointer<bool> cookie);
     /**
      * Resets the projection cache without triggering the update job.
      */
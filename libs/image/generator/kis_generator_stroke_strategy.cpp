@@ -26,6 +26,99 @@ KisGeneratorStrokeStrategy::KisGeneratorStrokeStrategy()
     setCanForgetAboutMe(false);
 }
 
+KisGeneratorStrokeStrategy::KisGeneratorStrokeStrategy(KisGeneratorLayerSP layer, QSharedPointer<bool> cookie, KisGeneratorSP f, KisPaintDeviceSP dev, const QRegion &region, KisFilterConfigurationSP filterConfig)
+    : KisGeneratorStrokeStrategy()
+{
+    m_layer = layer;
+    m_cookie = cookie;
+    m_generator = f;
+    m_device = dev;
+    m_region = region;
+    m_filterConfig = filterConfig;
+    m_progressHelper.reset(new KisProcessingVisitor::ProgressHelper(layer));
+
+    /**
+     * The preview is rendered patch by patch, so the generators that
+     * need the whole image in one pass can render only the
+     * full-resolution result
+     */
+    if (f->allowsSplittingIntoPatches()) {
+        enableLodPreview();
+    }
+}
+
+KisGeneratorStrokeStrategy::KisGeneratorStrokeStrategy(const KisGeneratorStrokeStrategy &rhs)
+    : QObject(),
+      KisRunnableBasedStrokeStrategy(rhs),
+      m_layer(rhs.m_layer),
+      m_cookie(rhs.m_cookie),
+      m_generator(rhs.m_generator),
+      m_device(rhs.m_device),
+      m_region(rhs.m_region),
+      m_filterConfig(rhs.m_filterConfig),
+      m_progressHelper(rhs.m_progressHelper)
+{
+}
+
+void KisGeneratorStrokeStrategy::initStrokeCallback()
+{
+    using namespace KritaUtils;
+
+    // the jobs have been added externally
+    if (!m_generator) return;
+
+    QVector<KisStrokeJobData *> jobsData;
+
+    KisGeneratorLayerSP layer = m_layer;
+    QSharedPointer<bool> cookie = m_cookie;
+    const KisGeneratorSP f = m_generator;
+    const KisPaintDeviceSP dev = m_device;
+    const KisFilterConfigurationSP filterConfig = m_filterConfig;
+    const QSharedPointer<KisProcessingVisitor::ProgressHelper> helper = m_progressHelper;
+
+    /**
+     * The jobs keep the cookie alive till the last of them is done, so
+     * the stroke should not hold it by itself.
+     */
+    m_cookie.clear();
+
+    for (const auto& rc: m_region) {
+        if (f->allowsSplittingIntoPatches()) {
+            addTiledJobs(jobsData, rc, [=](const QRect &tile) {
+                KisProcessingInformation dstCfg(dev, tile.topLeft(), KisSelectionSP());
+                f->generate(dstCfg, tile.size(), filterConfig, helper->updater());
+
+                // HACK ALERT!!!
+                // this avoids cyclic loop with KisRecalculateGeneratorLayerJob::run()
+                const_cast<KisGeneratorLayerSP &>(layer)->setDirtyWithoutUpdate({tile});
+
+                const_cast<QSharedPointer<bool> &>(cookie).clear();
+            });
+        } else {
+            KisProcessingInformation dstCfg(dev, rc.topLeft(), KisSelectionSP());
+
+            addJobSequential(jobsData, [=]() {
+                f->generate(dstCfg, rc.size(), filterConfig, helper->updater());
+
+                // HACK ALERT!!!
+                // this avoids cyclic loop with KisRecalculateGeneratorLayerJob::run()
+                const_cast<KisGeneratorLayerSP &>(layer)->setDirtyWithoutUpdate({rc});
+
+                const_cast<QSharedPointer<bool>&>(cookie).clear();
+            });
+        }
+    }
+
+    addMutatedJobs(jobsData);
+}
+
+KisRunnableBasedStrokeStrategy* KisGeneratorStrokeStrategy::createLodPreviewClone(int levelOfDetail)
+{
+    if (!m_generator->supportsLevelOfDetail(m_filterConfig, levelOfDetail)) return nullptr;
+
+    return new KisGeneratorStrokeStrategy(*this);
+}
+
 QVector<KisStrokeJobData *>KisGeneratorStrokeStrategy::createJobsData(const KisGeneratorLayerSP layer, QSharedPointer<bool> cookie, const KisGeneratorSP f, const KisPaintDeviceSP dev, const QRegion &region, const KisFilterConfigurationSP filterConfig)
 {
     using namespace KritaUtils;
@@ -11,13 +11,41 @@
 #include <kis_generator.h>
 #include <kis_generator_layer.h>
 #include <KisRunnableBasedStrokeStrategy.h>
+#include <kis_processing_visitor.h>
 
 class KisGeneratorStrokeStrategy: public QObject, public KisRunnableBasedStrokeStrategy
 {
     Q_OBJECT
 public:
+    /**
+     * Creates a stroke that renders the jobs added to it externally
+     * with createJobsData()
+     */
     KisGeneratorStrokeStrategy();
+
+    /**
+     * Creates a stroke that renders \p region of \p layer itself. If the
+     * generator supports it, the stroke renders a LoD preview first.
+     */
+    KisGeneratorStrokeStrategy(KisGeneratorLayerSP layer, QSharedPointer<bool> cookie, KisGeneratorSP f, KisPaintDeviceSP dev, const QRegion &region, KisFilterConfigurationSP filterConfig);
     ~KisGeneratorStrokeStrategy() override;
 
+    void initStrokeCallback() override;
+
     static QVector<KisStrokeJobData *> createJobsData(const KisGeneratorLayerSP layer, QSharedPointer<bool> cookie, const KisGeneratorSP f, const KisPaintDeviceSP dev, const QRegion &rc, const KisFilterConfigurationSP filterConfig);
+
+protected:
+    KisRunnableBasedStrokeStrategy* createLodPreviewClone(int levelOfDetail) override;
+
+private:
+    KisGeneratorStrokeStrategy(const KisGeneratorStrokeStrategy &rhs);
+
+private:
+    KisGeneratorLayerSP m_layer;
+    QSharedPointer<bool> m_cookie;
+    KisGeneratorSP m_generator;
+    KisPaintDeviceSP m_device;
+    QRegion m_region;
+    KisFilterConfigurationSP m_filterConfig;
+    QSharedPointer<KisProcessingVisitor::ProgressHelper> m_progressHelper;
 };
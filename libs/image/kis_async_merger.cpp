@@ -33,6 +33,7 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisBelowStackCache.h"
 
 
 //#define DEBUG_MERGER
@@ -246,6 +247,24 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 
         if (!m_currentProjection) {
             setupProjection(currentLeaf, applyRect, useTempProjections);
+
+            if (walker.levelOfDetail() == 0 && KisBelowStackCache::isEnabled()) {
+                const bool canUseCache = m_currentProjection && !useTempProjections;
+
+                if (processBelowStackCache(walker, item, applyRect, canUseCache)) {
+                    // the layers below the changed one have been loaded from the cache
+                    continue;
+                }
+            }
+        }
+
+        if (m_belowStackCache && currentLeaf == m_belowStackPivot) {
+            m_belowStackCache->store(m_belowStackPivot->node(),
+                                     m_belowStackGraphSequenceNumber,
+                                     m_belowStackRect,
+                                     m_currentProjection);
+            m_belowStackCache = 0;
+            m_belowStackPivot.clear();
         }
 
         KisUpdateOriginalVisitor originalVisitor(applyRect,
@@ -308,6 +327,89 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
 void KisAsyncMerger::resetProjection() {
     m_currentProjection = 0;
     m_finalProjection = 0;
+    m_belowStackCache = 0;
+    m_belowStackPivot.clear();
+}
+
+bool KisAsyncMerger::processBelowStackCache(KisBaseRectsWalker &walker,
+                                            const KisBaseRectsWalker::JobItem &firstItem,
+                                            const QRect &applyRect,
+                                            bool canUseCache)
+{
+    KisProjectionLeafSP parentLeaf = firstItem.m_leaf->parent();
+    if (!parentLeaf) return false;
+
+    KisGroupLayer *group = qobject_cast<KisGroupLayer*>(parentLeaf->node().data());
+    if (!group) return false;
+
+    KisBelowStackCache *cache = group->belowStackCache();
+    const KisNodeSP cachedPivot = cache->pivot();
+
+    KisMergeWalker::LeafStack &leafStack = walker.leafStack();
+
+    /**
+     * Find the lowest child of the group that is changed by the walk
+     * (the items are popped from the end of the stack, so the upper
+     * children have lower indexes)
+     */
+    int numBelowItems = 0;
+    KisProjectionLeafSP changedLeaf;
+    bool cachedPivotIsBelowChanged = false;
+
+    for (int i = 0; i <= leafStack.size(); i++) {
+        const KisBaseRectsWalker::JobItem &item =
+            i == 0 ? firstItem : leafStack[leafStack.size() - i];
+
+        if (item.m_leaf->parent() != parentLeaf) break;
+
+        if (!changedLeaf) {
+            const bool isPlainBelowItem =
+                (item.m_position & KisMergeWalker::N_BELOW_FILTHY) &&
+                !(item.m_position & (KisMergeWalker::N_EXTRA | KisMergeWalker::N_TOPMOST)) &&
+                item.m_applyRect == applyRect;
+
+            if (isPlainBelowItem) {
+                numBelowItems++;
+            } else {
+                changedLeaf = item.m_leaf;
+            }
+        }
+
+        if (cachedPivot && item.m_leaf->node() == cachedPivot) {
+            cachedPivotIsBelowChanged = !changedLeaf || changedLeaf == item.m_leaf;
+        }
+
+        if (item.m_position & KisMergeWalker::N_TOPMOST) break;
+    }
+
+    if (!changedLeaf) return false;
+
+    /**
+     * The cached composite includes the changed child if the
+     * pivot is above it, so this area is not valid anymore
+     */
+    if (cachedPivot && !cachedPivotIsBelowChanged) {
+        cache->invalidate(applyRect);
+    }
+
+    if (!canUseCache || numBelowItems < KisBelowStackCache::MIN_CACHED_LAYERS) return false;
+
+    const int graphSequenceNumber = group->graphSequenceNumber();
+
+    if (cache->load(changedLeaf->node(), graphSequenceNumber, applyRect, m_currentProjection)) {
+        // the first item has already been popped by the caller
+        for (int i = 1; i < numBelowItems; i++) {
+            leafStack.pop();
+        }
+        return true;
+    }
+
+    m_belowStackCache = cache;
+    m_belowStackPivot = changedLeaf;
+    m_belowStackRect = applyRect;
+    m_belowStackGraphSequenceNumber = graphSequenceNumber;
+
+    return false;
 }
 
 void KisAsyncMerger::setupProjection(KisProjectionLeafSP currentLeaf, const QRect& rect, bool useTempProjection) {
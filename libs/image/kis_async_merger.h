@@ -8,9 +8,11 @@
 
 #include "kritaimage_export.h"
 #include "kis_types.h"
+#include "kis_base_rects_walker.h"
 
-class QRect;
-class KisBaseRectsWalker;
+#include <QRect>
+
+class KisBelowStackCache;
 
 class KRITAIMAGE_EXPORT KisAsyncMerger
 {
@@ -23,6 +25,10 @@ private:
     inline void writeProjection(KisProjectionLeafSP topmostLeaf, bool useTempProjection, const QRect &rect);
     inline bool compositeWithProjection(KisProjectionLeafSP leaf, const QRect &rect);
     inline void doNotifyClones(KisBaseRectsWalker &walker);
+    bool processBelowStackCache(KisBaseRectsWalker &walker,
+                                const KisBaseRectsWalker::JobItem &firstItem,
+                                const QRect &applyRect,
+                                bool canUseCache);
 
 private:
     /**
@@ -49,6 +55,17 @@ private:
      * setupProjection()
      */
     KisPaintDeviceSP m_cachedPaintDevice;
+
+    /**
+     * The below-stack cache of the current group that should be
+     * filled right before the pivot leaf is composited.
+     *
+     * \see KisBelowStackCache
+     */
+    KisBelowStackCache *m_belowStackCache {0};
+    KisProjectionLeafSP m_belowStackPivot;
+    QRect m_belowStackRect;
+    int m_belowStackGraphSequenceNumber {-1};
 };
 
 
@@ -40,7 +40,8 @@ struct Q_DECL_HIDDEN KisBaseProcessor::Private {
             , supportsAdjustmentLayers(true)
             , supportsThreading(true)
             , showConfigurationWidget(true)
-            , colorSpaceIndependence(FULLY_INDEPENDENT) {
+            , colorSpaceIndependence(FULLY_INDEPENDENT)
+            , costHint(1.0) {
     }
 
     KisBookmarkedConfigurationManager* bookmarkManager;
@@ -54,6 +55,7 @@ struct Q_DECL_HIDDEN KisBaseProcessor::Private {
     bool supportsThreading;
     bool showConfigurationWidget;
     ColorSpaceIndependence colorSpaceIndependence;
+    qreal costHint;
 };
 
 KisBaseProcessor::KisBaseProcessor(const KoID& id, const KoID & category, const QString & entry)
@@ -150,6 +152,11 @@ ColorSpaceIndependence KisBaseProcessor::colorSpaceIndependence() const
     return d->colorSpaceIndependence;
 }
 
+qreal KisBaseProcessor::costHint() const
+{
+    return d->costHint;
+}
+
 void KisBaseProcessor::setSupportsPainting(bool v)
 {
     d->supportsPainting = v;
@@ -170,6 +177,11 @@ void KisBaseProcessor::setColorSpaceIndependence(ColorSpaceIndependence v)
     d->colorSpaceIndependence = v;
 }
 
+void KisBaseProcessor::setCostHint(qreal v)
+{
+    d->costHint = v;
+}
+
 bool KisBaseProcessor::showConfigurationWidget()
 {
     return d->showConfigurationWidget;
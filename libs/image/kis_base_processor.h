@@ -133,6 +133,14 @@ public:
      */
     ColorSpaceIndependence colorSpaceIndependence() const;
 
+    /**
+     * The relative cost of processing one pixel of the needed area of
+     * the filter, where 1.0 is the cost of compositing one pixel of a
+     * layer. The update queue uses it to estimate how expensive an
+     * update is and how finely it should be split between the threads.
+     */
+    qreal costHint() const;
+
     /// @return the default configuration object as defined by whoever wrote the plugin.
     /// This object must be filled in with fromXML after that.
     virtual KisFilterConfigurationSP factoryConfiguration(KisResourcesInterfaceSP resourcesInterface) const;
@@ -144,6 +152,7 @@ protected:
     void setSupportsThreading(bool v);
     void setColorSpaceIndependence(ColorSpaceIndependence v);
     void setShowConfigurationWidget(bool v);
+    void setCostHint(qreal v);
 
     /**
      * Set the default shortcut for activation of this filter.
@@ -26,6 +26,7 @@ public:
         UPDATE_NO_FILTHY,
         FULL_REFRESH,
         FULL_REFRESH_NO_FILTHY,
+        BATCH_REFRESH,
         UNSUPPORTED
     };
 
@@ -122,6 +123,7 @@ public:
         m_requestedRect = requestedRect;
         m_startNode = node;
         m_levelOfDetail = getNodeLevelOfDetail(startLeaf);
+        m_costDensity = -1.0;
         startTrip(startLeaf);
     }
 
@@ -211,6 +213,47 @@ public:
         return m_levelOfDetail;
     }
 
+    /**
+     * True if the update has been requested by a running stroke
+     * job. KisSimpleUpdateQueue processes such updates before the
+     * background ones.
+     */
+    inline bool isStrokeUpdate() const {
+        return m_isStrokeUpdate;
+    }
+
+    inline void setStrokeUpdate(bool value) {
+        m_isStrokeUpdate = value;
+    }
+
+    /**
+     * The estimated cost of the merge job per pixel of the requested
+     * rect (see KisUpdateCostModel). It is calculated by
+     * KisSimpleUpdateQueue once the rects are collected and is reset
+     * by every collectRects(). Negative if it hasn't been calculated.
+     */
+    inline qreal costDensity() const {
+        return m_costDensity;
+    }
+
+    inline void setCostDensity(qreal value) {
+        m_costDensity = value;
+    }
+
+    /**
+     * The priority class of the update assigned by KisSimpleUpdateQueue
+     * (see KisSimpleUpdateQueue::UpdatePriority). The queue updates it
+     * when the walker is queued or re-collected and when the visible
+     * areas of the canvases change.
+     */
+    inline int queuePriority() const {
+        return m_queuePriority;
+    }
+
+    inline void setQueuePriority(int value) {
+        m_queuePriority = value;
+    }
+
     virtual UpdateType type() const = 0;
 
 protected:
@@ -500,6 +543,12 @@ private:
     QRect m_lastNeedRect;
 
     int m_levelOfDetail {0};
+
+    bool m_isStrokeUpdate {false};
+
+    qreal m_costDensity {-1.0};
+
+    int m_queuePriority {0};
 };
 
 #endif /* __KIS_BASE_RECTS_WALKER_H */
@@ -0,0 +1,108 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_BATCH_REFRESH_WALKER_H
+#define __KIS_BATCH_REFRESH_WALKER_H
+
+#include <QSet>
+#include <QVector>
+
+#include "kis_full_refresh_walker.h"
+#include "kis_node.h"
+
+
+/**
+ * Refreshes the subtrees of several nodes in a single walk of the
+ * graph. The walk is started at the lowest common ancestor of the
+ * nodes, so every ancestor projection is recomposited only once.
+ * The children that don't contain any of the refreshed nodes are
+ * not regenerated: their current projections are reused.
+ *
+ * The effect is the same as of calling refreshGraphAsync() for every
+ * node with the united rect of the batch.
+ */
+class KisBatchRefreshWalker : public KisFullRefreshWalker
+{
+public:
+    KisBatchRefreshWalker(QRect cropRect, const QVector<KisNodeSP> &nodes)
+        : KisFullRefreshWalker(cropRect),
+          m_nodes(nodes)
+    {
+    }
+
+    UpdateType type() const override {
+        return BATCH_REFRESH;
+    }
+
+    const QVector<KisNodeSP>& nodes() const {
+        return m_nodes;
+    }
+
+    /**
+     * Returns the lowest common ancestor of \p nodes, which is the node
+     * the walk should be started with. The nodes that don't belong to
+     * the same graph as the first node are ignored.
+     */
+    static KisNodeSP commonAncestor(const QVector<KisNodeSP> &nodes) {
+        if (nodes.isEmpty()) return 0;
+
+        QVector<KisNodeSP> chain;
+        for (KisNodeSP node = nodes.first(); node; node = node->parent()) {
+            chain << node;
+        }
+
+        int commonIndex = 0;
+
+        Q_FOREACH (KisNodeSP node, nodes) {
+            for (; node; node = node->parent()) {
+                const int index = chain.indexOf(node);
+                if (index >= 0) {
+                    commonIndex = qMax(commonIndex, index);
+                    break;
+                }
+            }
+        }
+
+        return chain[commonIndex];
+    }
+
+    void startTrip(KisProjectionLeafSP startWith) override {
+        if (isStartLeaf(startWith)) {
+            m_filthyNodes.clear();
+            m_filthyAncestors.clear();
+
+            Q_FOREACH (KisNodeSP node, m_nodes) {
+                m_filthyNodes.insert(node.data());
+
+                for (node = node->parent(); node; node = node->parent()) {
+                    m_filthyAncestors.insert(node.data());
+                }
+            }
+        }
+
+        KisFullRefreshWalker::startTrip(startWith);
+    }
+
+protected:
+    bool isFilthySubtree(KisProjectionLeafSP leaf) const override {
+        KisNodeSP node = leaf->node();
+        if (m_filthyAncestors.contains(node.data())) return true;
+
+        for (; node; node = node->parent()) {
+            if (m_filthyNodes.contains(node.data())) return true;
+        }
+
+        return false;
+    }
+
+private:
+    QVector<KisNodeSP> m_nodes;
+
+    QSet<KisNode*> m_filthyNodes;
+    QSet<KisNode*> m_filthyAncestors;
+};
+
+#endif /* __KIS_BATCH_REFRESH_WALKER_H */
@@ -121,6 +121,10 @@ public:
         ACTUAL_DATAMGR::purge(area);
     }
 
+    inline void deduplicateTiles(KisTileDataDeduplicator &deduplicator) {
+        ACTUAL_DATAMGR::deduplicateTiles(deduplicator);
+    }
+
     /**
      * The tiles may be not allocated directly from the glibc, but
      * instead can be allocated in bigger blobs. After you freed quite
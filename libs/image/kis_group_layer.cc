@@ -25,6 +25,7 @@
 #include "kis_selection_mask.h"
 #include "kis_psd_layer_style.h"
 #include "kis_layer_properties_icons.h"
+#include "KisBelowStackCache.h"
 
 
 struct Q_DECL_HIDDEN KisGroupLayer::Private
@@ -42,6 +43,7 @@ public:
     qint32 x;
     qint32 y;
     bool passThroughMode;
+    KisBelowStackCache belowStackCache;
 };
 
 KisGroupLayer::KisGroupLayer(KisImageWSP image, const QString &name, quint8 opacity) :
@@ -183,6 +185,8 @@ void KisGroupLayer::fillMergedLayerTemplate(KisLayerSP dstLayer, KisLayerSP prev
 
 void KisGroupLayer::resetCache(const KoColorSpace *colorSpace)
 {
+    m_d->belowStackCache.invalidateAll();
+
     if (!colorSpace)
         colorSpace = image()->colorSpace();
 
@@ -286,6 +290,11 @@ bool KisGroupLayer::projectionIsValid() const
     return !tryObligeChild();
 }
 
+KisBelowStackCache* KisGroupLayer::belowStackCache() const
+{
+    return &m_d->belowStackCache;
+}
+
 void KisGroupLayer::setDefaultProjectionColor(KoColor color)
 {
     m_d->paintDevice->setDefaultPixel(color);
@@ -307,6 +316,7 @@ void KisGroupLayer::setPassThroughMode(bool value)
     if (m_d->passThroughMode == value) return;
 
     m_d->passThroughMode = value;
+    m_d->belowStackCache.invalidateAll();
 
     baseNodeChangedCallback();
     baseNodeInvalidateAllFramesCallback();
@@ -354,6 +364,7 @@ qint32 KisGroupLayer::y() const
 
 void KisGroupLayer::setX(qint32 x)
 {
+    m_d->belowStackCache.invalidateAll();
     m_d->x = x;
     if(m_d->paintDevice) {
         m_d->paintDevice->setX(x);
@@ -362,6 +373,7 @@ void KisGroupLayer::setX(qint32 x)
 
 void KisGroupLayer::setY(qint32 y)
 {
+    m_d->belowStackCache.invalidateAll();
     m_d->y = y;
     if(m_d->paintDevice) {
         m_d->paintDevice->setY(y);
@@ -11,6 +11,7 @@
 #include "kis_types.h"
 
 class KoColorSpace;
+class KisBelowStackCache;
 
 /**
  * A KisLayer that bundles child layers into a single layer.
@@ -95,6 +96,14 @@ public:
 
     bool projectionIsValid() const;
 
+    /**
+     * The cache of the composite of the children below the one
+     * that is currently being changed.
+     *
+     * \see KisBelowStackCache
+     */
+    KisBelowStackCache* belowStackCache() const;
+
 protected:
     KisLayer* onlyMeaningfulChild() const;
     KisPaintDeviceSP tryObligeChild() const;
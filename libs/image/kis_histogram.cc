@@ -7,7 +7,13 @@
 
 #include "kis_histogram.h"
 
+#include <atomic>
+#include <functional>
+
+#include <QSharedPointer>
+#include <QThread>
 #include <QVector>
+#include <QtConcurrent>
 
 #include "kis_image.h"
 #include "kis_paint_layer.h"
@@ -15,6 +21,35 @@
 #include "KoColorSpace.h"
 #include "kis_debug.h"
 #include "kis_iterator_ng.h"
+#include "krita_utils.h"
+#include "KisWorkStealingExecutor.h"
+
+namespace {
+
+void addRectToBin(KisPaintDeviceSP dev, const QRect &rect,
+                  KoHistogramProducer *producer, const KoColorSpace *cs)
+{
+    KisSequentialConstIterator srcIt(dev, rect);
+
+    // XXX: the original code depended on their being a selection mask in the iterator
+    //      if the paint device had a selection. When we changed that to passing an
+    //      explicit selection to the createRectIterator call, that broke because
+    //      paint devices didn't know about their selections anymore.
+    //      updateHistogram should get a selection parameter.
+    int numConseqPixels = srcIt.nConseqPixels();
+    while (srcIt.nextPixels(numConseqPixels)) {
+
+        numConseqPixels = srcIt.nConseqPixels();
+        producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
+    }
+}
+
+void runJob(std::function<void()> &job)
+{
+    job();
+}
+
+}
 
 KisHistogram::KisHistogram(const KisPaintLayerSP layer,
                            KoHistogramProducer *producer,
@@ -73,23 +108,56 @@ void KisHistogram::updateHistogram()
         return;
     }
 
-    KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
     const KoColorSpace* cs = m_paintDevice->colorSpace();
 
     // Let the producer do it's work
     m_producer->clear();
 
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(m_bounds, KritaUtils::optimalPatchSize());
+    const int numThreads = qMin(patches.size(), QThread::idealThreadCount());
+
+    /**
+     * Every thread counts its share of the patches with its own copy of
+     * the producer, and the copies are summed up at the end, so the
+     * threads never touch the same bins
+     */
+    QVector<QSharedPointer<KoHistogramProducer>> threadProducers;
+
+    for (int i = 0; numThreads > 1 && i < numThreads; i++) {
+        KoHistogramProducer *producer = m_producer->createEmptyCopy();
+        if (!producer) {
+            threadProducers.clear();
+            break;
+        }
+        threadProducers.append(QSharedPointer<KoHistogramProducer>(producer));
+    }
 
-    // XXX: the original code depended on their being a selection mask in the iterator
-    //      if the paint device had a selection. When we changed that to passing an
-    //      explicit selection to the createRectIterator call, that broke because
-    //      paint devices didn't know about their selections anymore.
-    //      updateHistogram should get a selection parameter.
-    int numConseqPixels = srcIt.nConseqPixels();
-    while (srcIt.nextPixels(numConseqPixels)) {
+    if (threadProducers.isEmpty()) {
+        addRectToBin(m_paintDevice, m_bounds, m_producer, cs);
+    } else {
+        std::atomic<int> nextPatch {0};
+        QVector<std::function<void()>> jobs;
+
+        Q_FOREACH (QSharedPointer<KoHistogramProducer> producer, threadProducers) {
+            jobs.append([this, producer, cs, &patches, &nextPatch] () {
+                int index;
+                while ((index = nextPatch.fetch_add(1)) < patches.size()) {
+                    addRectToBin(m_paintDevice, patches[index], producer.data(), cs);
+                }
+            });
+        }
 
-        numConseqPixels = srcIt.nConseqPixels();
-        m_producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
+        KisWorkStealingExecutor *executor = KisWorkStealingExecutor::currentExecutor();
+        if (executor) {
+            executor->runParallelJobs(jobs);
+        } else {
+            QtConcurrent::blockingMap(jobs, runJob);
+        }
+
+        Q_FOREACH (QSharedPointer<KoHistogramProducer> producer, threadProducers) {
+            m_producer->addBinsFrom(producer.data());
+        }
     }
 
     computeHistogram();
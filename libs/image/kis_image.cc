@@ -95,11 +95,14 @@
 #include "kis_time_span.h"
 
 #include "KisRunnableBasedStrokeStrategy.h"
+#include "tiles3/kis_tile_data_deduplicator.h"
+#include "tiles3/kis_tile_data_store.h"
 #include "KisRunnableStrokeJobData.h"
 #include "KisRunnableStrokeJobUtils.h"
 #include "KisRunnableStrokeJobsInterface.h"
 
 #include "KisBusyWaitBroker.h"
+#include "KisBatchNodeUpdate.h"
 
 
 // #define SANITY_CHECKS
@@ -253,6 +256,15 @@ public:
     QPointF axesCenter;
     bool allowMasksOnRootNode = false;
 
+    QMutex viewportPriorityRectsLock;
+    QHash<const void*, QRect> viewportPriorityRects;
+
+    /**
+     * The value of KisTileDataStore::tileDataContentChanges() at the
+     * start of the last successful deduplication pass
+     */
+    QAtomicInt lastDeduplicationContentChanges {-1};
+
     bool tryCancelCurrentStrokeAsync();
 
     void notifyProjectionUpdatedInPatches(const QRect &rc, QVector<KisRunnableStrokeJobData *> &jobs);
@@ -911,6 +923,83 @@ void KisImage::purgeUnusedData(bool isCancellable)
     endStroke(id);
 }
 
+void KisImage::deduplicateTileData()
+{
+    /**
+     * The routine is called on every idle tick, so skip it if no tile
+     * data has been changed since the previous pass. The counter is
+     * global, so the changes in other images restart the pass as
+     * well, but it is cheap then: only the changed tiles are hashed.
+     */
+    const int contentChanges = KisTileDataStore::instance()->tileDataContentChanges();
+    if (contentChanges == m_d->lastDeduplicationContentChanges.loadAcquire()) return;
+
+    struct DeduplicateTileDataStroke : public KisRunnableBasedStrokeStrategy {
+        DeduplicateTileDataStroke(KisImageSP image, int contentChanges)
+            : KisRunnableBasedStrokeStrategy(QLatin1String("deduplicate-tile-data"),
+                                             kundo2_noi18n("deduplicate-tile-data")),
+              m_image(image),
+              m_contentChanges(contentChanges)
+        {
+            this->enableJob(JOB_INIT, true, KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
+            this->enableJob(JOB_DOSTROKE, true);
+            this->enableJob(JOB_FINISH, true);
+            setClearsRedoOnStart(false);
+            setRequestsOtherStrokesToEnd(false);
+            setCanForgetAboutMe(true);
+        }
+
+        void initStrokeCallback() override {
+            KisPaintDeviceList deviceList;
+            QVector<KisStrokeJobData*> jobsData;
+
+            KisLayerUtils::recursiveApplyNodes(m_image->root(),
+                [&deviceList](KisNodeSP node) {
+                    KisPaintDeviceSP device = node->paintDevice();
+                    if (device && !deviceList.contains(device)) {
+                        deviceList << device;
+                    }
+                });
+
+            /**
+             * The deduplicator is not thread-safe, so the devices are
+             * processed sequentially. Each device gets its own job to
+             * let the user cancel the stroke in the middle. The jobs
+             * are exclusive, because nobody may write into the devices
+             * while their tiles are being merged.
+             *
+             * The projections are not touched, they are regenerated
+             * too often to be worth it.
+             */
+            Q_FOREACH (KisPaintDeviceSP device, deviceList) {
+                jobsData << new KisRunnableStrokeJobData(
+                    [this, device] () {
+                        device->deduplicateTiles(m_deduplicator);
+                    },
+                    KisStrokeJobData::SEQUENTIAL,
+                    KisStrokeJobData::EXCLUSIVE);
+            }
+
+            addMutatedJobs(jobsData);
+        }
+
+        void finishStrokeCallback() override {
+            m_deduplicator.publishStatistics();
+
+            // a cancelled pass is not recorded, so it will be restarted
+            m_image->m_d->lastDeduplicationContentChanges.storeRelease(m_contentChanges);
+        }
+
+    private:
+        KisImageSP m_image;
+        int m_contentChanges;
+        KisTileDataDeduplicator m_deduplicator;
+    };
+
+    KisStrokeId id = startStroke(new DeduplicateTileDataStroke(this, contentChanges));
+    endStroke(id);
+}
+
 void KisImage::cropNode(KisNodeSP node, const QRect& newRect, const bool activeFrameOnly)
 {
     const bool isLayer = qobject_cast<KisLayer*>(node.data());
@@ -1813,6 +1902,25 @@ void KisImage::waitForDone()
     KisBusyWaitBroker::instance()->notifyWaitOnImageEnded(this);
 }
 
+KisStrokesQueueStatistics KisImage::strokesQueueStatistics() const
+{
+    return m_d->scheduler.strokesQueueStatistics();
+}
+
+bool KisImage::waitForPendingStrokes(int maxPendingStrokes, int timeout)
+{
+    KisBusyWaitBroker::instance()->notifyWaitOnImageStarted(this);
+    const bool result = m_d->scheduler.waitForPendingStrokes(maxPendingStrokes, timeout);
+    KisBusyWaitBroker::instance()->notifyWaitOnImageEnded(this);
+
+    return result;
+}
+
+void KisImage::addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback)
+{
+    m_d->scheduler.addStrokeCompletionCallback(id, callback);
+}
+
 KisStrokeId KisImage::startStroke(KisStrokeStrategy *strokeStrategy)
 {
     /**
@@ -2139,6 +2247,36 @@ void KisImage::refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rects, co
     }
 }
 
+void KisImage::refreshGraphAsync(const KisBatchNodeUpdate &updates, UpdateFlags flags)
+{
+    /**
+     * The projection updates filters work on per-node basis, so
+     * we let them process every node separately
+     */
+    if (updates.size() <= 1 ||
+        (flags & NoFilthyUpdate) ||
+        !m_d->projectionUpdatesFilters.isEmpty()) {
+
+        for (auto it = updates.begin(); it != updates.end(); ++it) {
+            refreshGraphAsync(it->first, it->second, flags);
+        }
+        return;
+    }
+
+    /**
+     * A null node means the root layer, the same way as in the
+     * per-node version of refreshGraphAsync()
+     */
+    KisBatchNodeUpdate rootedUpdates(updates);
+
+    for (auto it = rootedUpdates.begin(); it != rootedUpdates.end(); ++it) {
+        if (!it->first) it->first = m_d->rootLayer;
+        m_d->animationInterface->notifyNodeChanged(it->first.data(), it->second, true);
+    }
+
+    m_d->scheduler.fullRefreshAsync(rootedUpdates, bounds());
+}
+
 
 void KisImage::requestProjectionUpdateNoFilthy(KisNodeSP pseudoFilthy, const QRect &rc, const QRect &cropRect)
 {
@@ -2509,6 +2647,19 @@ KisLodPreferences KisImage::lodPreferences() const
     return m_d->scheduler.lodPreferences();
 }
 
+void KisImage::setViewportPriorityRect(const void *view, const QRect &rect)
+{
+    QMutexLocker l(&m_d->viewportPriorityRectsLock);
+
+    if (rect.isEmpty()) {
+        m_d->viewportPriorityRects.remove(view);
+    } else {
+        m_d->viewportPriorityRects.insert(view, rect);
+    }
+
+    m_d->scheduler.setUpdatePriorityRects(m_d->viewportPriorityRects.values().toVector());
+}
+
 void KisImage::nodeCollapsedChanged(KisNode * node)
 {
     Q_UNUSED(node);
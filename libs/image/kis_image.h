@@ -13,6 +13,8 @@
 #include <QRect>
 #include <QBitArray>
 
+#include <functional>
+
 #include <KoColorConversionTransformation.h>
 
 #include "kis_types.h"
@@ -21,6 +23,7 @@
 #include "kis_node_facade.h"
 #include "kis_image_interfaces.h"
 #include "kis_strokes_queue_undo_result.h"
+#include "KisStrokesQueueStatistics.h"
 #include "KisLodPreferences.h"
 
 #include <kritaimage_export.h>
@@ -258,6 +261,17 @@ public:
      */
     void purgeUnusedData(bool isCancellable);
 
+    /**
+     * @brief let the tiles with equal content in all the layers and
+     * animation frames of the image share memory. Unlike
+     * purgeUnusedData(), it doesn't change the data of the layers and
+     * does not affect undo. The operation is run in background and is
+     * cancelled as soon as the user starts any action.
+     *
+     * \see KisTileDataDeduplicator
+     */
+    void deduplicateTileData();
+
     /**
      * @brief start asynchronous operation on cropping a subtree of nodes starting at \p node
      *
@@ -760,6 +774,14 @@ public:
      */
     KisLodPreferences lodPreferences() const;
 
+    /**
+     * Sets the rect of the image that is visible in the view identified
+     * by \p view. The updates intersecting the visible rects of all the
+     * views are processed before the other ones. Pass an empty rect to
+     * remove the view.
+     */
+    void setViewportPriorityRect(const void *view, const QRect &rect);
+
     KisImageAnimationInterface *animationInterface() const;
 
     /**
@@ -991,6 +1013,29 @@ public Q_SLOTS:
      */
     void waitForDone();
 
+    /**
+     * Returns the current depth of the strokes queue of the image
+     */
+    KisStrokesQueueStatistics strokesQueueStatistics() const;
+
+    /**
+     * Waits until there are no more than \p maxPendingStrokes strokes
+     * left in the strokes queue or \p timeout milliseconds have passed.
+     * Unlike waitForDone(), it lets the batch clients keep a few strokes
+     * in flight while still bounding the queue size. The opened strokes
+     * are not asked to end.
+     *
+     * @return true if the queue has shrunk to \p maxPendingStrokes
+     */
+    bool waitForPendingStrokes(int maxPendingStrokes, int timeout = -1);
+
+    /**
+     * Calls \p callback when stroke \p id is finished or cancelled. The
+     * callback is called from a worker thread, so it should only post
+     * an event or queue a signal to the caller.
+     */
+    void addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback);
+
     KisStrokeId startStroke(KisStrokeStrategy *strokeStrategy) override;
     void addJob(KisStrokeId id, KisStrokeJobData *data) override;
     void endStroke(KisStrokeId id) override;
@@ -1123,6 +1168,7 @@ public Q_SLOTS:
     void refreshGraphAsync(KisNodeSP root, const QRect &rc, UpdateFlags flags = None) override;
     void refreshGraphAsync(KisNodeSP root, const QRect &rc, const QRect &cropRect, UpdateFlags flags = None) override;
     void refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rects, const QRect &cropRect, UpdateFlags flags = None) override;
+    void refreshGraphAsync(const KisBatchNodeUpdate &updates, UpdateFlags flags = None) override;
 
     /**
      * Triggers synchronous recomposition of the projection
@@ -13,6 +13,7 @@
 #include <KoColorSpaceRegistry.h>
 #include <KoColorConversionTransformation.h>
 #include <kis_properties_configuration.h>
+#include "tiles3/swap/kis_tile_compressor_2.h"
 
 #include "kis_debug.h"
 
@@ -79,6 +80,17 @@ void KisImageConfig::setEnablePerfLog(bool value)
     m_config.writeEntry("enablePerfLog", value);
 }
 
+QString KisImageConfig::perfTraceFile(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("perfTraceFile", QString()) : QString();
+}
+
+void KisImageConfig::setPerfTraceFile(const QString &value)
+{
+    m_config.writeEntry("perfTraceFile", value);
+}
+
 qreal KisImageConfig::transformMaskOffBoundsReadArea() const
 {
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
@@ -108,6 +120,47 @@ void KisImageConfig::setUpdatePatchWidth(int value)
     m_config.writeEntry("updatePatchWidth", value);
 }
 
+bool KisImageConfig::adaptiveUpdatePatches(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("adaptiveUpdatePatches", true) : true;
+}
+
+void KisImageConfig::setAdaptiveUpdatePatches(bool value)
+{
+    m_config.writeEntry("adaptiveUpdatePatches", value);
+}
+
+qreal KisImageConfig::updatePatchReferenceCost(bool requestDefault) const
+{
+    /**
+     * The cost per pixel (in composited layers) the default patch
+     * size is good for. The patches of more expensive updates are
+     * shrunk, see KisUpdateCostModel.
+     */
+    const qreal defaultValue = 16.0;
+    const qreal value = !requestDefault ?
+        m_config.readEntry("updatePatchReferenceCost", defaultValue) : defaultValue;
+
+    return value > 0.0 ? value : defaultValue;
+}
+
+void KisImageConfig::setUpdatePatchReferenceCost(qreal value)
+{
+    m_config.writeEntry("updatePatchReferenceCost", value);
+}
+
+bool KisImageConfig::groupBelowStackCache(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("groupBelowStackCache", true) : true;
+}
+
+void KisImageConfig::setGroupBelowStackCache(bool value)
+{
+    m_config.writeEntry("groupBelowStackCache", value);
+}
+
 qreal KisImageConfig::maxCollectAlpha() const
 {
     return m_config.readEntry("maxCollectAlpha", 2.5);
@@ -167,6 +220,115 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+bool KisImageConfig::swapMapWholeFile(bool requestDefault) const
+{
+    // mapping the whole swap file makes sense on 64-bit systems only
+    const bool defaultValue = QT_POINTER_SIZE >= 8;
+
+    return !requestDefault ?
+        m_config.readEntry("swapMapWholeFile", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setSwapMapWholeFile(bool value)
+{
+    m_config.writeEntry("swapMapWholeFile", value);
+}
+
+bool KisImageConfig::swapPrefetchEnabled(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapPrefetchEnabled", true) : true;
+}
+
+void KisImageConfig::setSwapPrefetchEnabled(bool value)
+{
+    m_config.writeEntry("swapPrefetchEnabled", value);
+}
+
+int KisImageConfig::swapCompressionThreads(bool requestDefault) const
+{
+    // swapping shouldn't steal all the cores from the painting threads
+    const int defaultValue = qBound(1, QThread::idealThreadCount() / 2, 8);
+
+    return !requestDefault ?
+        qMax(1, m_config.readEntry("swapCompressionThreads", defaultValue)) : defaultValue;
+}
+
+void KisImageConfig::setSwapCompressionThreads(int value)
+{
+    m_config.writeEntry("swapCompressionThreads", value);
+}
+
+bool KisImageConfig::updaterThreadAffinity(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("updaterThreadAffinity", false) : false;
+}
+
+void KisImageConfig::setUpdaterThreadAffinity(bool value)
+{
+    m_config.writeEntry("updaterThreadAffinity", value);
+}
+
+bool KisImageConfig::useDeltaMementos(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useDeltaMementos", false) : false;
+}
+
+void KisImageConfig::setUseDeltaMementos(bool value)
+{
+    m_config.writeEntry("useDeltaMementos", value);
+}
+
+bool KisImageConfig::useAdaptiveSwapPolicy(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("useAdaptiveSwapPolicy", true) : true;
+}
+
+void KisImageConfig::setUseAdaptiveSwapPolicy(bool value)
+{
+    m_config.writeEntry("useAdaptiveSwapPolicy", value);
+}
+
+bool KisImageConfig::tileDeduplicationEnabled(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tileDeduplicationEnabled", true) : true;
+}
+
+void KisImageConfig::setTileDeduplicationEnabled(bool value)
+{
+    m_config.writeEntry("tileDeduplicationEnabled", value);
+}
+
+int KisImageConfig::swapCompressionMode(bool requestDefault) const
+{
+    const int defaultValue = KisTileCompressor2::FastCompression;
+
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionMode", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setSwapCompressionMode(int value)
+{
+    m_config.writeEntry("swapCompressionMode", value);
+}
+
+int KisImageConfig::documentTileCompressionMode(bool requestDefault) const
+{
+    const int defaultValue = KisTileCompressor2::LzfCompression;
+
+    return !requestDefault ?
+        m_config.readEntry("documentTileCompressionMode", defaultValue) : defaultValue;
+}
+
+void KisImageConfig::setDocumentTileCompressionMode(int value)
+{
+    m_config.writeEntry("documentTileCompressionMode", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
@@ -24,6 +24,13 @@ public:
     bool enablePerfLog(bool requestDefault = false) const;
     void setEnablePerfLog(bool value);
 
+    /**
+     * The file KisPerfTracer writes the trace into. An empty
+     * string disables the tracing.
+     */
+    QString perfTraceFile(bool requestDefault = false) const;
+    void setPerfTraceFile(const QString &value);
+
     qreal transformMaskOffBoundsReadArea() const;
 
     int updatePatchHeight() const;
@@ -31,6 +38,15 @@ public:
     int updatePatchWidth() const;
     void setUpdatePatchWidth(int value);
 
+    bool adaptiveUpdatePatches(bool requestDefault = false) const;
+    void setAdaptiveUpdatePatches(bool value);
+
+    qreal updatePatchReferenceCost(bool requestDefault = false) const;
+    void setUpdatePatchReferenceCost(qreal value);
+
+    bool groupBelowStackCache(bool requestDefault = false) const;
+    void setGroupBelowStackCache(bool value);
+
     qreal maxCollectAlpha() const;
     qreal maxMergeAlpha() const;
     qreal maxMergeCollectAlpha() const;
@@ -46,6 +62,65 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    bool swapMapWholeFile(bool requestDefault = false) const;
+    void setSwapMapWholeFile(bool value);
+
+    bool swapPrefetchEnabled(bool requestDefault = false) const;
+    void setSwapPrefetchEnabled(bool value);
+
+    /**
+     * The number of threads compressing the tiles in parallel when
+     * they are swapped out. See KisSwappedDataStore.
+     */
+    int swapCompressionThreads(bool requestDefault = false) const;
+    void setSwapCompressionThreads(int value);
+
+    /**
+     * Bind the update threads to fixed CPUs and distribute the
+     * updates between them by image stripes. Helps on multi-socket
+     * (NUMA) machines. See KisUpdaterContext.
+     */
+    bool updaterThreadAffinity(bool requestDefault = false) const;
+    void setUpdaterThreadAffinity(bool value);
+
+    /**
+     * Store the overwritten undo revisions of the tiles as compressed
+     * deltas against the newer ones. See KisMementoManager.
+     */
+    bool useDeltaMementos(bool requestDefault = false) const;
+    void setUseDeltaMementos(bool value);
+
+    /**
+     * Make the swapper take the access frequency of the tiles into
+     * account when choosing what to swap out, instead of a pure
+     * clock sweep. See KisTileDataSwapper.
+     */
+    bool useAdaptiveSwapPolicy(bool requestDefault = false) const;
+    void setUseAdaptiveSwapPolicy(bool value);
+
+    /**
+     * Let the tiles with equal content (in duplicated layers or in
+     * repeated animation frames) share memory. The tiles are merged
+     * when the image becomes idle. See KisTileDataDeduplicator.
+     */
+    bool tileDeduplicationEnabled(bool requestDefault = false) const;
+    void setTileDeduplicationEnabled(bool value);
+
+    /**
+     * Codec used for compressing tiles on swapping and on saving
+     * layers into .kra. The value is one of
+     * KisTileCompressor2::CompressionMode.
+     *
+     * NOTE: .kra files saved with a non-LZF codec cannot be opened
+     *       by Krita versions that don't know about it, so the
+     *       default for documents is LZF.
+     */
+    int swapCompressionMode(bool requestDefault = false) const;
+    void setSwapCompressionMode(int value);
+
+    int documentTileCompressionMode(bool requestDefault = false) const;
+    void setDocumentTileCompressionMode(int value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
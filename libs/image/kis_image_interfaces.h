@@ -14,6 +14,7 @@ class QRect;
 class KisStrokeStrategy;
 class KisStrokeJobData;
 class KisPostExecutionUndoAdapter;
+class KisBatchNodeUpdate;
 
 
 class KRITAIMAGE_EXPORT KisStrokesFacade
@@ -59,6 +60,13 @@ public:
     virtual void refreshGraphAsync(KisNodeSP root, const QRect &rc, const QRect &cropRect, UpdateFlags flags = None) = 0;
     virtual void refreshGraphAsync(KisNodeSP root, const QVector<QRect> &rc, const QRect &cropRect, UpdateFlags flags = None) = 0;
 
+    /**
+     * Refreshes the subtrees of all the nodes of \p updates. The updates
+     * are merged into a single walk of the graph, so every common ancestor
+     * is recomposited only once for the whole batch.
+     */
+    virtual void refreshGraphAsync(const KisBatchNodeUpdate &updates, UpdateFlags flags = None) = 0;
+
     virtual KisProjectionUpdatesFilterCookie addProjectionUpdatesFilter(KisProjectionUpdatesFilterSP filter) = 0;
     virtual KisProjectionUpdatesFilterSP removeProjectionUpdatesFilter(KisProjectionUpdatesFilterCookie cookie) = 0;
     virtual KisProjectionUpdatesFilterCookie currentProjectionUpdatesFilter() const = 0;
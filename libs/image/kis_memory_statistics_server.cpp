@@ -142,8 +142,13 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.realMemorySize = tileStats.realMemorySize;
     stats.historicalMemorySize = tileStats.historicalMemorySize;
     stats.poolSize = tileStats.poolSize;
+    stats.historicalDeltaSize = tileStats.historicalDeltaSize;
+    stats.historicalDeltaSavedSize = tileStats.historicalDeltaSavedSize;
+    stats.deduplicatedSize = tileStats.deduplicatedSize;
+    stats.deduplicatedUniqueSize = tileStats.deduplicatedUniqueSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.swapOutThroughput = tileStats.swapOutThroughput;
 
     KisImageConfig cfg(true);
 
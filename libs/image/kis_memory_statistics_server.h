@@ -31,8 +31,13 @@ public:
               realMemorySize(0),
               historicalMemorySize(0),
               poolSize(0),
+              historicalDeltaSize(0),
+              historicalDeltaSavedSize(0),
+              deduplicatedSize(0),
+              deduplicatedUniqueSize(0),
 
               swapSize(0),
+              swapOutThroughput(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -50,8 +55,13 @@ public:
         qint64 realMemorySize;
         qint64 historicalMemorySize;
         qint64 poolSize;
+        qint64 historicalDeltaSize;
+        qint64 historicalDeltaSavedSize;
+        qint64 deduplicatedSize;
+        qint64 deduplicatedUniqueSize;
 
         qint64 swapSize;
+        qint64 swapOutThroughput;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
@@ -1517,6 +1517,23 @@ void KisPaintDevice::purgeDefaultPixels()
     dm->purge(dm->extent());
 }
 
+void KisPaintDevice::deduplicateTiles(KisTileDataDeduplicator &deduplicator)
+{
+    QList<KisDataManagerSP> dataManagers;
+    dataManagers << m_d->dataManager();
+
+    Q_FOREACH (int frameId, m_d->frameIds()) {
+        KisDataManagerSP dm = m_d->frameDataManager(frameId);
+        if (!dataManagers.contains(dm)) {
+            dataManagers << dm;
+        }
+    }
+
+    Q_FOREACH (KisDataManagerSP dm, dataManagers) {
+        dm->deduplicateTiles(deduplicator);
+    }
+}
+
 void KisPaintDevice::setDefaultPixel(const KoColor &defPixel)
 {
     KoColor color(defPixel);
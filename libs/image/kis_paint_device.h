@@ -37,6 +37,7 @@ class KoColorProfile;
 class KisRegion;
 class KisDataManager;
 class KisPaintDeviceWriter;
+class KisTileDataDeduplicator;
 class KisKeyframe;
 class KisRasterKeyframeChannel;
 
@@ -283,6 +284,17 @@ public:
      */
     void purgeDefaultPixels();
 
+    /**
+     * Makes the tiles with equal content share the same memory. All
+     * the frames of the device are processed, and \p deduplicator
+     * may be shared with other devices to find equal tiles among
+     * them as well. Neither the content nor the undo history of the
+     * device is changed.
+     *
+     * \see KisTileDataDeduplicator
+     */
+    void deduplicateTiles(KisTileDataDeduplicator &deduplicator);
+
     /**
      * Sets the default pixel. New data will be initialised with this pixel. The pixel is copied: the
      * caller still owns the pointer and needs to delete it to avoid memory leaks.
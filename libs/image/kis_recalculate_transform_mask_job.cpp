@@ -37,9 +37,6 @@ void KisRecalculateTransformMaskJob::run()
     if (!m_mask->parent()) return;
     if (!m_mask->visible()) return;
 
-    const QRect oldMaskExtent = m_mask->extent();
-    m_mask->recaclulateStaticImage();
-
     KisLayerSP layer = qobject_cast<KisLayer*>(m_mask->parent().data());
 
     if (!layer) {
@@ -50,6 +47,26 @@ void KisRecalculateTransformMaskJob::run()
     KisImageSP image = layer->image();
     Q_ASSERT(image);
 
+    /**
+     * If only a few areas of the source have changed since the last
+     * recalculation, we regenerate only the tiles depending on them
+     * and propagate just these tiles through the stack
+     */
+    QVector<QRect> updatedRects;
+    if (m_mask->recalculateStaticImageIncrementally(&updatedRects)) {
+        if (!updatedRects.isEmpty()) {
+            for (auto it = updatedRects.begin(); it != updatedRects.end(); ++it) {
+                *it = layer->projectionPlane()->changeRect(*it, KisLayer::N_ABOVE_FILTHY);
+            }
+
+            image->requestProjectionUpdateNoFilthy(layer, updatedRects, image->bounds(), false);
+        }
+        return;
+    }
+
+    const QRect oldMaskExtent = m_mask->extent();
+    m_mask->recaclulateStaticImage();
+
     /**
      * Depending on whether the mask is hidden we should either
      * update it entirely via the setDirty() call, or we can use a
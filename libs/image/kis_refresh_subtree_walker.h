@@ -133,12 +133,16 @@ protected:
 
         KisProjectionLeafSP currentLeaf = startWith->lastChild();
         while(currentLeaf) {
-            NodePosition pos = (m_flags & NoFilthyMode ? N_ABOVE_FILTHY : N_FILTHY) |
+            const bool isFilthy = !(m_flags & NoFilthyMode) && isFilthySubtree(currentLeaf);
+
+            NodePosition pos = (isFilthy ? N_FILTHY : N_ABOVE_FILTHY) |
                 calculateNodePosition(currentLeaf);
             registerNeedRect(currentLeaf, pos);
 
             // see a comment above
-            registerCloneNotification(currentLeaf->node(), pos);
+            if (isFilthy || m_flags & NoFilthyMode) {
+                registerCloneNotification(currentLeaf->node(), pos);
+            }
             currentLeaf = currentLeaf->prevSibling();
         }
 
@@ -150,13 +154,23 @@ protected:
 
         currentLeaf = startWith->lastChild();
         while(currentLeaf) {
-            if(currentLeaf->canHaveChildLayers()) {
+            if(currentLeaf->canHaveChildLayers() && isFilthySubtree(currentLeaf)) {
                 startTrip(currentLeaf);
             }
             currentLeaf = currentLeaf->prevSibling();
         }
     }
 
+    /**
+     * Returns true if the subtree of \p leaf has changed and should be
+     * regenerated. Otherwise, the current projection of \p leaf is
+     * reused. The default implementation refreshes the whole subtree.
+     */
+    virtual bool isFilthySubtree(KisProjectionLeafSP leaf) const {
+        Q_UNUSED(leaf);
+        return true;
+    }
+
 private:
     Flags m_flags = None;
 };
@@ -11,7 +11,17 @@
 
 #include "kis_image_config.h"
 #include "kis_full_refresh_walker.h"
+#include "kis_batch_refresh_walker.h"
 #include "kis_spontaneous_job.h"
+#include "krita_utils.h"
+#include "KisUpdateCostModel.h"
+#include "kis_update_job_item.h"
+#include "kis_lod_transform.h"
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+#include "kis_projection_leaf.h"
+#include "tiles3/kis_tile_data_interface.h"
+#include "tiles3/kis_tile_data_store.h"
 
 
 //#define ENABLE_DEBUG_JOIN
@@ -65,6 +75,9 @@ void KisSimpleUpdateQueue::updateSettings()
     m_patchWidth = config.updatePatchWidth();
     m_patchHeight = config.updatePatchHeight();
 
+    m_adaptivePatches = config.adaptiveUpdatePatches();
+    m_patchReferenceCost = config.updatePatchReferenceCost();
+
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
@@ -89,30 +102,40 @@ bool KisSimpleUpdateQueue::processOneJob(KisUpdaterContext &updaterContext)
 {
     QMutexLocker locker(&m_lock);
 
-    KisBaseRectsWalkerSP item;
-    KisMutableWalkersListIterator iter(m_updatesList);
     bool jobAdded = false;
 
     int currentLevelOfDetail = updaterContext.currentLevelOfDetail();
 
-    while(iter.hasNext()) {
-        item = iter.next();
+    /**
+     * The priorities are cached in the walkers, so we only scan the
+     * list once per priority class
+     */
+    for (int priority = 0; priority < NumUpdatePriorities && !jobAdded; priority++) {
+        KisMutableWalkersListIterator iter(m_updatesList);
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            !item->checksumValid()) {
+        while (iter.hasNext()) {
+            KisBaseRectsWalkerSP item = iter.next();
 
-            m_overrideLevelOfDetail = item->levelOfDetail();
-            item->recalculate(item->requestedRect());
-            m_overrideLevelOfDetail = -1;
-        }
+            if (item->queuePriority() != priority) continue;
 
-        if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
-            updaterContext.isJobAllowed(item)) {
+            if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
+                !item->checksumValid()) {
 
-            updaterContext.addMergeJob(item);
-            iter.remove();
-            jobAdded = true;
-            break;
+                m_overrideLevelOfDetail = item->levelOfDetail();
+                item->recalculate(item->requestedRect());
+                m_overrideLevelOfDetail = -1;
+
+                item->setQueuePriority(updatePriority(item));
+            }
+
+            if ((currentLevelOfDetail < 0 || currentLevelOfDetail == item->levelOfDetail()) &&
+                updaterContext.isJobAllowed(item)) {
+
+                updaterContext.addMergeJob(item);
+                iter.remove();
+                jobAdded = true;
+                break;
+            }
         }
     }
 
@@ -181,6 +204,136 @@ void KisSimpleUpdateQueue::addFullRefreshNoFilthyJob(KisNodeSP node, const QVect
     addJob(node, rects, cropRect, levelOfDetail, KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY);
 }
 
+namespace {
+
+KisBaseRectsWalkerSP createWalker(const QRect &cropRect, KisBaseRectsWalker::UpdateType type)
+{
+    KisBaseRectsWalkerSP walker;
+
+    if (type == KisBaseRectsWalker::UPDATE) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
+        walker = new KisFullRefreshWalker(cropRect);
+    }
+    else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
+        walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
+    }
+    else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
+        walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
+    }
+    /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
+
+    return walker;
+}
+
+/**
+ * Asks the swap to load the data the walkers are going to read. The
+ * walkers are prefetched when they are queued, so that the swap-in
+ * overlaps with the jobs that are already running instead of
+ * blocking the worker thread that starts the merge.
+ */
+void prefetchWalkersData(const QList<KisBaseRectsWalkerSP> &walkers)
+{
+    if (!KisTileDataStore::instance()->hasSwappedTiles()) return;
+
+    auto prefetchDevice = [] (KisPaintDeviceSP device, const QRect &rect) {
+        if (!device) return;
+        device->dataManager()->prefetchRect(rect.translated(-device->x(), -device->y()));
+    };
+
+    Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+        const KisBaseRectsWalker::LeafStack &leafStack = walker->leafStack();
+
+        Q_FOREACH (const KisBaseRectsWalker::JobItem &item, leafStack) {
+            if (item.m_applyRect.isEmpty()) continue;
+
+            prefetchDevice(item.m_leaf->projection(), item.m_applyRect);
+
+            if (item.m_position & KisBaseRectsWalker::N_FILTHY) {
+                prefetchDevice(item.m_leaf->original(), item.m_applyRect);
+            }
+        }
+    }
+}
+
+}
+
+void KisSimpleUpdateQueue::addBatchRefreshJob(const KisBatchNodeUpdate &updates, const QRect &cropRect, int levelOfDetail)
+{
+    KisBatchNodeUpdate nonEmptyUpdates;
+    QRect unitedRect;
+
+    for (auto it = updates.begin(); it != updates.end(); ++it) {
+        if (!it->first || it->second.isEmpty()) continue;
+
+        nonEmptyUpdates.push_back(*it);
+        unitedRect |= it->second;
+    }
+
+    if (nonEmptyUpdates.empty()) return;
+
+    if (nonEmptyUpdates.size() == 1) {
+        addFullRefreshJob(nonEmptyUpdates.front().first, nonEmptyUpdates.front().second, cropRect, levelOfDetail);
+        return;
+    }
+
+    QList<KisBaseRectsWalkerSP> walkers;
+
+    const bool isStrokeUpdate = KisUpdateJobItem::currentThreadRunsStrokeJob();
+
+    /**
+     * Every patch is refreshed with the nodes whose dirty rects intersect
+     * it. The nodes are refreshed with the united rect of the patch, which
+     * costs a bit of extra work when the rects are far from each other,
+     * but the common ancestors are composited only once.
+     */
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(unitedRect, QSize(m_patchWidth, m_patchHeight));
+
+    Q_FOREACH (const QRect &patch, patches) {
+        QVector<KisNodeSP> nodes;
+        QRect patchRect;
+
+        for (auto it = nonEmptyUpdates.begin(); it != nonEmptyUpdates.end(); ++it) {
+            const QRect rc = it->second & patch;
+            if (rc.isEmpty()) continue;
+
+            if (!nodes.contains(it->first)) {
+                nodes.append(it->first);
+            }
+            patchRect |= rc;
+        }
+
+        if (nodes.isEmpty()) continue;
+
+        KisBaseRectsWalkerSP walker;
+
+        if (nodes.size() == 1) {
+            walker = createWalker(cropRect, KisBaseRectsWalker::FULL_REFRESH);
+            walker->collectRects(nodes.first(), patchRect);
+        } else {
+            walker = new KisBatchRefreshWalker(cropRect, nodes);
+            walker->collectRects(KisBatchRefreshWalker::commonAncestor(nodes), patchRect);
+        }
+
+        walker->setStrokeUpdate(isStrokeUpdate);
+        updateCostDensity(walker);
+        walkers.append(walker);
+    }
+
+    if (!walkers.isEmpty()) {
+        prefetchWalkersData(walkers);
+
+        m_lock.lock();
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+            walker->setQueuePriority(updatePriority(walker));
+        }
+        m_updatesList.append(walkers);
+        m_lock.unlock();
+    }
+}
+
 void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
                                   const QRect& cropRect,
                                   int levelOfDetail,
@@ -188,34 +341,34 @@ void KisSimpleUpdateQueue::addJob(KisNodeSP node, const QVector<QRect> &rects,
 {
     QList<KisBaseRectsWalkerSP> walkers;
 
+    const bool isStrokeUpdate = KisUpdateJobItem::currentThreadRunsStrokeJob();
+
     Q_FOREACH (const QRect &rc, rects) {
         if (rc.isEmpty()) continue;
 
         KisBaseRectsWalkerSP walker;
 
-        if(trySplitJob(node, rc, cropRect, levelOfDetail, type)) continue;
+        if(trySplitJob(node, rc, cropRect, levelOfDetail, type, walker)) continue;
         if(tryMergeJob(node, rc, cropRect, levelOfDetail, type)) continue;
 
-        if (type == KisBaseRectsWalker::UPDATE) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::DEFAULT);
+        // the walker might have already been created while estimating the cost
+        if (!walker) {
+            walker = createWalker(cropRect, type);
+            walker->collectRects(node, rc);
+            updateCostDensity(walker);
         }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH)  {
-            walker = new KisFullRefreshWalker(cropRect);
-        }
-        else if (type == KisBaseRectsWalker::UPDATE_NO_FILTHY) {
-            walker = new KisMergeWalker(cropRect, KisMergeWalker::NO_FILTHY);
-        }
-        else if (type == KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY)  {
-            walker = new KisFullRefreshWalker(cropRect, KisFullRefreshWalker::NoFilthyMode);
-        }
-        /* else if(type == KisBaseRectsWalker::UNSUPPORTED) fatalKrita; */
 
-        walker->collectRects(node, rc);
+        walker->setStrokeUpdate(isStrokeUpdate);
         walkers.append(walker);
     }
 
     if (!walkers.isEmpty()) {
+        prefetchWalkersData(walkers);
+
         m_lock.lock();
+        Q_FOREACH (KisBaseRectsWalkerSP walker, walkers) {
+            walker->setQueuePriority(updatePriority(walker));
+        }
         m_updatesList.append(walkers);
         m_lock.unlock();
     }
@@ -257,30 +410,45 @@ qint32 KisSimpleUpdateQueue::sizeMetric() const
 bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
                                        const QRect& cropRect,
                                        int levelOfDetail,
-                                       KisBaseRectsWalker::UpdateType type)
+                                       KisBaseRectsWalker::UpdateType type,
+                                       KisBaseRectsWalkerSP &probeWalker)
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
-        return false;
+    QSize patchSize(m_patchWidth, m_patchHeight);
 
-    // a bit of recursive splitting...
+    if (m_adaptivePatches) {
+        // the patches are never smaller than a tile
+        if (rc.width() <= KisTileData::WIDTH || rc.height() <= KisTileData::HEIGHT)
+            return false;
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+        /**
+         * Estimate the cost density of the update on its first patch.
+         * If the update is not split, the probe walker is reused for
+         * the job itself, so the small updates don't pay anything.
+         */
+        const QRect probeRect = rc & QRect(rc.topLeft(), patchSize);
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+        probeWalker = createWalker(cropRect, type);
+        probeWalker->collectRects(node, probeRect);
+        updateCostDensity(probeWalker);
 
-    QVector<QRect> splitRects;
+        patchSize = KisUpdateCostModel::adaptivePatchSize(probeWalker->costDensity(),
+                                                          patchSize,
+                                                          m_patchReferenceCost);
 
-    for(qint32 i = firstRow; i <= lastRow; i++) {
-        for(qint32 j = firstCol; j <= lastCol; j++) {
-            QRect maxPatchRect(j * m_patchWidth, i * m_patchHeight,
-                               m_patchWidth, m_patchHeight);
-            QRect patchRect = rc & maxPatchRect;
-            splitRects.append(patchRect);
+        if (probeRect != rc) {
+            probeWalker = 0;
         }
     }
 
+    if(rc.width() <= patchSize.width() || rc.height() <= patchSize.height())
+        return false;
+
+    probeWalker = 0;
+
+    // a bit of recursive splitting...
+
+    const QVector<QRect> splitRects = KritaUtils::splitRectIntoPatches(rc, patchSize);
+
     KIS_SAFE_ASSERT_RECOVER_NOOP(!splitRects.isEmpty());
     addJob(node, splitRects, cropRect, levelOfDetail, type);
 
@@ -315,14 +483,19 @@ bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
         if(item->cropRect() != cropRect) continue;
         if(item->levelOfDetail() != levelOfDetail) continue;
 
-        if(joinRects(baseRect, item->requestedRect(), m_maxMergeAlpha)) {
+        if(joinRects(baseRect, item->requestedRect(), m_maxMergeAlpha, patchSizeForWalker(item))) {
             goodCandidate = item;
             break;
         }
     }
 
-    if(goodCandidate)
+    if(goodCandidate) {
+        if (KisUpdateJobItem::currentThreadRunsStrokeJob()) {
+            goodCandidate->setStrokeUpdate(true);
+        }
+
         collectJobs(goodCandidate, baseRect, m_maxMergeCollectAlpha);
+    }
 
     return (bool)goodCandidate;
 }
@@ -346,30 +519,42 @@ void KisSimpleUpdateQueue::collectJobs(KisBaseRectsWalkerSP &baseWalker,
     KisBaseRectsWalkerSP item;
     KisMutableWalkersListIterator iter(m_updatesList);
 
+    const QSize maxSize = patchSizeForWalker(baseWalker);
+
     while(iter.hasNext()) {
         item = iter.next();
 
         if(item == baseWalker) continue;
         if(item->type() != baseWalker->type()) continue;
+        if(item->type() == KisBaseRectsWalker::BATCH_REFRESH) continue;
         if(item->startNode() != baseWalker->startNode()) continue;
         if(item->cropRect() != baseWalker->cropRect()) continue;
         if(item->levelOfDetail() != baseWalker->levelOfDetail()) continue;
 
-        if(joinRects(baseRect, item->requestedRect(), maxAlpha)) {
+        if(joinRects(baseRect, item->requestedRect(), maxAlpha, maxSize)) {
+            if (item->isStrokeUpdate()) {
+                baseWalker->setStrokeUpdate(true);
+            }
+
             iter.remove();
         }
     }
 
     if(baseWalker->requestedRect() != baseRect) {
         baseWalker->collectRects(baseWalker->startNode(), baseRect);
+        updateCostDensity(baseWalker);
     }
+
+    // the change rect or the stroke flag might have changed
+    baseWalker->setQueuePriority(updatePriority(baseWalker));
 }
 
 bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
-                                     const QRect& newRect, qreal maxAlpha)
+                                     const QRect& newRect, qreal maxAlpha,
+                                     const QSize &maxSize)
 {
     QRect unitedRect = baseRect | newRect;
-    if(unitedRect.width() > m_patchWidth || unitedRect.height() > m_patchHeight)
+    if(unitedRect.width() > maxSize.width() || unitedRect.height() > maxSize.height())
         return false;
 
     bool result = false;
@@ -394,6 +579,74 @@ bool KisSimpleUpdateQueue::joinRects(QRect& baseRect,
     return result;
 }
 
+QSize KisSimpleUpdateQueue::patchSizeForWalker(KisBaseRectsWalkerSP walker) const
+{
+    const QSize patchSize(m_patchWidth, m_patchHeight);
+
+    /**
+     * Don't let the jobs merge back into big patches after they
+     * have been split by trySplitJob()
+     */
+    if (!m_adaptivePatches) return patchSize;
+
+    /**
+     * The density is normally calculated before the walker is added
+     * to the queue, this is just a fallback for the walkers added
+     * while the adaptive patches were disabled
+     */
+    if (walker->costDensity() < 0) {
+        updateCostDensity(walker);
+    }
+
+    return KisUpdateCostModel::adaptivePatchSize(walker->costDensity(),
+                                                 patchSize,
+                                                 m_patchReferenceCost);
+}
+
+void KisSimpleUpdateQueue::updateCostDensity(KisBaseRectsWalkerSP walker) const
+{
+    if (!m_adaptivePatches) return;
+
+    const QRect rc = walker->requestedRect();
+    const qint64 area = qint64(rc.width()) * rc.height();
+
+    walker->setCostDensity(area > 0 ? KisUpdateCostModel::estimateCost(walker) / area : 0.0);
+}
+
+void KisSimpleUpdateQueue::setPriorityRects(const QVector<QRect> &rects)
+{
+    QMutexLocker locker(&m_lock);
+    m_priorityRects = rects;
+
+    Q_FOREACH (KisBaseRectsWalkerSP walker, m_updatesList) {
+        walker->setQueuePriority(updatePriority(walker));
+    }
+}
+
+QVector<QRect> KisSimpleUpdateQueue::priorityRects() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_priorityRects;
+}
+
+KisSimpleUpdateQueue::UpdatePriority
+KisSimpleUpdateQueue::updatePriority(KisBaseRectsWalkerSP walker) const
+{
+    const int lod = walker->levelOfDetail();
+    const QRect changeRect = walker->changeRect();
+
+    Q_FOREACH (const QRect &rc, m_priorityRects) {
+        const QRect lodRect = lod > 0 ?
+            KisLodTransform::scaledRect(KisLodTransform::alignedRect(rc, lod), lod) : rc;
+
+        if (lodRect.intersects(changeRect)) {
+            return ViewportPriority;
+        }
+    }
+
+    return walker->isStrokeUpdate() ? StrokePriority : BackgroundPriority;
+}
+
 KisWalkersList& KisTestableSimpleUpdateQueue::getWalkersList()
 {
     return m_updatesList;
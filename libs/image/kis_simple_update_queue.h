@@ -9,6 +9,7 @@
 
 #include <QMutex>
 #include "kis_updater_context.h"
+#include "KisBatchNodeUpdate.h"
 
 typedef QList<KisBaseRectsWalkerSP> KisWalkersList;
 typedef QListIterator<KisBaseRectsWalkerSP> KisWalkersListIterator;
@@ -34,6 +35,16 @@ public:
     void addFullRefreshJob(KisNodeSP node, const QRect &rc, const QRect& cropRect, int levelOfDetail);
     void addFullRefreshJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail);
     void addFullRefreshNoFilthyJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail);
+
+    /**
+     * Refreshes the subtrees of all the nodes of \p updates in a single
+     * walk started at their common ancestor, so that every ancestor
+     * projection is recomposited only once per patch.
+     *
+     * \see KisBatchRefreshWalker
+     */
+    void addBatchRefreshJob(const KisBatchNodeUpdate &updates, const QRect& cropRect, int levelOfDetail);
+
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
 
@@ -46,17 +57,43 @@ public:
 
     int overrideLevelOfDetail() const;
 
+    /**
+     * The priority classes of the updates. The queue starts the jobs
+     * of a higher priority first, the jobs of the same priority are
+     * started in the order they have been added.
+     */
+    enum UpdatePriority {
+        ViewportPriority = 0, ///< intersects the visible area of a canvas
+        StrokePriority, ///< requested by a running stroke job
+        BackgroundPriority, ///< everything else
+        NumUpdatePriorities
+    };
+
+    /**
+     * Sets the areas of the image (in LoD0 coordinates) that are
+     * currently visible on the canvases. The updates intersecting
+     * them are processed before all the others. The background
+     * updates are still processed whenever there are spare threads.
+     */
+    void setPriorityRects(const QVector<QRect> &rects);
+    QVector<QRect> priorityRects() const;
+
 protected:
     void addJob(KisNodeSP node, const QVector<QRect> &rects, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     bool processOneJob(KisUpdaterContext &updaterContext);
 
-    bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
+    bool trySplitJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type, KisBaseRectsWalkerSP &probeWalker);
     bool tryMergeJob(KisNodeSP node, const QRect& rc, const QRect& cropRect, int levelOfDetail, KisBaseRectsWalker::UpdateType type);
 
     void collectJobs(KisBaseRectsWalkerSP &baseWalker, QRect baseRect,
                      const qreal maxAlpha);
-    bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
+    bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha, const QSize &maxSize);
+
+    QSize patchSizeForWalker(KisBaseRectsWalkerSP walker) const;
+    void updateCostDensity(KisBaseRectsWalkerSP walker) const;
+
+    UpdatePriority updatePriority(KisBaseRectsWalkerSP walker) const;
 
 protected:
 
@@ -77,6 +114,15 @@ protected:
     qint32 m_patchWidth;
     qint32 m_patchHeight;
 
+    /**
+     * When enabled, the patches are shrunk for the updates that
+     * are more expensive than m_patchReferenceCost per pixel.
+     *
+     * \see KisUpdateCostModel
+     */
+    bool m_adaptivePatches;
+    qreal m_patchReferenceCost;
+
     /**
      * Maximum coefficient of work while regular optimization()
      */
@@ -94,6 +140,8 @@ protected:
     qreal m_maxMergeCollectAlpha;
 
     int m_overrideLevelOfDetail;
+
+    QVector<QRect> m_priorityRects;
 };
 
 class KRITAIMAGE_EXPORT KisTestableSimpleUpdateQueue : public KisSimpleUpdateQueue
@@ -9,6 +9,9 @@
 #include <QQueue>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QWaitCondition>
+#include <QDeadlineTimer>
+#include <QHash>
 #include "kis_stroke.h"
 #include "kis_updater_context.h"
 #include "kis_stroke_job_strategy.h"
@@ -16,6 +19,8 @@
 #include "kis_undo_stores.h"
 #include "kis_post_execution_undo_adapter.h"
 #include "KisCppQuirks.h"
+#include "KisPerfTracer.h"
+#include <kundo2magicstring.h>
 
 typedef QQueue<KisStrokeSP> StrokesQueue;
 typedef QQueue<KisStrokeSP>::iterator StrokesQueueIterator;
@@ -92,6 +97,27 @@ struct Q_DECL_HIDDEN KisStrokesQueue::Private {
     KisPostExecutionUndoAdapter lodNPostExecutionUndoAdapter;
     KisLodPreferences lodPreferences;
 
+    /**
+     * The time the current stroke has been loaded at, in terms of
+     * KisPerfTracer::timestamp(), or -1 if the tracer was disabled
+     */
+    qint64 currentStrokeTraceStartTime = -1;
+
+    qint64 numFinishedStrokes = 0;
+    QWaitCondition strokeFinishedCondition;
+
+    /**
+     * The callbacks registered with addStrokeCompletionCallback(). When
+     * the stroke is finished, they are moved into the pending list and
+     * called by processQueue() when the locks are released.
+     */
+    QHash<KisStroke*, QVector<std::function<void()>>> completionCallbacks;
+    QVector<std::function<void()>> pendingCompletionCallbacks;
+
+    void loadCurrentStroke(KisStrokeSP stroke);
+    void traceStrokeFinished(KisStrokeSP stroke);
+    void notifyStrokeFinished(KisStrokeSP stroke);
+
     void cancelForgettableStrokes();
     void startLod0ToNStroke(int levelOfDetail, bool forgettable);
 
@@ -161,6 +187,50 @@ void KisStrokesQueue::Private::startLod0ToNStroke(int levelOfDetail, bool forget
     this->lodNNeedsSynchronization = false;
 }
 
+void KisStrokesQueue::Private::loadCurrentStroke(KisStrokeSP stroke)
+{
+    needsExclusiveAccess = stroke->isExclusive();
+    wrapAroundModeSupported = stroke->supportsWrapAroundMode();
+    balancingRatioOverride = stroke->balancingRatioOverride();
+    currentStrokeLoaded = true;
+
+    KisPerfTracer *tracer = KisPerfTracer::instance();
+    currentStrokeTraceStartTime =
+        tracer && tracer->isEnabled() ? tracer->timestamp() : -1;
+}
+
+void KisStrokesQueue::Private::traceStrokeFinished(KisStrokeSP stroke)
+{
+    KisPerfTracer *tracer = KisPerfTracer::instance();
+    if (!tracer || !tracer->isEnabled() || currentStrokeTraceStartTime < 0) return;
+
+    QVariantMap args;
+    args["name"] = stroke->name().toString();
+    args["lod"] = stroke->worksOnLevelOfDetail();
+    args["exclusive"] = stroke->isExclusive();
+    args["cancelled"] = stroke->isCancelled();
+
+    tracer->addCompleteEvent("stroke", stroke->id().toUtf8(),
+                             currentStrokeTraceStartTime,
+                             tracer->timestamp() - currentStrokeTraceStartTime,
+                             args);
+
+    currentStrokeTraceStartTime = -1;
+}
+
+void KisStrokesQueue::Private::notifyStrokeFinished(KisStrokeSP stroke)
+{
+    numFinishedStrokes++;
+
+    auto it = completionCallbacks.find(stroke.data());
+    if (it != completionCallbacks.end()) {
+        pendingCompletionCallbacks.append(it.value());
+        completionCallbacks.erase(it);
+    }
+
+    strokeFinishedCondition.wakeAll();
+}
+
 void KisStrokesQueue::Private::cancelForgettableStrokes()
 {
     if (!strokesQueue.isEmpty() && !hasUnfinishedStrokes()) {
@@ -579,8 +649,15 @@ void KisStrokesQueue::processQueue(KisUpdaterContext &updaterContext,
           processOneJob(updaterContext,
                         externalJobsPending));
 
+    QVector<std::function<void()>> completionCallbacks;
+    std::swap(completionCallbacks, m_d->pendingCompletionCallbacks);
+
     m_d->mutex.unlock();
     updaterContext.unlock();
+
+    for (auto it = completionCallbacks.begin(); it != completionCallbacks.end(); ++it) {
+        (*it)();
+    }
 }
 
 bool KisStrokesQueue::needsExclusiveAccess() const
@@ -638,6 +715,52 @@ qint32 KisStrokesQueue::sizeMetric() const
     return qMax(1, m_d->strokesQueue.head()->numJobs()) * m_d->strokesQueue.size();
 }
 
+KisStrokesQueueStatistics KisStrokesQueue::statistics() const
+{
+    QMutexLocker locker(&m_d->mutex);
+
+    KisStrokesQueueStatistics stats;
+    stats.numStrokes = m_d->strokesQueue.size();
+    stats.numOpenedStrokes = m_d->openedStrokesCounter;
+    stats.numFinishedStrokes = m_d->numFinishedStrokes;
+
+    Q_FOREACH (KisStrokeSP stroke, m_d->strokesQueue) {
+        stats.numPendingJobs += stroke->numJobs();
+    }
+
+    return stats;
+}
+
+bool KisStrokesQueue::waitForPendingStrokes(int maxPendingStrokes, int timeout)
+{
+    QMutexLocker locker(&m_d->mutex);
+
+    QDeadlineTimer deadline(timeout);
+
+    while (m_d->strokesQueue.size() > maxPendingStrokes) {
+        if (!m_d->strokeFinishedCondition.wait(&m_d->mutex, deadline)) {
+            return m_d->strokesQueue.size() <= maxPendingStrokes;
+        }
+    }
+
+    return true;
+}
+
+void KisStrokesQueue::addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback)
+{
+    {
+        QMutexLocker locker(&m_d->mutex);
+
+        KisStrokeSP stroke = id.toStrongRef();
+        if (stroke && m_d->strokesQueue.contains(stroke)) {
+            m_d->completionCallbacks[stroke.data()].append(callback);
+            return;
+        }
+    }
+
+    callback();
+}
+
 void KisStrokesQueue::Private::switchDesiredLevelOfDetail(bool forced)
 {
     if (forced || nextDesiredLevelOfDetail != desiredLevelOfDetail) {
@@ -767,10 +890,7 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
          * stroke might end up in loaded, but uninitialized state.
          */
         if (!m_d->currentStrokeLoaded) {
-            m_d->needsExclusiveAccess = stroke->isExclusive();
-            m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
-            m_d->balancingRatioOverride = stroke->balancingRatioOverride();
-            m_d->currentStrokeLoaded = true;
+            m_d->loadCurrentStroke(stroke);
         }
 
         result = true;
@@ -781,16 +901,15 @@ bool KisStrokesQueue::checkStrokeState(bool hasStrokeJobsRunning,
          * arrive here unloaded.
          */
         if (!m_d->currentStrokeLoaded) {
-            m_d->needsExclusiveAccess = stroke->isExclusive();
-            m_d->wrapAroundModeSupported = stroke->supportsWrapAroundMode();
-            m_d->balancingRatioOverride = stroke->balancingRatioOverride();
-            m_d->currentStrokeLoaded = true;
+            m_d->loadCurrentStroke(stroke);
         }
 
         result = true;
     }
     else if(stroke->isEnded() && !hasJobs && !hasStrokeJobsRunning) {
         m_d->tryClearUndoOnStrokeCompletion(stroke);
+        m_d->traceStrokeFinished(stroke);
+        m_d->notifyStrokeFinished(stroke);
 
         m_d->strokesQueue.dequeue(); // deleted by shared pointer
         m_d->needsExclusiveAccess = false;
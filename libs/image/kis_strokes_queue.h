@@ -7,6 +7,8 @@
 #ifndef __KIS_STROKES_QUEUE_H
 #define __KIS_STROKES_QUEUE_H
 
+#include <functional>
+
 #include "kritaimage_export.h"
 #include "kundo2magicstring.h"
 #include "kis_types.h"
@@ -14,6 +16,7 @@
 #include "kis_stroke_strategy.h"
 #include "kis_stroke_strategy_factory.h"
 #include "kis_strokes_queue_undo_result.h"
+#include "KisStrokesQueueStatistics.h"
 #include "KisStrokesQueueMutatedJobInterface.h"
 #include "KisUpdaterContextSnapshotEx.h"
 #include "KisLodPreferences.h"
@@ -47,6 +50,38 @@ public:
     bool isEmpty() const;
 
     qint32 sizeMetric() const;
+
+    /**
+     * Returns the current depth of the queue. Batch clients may
+     * use it to decide whether they should wait before adding
+     * more strokes.
+     */
+    KisStrokesQueueStatistics statistics() const;
+
+    /**
+     * Blocks the calling thread until there are no more than
+     * \p maxPendingStrokes strokes in the queue or \p timeout
+     * milliseconds have passed. A negative \p timeout means
+     * waiting forever.
+     *
+     * The opened strokes never leave the queue, so they should be
+     * ended before waiting for them. The queue should also be
+     * processed by somebody else, e.g. by the updater context
+     * threads, otherwise the call will wait until the timeout.
+     *
+     * \return true if the queue has shrunk to \p maxPendingStrokes
+     */
+    bool waitForPendingStrokes(int maxPendingStrokes, int timeout = -1);
+
+    /**
+     * Calls \p callback when stroke \p id is finished or cancelled
+     * and removed from the queue. The callback is called from the
+     * thread that processes the queue, with all the queue's locks
+     * released. If the stroke has already left the queue, the callback
+     * is called immediately from the calling thread.
+     */
+    void addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback);
+
     KUndo2MagicString currentStrokeName() const;
     bool hasOpenedStrokes() const;
 
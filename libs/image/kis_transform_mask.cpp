@@ -5,6 +5,11 @@
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
+#include <QMutex>
+#include <QThread>
+#include <QAtomicPointer>
+#include <QtMath>
+
 #include <KoIcon.h>
 #include <kis_icon.h>
 #include <KoCompositeOpRegistry.h>
@@ -37,6 +42,8 @@
 
 #include "kis_image_config.h"
 #include "kis_lod_capable_layer_offset.h"
+#include "tiles3/kis_tile_data_interface.h"
+#include <KisRegion.h>
 
 //#include "kis_paint_device_debug_utils.h"
 //#define DEBUG_RENDERING
@@ -44,6 +51,32 @@
 
 #define UPDATE_DELAY 3000 /*ms */
 
+/**
+ * The support of the resampling filters of the transform workers is
+ * not included into needRect(), so the source of an incremental update
+ * is grown by this margin (in pixels) both in the source and in the
+ * destination space. The widest filter (Lanczos3) reaches 3 pixels
+ * around the sample at the scale of 1.0 and KisTransformWorker applies
+ * it in up to three passes (scale, shear and rotate), which makes 9
+ * pixels; the rest is a safety gap. When the transformation shrinks
+ * the image, the support in the source space grows by the inverse of
+ * the scale, so the source margin is scaled accordingly (see
+ * incrementalUpdateSourceMargin()).
+ */
+#define INCREMENTAL_UPDATE_MARGIN 16
+
+/**
+ * If the dirty areas need more than this share of the source
+ * device, the static image is regenerated entirely
+ */
+#define MAX_INCREMENTAL_UPDATE_PORTION 0.5
+
+/**
+ * The maximum number of the dirty rects kept before they are
+ * merged into tiles
+ */
+#define MAX_DIRTY_RECTS 1024
+
 struct Q_DECL_HIDDEN KisTransformMask::Private
 {
     Private(KisImageSP image)
@@ -78,6 +111,51 @@ struct Q_DECL_HIDDEN KisTransformMask::Private
 
         params->clearChangedFlag();
         staticCacheValid = false;
+        invalidateStaticCacheEntirely();
+    }
+
+    void addDirtyStaticCacheRect(const QRect &rc, int levelOfDetail)
+    {
+        /**
+         * The updates of the LoD planes are always followed by the
+         * same updates of LoD0, so we can just skip them
+         */
+        if (levelOfDetail > 0) return;
+
+        QMutexLocker l(&dirtyStaticCacheRectsLock);
+        dirtyStaticCacheRects.append(rc);
+
+        if (dirtyStaticCacheRects.size() > MAX_DIRTY_RECTS) {
+            dirtyStaticCacheRects =
+                KisRegion::fromOverlappingRects(dirtyStaticCacheRects, KisTileData::WIDTH).rects();
+        }
+    }
+
+    void invalidateStaticCacheEntirely()
+    {
+        QMutexLocker l(&dirtyStaticCacheRectsLock);
+        staticCacheNeedsFullUpdate = true;
+    }
+
+    /**
+     * Moves the dirty rects into \p rects and resets the dirty state
+     * of the cache in one go. It must be called right before the cache
+     * starts to be recalculated: the concurrent merges may dirty the
+     * cache while it is being recalculated and these rects should be
+     * kept for the next recalculation.
+     *
+     * \return false if the cache should be regenerated entirely
+     */
+    bool takeDirtyStaticCacheRects(QVector<QRect> *rects)
+    {
+        QMutexLocker l(&dirtyStaticCacheRectsLock);
+        rects->clear();
+        rects->swap(dirtyStaticCacheRects);
+
+        const bool canUpdateIncrementally = !staticCacheNeedsFullUpdate;
+        staticCacheNeedsFullUpdate = false;
+
+        return canUpdateIncrementally;
     }
 
     KisPerspectiveTransformWorker worker;
@@ -88,6 +166,24 @@ struct Q_DECL_HIDDEN KisTransformMask::Private
     KisPaintDeviceSP staticCacheDevice;
     bool staticCacheIsOverridden = false;
 
+    /**
+     * The areas of the static cache that have become outdated since
+     * its last recalculation. Unless the whole cache is invalidated,
+     * e.g. by a change of the transformation, only these areas are
+     * regenerated. Both fields are guarded by dirtyStaticCacheRectsLock.
+     */
+    QMutex dirtyStaticCacheRectsLock;
+    QVector<QRect> dirtyStaticCacheRects;
+    bool staticCacheNeedsFullUpdate = true;
+
+    /**
+     * The thread that regenerates the projection of the parent layer
+     * from the static cache. The merges it runs should not dirty the
+     * cache, but the merges running concurrently in the other threads
+     * still should.
+     */
+    QAtomicPointer<QThread> staticCacheRefreshThread;
+
     KisLodCapableLayerOffset offset;
 
     KisThreadSafeSignalCompressor updateSignalCompressor;
@@ -197,6 +293,50 @@ KisPaintDeviceSP KisTransformMask::buildPreviewDevice()
     return device;
 }
 
+namespace {
+
+/**
+ * Builds the source of \p mask, that is, the original of the layer with
+ * all the masks below \p mask applied, in the area \p requestedRect
+ */
+void buildMaskSource(KisLayerSP parentLayer, KisNodeSP mask,
+                     KisPaintDeviceSP device, QRect requestedRect)
+{
+    KisNodeSP prevSibling = mask->prevSibling();
+    if (prevSibling) {
+        parentLayer->buildProjectionUpToNode(device, prevSibling, requestedRect);
+    } else {
+        requestedRect = parentLayer->outgoingChangeRect(requestedRect);
+        parentLayer->copyOriginalToProjection(parentLayer->original(), device, requestedRect);
+    }
+}
+
+/**
+ * Returns the margin the source of an incremental update should be
+ * grown by to include the support of the resampling filter for the
+ * affine transformation \p t, or -1 if the transformation is degenerate
+ */
+int incrementalUpdateSourceMargin(const QTransform &t)
+{
+    /**
+     * The smallest singular value of the linear part of the transform
+     * is the strongest shrinking it applies in any direction
+     */
+    const qreal sumOfSquares =
+        pow2(t.m11()) + pow2(t.m12()) + pow2(t.m21()) + pow2(t.m22());
+    const qreal det = t.m11() * t.m22() - t.m12() * t.m21();
+    const qreal minScale =
+        std::sqrt(0.5 * qMax(0.0, sumOfSquares - std::sqrt(qMax(0.0, pow2(sumOfSquares) - 4 * pow2(det)))));
+
+    if (qFuzzyIsNull(minScale)) return -1;
+
+    return minScale >= 1.0 ?
+        INCREMENTAL_UPDATE_MARGIN :
+        qCeil(INCREMENTAL_UPDATE_MARGIN / minScale);
+}
+
+}
+
 KisPaintDeviceSP KisTransformMask::buildSourcePreviewDevice()
 {
     /**
@@ -213,15 +353,7 @@ KisPaintDeviceSP KisTransformMask::buildSourcePreviewDevice()
         new KisPaintDevice(parentLayer->original()->colorSpace());
     device->setDefaultBounds(parentLayer->original()->defaultBounds());
 
-    QRect requestedRect = parentLayer->original()->exactBounds();
-
-    KisNodeSP prevSibling = this->prevSibling();
-    if (prevSibling) {
-        parentLayer->buildProjectionUpToNode(device, prevSibling, requestedRect);
-    } else {
-        requestedRect = parentLayer->outgoingChangeRect(requestedRect);
-        parentLayer->copyOriginalToProjection(parentLayer->original(), device, requestedRect);
-    }
+    buildMaskSource(parentLayer, this, device, parentLayer->original()->exactBounds());
 
     return device;
 }
@@ -237,6 +369,9 @@ void KisTransformMask::overrideStaticCacheDevice(KisPaintDeviceSP device)
 
     m_d->staticCacheValid = bool(device);
     m_d->staticCacheIsOverridden = bool(device);
+
+    // the overridden content is not ours anymore
+    m_d->invalidateStaticCacheEntirely();
 }
 
 void KisTransformMask::recaclulateStaticImage()
@@ -263,6 +398,13 @@ void KisTransformMask::recaclulateStaticImage()
         m_d->staticCacheDevice->setDefaultBounds(parentLayer->original()->defaultBounds());
     }
 
+    /**
+     * The source is read after this point, so all the areas dirtied
+     * before it are covered by the recalculation
+     */
+    QVector<QRect> dirtyRects;
+    m_d->takeDirtyStaticCacheRects(&dirtyRects);
+
     m_d->recalculatingStaticImage = true;
     /**
      * updateProjection() is assuming that the requestedRect takes
@@ -287,6 +429,126 @@ void KisTransformMask::recaclulateStaticImage()
     m_d->staticCacheValid = true;
 }
 
+bool KisTransformMask::recalculateStaticImageIncrementally(QVector<QRect> *updatedRects)
+{
+    /**
+     * Note: this function must be called from within the scheduler's
+     * context, the same way as recaclulateStaticImage()
+     */
+
+    KisLayerSP parentLayer = qobject_cast<KisLayer*>(parent().data());
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(parentLayer, false);
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(parentLayer->projection() != parentLayer->paintDevice(), false);
+
+    if (m_d->params->hasChanged()) m_d->reloadParameters();
+
+    /**
+     * Only truly affine transformations resample the source locally
+     * with a bounded filter support. The params report isAffine() for
+     * the perspective transformations as well, so we check the matrix
+     * itself. The non-affine workers (cage, warp, liquify, mesh) depend
+     * on the bounds of the whole source, so they are always regenerated
+     * entirely.
+     */
+    if (m_d->staticCacheIsOverridden ||
+        !m_d->staticCacheDevice ||
+        *m_d->staticCacheDevice->colorSpace() != *parentLayer->original()->colorSpace() ||
+        !m_d->params->isAffine() ||
+        !m_d->params->finalAffineTransform().isAffine() ||
+        m_d->params->isHidden() ||
+        isAnimated()) {
+
+        return false;
+    }
+
+    const int sourceMargin =
+        incrementalUpdateSourceMargin(m_d->params->finalAffineTransform());
+    if (sourceMargin < 0) return false;
+
+    /**
+     * If we fall back to the full recalculation below, it will cover
+     * the taken rects, because it reads the source after us
+     */
+    QVector<QRect> dirtyRects;
+    if (!m_d->takeDirtyStaticCacheRects(&dirtyRects)) {
+        return false;
+    }
+
+    const QVector<QRect> dirtyTiles =
+        KisRegion::fromOverlappingRects(dirtyRects, KisTileData::WIDTH).rects();
+
+    const QRect sourceBounds = sourceDataBounds();
+
+    /**
+     * Every destination tile depends only on the source pixels inside
+     * its need rect, so we regenerate the dirty tiles from their own
+     * pieces of the source. If the pieces overlap too much, it is
+     * cheaper to transform the whole source at once.
+     */
+    QVector<QRect> sourceRects;
+    qint64 sourceArea = 0;
+
+    Q_FOREACH (const QRect &rc, dirtyTiles) {
+        const QRect sourceRect =
+            kisGrowRect(needRect(kisGrowRect(rc, INCREMENTAL_UPDATE_MARGIN)),
+                        sourceMargin) & sourceBounds;
+
+        sourceRects << sourceRect;
+        sourceArea += qint64(sourceRect.width()) * sourceRect.height();
+    }
+
+    if (sourceArea > MAX_INCREMENTAL_UPDATE_PORTION * sourceBounds.width() * sourceBounds.height()) {
+        return false;
+    }
+
+    const KoColorSpace *cs = parentLayer->original()->colorSpace();
+
+    for (int i = 0; i < dirtyTiles.size(); i++) {
+        const QRect &dstRect = dirtyTiles[i];
+        const QRect &sourceRect = sourceRects[i];
+
+        m_d->staticCacheDevice->clear(dstRect);
+
+        if (sourceRect.isEmpty()) continue;
+
+        KisPaintDeviceSP srcDevice = new KisPaintDevice(cs);
+        srcDevice->setDefaultBounds(parentLayer->original()->defaultBounds());
+        buildMaskSource(parentLayer, this, srcDevice, sourceRect);
+        srcDevice->crop(sourceRect);
+
+        KisPaintDeviceSP dstDevice = new KisPaintDevice(cs);
+        dstDevice->setDefaultBounds(parentLayer->original()->defaultBounds());
+        m_d->params->transformDevice(this, srcDevice, dstDevice);
+
+        KisPainter::copyAreaOptimized(dstRect.topLeft(), dstDevice, m_d->staticCacheDevice, dstRect);
+    }
+
+    m_d->staticCacheValid = true;
+
+    /**
+     * Regenerate the projection of the layer in the updated areas. The
+     * masks above us may spread the change further.
+     */
+    m_d->staticCacheRefreshThread.storeRelease(QThread::currentThread());
+
+    Q_FOREACH (const QRect &rc, dirtyTiles) {
+        QRect changeRect = rc;
+
+        for (KisNodeSP node = nextSibling(); node; node = node->nextSibling()) {
+            if (qobject_cast<KisEffectMask*>(node.data()) && node->visible()) {
+                changeRect = node->changeRect(changeRect);
+            }
+        }
+
+        parentLayer->updateProjection(changeRect, this);
+        *updatedRects << changeRect;
+    }
+
+    m_d->staticCacheRefreshThread.storeRelease(nullptr);
+
+    return true;
+}
+
 QRect KisTransformMask::decorateRect(KisPaintDeviceSP &src,
                                      KisPaintDeviceSP &dst,
                                      const QRect & rc,
@@ -307,9 +569,11 @@ QRect KisTransformMask::decorateRect(KisPaintDeviceSP &src,
 
     if (!m_d->staticCacheIsOverridden &&
         !m_d->recalculatingStaticImage &&
+        m_d->staticCacheRefreshThread.loadAcquire() != QThread::currentThread() &&
         (maskPos == N_FILTHY || maskPos == N_ABOVE_FILTHY)) {
 
         m_d->staticCacheValid = false;
+        m_d->addDirtyStaticCacheRect(rc, src->defaultBounds()->currentLevelOfDetail());
         m_d->updateSignalCompressor.start();
     }
 
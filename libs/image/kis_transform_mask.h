@@ -7,6 +7,7 @@
 #define _KIS_TRANSFORM_MASK_
 
 #include <QScopedPointer>
+#include <QVector>
 
 #include "kis_types.h"
 #include "kis_effect_mask.h"
@@ -58,6 +59,18 @@ public:
     KisTransformMaskParamsInterfaceSP transformParams() const;
 
     void recaclulateStaticImage();
+
+    /**
+     * Regenerates only the parts of the static image that depend on
+     * the source areas changed since the last recalculation and updates
+     * the projection of the parent layer there. The updated rects are
+     * appended to \p updatedRects.
+     *
+     * \return false if the static image cannot be updated incrementally,
+     *         e.g. when the transformation itself has changed. In such a
+     *         case recaclulateStaticImage() should be called instead.
+     */
+    bool recalculateStaticImageIncrementally(QVector<QRect> *updatedRects);
     KisPaintDeviceSP buildPreviewDevice();
     KisPaintDeviceSP buildSourcePreviewDevice();
 
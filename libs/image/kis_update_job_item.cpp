@@ -9,3 +9,27 @@
 /**
  * This cpp-file is for QObject support mostly
  */
+
+namespace {
+bool& currentThreadRunsStrokeJobFlag()
+{
+    thread_local bool value = false;
+    return value;
+}
+}
+
+bool KisUpdateJobItem::currentThreadRunsStrokeJob()
+{
+    return currentThreadRunsStrokeJobFlag();
+}
+
+KisUpdateJobItem::StrokeJobThreadMarker::StrokeJobThreadMarker(bool isStrokeJob)
+    : m_oldValue(currentThreadRunsStrokeJobFlag())
+{
+    currentThreadRunsStrokeJobFlag() = isStrokeJob;
+}
+
+KisUpdateJobItem::StrokeJobThreadMarker::~StrokeJobThreadMarker()
+{
+    currentThreadRunsStrokeJobFlag() = m_oldValue;
+}
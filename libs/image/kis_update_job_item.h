@@ -9,6 +9,7 @@
 
 #include <atomic>
 
+#include <QElapsedTimer>
 #include <QRunnable>
 #include <QReadWriteLock>
 
@@ -17,6 +18,8 @@
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_updater_context.h"
+#include "KisUpdaterThreadAffinity.h"
+#include "KisPerfTracer.h"
 #include <KoAlwaysInline.h>
 
 //#define DEBUG_JOBS_SEQUENCE
@@ -34,8 +37,9 @@ public:
     };
 
 public:
-    KisUpdateJobItem(KisUpdaterContext *updaterContext)
-        : m_updaterContext(updaterContext)
+    KisUpdateJobItem(KisUpdaterContext *updaterContext, int slotIndex = -1)
+        : m_updaterContext(updaterContext),
+          m_slotIndex(slotIndex)
     {
         setAutoDelete(false);
         KIS_SAFE_ASSERT_RECOVER_NOOP(m_atomicType.is_lock_free());
@@ -46,6 +50,14 @@ public:
     }
 
     void run() override {
+        if (m_slotIndex >= 0) {
+            if (m_updaterContext->threadAffinityEnabled()) {
+                KisUpdaterThreadAffinity::bindCurrentThread(m_slotIndex);
+            } else {
+                KisUpdaterThreadAffinity::unbindCurrentThread();
+            }
+        }
+
         runImpl();
 
         // notify that the job is exiting and wake everybody
@@ -69,6 +81,11 @@ private:
          * To overcome this problem we try to bulk-process the jobs. In sigJobFinished()
          * signal (which is DirectConnection), the context may add the job to ourselves(!!!),
          * so we switch from "done" state into "running" again.
+         *
+         * The fine-grained parallelism is achieved differently: the job itself may
+         * split its work into tile-sized subtasks with
+         * KisWorkStealingExecutor::runSplitJob(), and the idle workers of the
+         * context's executor steal them.
          */
 
         while (1) {
@@ -97,6 +114,16 @@ private:
                     }
 #endif
 
+                    StrokeJobThreadMarker marker(m_atomicType == Type::STROKE);
+
+                    KisPerfTracer::Scope traceScope(m_atomicType == Type::STROKE ? "stroke" : "spontaneous",
+                                                    "job");
+                    if (traceScope.isActive()) {
+                        traceScope.setName(m_runnableJob->debugName());
+                        traceScope.addArg("exclusive", m_exclusive);
+                        traceScope.addArg("slot", m_slotIndex);
+                    }
+
                     m_runnableJob->run();
                 }
             }
@@ -119,6 +146,29 @@ private:
         }
     }
 
+public:
+
+    /**
+     * Returns true if the calling thread is running a stroke job
+     * right now. The updates requested from such a thread belong
+     * to the current stroke.
+     */
+    static bool currentThreadRunsStrokeJob();
+
+    /**
+     * Marks the calling thread as running a stroke job (or not) for
+     * the lifetime of the object. Besides the job item itself, it is
+     * used by KisWorkStealingExecutor to carry the flag over to the
+     * helper threads of a split job.
+     */
+    struct KRITAIMAGE_EXPORT StrokeJobThreadMarker {
+        StrokeJobThreadMarker(bool isStrokeJob);
+        ~StrokeJobThreadMarker();
+
+    private:
+        bool m_oldValue;
+    };
+
 public:
 
     inline void runMergeJob() {
@@ -132,7 +182,24 @@ public:
 
 #endif
 
-        m_merger.startMerge(*m_walker);
+        QElapsedTimer timer;
+        timer.start();
+
+        {
+            KisPerfTracer::Scope traceScope("update", walkerTypeName(m_walker->type()));
+            if (traceScope.isActive()) {
+                traceScope.addRectArgs(m_walker->requestedRect());
+                traceScope.addArg("changeArea", qint64(m_changeRect.width()) * m_changeRect.height());
+                traceScope.addArg("node", m_walker->startNode() ? m_walker->startNode()->name() : QString());
+                traceScope.addArg("lod", m_walker->levelOfDetail());
+                traceScope.addArg("slot", m_slotIndex);
+            }
+
+            m_merger.startMerge(*m_walker);
+        }
+
+        m_mergeTime += timer.nsecsElapsed();
+        m_numMergeJobs++;
 
         QRect changeRect = m_walker->changeRect();
         m_updaterContext->continueUpdate(changeRect);
@@ -209,6 +276,23 @@ public:
         return m_strokeJobSequentiality;
     }
 
+    /**
+     * The time the item spent in merge jobs since the last call to
+     * resetMergeStatistics(), in nanoseconds
+     */
+    inline qint64 mergeTime() const {
+        return m_mergeTime;
+    }
+
+    inline int numMergeJobs() const {
+        return m_numMergeJobs;
+    }
+
+    inline void resetMergeStatistics() {
+        m_mergeTime = 0;
+        m_numMergeJobs = 0;
+    }
+
 private:
     /**
      * Open walker and stroke job for the testing suite.
@@ -220,6 +304,25 @@ private:
     friend class KisUpdateSchedulerTest;
     friend class KisUpdaterContext;
 
+    static const char* walkerTypeName(KisBaseRectsWalker::UpdateType type) {
+        switch (type) {
+        case KisBaseRectsWalker::UPDATE:
+            return "merge";
+        case KisBaseRectsWalker::UPDATE_NO_FILTHY:
+            return "merge (no filthy)";
+        case KisBaseRectsWalker::FULL_REFRESH:
+            return "full refresh";
+        case KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY:
+            return "full refresh (no filthy)";
+        case KisBaseRectsWalker::BATCH_REFRESH:
+            return "batch refresh";
+        case KisBaseRectsWalker::UNSUPPORTED:
+            break;
+        }
+
+        return "unknown walker";
+    }
+
     inline KisBaseRectsWalkerSP walker() const {
         return m_walker;
     }
@@ -237,6 +340,13 @@ private:
 
 private:
     KisUpdaterContext *m_updaterContext {0};
+
+    /**
+     * The index of the item in the context, used as the CPU index
+     * in the thread-affine mode
+     */
+    int m_slotIndex {-1};
+
     bool m_exclusive {false};
     std::atomic<Type> m_atomicType {Type::EMPTY};
     volatile KisStrokeJobData::Sequentiality m_strokeJobSequentiality;
@@ -259,6 +369,9 @@ private:
      */
     QRect m_accessRect;
     QRect m_changeRect;
+
+    std::atomic<qint64> m_mergeTime {0};
+    std::atomic<int> m_numMergeJobs {0};
 };
 
 
@@ -12,6 +12,8 @@
 #include "kis_full_refresh_walker.h"
 
 #include "kis_updater_context.h"
+#include "KisBelowStackCache.h"
+#include "KisPerfTracer.h"
 #include "kis_simple_update_queue.h"
 #include "kis_strokes_queue.h"
 
@@ -103,6 +105,16 @@ int KisUpdateScheduler::threadsLimit() const
     return m_d->updaterContext.threadsLimit();
 }
 
+qreal KisUpdateScheduler::mergeLoadBalance() const
+{
+    return m_d->updaterContext.loadBalanceStatistics().loadBalance();
+}
+
+void KisUpdateScheduler::resetLoadBalanceStatistics()
+{
+    m_d->updaterContext.resetLoadBalanceStatistics();
+}
+
 void KisUpdateScheduler::connectSignals()
 {
     connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
@@ -174,6 +186,12 @@ void KisUpdateScheduler::fullRefreshAsyncNoFilthy(KisNodeSP root, const QVector<
     processQueues();
 }
 
+void KisUpdateScheduler::fullRefreshAsync(const KisBatchNodeUpdate &updates, const QRect &cropRect)
+{
+    m_d->updatesQueue.addBatchRefreshJob(updates, cropRect, currentLevelOfDetail());
+    processQueues();
+}
+
 void KisUpdateScheduler::fullRefresh(KisNodeSP root, const QRect& rc, const QRect &cropRect)
 {
     KisBaseRectsWalkerSP walker = new KisFullRefreshWalker(cropRect);
@@ -211,6 +229,22 @@ bool KisUpdateScheduler::hasUpdatesRunning() const
     return !m_d->updatesQueue.isEmpty();
 }
 
+KisStrokesQueueStatistics KisUpdateScheduler::strokesQueueStatistics() const
+{
+    return m_d->strokesQueue.statistics();
+}
+
+bool KisUpdateScheduler::waitForPendingStrokes(int maxPendingStrokes, int timeout)
+{
+    processQueues();
+    return m_d->strokesQueue.waitForPendingStrokes(maxPendingStrokes, timeout);
+}
+
+void KisUpdateScheduler::addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback)
+{
+    m_d->strokesQueue.addStrokeCompletionCallback(id, callback);
+}
+
 KisStrokeId KisUpdateScheduler::startStroke(KisStrokeStrategy *strokeStrategy)
 {
     KisStrokeId id  = m_d->strokesQueue.startStroke(strokeStrategy);
@@ -277,6 +311,11 @@ void KisUpdateScheduler::explicitRegenerateLevelOfDetail()
     processQueues();
 }
 
+void KisUpdateScheduler::setUpdatePriorityRects(const QVector<QRect> &rects)
+{
+    m_d->updatesQueue.setPriorityRects(rects);
+}
+
 int KisUpdateScheduler::currentLevelOfDetail() const
 {
     int levelOfDetail = m_d->updaterContext.currentLevelOfDetail();
@@ -314,6 +353,9 @@ void KisUpdateScheduler::updateSettings()
     KisImageConfig config(true);
     m_d->defaultBalancingRatio = config.schedulerBalancingRatio();
     setThreadsLimit(config.maxNumberOfThreads());
+    m_d->updaterContext.setThreadAffinityEnabled(config.updaterThreadAffinity());
+    KisBelowStackCache::setEnabled(config.groupBelowStackCache());
+    KisPerfTracer::instance()->updateSettings();
 }
 
 void KisUpdateScheduler::immediateLockForReadOnly()
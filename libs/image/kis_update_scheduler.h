@@ -7,6 +7,8 @@
 #ifndef __KIS_UPDATE_SCHEDULER_H
 #define __KIS_UPDATE_SCHEDULER_H
 
+#include <functional>
+
 #include <QObject>
 #include "kritaimage_export.h"
 #include "kis_types.h"
@@ -14,6 +16,7 @@
 #include "kis_image_interfaces.h"
 #include "kis_stroke_strategy_factory.h"
 #include "kis_strokes_queue_undo_result.h"
+#include "KisStrokesQueueStatistics.h"
 #include "KisLodPreferences.h"
 
 class QRect;
@@ -21,6 +24,7 @@ class KoProgressProxy;
 class KisProjectionUpdateListener;
 class KisSpontaneousJob;
 class KisPostExecutionUndoAdapter;
+class KisBatchNodeUpdate;
 
 
 class KRITAIMAGE_EXPORT KisUpdateScheduler : public QObject, public KisStrokesFacade
@@ -41,6 +45,16 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Returns how evenly the merge jobs were distributed between the
+     * threads since the last call to resetLoadBalanceStatistics(). 1.0
+     * means that all the threads spent the same time in the merge jobs.
+     *
+     * \see KisUpdaterContext::loadBalanceStatistics()
+     */
+    qreal mergeLoadBalance() const;
+    void resetLoadBalanceStatistics();
+
     /**
      * Sets the proxy that is going to be notified about the progress
      * of processing of the queues. If you want to switch the proxy
@@ -130,11 +144,30 @@ public:
     void updateProjectionNoFilthy(KisNodeSP node, const QRect& rc, const QRect &cropRect);
     void fullRefreshAsync(KisNodeSP root, const QVector<QRect>& rc, const QRect &cropRect);
     void fullRefreshAsyncNoFilthy(KisNodeSP root, const QVector<QRect>& rects, const QRect &cropRect);
+    void fullRefreshAsync(const KisBatchNodeUpdate &updates, const QRect &cropRect);
     void fullRefresh(KisNodeSP root, const QRect& rc, const QRect &cropRect);
     void addSpontaneousJob(KisSpontaneousJob *spontaneousJob);
 
     bool hasUpdatesRunning() const;
 
+    /**
+     * \see KisStrokesQueue::statistics()
+     */
+    KisStrokesQueueStatistics strokesQueueStatistics() const;
+
+    /**
+     * Starts processing the queues and waits until there are no more
+     * than \p maxPendingStrokes strokes left in the strokes queue
+     *
+     * \see KisStrokesQueue::waitForPendingStrokes()
+     */
+    bool waitForPendingStrokes(int maxPendingStrokes, int timeout = -1);
+
+    /**
+     * \see KisStrokesQueue::addStrokeCompletionCallback()
+     */
+    void addStrokeCompletionCallback(KisStrokeId id, std::function<void()> callback);
+
     KisStrokeId startStroke(KisStrokeStrategy *strokeStrategy) override;
     void addJob(KisStrokeId id, KisStrokeJobData *data) override;
     void endStroke(KisStrokeId id) override;
@@ -160,6 +193,15 @@ public:
      */
     void explicitRegenerateLevelOfDetail();
 
+    /**
+     * Sets the areas of the image that are visible on the canvases. The
+     * updates intersecting these areas are processed first, then the
+     * updates requested by the running strokes, then all the rest.
+     *
+     * \see KisSimpleUpdateQueue::setPriorityRects()
+     */
+    void setUpdatePriorityRects(const QVector<QRect> &rects);
+
     /**
      * Install a factory of a stroke strategy, that will be started
      * every time when the scheduler needs to synchronize LOD caches
@@ -7,15 +7,22 @@
 #include "kis_updater_context.h"
 
 #include <QThread>
-#include <QThreadPool>
 
 #include "kis_update_job_item.h"
 #include "kis_stroke_job.h"
+#include "KisUpdaterThreadAffinity.h"
 
 const int KisUpdaterContext::useIdealThreadCountTag = -1;
 
+qreal KisUpdaterContext::LoadBalanceStatistics::loadBalance() const
+{
+    return maxThreadMergeTime > 0 && numThreads > 0 ?
+        qreal(totalMergeTime) / (qreal(maxThreadMergeTime) * numThreads) : 1.0;
+}
+
 KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *parent)
-    : m_scheduler(parent)
+    : m_executor(threadCount),
+      m_scheduler(parent)
 {
     if(threadCount <= 0) {
         threadCount = QThread::idealThreadCount();
@@ -27,7 +34,7 @@ KisUpdaterContext::KisUpdaterContext(qint32 threadCount, KisUpdateScheduler *par
 
 KisUpdaterContext::~KisUpdaterContext()
 {
-    m_threadPool.waitForDone();
+    m_executor.waitForDone();
 
     if (m_testingMode) {
         clear();
@@ -124,7 +131,7 @@ void KisUpdaterContext::startThread(int index)
         m_numRunningThreads++;
     }
 
-    m_threadPool.start(m_jobs[index]);
+    m_executor.start(m_jobs[index]);
 }
 
 /**
@@ -138,7 +145,8 @@ void KisUpdaterContext::startThread(int index)
 void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
 {
     m_lodCounter.addLod(walker->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = m_threadAffinityEnabled.loadAcquire() ?
+        findSpareThread(walker->accessRect()) : findSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setWalker(walker);
@@ -210,6 +218,25 @@ qint32 KisUpdaterContext::findSpareThread()
     return -1;
 }
 
+qint32 KisUpdaterContext::findSpareThread(const QRect &rc)
+{
+    const qint32 preferredIndex =
+        KisUpdaterThreadAffinity::preferredSlot(rc, m_jobs.size());
+
+    /**
+     * If the preferred slot is busy, take the closest one: the
+     * neighbouring CPUs are usually on the same socket
+     */
+    for (qint32 i = 0; i < m_jobs.size(); i++) {
+        const qint32 index = (preferredIndex + i) % m_jobs.size();
+        if (!m_jobs[index]->isRunning()) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
 void KisUpdaterContext::lock()
 {
     m_lock.lock();
@@ -222,7 +249,7 @@ void KisUpdaterContext::unlock()
 
 void KisUpdaterContext::setThreadsLimit(int value)
 {
-    m_threadPool.setMaxThreadCount(value);
+    m_executor.setMaxThreadCount(value);
 
     for (int i = 0; i < m_jobs.size(); i++) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(!m_jobs[i]->isRunning());
@@ -236,16 +263,59 @@ void KisUpdaterContext::setThreadsLimit(int value)
     m_jobs.resize(value);
 
     for(qint32 i = 0; i < m_jobs.size(); i++) {
-        m_jobs[i] = new KisUpdateJobItem(this);
+        m_jobs[i] = new KisUpdateJobItem(this, i);
     }
 }
 
 int KisUpdaterContext::threadsLimit() const
 {
-    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_threadPool.maxThreadCount());
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_jobs.size() == m_executor.maxThreadCount());
     return m_jobs.size();
 }
 
+void KisUpdaterContext::setThreadAffinityEnabled(bool value)
+{
+    m_threadAffinityEnabled.storeRelease(value);
+}
+
+bool KisUpdaterContext::threadAffinityEnabled() const
+{
+    return m_threadAffinityEnabled.loadAcquire();
+}
+
+KisWorkStealingExecutor::Statistics KisUpdaterContext::executorStatistics() const
+{
+    return m_executor.statistics();
+}
+
+void KisUpdaterContext::resetExecutorStatistics()
+{
+    m_executor.resetStatistics();
+}
+
+KisUpdaterContext::LoadBalanceStatistics KisUpdaterContext::loadBalanceStatistics() const
+{
+    LoadBalanceStatistics stats;
+    stats.numThreads = m_jobs.size();
+
+    Q_FOREACH (const KisUpdateJobItem *item, m_jobs) {
+        const qint64 mergeTime = item->mergeTime();
+
+        stats.numMergeJobs += item->numMergeJobs();
+        stats.totalMergeTime += mergeTime;
+        stats.maxThreadMergeTime = qMax(stats.maxThreadMergeTime, mergeTime);
+    }
+
+    return stats;
+}
+
+void KisUpdaterContext::resetLoadBalanceStatistics()
+{
+    Q_FOREACH (KisUpdateJobItem *item, m_jobs) {
+        item->resetMergeStatistics();
+    }
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
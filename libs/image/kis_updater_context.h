@@ -9,12 +9,12 @@
 
 #include <QMutex>
 #include <QReadWriteLock>
-#include <QThreadPool>
 #include <QWaitCondition>
 
 #include "kis_base_rects_walker.h"
 #include "kis_async_merger.h"
 #include "kis_lock_free_lod_counter.h"
+#include "KisWorkStealingExecutor.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
 #include "kis_update_scheduler.h"
@@ -29,6 +29,25 @@ class KRITAIMAGE_EXPORT KisUpdaterContext
 public:
     static const int useIdealThreadCountTag;
 
+    struct KRITAIMAGE_EXPORT LoadBalanceStatistics
+    {
+        int numThreads = 0;
+        int numMergeJobs = 0;
+
+        /// the sum of the time spent in merge jobs by all the threads, in nanoseconds
+        qint64 totalMergeTime = 0;
+
+        /// the time spent in merge jobs by the busiest thread, in nanoseconds
+        qint64 maxThreadMergeTime = 0;
+
+        /**
+         * The ratio of the average merge time of a thread to the merge
+         * time of the busiest thread. 1.0 means that all the threads
+         * did the same amount of work.
+         */
+        qreal loadBalance() const;
+    };
+
 public:
     KisUpdaterContext(qint32 threadCount = useIdealThreadCountTag, KisUpdateScheduler *parent = 0);
     ~KisUpdaterContext();
@@ -127,6 +146,32 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Enables the thread-affine mode: the merge jobs are assigned to
+     * the job slots according to the stripe of the image they
+     * update, and every slot runs on a fixed CPU. It keeps both the
+     * compositing and the memory of the projection tiles local to
+     * one core (and one NUMA node) on multi-socket machines.
+     *
+     * \see KisUpdaterThreadAffinity
+     */
+    void setThreadAffinityEnabled(bool value);
+    bool threadAffinityEnabled() const;
+
+    /**
+     * Returns the utilization statistics of the worker threads
+     * collected since the last call to resetExecutorStatistics()
+     */
+    KisWorkStealingExecutor::Statistics executorStatistics() const;
+    void resetExecutorStatistics();
+
+    /**
+     * Returns how evenly the merge jobs were distributed between the
+     * threads since the last call to resetLoadBalanceStatistics()
+     */
+    LoadBalanceStatistics loadBalanceStatistics() const;
+    void resetLoadBalanceStatistics();
+
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
     void jobFinished();
@@ -138,6 +183,7 @@ protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
+    qint32 findSpareThread(const QRect &rc);
 
 protected:
     /**
@@ -153,10 +199,11 @@ protected:
     int m_numRunningThreads = 0;
     QWaitCondition m_waitForDoneCondition;
     QVector<KisUpdateJobItem*> m_jobs;
-    QThreadPool m_threadPool;
+    KisWorkStealingExecutor m_executor;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
+    QAtomicInt m_threadAffinityEnabled;
 
 private:
 
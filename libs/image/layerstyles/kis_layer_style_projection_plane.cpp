@@ -22,8 +22,13 @@
 #include "kis_painter.h"
 #include "kis_ls_utils.h"
 #include "KisLayerStyleKnockoutBlower.h"
+#include "KisWorkStealingExecutor.h"
 #include "krita_utils.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+
 struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
 {
     KisLayerProjectionPlaneWSP sourceProjectionPlane;
@@ -34,7 +39,6 @@ struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
     KisStrokeLayerStyleFilterProjectionPlaneSP strokeStyle;
 
     KisCachedPaintDevice cachedPaintDevice;
-    KisCachedSelection cachedSelection;
     KisLayer *sourceLayer = 0;
 
 
@@ -42,6 +46,21 @@ struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
     bool canHaveChildNodes = false;
     bool dependsOnLowerNodes = false;
 
+    /**
+     * The knockout selection of the overlay styles depends on the
+     * projection of the source layer only, so it is kept between the
+     * updates and regenerated only in the areas that have been passed
+     * to recalculate(). The layers above the dirty area reuse it as
+     * it is. The source device is tracked with a weak pointer, so
+     * that a new device allocated at the address of a dead one could
+     * not be mistaken for it.
+     */
+    QMutex knockoutCacheLock;
+    KisSelectionSP knockoutSelection;
+    QRegion knockoutValidRegion;
+    KritaUtils::ThresholdMode knockoutThresholdMode = KritaUtils::ThresholdNone;
+    KisPaintDeviceWSP knockoutSourceDevice;
+
     void initSourcePlane(KisLayer *sourceLayer) {
         KIS_SAFE_ASSERT_RECOVER_RETURN(sourceLayer);
         sourceProjectionPlane = sourceLayer->internalProjectionPlane();
@@ -85,8 +104,62 @@ struct Q_DECL_HIDDEN KisLayerStyleProjectionPlane::Private
                            KisLayerStyleFilterProjectionPlaneSP plane,
                            const QRect &rect,
                            KisPaintDeviceSP originalClone);
+
+    KisSelectionSP fetchKnockoutSelection(const QRect &rect, KritaUtils::ThresholdMode thresholdMode);
+    void invalidateKnockoutSelection(const QRect &rect);
 };
 
+/**
+ * The maximum number of rects in the valid region of the knockout
+ * cache. A more fragmented cache is just dropped.
+ */
+const int MAX_KNOCKOUT_CACHE_RECTS = 64;
+
+KisSelectionSP KisLayerStyleProjectionPlane::Private::fetchKnockoutSelection(const QRect &rect, KritaUtils::ThresholdMode thresholdMode)
+{
+    KisPaintDeviceSP sourceDevice = sourceLayer->projection();
+
+    QMutexLocker l(&knockoutCacheLock);
+
+    /**
+     * The devices of different levels of detail share the same object,
+     * so we cache only the full-size data
+     */
+    const bool canCache = sourceDevice->defaultBounds()->currentLevelOfDetail() == 0;
+
+    if (!knockoutSelection ||
+        !canCache ||
+        thresholdMode != knockoutThresholdMode ||
+        !knockoutSourceDevice.isValid() ||
+        knockoutSourceDevice != sourceDevice.data() ||
+        knockoutValidRegion.rectCount() > MAX_KNOCKOUT_CACHE_RECTS) {
+
+        knockoutSelection = new KisSelection(new KisSelectionEmptyBounds(0));
+        knockoutValidRegion = QRegion();
+        knockoutThresholdMode = thresholdMode;
+        knockoutSourceDevice = canCache ? sourceDevice.data() : 0;
+    }
+
+    const QRegion dirtyRegion = QRegion(rect) - knockoutValidRegion;
+
+    for (auto it = dirtyRegion.begin(); it != dirtyRegion.end(); ++it) {
+        KisLsUtils::selectionFromAlphaChannel(sourceDevice, knockoutSelection, *it);
+        KritaUtils::thresholdOpacityAlpha8(knockoutSelection->pixelSelection(), *it, thresholdMode);
+    }
+
+    if (canCache) {
+        knockoutValidRegion += dirtyRegion;
+    }
+
+    return knockoutSelection;
+}
+
+void KisLayerStyleProjectionPlane::Private::invalidateKnockoutSelection(const QRect &rect)
+{
+    QMutexLocker l(&knockoutCacheLock);
+    knockoutValidRegion -= rect;
+}
+
 KisLayerStyleProjectionPlane::KisLayerStyleProjectionPlane(KisLayer *sourceLayer)
     : m_d(new Private)
 {
@@ -224,13 +297,35 @@ QRect KisLayerStyleProjectionPlane::recalculate(const QRect& rect, KisNodeSP fil
     QRect result = rect;
 
     if (m_d->style->isEnabled()) {
-        result = sourcePlane->recalculate(stylesNeedRect(rect), filthyNode);
+        const QRect sourceRect = stylesNeedRect(rect);
+        result = sourcePlane->recalculate(sourceRect, filthyNode);
+        m_d->invalidateKnockoutSelection(sourceRect);
+
+        /**
+         * Every style renders into its own projection, so the styles
+         * (and their blurs) can be calculated concurrently. When called
+         * from a worker thread, the idle workers pick some of them up.
+         */
+        QVector<std::function<void()>> jobs;
 
         Q_FOREACH (const KisAbstractProjectionPlaneSP plane, m_d->allStyles()) {
-            plane->recalculate(rect, filthyNode);
+            jobs << [plane, rect, filthyNode] () {
+                plane->recalculate(rect, filthyNode);
+            };
+        }
+
+        KisWorkStealingExecutor *executor = KisWorkStealingExecutor::currentExecutor();
+
+        if (executor) {
+            executor->runParallelJobs(jobs);
+        } else {
+            Q_FOREACH (const std::function<void()> &job, jobs) {
+                job();
+            }
         }
     } else {
         result = sourcePlane->recalculate(rect, filthyNode);
+        m_d->invalidateKnockoutSelection(rect);
     }
 
     return result;
@@ -277,9 +372,8 @@ void KisLayerStyleProjectionPlane::apply(KisPainter *painter, const QRect &rect)
                 KritaUtils::ThresholdNone;
 
             if (m_d->hasOverlayStyles()) {
-                KisCachedSelection::Guard s1(m_d->cachedSelection);
-                KisSelectionSP knockoutSelection = s1.selection();
-                KisLsUtils::selectionFromAlphaChannel(m_d->sourceLayer->projection(), knockoutSelection, rect);
+                KisSelectionSP knockoutSelection =
+                    m_d->fetchKnockoutSelection(rect, sourceThresholdMode);
 
                 KisCachedPaintDevice::Guard d2(painter->device(), m_d->cachedPaintDevice);
                 KisPaintDeviceSP sourceProjection = d2.device();
@@ -294,8 +388,6 @@ void KisLayerStyleProjectionPlane::apply(KisPainter *painter, const QRect &rect)
                     }
                 }
 
-                KritaUtils::thresholdOpacityAlpha8(knockoutSelection->pixelSelection(), rect, sourceThresholdMode);
-
                 KisLayerStyleKnockoutBlower blower;
                 blower.setKnockoutSelection(knockoutSelection);
                 blower.apply(painter, sourceProjection, rect);
@@ -12,6 +12,7 @@
 #include <cstdlib>
 
 #include <QBitArray>
+#include <QScopedPointer>
 
 #include <KoUpdater.h>
 #include <resources/KoPattern.h>
@@ -130,22 +131,43 @@ struct ShadowsFetchOp {
     }
 };
 
+template <class MapOp>
+struct PixelValuesMap {
+    PixelValuesMap(MapOp mapOp) {
+        for (int i = 0; i < 256; i++) {
+            values[i] = mapOp(i);
+        }
+    }
+
+    quint8 values[256];
+};
+
+/**
+ * The styles of the layer may be rendered concurrently, so the
+ * shared table is generated only once, during the thread-safe
+ * initialization of the static, and the tables of the configurable
+ * operations are not shared at all.
+ */
+template <class MapOp>
+const quint8* pixelValuesMap(MapOp mapOp, QScopedPointer<PixelValuesMap<MapOp>> &localMap)
+{
+    if (MapOp::supportsCaching) {
+        static const PixelValuesMap<MapOp> cachedMap(mapOp);
+        return cachedMap.values;
+    }
+
+    localMap.reset(new PixelValuesMap<MapOp>(mapOp));
+    return localMap->values;
+}
+
 template <class MapOp>
 void mapPixelValues(KisPixelSelectionSP srcSelection,
                     KisPixelSelectionSP dstSelection,
                     MapOp mapOp,
                     const QRect &applyRect)
 {
-    static quint8 mapTable[256];
-    static bool mapInitialized = false;
-
-    if (!MapOp::supportsCaching || !mapInitialized) {
-        mapInitialized = true;
-
-        for (int i = 0; i < 256; i++) {
-            mapTable[i] = mapOp(i);
-        }
-    }
+    QScopedPointer<PixelValuesMap<MapOp>> localMap;
+    const quint8 *mapTable = pixelValuesMap(mapOp, localMap);
 
     KisSequentialConstIterator srcIt(srcSelection, applyRect);
     KisSequentialIterator dstIt(dstSelection, applyRect);
@@ -162,16 +184,8 @@ void mapPixelValues(KisPixelSelectionSP dstSelection,
                     MapOp mapOp,
                     const QRect &applyRect)
 {
-    static quint8 mapTable[256];
-    static bool mapInitialized = false;
-
-    if (!MapOp::supportsCaching || !mapInitialized) {
-        mapInitialized = true;
-
-        for (int i = 0; i < 256; i++) {
-            mapTable[i] = mapOp(i);
-        }
-    }
+    QScopedPointer<PixelValuesMap<MapOp>> localMap;
+    const quint8 *mapTable = pixelValuesMap(mapOp, localMap);
 
     KisSequentialIterator dstIt(dstSelection, applyRect);
 
@@ -31,6 +31,7 @@
 
 #include "kis_image_config.h"
 #include "KisImageConfigNotifier.h"
+#include "KisBelowStackCache.h"
 
 void KisAsyncMergerTest::init()
 {
@@ -496,6 +497,121 @@ void KisAsyncMergerTest::testFilterMaskOnFilterLayer()
                                   "async_merger_test", "mask_on_adj", "initial", 3));
 }
 
+    /*
+      +-----------+
+      |root       |
+      | group     |
+      |  paint 5  |
+      |  paint 4  |
+      |  paint 3  |
+      |  paint 2  |
+      |  paint 1  |
+      +-----------+
+     */
+
+void KisAsyncMergerTest::testBelowStackCache()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, colorSpace, "below stack cache test");
+
+    KisLayerSP groupLayer = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    image->addNode(groupLayer, image->rootLayer());
+
+    const QVector<QColor> colors({Qt::white, Qt::red, Qt::green, Qt::blue, Qt::yellow});
+    QVector<KisLayerSP> layers;
+
+    for (int i = 0; i < colors.size(); i++) {
+        KisPaintDeviceSP device = new KisPaintDevice(colorSpace);
+        device->fill(QRect(i * 20, i * 20, 160, 160), KoColor(colors[i], colorSpace));
+
+        KisLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i + 1), OPACITY_OPAQUE_U8 / 2, device);
+        image->addNode(layer, groupLayer);
+        layers << layer;
+    }
+
+    image->initialRefreshGraph();
+
+    KisGroupLayer *group = qobject_cast<KisGroupLayer*>(groupLayer.data());
+    KisBelowStackCache *cache = group->belowStackCache();
+    cache->invalidateAll();
+
+    KisLayerSP topLayer = layers.last();
+    const QRect rect(64, 64, 128, 128);
+
+    auto mergeLayer = [image] (KisLayerSP layer, const QRect &rc) {
+        KisMergeWalker walker(image->bounds());
+        KisAsyncMerger merger;
+        walker.collectRects(layer, rc);
+        merger.startMerge(walker);
+    };
+
+    auto uncachedGroupImage = [&] () {
+        KisBelowStackCache::setEnabled(false);
+        mergeLayer(topLayer, image->bounds());
+        KisBelowStackCache::setEnabled(true);
+        return groupLayer->original()->convertToQImage(0, image->bounds());
+    };
+
+    // the first update fills the cache...
+    mergeLayer(topLayer, rect);
+    QVERIFY(cache->pivot() == KisNodeSP(topLayer));
+
+    // ... and the next ones use it
+    topLayer->paintDevice()->fill(rect, KoColor(Qt::cyan, colorSpace));
+    mergeLayer(topLayer, rect);
+
+    QImage result = groupLayer->original()->convertToQImage(0, image->bounds());
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImages(pt, uncachedGroupImage(), result));
+
+    // a change below the pivot should invalidate the cache
+    layers[1]->paintDevice()->fill(rect, KoColor(Qt::magenta, colorSpace));
+    mergeLayer(layers[1], rect);
+
+    mergeLayer(topLayer, rect);
+    result = groupLayer->original()->convertToQImage(0, image->bounds());
+    QVERIFY(TestUtil::compareQImages(pt, uncachedGroupImage(), result));
+
+    // the graph changes drop the cache
+    mergeLayer(topLayer, rect);
+    image->removeNode(layers[2]);
+    image->waitForDone();
+
+    mergeLayer(topLayer, rect);
+    result = groupLayer->original()->convertToQImage(0, image->bounds());
+    QVERIFY(TestUtil::compareQImages(pt, uncachedGroupImage(), result));
+}
+
+void KisAsyncMergerTest::testBelowStackCachePivotLifetime()
+{
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, colorSpace, "below stack cache pivot test");
+
+    const QRect rect(0, 0, 64, 64);
+    KisPaintDeviceSP src = new KisPaintDevice(colorSpace);
+    src->fill(rect, KoColor(Qt::red, colorSpace));
+    KisPaintDeviceSP dst = new KisPaintDevice(colorSpace);
+
+    KisBelowStackCache cache;
+
+    KisNodeSP pivot = new KisPaintLayer(image, "pivot", OPACITY_OPAQUE_U8);
+    cache.store(pivot, 1, rect, src);
+    QVERIFY(cache.load(pivot, 1, rect, dst));
+
+    // invalidating everything empties the cache
+    cache.invalidate(rect);
+    QVERIFY(!cache.load(pivot, 1, rect, dst));
+
+    cache.store(pivot, 1, rect, src);
+    QVERIFY(cache.load(pivot, 1, rect, dst));
+
+    // a deleted pivot never matches, even if its address is reused
+    pivot = 0;
+    QVERIFY(!cache.pivot());
+
+    KisNodeSP newPivot = new KisPaintLayer(image, "new pivot", OPACITY_OPAQUE_U8);
+    QVERIFY(!cache.load(newPivot, 1, rect, dst));
+}
 
 SIMPLE_TEST_MAIN(KisAsyncMergerTest)
 
@@ -164,6 +164,230 @@ void KisImageTest::testBlockLevelOfDetail()
     }
 }
 
+#include <QMutex>
+#include "KisRunnableBasedStrokeStrategy.h"
+
+class LodPreviewStrokeStrategy : public KisRunnableBasedStrokeStrategy
+{
+public:
+    struct Patch {
+        int strokeLod;
+        int deviceLod;
+        QRect rect;
+    };
+
+    LodPreviewStrokeStrategy(KisPaintDeviceSP device, const QRect &rect,
+                             QVector<Patch> *patches, QMutex *patchesLock)
+        : KisRunnableBasedStrokeStrategy(QLatin1String("LodPreviewStrokeStrategy")),
+          m_device(device),
+          m_rect(rect),
+          m_patches(patches),
+          m_patchesLock(patchesLock)
+    {
+        enableJob(JOB_INIT);
+        enableJob(JOB_DOSTROKE);
+        enableLodPreview();
+    }
+
+    void initStrokeCallback() override {
+        QVector<KisStrokeJobData*> jobs;
+
+        addTiledJobs(jobs, m_rect,
+                     [this] (const QRect &rc) {
+                         QMutexLocker l(m_patchesLock);
+                         m_patches->append({previewLevelOfDetail(),
+                                            m_device->defaultBounds()->currentLevelOfDetail(),
+                                            rc});
+                     },
+                     QSize(64, 64));
+
+        addMutatedJobs(jobs);
+    }
+
+protected:
+    KisRunnableBasedStrokeStrategy* createLodPreviewClone(int levelOfDetail) override {
+        Q_UNUSED(levelOfDetail);
+        return new LodPreviewStrokeStrategy(*this);
+    }
+
+private:
+    KisPaintDeviceSP m_device;
+    QRect m_rect;
+    QVector<Patch> *m_patches;
+    QMutex *m_patchesLock;
+};
+
+void KisImageTest::testRunnableStrokeLodPreview()
+{
+    TestUtil::MaskParent p;
+
+    testingSetOldDesiredLevelOfDetail(p.image, 2);
+    p.image->waitForDone();
+
+    QVector<LodPreviewStrokeStrategy::Patch> patches;
+    QMutex patchesLock;
+
+    const QRect rect(0, 0, 256, 256);
+
+    KisStrokeId id = p.image->startStroke(
+        new LodPreviewStrokeStrategy(p.layer->paintDevice(), rect, &patches, &patchesLock));
+    p.image->endStroke(id);
+    p.image->waitForDone();
+
+    QRegion previewRegion;
+    QRegion fullRegion;
+
+    Q_FOREACH (const LodPreviewStrokeStrategy::Patch &patch, patches) {
+        QCOMPARE(patch.deviceLod, patch.strokeLod);
+
+        if (patch.strokeLod == 2) {
+            QVERIFY(fullRegion.isEmpty());
+            previewRegion += patch.rect;
+        } else {
+            QCOMPARE(patch.strokeLod, 0);
+            QVERIFY(patch.rect.width() <= 64 && patch.rect.height() <= 64);
+            fullRegion += patch.rect;
+        }
+    }
+
+    // the preview is rendered first, then the full-resolution result
+    QCOMPARE(previewRegion, QRegion(QRect(0, 0, 64, 64)));
+    QCOMPARE(fullRegion, QRegion(rect));
+}
+
+#include "generator/kis_generator.h"
+#include "generator/kis_generator_layer.h"
+#include "generator/kis_generator_registry.h"
+#include "kis_processing_information.h"
+
+class LodPreviewGenerator : public KisGenerator
+{
+public:
+    struct Patch {
+        int deviceLod;
+        QRect rect;
+    };
+
+    LodPreviewGenerator()
+        : KisGenerator(KoID("lod_preview_generator"), KoID("basic"), "LoD preview generator")
+    {
+    }
+
+    void generate(KisProcessingInformation dst,
+                  const QSize& size,
+                  const KisFilterConfigurationSP config,
+                  KoUpdater* progressUpdater) const override
+    {
+        Q_UNUSED(config);
+        Q_UNUSED(progressUpdater);
+
+        KisPaintDeviceSP dev = dst.paintDevice();
+        const QRect rc(dst.topLeft(), size);
+
+        dev->fill(rc, KoColor(Qt::red, dev->colorSpace()));
+
+        QMutexLocker l(&patchesLock);
+        patches.append({dev->defaultBounds()->currentLevelOfDetail(), rc});
+    }
+
+    bool supportsLevelOfDetail(const KisFilterConfigurationSP config, int lod) const override
+    {
+        Q_UNUSED(lod);
+        return config->getBool("supportsLod");
+    }
+
+    mutable QVector<Patch> patches;
+    mutable QMutex patchesLock;
+};
+
+void KisImageTest::testGeneratorStrokeLodPreview()
+{
+    LodPreviewGenerator *generator = new LodPreviewGenerator();
+    KisGeneratorRegistry::instance()->add(generator);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 256, 256);
+
+    auto renderLayer = [&] (const KisLodPreferences &preferences, bool supportsLod) {
+        generator->patches.clear();
+
+        KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "test");
+        image->setLodPreferences(preferences);
+        image->waitForDone();
+
+        KisFilterConfigurationSP config =
+            new KisFilterConfiguration(generator->id(), 1, KisGlobalResourcesInterface::instance());
+        config->setProperty("supportsLod", supportsLod);
+
+        KisGeneratorLayerSP layer = new KisGeneratorLayer(image, "fill", config, 0);
+        image->addNode(layer);
+        image->waitForDone();
+
+        layer->update();
+        image->waitForDone();
+
+        QRegion previewRegion;
+        QRegion fullRegion;
+
+        Q_FOREACH (const LodPreviewGenerator::Patch &patch, generator->patches) {
+            if (patch.deviceLod == 2) {
+                // the preview is rendered first
+                KIS_ASSERT(fullRegion.isEmpty());
+                previewRegion += patch.rect;
+            } else {
+                KIS_ASSERT(patch.deviceLod == 0);
+                fullRegion += patch.rect;
+            }
+        }
+
+        KIS_ASSERT(fullRegion == QRegion(imageRect));
+        KIS_ASSERT(layer->original()->exactBounds() == imageRect);
+
+        return previewRegion;
+    };
+
+    // the preview is rendered only when instant preview is preferred...
+    QCOMPARE(renderLayer(KisLodPreferences(2), true), QRegion(QRect(0, 0, 64, 64)));
+    QCOMPARE(renderLayer(KisLodPreferences(KisLodPreferences::LodSupported, 2), true), QRegion());
+
+    // ... and the generator can render at the reduced resolution
+    QCOMPARE(renderLayer(KisLodPreferences(2), false), QRegion());
+}
+
+#include "KisBatchNodeUpdate.h"
+
+void KisImageTest::testBatchRefreshNullNode()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 256, 256, cs, "test");
+
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+
+    image->addNode(layer1);
+    image->addNode(layer2);
+    image->waitForDone();
+
+    const QRect rect1(0, 0, 64, 64);
+    const QRect rect2(128, 128, 64, 64);
+
+    // change the layers without issuing any updates
+    layer1->paintDevice()->fill(rect1, KoColor(Qt::red, cs));
+    layer2->paintDevice()->fill(rect2, KoColor(Qt::green, cs));
+
+    QCOMPARE(image->projection()->exactBounds(), QRect());
+
+    KisBatchNodeUpdate updates;
+    updates.addUpdate(KisNodeSP(), rect1);
+    updates.addUpdate(layer2, rect2);
+
+    // the null node is refreshed as the root layer
+    image->refreshGraphAsync(updates);
+    image->waitForDone();
+
+    QCOMPARE(image->projection()->exactBounds(), rect1 | rect2);
+}
+
 void KisImageTest::testConvertImageColorSpace()
 {
     const KoColorSpace *cs8 = KoColorSpaceRegistry::instance()->rgb8();
@@ -19,6 +19,9 @@ private Q_SLOTS:
     void layerTests();
     void benchmarkCreation();
     void testBlockLevelOfDetail();
+    void testRunnableStrokeLodPreview();
+    void testGeneratorStrokeLodPreview();
+    void testBatchRefreshNullNode();
     void testConvertImageColorSpace();
     void testAssignImageProfile();
     void testGlobalSelection();
@@ -659,4 +659,65 @@ void KisLayerStyleProjectionPlaneTest::testBlending()
     KIS_DUMP_DEVICE_2(originalBg, rc, "04_knockout", "dd");
 }
 
+void KisLayerStyleProjectionPlaneTest::testKnockoutCache()
+{
+    const QRect imageRect(0, 0, 200, 200);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "styles test");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+    style->colorOverlay()->setOpacity(80);
+    style->colorOverlay()->setEffectEnabled(true);
+    style->colorOverlay()->setColor(KoColor(Qt::white, cs));
+    style->colorOverlay()->setBlendMode(COMPOSITE_LINEAR_DODGE);
+    style->dropShadow()->setEffectEnabled(true);
+    style->dropShadow()->setSize(10);
+
+    auto paintEllipse = [layer, cs] (const QRect &rc) {
+        KisPainter gc(layer->paintDevice());
+        gc.setPaintColor(KoColor(Qt::red, cs));
+        gc.setFillStyle(KisPainter::FillStyleForegroundColor);
+        gc.paintEllipse(rc);
+    };
+
+    auto applyPlane = [cs] (KisLayerStyleProjectionPlane &plane, const QRect &rc) {
+        KisPaintDeviceSP projection = new KisPaintDevice(cs);
+        KisPainter painter(projection);
+        plane.apply(&painter, rc);
+        return projection;
+    };
+
+    paintEllipse(QRect(10, 10, 100, 100));
+
+    KisLayerStyleProjectionPlane plane(layer.data(), style);
+    plane.recalculate(imageRect, layer);
+
+    KisPaintDeviceSP projection1 = applyPlane(plane, imageRect);
+
+    // the second pass reuses the cached knockout selection
+    KisPaintDeviceSP projection2 = applyPlane(plane, imageRect);
+
+    QPoint pt;
+    QVERIFY(TestUtil::comparePaintDevices(pt, projection1, projection2));
+
+    // change the layer and update the dirty area only
+    const QRect dirtyRect(80, 80, 60, 60);
+    paintEllipse(dirtyRect);
+    plane.recalculate(plane.changeRect(dirtyRect, KisLayer::N_FILTHY), layer);
+
+    KisPaintDeviceSP updatedProjection = applyPlane(plane, imageRect);
+
+    KisLayerStyleProjectionPlane referencePlane(layer.data(), style);
+    referencePlane.recalculate(imageRect, layer);
+
+    KisPaintDeviceSP referenceProjection = applyPlane(referencePlane, imageRect);
+
+    QVERIFY(TestUtil::comparePaintDevices(pt, updatedProjection, referenceProjection));
+    QVERIFY(!TestUtil::comparePaintDevices(pt, projection1, referenceProjection));
+}
+
 KISTEST_MAIN(KisLayerStyleProjectionPlaneTest)
@@ -36,6 +36,8 @@ private Q_SLOTS:
 
     void testBlending();
 
+    void testKnockoutCache();
+
 private:
     void test(KisPSDLayerStyleSP style, const QString testName);
 
@@ -22,6 +22,9 @@
 
 #include "kis_update_job_item.h"
 #include "kis_simple_update_queue.h"
+#include "KisBatchNodeUpdate.h"
+#include "kis_image_config.h"
+#include "KisUpdateCostModel.h"
 #include "scheduler_utils.h"
 #include <KisGlobalResourcesInterface.h>
 
@@ -140,6 +143,76 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testAdaptivePatchSize()
+{
+    const QSize maxSize(512, 512);
+
+    // cheap updates use the default patch size
+    QCOMPARE(KisUpdateCostModel::adaptivePatchSize(1.0, maxSize, 16.0), maxSize);
+    QCOMPARE(KisUpdateCostModel::adaptivePatchSize(16.0, maxSize, 16.0), maxSize);
+
+    // 4x more expensive updates get patches of 1/4 of the area
+    QCOMPARE(KisUpdateCostModel::adaptivePatchSize(64.0, maxSize, 16.0), QSize(256, 256));
+
+    // the patches are aligned to the tiles and are never smaller than a tile
+    QCOMPARE(KisUpdateCostModel::adaptivePatchSize(32.0, maxSize, 16.0), QSize(320, 320));
+    QCOMPARE(KisUpdateCostModel::adaptivePatchSize(1e6, maxSize, 16.0), QSize(64, 64));
+}
+
+void KisSimpleUpdateQueueTest::testAdaptiveSplit()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+    QVERIFY(filter);
+    KisFilterConfigurationSP configuration = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    KisAdjustmentLayerSP adjustmentLayer = new KisAdjustmentLayer(image, "adj", configuration->cloneWithResourcesSnapshot(), 0);
+
+    image->barrierLock();
+    image->addNode(paintLayer, image->rootLayer());
+    image->addNode(adjustmentLayer, image->rootLayer());
+    image->unlock();
+
+    KisImageConfig config(false);
+    const qreal oldReferenceCost = config.updatePatchReferenceCost();
+    config.setUpdatePatchReferenceCost(1.0);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, QRect(0,0,1000,1000), imageRect, 0);
+
+    config.setUpdatePatchReferenceCost(oldReferenceCost);
+
+    // the blur makes the update expensive, so it is split into smaller patches
+    QVERIFY(walkersList.size() > 4);
+
+    QRect coveredRect;
+
+    Q_FOREACH (KisBaseRectsWalkerSP walker, walkersList) {
+        QVERIFY(walker->requestedRect().width() < 512);
+        QVERIFY(walker->requestedRect().height() < 512);
+        coveredRect |= walker->requestedRect();
+    }
+
+    QCOMPARE(coveredRect, QRect(0,0,1000,1000));
+
+    // the cost is estimated once, when the walkers are collected
+    Q_FOREACH (KisBaseRectsWalkerSP walker, walkersList) {
+        QVERIFY(walker->costDensity() > 1.0);
+    }
+
+    // and the patches are not merged back
+    const int numWalkers = walkersList.size();
+    queue.optimize();
+    QCOMPARE(walkersList.size(), numWalkers);
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -234,6 +307,122 @@ void KisSimpleUpdateQueueTest::testMixingTypes()
     QCOMPARE(walkersList[3]->type(), KisBaseRectsWalker::FULL_REFRESH_NO_FILTHY);
 }
 
+void KisSimpleUpdateQueueTest::testUpdatePriority()
+{
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect backgroundRect(0,0,50,50);
+    QRect strokeRect(200,0,50,50);
+    QRect viewportRect(400,400,50,50);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, backgroundRect, imageRect, 0);
+    queue.addUpdateJob(paintLayer, strokeRect, imageRect, 0);
+    queue.addUpdateJob(paintLayer, viewportRect, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 3);
+
+    // the updates requested from outside the stroke jobs have no priority
+    QVERIFY(!walkersList[1]->isStrokeUpdate());
+    walkersList[1]->setStrokeUpdate(true);
+
+    queue.setPriorityRects({QRect(380,380,100,100)});
+
+    QVector<QRect> expectedOrder({viewportRect, strokeRect, backgroundRect});
+
+    Q_FOREACH (const QRect &rc, expectedOrder) {
+        KisTestableUpdaterContext context(1);
+
+        queue.processQueue(context);
+
+        QVector<KisUpdateJobItem*> jobs = context.getJobs();
+        QCOMPARE(jobs.size(), 1);
+        QVERIFY(checkWalker(jobs[0]->walker(), rc));
+    }
+
+    QVERIFY(queue.isEmpty());
+}
+
+void KisSimpleUpdateQueueTest::testBatchRefresh()
+{
+    QRect imageRect(0,0,512,512);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisGroupLayerSP groupLayer = new KisGroupLayer(image, "group", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP paintLayer3 = new KisPaintLayer(image, "paint3", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(groupLayer, image->rootLayer());
+    image->addNode(paintLayer1, groupLayer);
+    image->addNode(paintLayer2, groupLayer);
+    image->addNode(paintLayer3, groupLayer);
+    image->unlock();
+
+    KisBatchNodeUpdate updates;
+    updates.addUpdate(paintLayer1, QRect(0,0,50,50));
+    updates.addUpdate(paintLayer3, QRect(60,0,50,50));
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addBatchRefreshJob(updates, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 1);
+    QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::BATCH_REFRESH);
+    QCOMPARE(walkersList[0]->startNode(), KisNodeSP(groupLayer));
+    QCOMPARE(walkersList[0]->requestedRect(), QRect(0,0,110,50));
+
+    int numPaintLayers = 0;
+
+    Q_FOREACH (const KisBaseRectsWalker::JobItem &item, walkersList[0]->leafStack()) {
+        KisNodeSP node = item.m_leaf->node();
+
+        if (node == paintLayer1 || node == paintLayer3) {
+            QVERIFY(item.m_position & KisBaseRectsWalker::N_FILTHY);
+            numPaintLayers++;
+        } else if (node == paintLayer2) {
+            QVERIFY(item.m_position & KisBaseRectsWalker::N_ABOVE_FILTHY);
+            numPaintLayers++;
+        }
+    }
+
+    QCOMPARE(numPaintLayers, 3);
+
+    // the batch walkers are never merged with the usual ones
+    queue.addFullRefreshJob(groupLayer, QRect(0,0,50,50), imageRect, 0);
+    queue.optimize();
+
+    QCOMPARE(walkersList.size(), 2);
+
+    // a batch of a single node is a usual full refresh
+    walkersList.clear();
+
+    KisBatchNodeUpdate singleUpdate;
+    singleUpdate.addUpdate(paintLayer2, QRect(0,0,50,50));
+    singleUpdate.addUpdate(paintLayer3, QRect());
+
+    queue.addBatchRefreshJob(singleUpdate, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 1);
+    QCOMPARE(walkersList[0]->type(), KisBaseRectsWalker::FULL_REFRESH);
+    QCOMPARE(walkersList[0]->startNode(), KisNodeSP(paintLayer2));
+}
+
 void KisSimpleUpdateQueueTest::testSpontaneousJobsCompression()
 {
     KisTestableSimpleUpdateQueue queue;
@@ -21,8 +21,12 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testAdaptivePatchSize();
+    void testAdaptiveSplit();
     void testChecksum();
     void testMixingTypes();
+    void testUpdatePriority();
+    void testBatchRefresh();
     void testSpontaneousJobsCompression();
 };
 
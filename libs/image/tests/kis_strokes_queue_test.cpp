@@ -345,6 +345,61 @@ void KisStrokesQueueTest::testOpenedStrokeCounter()
     queue.processQueue(context, false); context.clear();
 }
 
+void KisStrokesQueueTest::testQueueStatistics()
+{
+    KisStrokesQueue queue;
+
+    KisStrokesQueueStatistics stats = queue.statistics();
+    QCOMPARE(stats.numStrokes, 0);
+    QCOMPARE(stats.numPendingJobs, 0);
+    QVERIFY(queue.waitForPendingStrokes(0, 0));
+
+    KisStrokeId id0 = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("0")));
+    queue.addJob(id0, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+    queue.addJob(id0, new KisStrokeJobData(KisStrokeJobData::CONCURRENT));
+
+    KisStrokeId id1 = queue.startStroke(new KisTestingStrokeStrategy(QLatin1String("1")));
+    queue.endStroke(id0);
+
+    int numCompletedStrokes = 0;
+    queue.addStrokeCompletionCallback(id0, [&numCompletedStrokes] () { numCompletedStrokes++; });
+
+    stats = queue.statistics();
+    QCOMPARE(stats.numStrokes, 2);
+    QCOMPARE(stats.numOpenedStrokes, 1);
+    QCOMPARE(stats.numFinishedStrokes, qint64(0));
+
+    // init, two dabs and finish of the first stroke, init of the second one
+    QCOMPARE(stats.numPendingJobs, 5);
+
+    // nobody processes the queue, so the wait times out
+    QVERIFY(!queue.waitForPendingStrokes(1, 10));
+    QVERIFY(queue.waitForPendingStrokes(2, 0));
+
+    KisTestableUpdaterContext context(2);
+    for (int i = 0; i < 4; i++) {
+        queue.processQueue(context, false); context.clear();
+    }
+
+    QCOMPARE(numCompletedStrokes, 1);
+
+    stats = queue.statistics();
+    QCOMPARE(stats.numStrokes, 1);
+    QCOMPARE(stats.numFinishedStrokes, qint64(1));
+    QVERIFY(queue.waitForPendingStrokes(1, 0));
+
+    // the callback for a finished stroke is called immediately
+    queue.addStrokeCompletionCallback(id0, [&numCompletedStrokes] () { numCompletedStrokes++; });
+    QCOMPARE(numCompletedStrokes, 2);
+
+    queue.endStroke(id1);
+    queue.processQueue(context, false); context.clear();
+    queue.processQueue(context, false); context.clear();
+
+    QCOMPARE(queue.statistics().numStrokes, 0);
+    QCOMPARE(queue.statistics().numFinishedStrokes, qint64(2));
+}
+
 void KisStrokesQueueTest::testAsyncCancelWhileOpenedStroke()
 {
     KisStrokesQueue queue;
@@ -23,6 +23,7 @@ private Q_SLOTS:
     void testStrokesOverlapping();
     void testImmediateCancel();
     void testOpenedStrokeCounter();
+    void testQueueStatistics();
     void testAsyncCancelWhileOpenedStroke();
     void testStrokesLevelOfDetail();
     void testStrokeWithMixedLodJobs();
@@ -22,6 +22,7 @@
 #include "kis_clone_layer.h"
 #include "kis_group_layer.h"
 #include "kis_paint_device_debug_utils.h"
+#include "kis_recalculate_transform_mask_job.h"
 
 
 
@@ -966,4 +967,103 @@ void KisTransformMaskTest::testTransformHiddenPartsOfTheGroup()
     //KIS_DUMP_DEVICE_2(p.image->projection(), imageRect, "image_proj_mask", "dd");
 }
 
+void KisTransformMaskTest::testIncrementalStaticImageUpdate()
+{
+    QRect refRect(0,0,512,512);
+    TestUtil::MaskParent p(refRect);
+    const KoColorSpace *cs = p.layer->colorSpace();
+
+    p.layer->paintDevice()->fill(QRect(50,50,400,400), KoColor(Qt::red, cs));
+
+    const QTransform transform = QTransform::fromTranslate(-20, 10);
+
+    KisTransformMaskSP mask = new KisTransformMask(p.image, "mask");
+    mask->setTransformParams(KisTransformMaskParamsInterfaceSP(
+                                 new KisDumbTransformMaskParams(transform)));
+    p.image->addNode(mask, p.layer);
+
+    p.layer->setDirty(refRect);
+    p.image->waitForDone();
+
+    // the first recalculation is always full
+    p.image->addSpontaneousJob(new KisRecalculateTransformMaskJob(mask));
+    p.image->waitForDone();
+
+    /**
+     * Change the layer in two places, but notify the mask only about one
+     * of them. The incremental update should regenerate only the notified
+     * area.
+     */
+    const QRect untrackedRect(60,60,30,30);
+    const QRect editRect(300,300,30,30);
+
+    p.layer->paintDevice()->fill(untrackedRect, KoColor(Qt::green, cs));
+    p.layer->paintDevice()->fill(editRect, KoColor(Qt::blue, cs));
+    p.layer->setDirty(editRect);
+    p.image->waitForDone();
+
+    p.image->addSpontaneousJob(new KisRecalculateTransformMaskJob(mask));
+    p.image->waitForDone();
+
+    KoColor color;
+    p.layer->projection()->pixel(transform.map(untrackedRect.center()), &color);
+    QCOMPARE(color, KoColor(Qt::red, cs));
+
+    p.layer->projection()->pixel(transform.map(editRect.center()), &color);
+    QCOMPARE(color, KoColor(Qt::blue, cs));
+
+    const QRect checkRect = transform.mapRect(kisGrowRect(editRect, 64));
+    const QImage incrementalImage = p.layer->projection()->convertToQImage(0, checkRect);
+
+    // now regenerate the whole static image and compare the results
+    mask->setTransformParams(KisTransformMaskParamsInterfaceSP(
+                                 new KisDumbTransformMaskParams(transform)));
+    p.image->addSpontaneousJob(new KisRecalculateTransformMaskJob(mask));
+    p.image->waitForDone();
+
+    p.layer->projection()->pixel(transform.map(untrackedRect.center()), &color);
+    QCOMPARE(color, KoColor(Qt::green, cs));
+
+    const QImage fullImage = p.layer->projection()->convertToQImage(0, checkRect);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::compareQImages(errorPoint, incrementalImage, fullImage));
+}
+
+void KisTransformMaskTest::testIncrementalStaticImageUpdatePerspective()
+{
+    QRect refRect(0,0,512,512);
+    TestUtil::MaskParent p(refRect);
+    const KoColorSpace *cs = p.layer->colorSpace();
+
+    p.layer->paintDevice()->fill(QRect(50,50,400,400), KoColor(Qt::red, cs));
+
+    // the dumb params report any transformation as affine
+    QTransform transform;
+    transform.setMatrix(1.0, 0.0, 0.0001,
+                        0.0, 1.0, 0.0,
+                        0.0, 0.0, 1.0);
+
+    KisTransformMaskSP mask = new KisTransformMask(p.image, "mask");
+    mask->setTransformParams(KisTransformMaskParamsInterfaceSP(
+                                 new KisDumbTransformMaskParams(transform)));
+    p.image->addNode(mask, p.layer);
+
+    p.layer->setDirty(refRect);
+    p.image->waitForDone();
+
+    p.image->addSpontaneousJob(new KisRecalculateTransformMaskJob(mask));
+    p.image->waitForDone();
+
+    const QRect editRect(300,300,30,30);
+    p.layer->paintDevice()->fill(editRect, KoColor(Qt::blue, cs));
+    p.layer->setDirty(editRect);
+    p.image->waitForDone();
+
+    // the filter support is not bounded for perspective transformations
+    QVector<QRect> updatedRects;
+    QVERIFY(!mask->recalculateStaticImageIncrementally(&updatedRects));
+    QVERIFY(updatedRects.isEmpty());
+}
+
 KISTEST_MAIN(KisTransformMaskTest)
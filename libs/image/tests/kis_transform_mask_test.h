@@ -25,6 +25,8 @@ private Q_SLOTS:
 
     void testWeirdFullUpdates();
     void testTransformHiddenPartsOfTheGroup();
+    void testIncrementalStaticImageUpdate();
+    void testIncrementalStaticImageUpdatePerspective();
 };
 
 #endif /* __KIS_TRANSFORM_MASK_TEST_H */
@@ -400,6 +400,74 @@ void KisUpdateSchedulerTest::testTimeMonitor()
     KisUpdateTimeMonitor::instance()->endStrokeMeasure();
 }
 
+#include "KisPerfTracer.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+void KisUpdateSchedulerTest::testPerfTracer()
+{
+    const QString traceFile = QString(FILES_OUTPUT_DIR) + '/' + "scheduler_perf_trace.json";
+
+    KisPerfTracer *tracer = KisPerfTracer::instance();
+    tracer->setTraceFile(traceFile);
+    QVERIFY(tracer->isEnabled());
+
+    KisImageSP image = buildTestingImage();
+    KisNodeSP rootLayer = image->rootLayer();
+    KisNodeSP paintLayer1 = rootLayer->firstChild();
+
+    QCOMPARE(paintLayer1->name(), QString("paint1"));
+
+    KisUpdateScheduler scheduler(image.data());
+
+    scheduler.updateProjection(paintLayer1, QRect(0,0,100,100), image->bounds());
+
+    KisStrokeId id = scheduler.startStroke(new KisTestingStrokeStrategy(QLatin1String("trace_")));
+    scheduler.addJob(id, new KisTestingStrokeJobData());
+    scheduler.endStroke(id);
+
+    scheduler.waitForDone();
+
+    QVERIFY(tracer->stop());
+    QVERIFY(!tracer->isEnabled());
+
+    QFile file(traceFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    const QJsonArray events =
+        QJsonDocument::fromJson(file.readAll()).object()["traceEvents"].toArray();
+
+    bool hasMergeEvent = false;
+    bool hasStrokeEvent = false;
+    bool hasStrokeJobEvent = false;
+
+    Q_FOREACH (const QJsonValue &value, events) {
+        const QJsonObject event = value.toObject();
+        if (event["ph"].toString() != "X") continue;
+
+        const QString category = event["cat"].toString();
+        const QString name = event["name"].toString();
+        const QJsonObject args = event["args"].toObject();
+
+        if (category == "update" && name == "merge" &&
+            args["node"].toString() == "paint1") {
+
+            QVERIFY(args["area"].toDouble() > 0);
+            hasMergeEvent = true;
+        }
+
+        if (category == "stroke") {
+            hasStrokeEvent |= name == "trace_";
+            hasStrokeJobEvent |= name == "KisNoopDabStrategy";
+        }
+    }
+
+    QVERIFY(hasMergeEvent);
+    QVERIFY(hasStrokeEvent);
+    QVERIFY(hasStrokeJobEvent);
+}
+
 void KisUpdateSchedulerTest::testLodSync()
 {
     KisImageSP image = buildTestingImage();
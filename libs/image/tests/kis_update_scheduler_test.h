@@ -28,6 +28,7 @@ private Q_SLOTS:
     void testBlockUpdates();
 
     void testTimeMonitor();
+    void testPerfTracer();
 
     void testLodSync();
 };
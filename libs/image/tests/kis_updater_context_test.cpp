@@ -10,6 +10,8 @@
 #include "kistest.h"
 
 #include <QAtomicInt>
+#include <QMutex>
+#include <QRunnable>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -17,6 +19,10 @@
 
 #include "kis_merge_walker.h"
 #include "kis_updater_context.h"
+#include "kis_update_job_item.h"
+#include "KisUpdaterThreadAffinity.h"
+#include "KisWorkStealingExecutor.h"
+#include "krita_utils.h"
 #include "kis_image.h"
 
 #include "scheduler_utils.h"
@@ -85,6 +91,258 @@ void KisUpdaterContextTest::testJobInterference()
     }
 }
 
+void KisUpdaterContextTest::testThreadAffinitySlots()
+{
+    KisTestableUpdaterContext context(4);
+    context.setThreadAffinityEnabled(true);
+
+    QRect imageRect(0,0,1000,1200);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    const int stripe = KisUpdaterThreadAffinity::STRIPE_HEIGHT;
+
+    QCOMPARE(KisUpdaterThreadAffinity::preferredSlot(QRect(0, 2 * stripe, 10, 10), 4), 2);
+    QCOMPARE(KisUpdaterThreadAffinity::preferredSlot(QRect(0, 5 * stripe, 10, 10), 4), 1);
+    QCOMPARE(KisUpdaterThreadAffinity::preferredSlot(QRect(0, -stripe, 10, 10), 4), 3);
+
+    // the job goes into the slot of its stripe...
+    KisBaseRectsWalkerSP walker1 = new KisMergeWalker(imageRect);
+    walker1->collectRects(paintLayer, QRect(0, 2 * stripe, 100, 100));
+
+    context.lock();
+    context.addMergeJob(walker1);
+    context.unlock();
+
+    QVERIFY(context.getJobs()[2]->isRunning());
+    QVERIFY(!context.getJobs()[0]->isRunning());
+
+    // ... or into the next spare one if the slot is busy
+    KisBaseRectsWalkerSP walker2 = new KisMergeWalker(imageRect);
+    walker2->collectRects(paintLayer, QRect(500, 2 * stripe, 100, 100));
+
+    context.lock();
+    context.addMergeJob(walker2);
+    context.unlock();
+
+    QVERIFY(context.getJobs()[3]->isRunning());
+    QVERIFY(!context.getJobs()[0]->isRunning());
+}
+
+namespace {
+
+class CountingRunnable : public QRunnable
+{
+public:
+    CountingRunnable(KisWorkStealingExecutor *executor, QAtomicInt *counter, int numChildren)
+        : m_executor(executor),
+          m_counter(counter),
+          m_numChildren(numChildren)
+    {
+    }
+
+    void run() override {
+        m_counter->ref();
+
+        // the children go into the deque of the current worker
+        for (int i = 0; i < m_numChildren; i++) {
+            m_executor->start(new CountingRunnable(m_executor, m_counter, 0));
+        }
+    }
+
+private:
+    KisWorkStealingExecutor *m_executor;
+    QAtomicInt *m_counter;
+    int m_numChildren;
+};
+
+}
+
+void KisUpdaterContextTest::testWorkStealingExecutor()
+{
+    KisWorkStealingExecutor executor(4);
+    QCOMPARE(executor.maxThreadCount(), 4);
+
+    QAtomicInt counter;
+
+    const int numParents = 100;
+    const int numChildren = 10;
+
+    for (int i = 0; i < numParents; i++) {
+        executor.start(new CountingRunnable(&executor, &counter, numChildren));
+    }
+
+    executor.waitForDone();
+    QCOMPARE(counter.loadAcquire(), numParents * (numChildren + 1));
+
+    KisWorkStealingExecutor::Statistics stats = executor.statistics();
+    QCOMPARE(stats.numWorkers, 4);
+    QCOMPARE(stats.numTasks, qint64(numParents * (numChildren + 1)));
+    QVERIFY(stats.utilization() >= 0.0 && stats.utilization() <= 1.0);
+
+    executor.setMaxThreadCount(2);
+    QCOMPARE(executor.maxThreadCount(), 2);
+    QCOMPARE(executor.statistics().numTasks, qint64(0));
+
+    counter.storeRelease(0);
+    executor.start(new CountingRunnable(&executor, &counter, numChildren));
+    executor.waitForDone();
+    QCOMPARE(counter.loadAcquire(), numChildren + 1);
+}
+
+namespace {
+
+class SplitJobRunnable : public QRunnable
+{
+public:
+    SplitJobRunnable(KisWorkStealingExecutor *executor, const QRect &rect, QVector<QRect> *processed, QMutex *lock)
+        : m_executor(executor),
+          m_rect(rect),
+          m_processed(processed),
+          m_lock(lock)
+    {
+    }
+
+    void run() override {
+        m_executor->runSplitJob(m_rect,
+            [this] (const QRect &rc) {
+                // all the patches should be processed by the workers
+                if (KisWorkStealingExecutor::currentExecutor() != m_executor) return;
+
+                QMutexLocker l(m_lock);
+                m_processed->append(rc);
+            });
+    }
+
+private:
+    KisWorkStealingExecutor *m_executor;
+    QRect m_rect;
+    QVector<QRect> *m_processed;
+    QMutex *m_lock;
+};
+
+}
+
+void KisUpdaterContextTest::testWorkStealingSplitJob()
+{
+    KisWorkStealingExecutor executor(4);
+
+    QCOMPARE(KisWorkStealingExecutor::currentExecutor(), (KisWorkStealingExecutor*)0);
+
+    const QRect rect(-10, 20, 500, 300);
+    QVector<QRect> processed;
+    QMutex lock;
+
+    executor.start(new SplitJobRunnable(&executor, rect, &processed, &lock));
+    executor.waitForDone();
+
+    const QVector<QRect> expected =
+        KritaUtils::splitRectIntoPatches(rect, KisWorkStealingExecutor::defaultPatchSize());
+
+    QCOMPARE(processed.size(), expected.size());
+
+    Q_FOREACH (const QRect &rc, expected) {
+        QCOMPARE(processed.count(rc), 1);
+    }
+}
+
+namespace {
+
+class FunctionRunnable : public QRunnable
+{
+public:
+    FunctionRunnable(std::function<void()> func)
+        : m_func(func)
+    {
+    }
+
+    void run() override {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+};
+
+}
+
+void KisUpdaterContextTest::testWorkStealingParallelJobs()
+{
+    KisWorkStealingExecutor executor(4);
+
+    const int numJobs = 10;
+    QAtomicInt counters[numJobs];
+    QAtomicInt numForeignJobs;
+
+    QVector<std::function<void()>> jobs;
+    for (int i = 0; i < numJobs; i++) {
+        jobs << [&executor, &counters, &numForeignJobs, i] () {
+            // all the jobs should be processed by the workers
+            if (KisWorkStealingExecutor::currentExecutor() != &executor) {
+                numForeignJobs.ref();
+            }
+            counters[i].ref();
+        };
+    }
+
+    executor.start(new FunctionRunnable([&executor, &jobs] () { executor.runParallelJobs(jobs); }));
+    executor.waitForDone();
+
+    QCOMPARE(numForeignJobs.loadAcquire(), 0);
+
+    for (int i = 0; i < numJobs; i++) {
+        QCOMPARE(counters[i].loadAcquire(), 1);
+    }
+}
+
+void KisUpdaterContextTest::testWorkStealingSplitJobContext()
+{
+    KisWorkStealingExecutor executor(4);
+
+    const QRect rect(0, 0, 1024, 1024);
+    QAtomicInt numPatches;
+    QAtomicInt numPatchesWithoutContext;
+
+    auto splitJob = [&] () {
+        KisUpdateJobItem::StrokeJobThreadMarker marker(true);
+
+        executor.runSplitJob(rect,
+            [&] (const QRect &) {
+                // the helpers should run in the context of the owner
+                if (!KisUpdateJobItem::currentThreadRunsStrokeJob()) {
+                    numPatchesWithoutContext.ref();
+                }
+                numPatches.ref();
+            });
+    };
+
+    executor.start(new FunctionRunnable(splitJob));
+    executor.waitForDone();
+
+    QCOMPARE(numPatches.loadAcquire(), 16 * 16);
+    QCOMPARE(numPatchesWithoutContext.loadAcquire(), 0);
+
+    // the context doesn't leak into the following tasks
+    QAtomicInt numTasksWithContext;
+    for (int i = 0; i < 16; i++) {
+        executor.start(new FunctionRunnable([&numTasksWithContext] () {
+            if (KisUpdateJobItem::currentThreadRunsStrokeJob()) {
+                numTasksWithContext.ref();
+            }
+        }));
+    }
+    executor.waitForDone();
+
+    QCOMPARE(numTasksWithContext.loadAcquire(), 0);
+}
+
 void KisUpdaterContextTest::testSnapshot()
 {
     KisTestableUpdaterContext context(3);
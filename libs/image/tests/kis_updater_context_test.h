@@ -16,6 +16,11 @@ class KisUpdaterContextTest : public QObject
 private Q_SLOTS:
     void testJobInterference();
     void testSnapshot();
+    void testThreadAffinitySlots();
+    void testWorkStealingExecutor();
+    void testWorkStealingSplitJob();
+    void testWorkStealingParallelJobs();
+    void testWorkStealingSplitJobContext();
     void stressTestExclusiveJobs();
 };
 
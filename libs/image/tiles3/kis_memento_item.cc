@@ -0,0 +1,264 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_memento_item.h"
+
+#include <QMutex>
+#include <QGlobalStatic>
+
+#include "kis_debug.h"
+
+#include "kis_tile_data_store.h"
+#include "swap/kis_lzf_compression.h"
+
+
+/**
+ * The delta links may cross the memento managers of different paint
+ * devices (a device shares its revisions with its copies), so they
+ * cannot be protected by the lock of the data manager. The lock is
+ * recursive, because destruction of a base item materializes its
+ * dependents.
+ */
+Q_GLOBAL_STATIC_WITH_ARGS(QMutex, s_deltaLock, (QMutex::Recursive))
+
+namespace {
+
+inline qint32 tileDataSize(qint32 pixelSize) {
+    return pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+}
+
+inline void xorData(const quint8 *src, quint8 *dst, qint32 size) {
+    for (qint32 i = 0; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+}
+
+bool KisMementoItem::canEncodeDeltaAgainst(KisMementoItem *base) const
+{
+    if (m_deltaBase || !m_committedFlag ||
+        m_type != CHANGED || !m_tileData) {
+
+        return false;
+    }
+
+    // the base must be a full item, we don't chain deltas on encoding
+    if (!base || base == this || base->m_deltaBase || !base->m_tileData) {
+        return false;
+    }
+
+    KisTileData *baseTileData = base->m_tileData;
+
+    if (baseTileData == m_tileData ||
+        baseTileData->pixelSize() != m_tileData->pixelSize()) {
+
+        return false;
+    }
+
+    /**
+     * If the tile data is shared with someone else (e.g. a clone
+     * or a copy of the device), it will not be freed, so there is
+     * no point in encoding it.
+     */
+    if (m_tileData->numUsers() > 1) {
+        return false;
+    }
+
+    return true;
+}
+
+bool KisMementoItem::encodeDelta(KisMementoItem *base)
+{
+    KisTileData *baseTileData = 0;
+    KisTileData *tileData = 0;
+
+    {
+        QMutexLocker l(s_deltaLock);
+
+        if (!canEncodeDeltaAgainst(base)) return false;
+
+        /**
+         * Keep the tile data alive while the delta is computed
+         * without holding the global lock
+         */
+        baseTileData = base->m_tileData;
+        baseTileData->ref();
+
+        tileData = m_tileData;
+        tileData->ref();
+    }
+
+    const qint32 pixelSize = tileData->pixelSize();
+    const qint32 dataSize = tileDataSize(pixelSize);
+
+    QByteArray xorBuffer(dataSize, Qt::Uninitialized);
+
+    baseTileData->blockSwapping();
+    memcpy(xorBuffer.data(), baseTileData->data(), dataSize);
+    baseTileData->unblockSwapping();
+
+    tileData->blockSwapping();
+    xorData(tileData->data(), reinterpret_cast<quint8*>(xorBuffer.data()), dataSize);
+    tileData->unblockSwapping();
+
+    KisLzfCompression compression;
+    QByteArray compressed(compression.outputBufferSize(dataSize), Qt::Uninitialized);
+
+    const qint32 compressedSize =
+        compression.compress(reinterpret_cast<const quint8*>(xorBuffer.constData()), dataSize,
+                             reinterpret_cast<quint8*>(compressed.data()), compressed.size());
+
+    // the delta is not worth keeping
+    bool result = compressedSize > 0 && compressedSize <= dataSize / 2;
+
+    if (result) {
+        compressed.resize(compressedSize);
+        compressed.squeeze();
+
+        QMutexLocker l(s_deltaLock);
+
+        // the items might have changed while the delta was computed
+        result = canEncodeDeltaAgainst(base) &&
+            base->m_tileData == baseTileData &&
+            m_tileData == tileData;
+
+        if (result) {
+            m_delta = compressed;
+            m_deltaPixelSize = pixelSize;
+            m_deltaBase = base;
+            base->m_deltaDependents.append(this);
+
+            m_numDeltaLinks.ref();
+            base->m_numDeltaLinks.ref();
+
+            releaseTileData();
+            m_tileData = 0;
+        }
+    }
+
+    baseTileData->deref();
+    tileData->deref();
+
+    if (result) {
+        KisTileDataStore::instance()->notifyMementoDeltaChanged(compressedSize, dataSize);
+    }
+
+    return result;
+}
+
+bool KisMementoItem::reconstructData(quint8 *dst)
+{
+    const qint32 dataSize = tileDataSize(m_deltaPixelSize);
+
+    if (!m_deltaBase) {
+        if (!m_tileData) return false;
+
+        m_tileData->blockSwapping();
+        memcpy(dst, m_tileData->data(), tileDataSize(m_tileData->pixelSize()));
+        m_tileData->unblockSwapping();
+
+        return true;
+    }
+
+    if (!m_deltaBase->reconstructData(dst)) return false;
+
+    KisLzfCompression compression;
+    QByteArray xorBuffer(dataSize, Qt::Uninitialized);
+
+    const qint32 bytesWritten =
+        compression.decompress(reinterpret_cast<const quint8*>(m_delta.constData()), m_delta.size(),
+                               reinterpret_cast<quint8*>(xorBuffer.data()), dataSize);
+
+    if (bytesWritten != dataSize) return false;
+
+    xorData(reinterpret_cast<const quint8*>(xorBuffer.constData()), dst, dataSize);
+
+    return true;
+}
+
+void KisMementoItem::materializeDelta()
+{
+    /**
+     * The old tile data is read on every undo-aware access to the
+     * device, so don't touch the global lock unless the item is
+     * linked to a delta. The links are created only on commit.
+     */
+    if (!m_numDeltaLinks.loadAcquire()) return;
+
+    QMutexLocker l(s_deltaLock);
+
+    if (!m_deltaBase) return;
+
+    const QByteArray zeroPixel(m_deltaPixelSize, 0);
+    KisTileData *td =
+        KisTileDataStore::instance()->createDefaultTileData(m_deltaPixelSize,
+                                                            reinterpret_cast<const quint8*>(zeroPixel.constData()));
+
+    td->blockSwapping();
+    const bool result = reconstructData(td->data());
+    td->unblockSwapping();
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(result && "failed to decode delta-encoded memento");
+
+    m_deltaBase->m_deltaDependents.removeOne(this);
+    m_deltaBase->m_numDeltaLinks.deref();
+    m_deltaBase = 0;
+    m_numDeltaLinks.deref();
+
+    KisTileDataStore::instance()->notifyMementoDeltaChanged(-m_delta.size(), -tileDataSize(m_deltaPixelSize));
+    m_delta.clear();
+
+    /**
+     * Restore the counters to the state
+     * of a committed memento item
+     */
+    m_tileData = td;
+    m_tileData->acquire();
+    m_tileData->setMementoed(true);
+}
+
+void KisMementoItem::releaseDelta()
+{
+    if (!m_numDeltaLinks.loadAcquire()) return;
+
+    QMutexLocker l(s_deltaLock);
+
+    if (!m_deltaDependents.isEmpty()) {
+        const QVector<KisMementoItem*> dependents = m_deltaDependents;
+
+        Q_FOREACH (KisMementoItem *item, dependents) {
+            if (item == m_parent.data() && item->refCount() == 1) {
+                /**
+                 * The parent is referenced by us only, so it will die
+                 * right after us and there is no need to restore it
+                 */
+                item->m_deltaBase = 0;
+                item->m_numDeltaLinks.deref();
+                m_deltaDependents.removeOne(item);
+                m_numDeltaLinks.deref();
+
+                KisTileDataStore::instance()->notifyMementoDeltaChanged(-item->m_delta.size(),
+                                                                        -tileDataSize(item->m_deltaPixelSize));
+                item->m_delta.clear();
+            } else {
+                item->materializeDelta();
+            }
+        }
+
+        KIS_SAFE_ASSERT_RECOVER_NOOP(m_deltaDependents.isEmpty());
+    }
+
+    if (m_deltaBase) {
+        m_deltaBase->m_deltaDependents.removeOne(this);
+        m_deltaBase->m_numDeltaLinks.deref();
+        m_deltaBase = 0;
+        m_numDeltaLinks.deref();
+
+        KisTileDataStore::instance()->notifyMementoDeltaChanged(-m_delta.size(), -tileDataSize(m_deltaPixelSize));
+        m_delta.clear();
+    }
+}
@@ -7,6 +7,10 @@
 #ifndef KIS_MEMENTO_ITEM_H_
 #define KIS_MEMENTO_ITEM_H_
 
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QVector>
+
 #include <kis_shared.h>
 #include <kis_shared_ptr.h>
 #include "kis_tile.h"
@@ -30,13 +34,16 @@ public:
 
     KisMementoItem(const KisMementoItem& rhs)
             : KisShared(),
-            m_tileData(rhs.m_tileData),
+            m_tileData(0),
             m_committedFlag(rhs.m_committedFlag),
             m_type(rhs.m_type),
             m_col(rhs.m_col),
             m_row(rhs.m_row),
             m_next(0),
             m_parent(0) {
+        const_cast<KisMementoItem&>(rhs).materializeDelta();
+        m_tileData = rhs.m_tileData;
+
         if (m_tileData) {
             if (m_committedFlag)
                 m_tileData->acquire();
@@ -72,6 +79,7 @@ public:
      */
     KisMementoItem(const KisMementoItem &rhs, KisMementoManager *mm) {
         Q_UNUSED(mm);
+        const_cast<KisMementoItem&>(rhs).materializeDelta();
         m_tileData = rhs.m_tileData;
         /* Setting counter: m_refCount++ */
         m_tileData->ref();
@@ -83,6 +91,7 @@ public:
     }
 
     ~KisMementoItem() {
+        releaseDelta();
         releaseTileData();
     }
 
@@ -101,6 +110,7 @@ public:
 
 
     void reset() {
+        releaseDelta();
         releaseTileData();
         m_tileData = 0;
         m_committedFlag = false;
@@ -141,11 +151,66 @@ public:
         m_committedFlag = true;
     }
 
+    /**
+     * Replaces the tile data of the item with \p td, which has
+     * exactly the same content. Called when the tile the item has
+     * been created for starts sharing its data with other tiles (see
+     * KisTile::shareTileData()), so that the old data could be freed.
+     */
+    void shareTileData(KisTileData *td) {
+        KisTileData *oldTileData = m_tileData;
+
+        if (m_committedFlag) {
+            td->acquire();
+            td->setMementoed(true);
+        } else {
+            td->ref();
+        }
+
+        m_tileData = td;
+
+        if (m_committedFlag) {
+            oldTileData->setMementoed(false);
+            oldTileData->release();
+        } else {
+            oldTileData->deref();
+        }
+    }
+
     inline KisTileSP tile(KisMementoManager *mm) {
+        materializeDelta();
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
     }
 
+    /**
+     * Delta-encoded mementos
+     *
+     * A committed item whose tile data has been overwritten by a newer
+     * revision (\p base) may drop its tile data and keep only a
+     * compressed XOR delta against the tile data of \p base. The full
+     * tile data is restored lazily by materializeDelta(), which is
+     * called automatically when the tile is requested by rollback().
+     *
+     * The item keeps a raw pointer to \p base, and \p base keeps a
+     * list of its dependents. When \p base is destroyed, it
+     * materializes the dependents that are still in use.
+     *
+     * \return true if the delta has been stored and the tile data
+     *         released
+     */
+    bool encodeDelta(KisMementoItem *base);
+
+    /**
+     * Restores the tile data of a delta-encoded item. Does nothing
+     * if the item is not delta-encoded.
+     */
+    void materializeDelta();
+
+    inline bool isDeltaEncoded() const {
+        return m_deltaBase;
+    }
+
     inline enumType type() {
         return m_type;
     }
@@ -170,6 +235,10 @@ public:
     inline qint32 row() const {
         return m_row;
     }
+    /**
+     * NOTE: returns null for delta-encoded items,
+     *       see materializeDelta()
+     */
     inline KisTileData* tileData() const {
         return m_tileData;
     }
@@ -194,6 +263,10 @@ public:
     }
 
 protected:
+    void releaseDelta();
+    bool reconstructData(quint8 *dst);
+    bool canEncodeDeltaAgainst(KisMementoItem *base) const;
+
     void releaseTileData() {
         if (m_tileData) {
             if (m_committedFlag) {
@@ -216,6 +289,22 @@ protected:
 
     KisMementoItemSP m_next;
     KisMementoItemSP m_parent;
+
+    /**
+     * Delta-encoded state, see encodeDelta()
+     */
+    QByteArray m_delta;
+    qint32 m_deltaPixelSize {0};
+    KisMementoItem *m_deltaBase {0};
+    QVector<KisMementoItem*> m_deltaDependents;
+
+    /**
+     * The number of delta links of the item: one for m_deltaBase
+     * plus one per dependent. It is changed under the delta lock,
+     * but read without it, so that the items that are not involved
+     * in delta encoding never touch the lock.
+     */
+    QAtomicInt m_numDeltaLinks {0};
 private:
 };
 
@@ -7,6 +7,7 @@
 #include <QtGlobal>
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
+#include "kis_image_config.h"
 
 
 //#define DEBUG_MM
@@ -87,11 +88,40 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
 
 KisMementoManager::~KisMementoManager()
 {
-    // Nothing to be done here. Happily...
-    // Everything is done by QList and KisSharedPtr...
+    /**
+     * Everything is done by QList and KisSharedPtr, but we release
+     * the history from the oldest revision, so that delta-encoded
+     * items die before their bases and don't need to be restored
+     */
+    while (!m_revisions.isEmpty()) {
+        m_revisions.removeFirst();
+    }
+
     DEBUG_LOG_SIMPLE_ACTION("died\n");
 }
 
+namespace {
+QAtomicInt s_deltaMementosEnabled(-1);
+}
+
+bool KisMementoManager::deltaMementosEnabled()
+{
+    int value = s_deltaMementosEnabled.loadAcquire();
+
+    if (value < 0) {
+        value = KisImageConfig(true).useDeltaMementos();
+        s_deltaMementosEnabled.testAndSetOrdered(-1, value);
+        value = s_deltaMementosEnabled.loadAcquire();
+    }
+
+    return value;
+}
+
+void KisMementoManager::setDeltaMementosEnabled(bool value)
+{
+    s_deltaMementosEnabled.storeRelease(value);
+}
+
 /**
  * NOTE: We don't assume that the registerTileChange/Delete
  * can be called once a commit only. Reverse can happen when we
@@ -132,6 +162,21 @@ void KisMementoManager::registerTileChange(KisTile *tile)
     }
 }
 
+void KisMementoManager::registerTileDataShared(qint32 col, qint32 row,
+                                               KisTileData *oldTileData,
+                                               KisTileData *tileData)
+{
+    KisMementoItemSP mi = m_index.getExistingTile(col, row);
+    if (mi && mi->tileData() == oldTileData) {
+        mi->shareTileData(tileData);
+    }
+
+    mi = m_headsHashTable.getExistingTile(col, row);
+    if (mi && mi->tileData() == oldTileData) {
+        mi->shareTileData(tileData);
+    }
+}
+
 void KisMementoManager::registerTileDeleted(KisTile *tile)
 {
     if (registrationBlocked()) return;
@@ -182,6 +227,8 @@ void KisMementoManager::commit()
     KisMementoItemSP parentMI;
     bool newTile;
 
+    const bool useDeltas = deltaMementosEnabled();
+
     KisMementoItemHashTableIterator iter(&m_index);
     while ((mi = iter.tile())) {
         parentMI = m_headsHashTable.getTileLazy(mi->col(), mi->row(), newTile);
@@ -190,6 +237,17 @@ void KisMementoManager::commit()
         mi->commit();
         revisionList.append(mi);
 
+        /**
+         * The parent is not the HEAD anymore, so it will be needed
+         * on undo only. Keep only its difference to the new HEAD.
+         */
+        if (useDeltas && !newTile &&
+            parentMI->type() == KisMementoItem::CHANGED &&
+            mi->type() == KisMementoItem::CHANGED) {
+
+            parentMI->encodeDelta(mi.data());
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
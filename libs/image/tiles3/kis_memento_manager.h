@@ -69,6 +69,20 @@ public:
     void registerTileDeleted(KisTile *tile);
 
 
+    /**
+     * Called by a tile when it replaces its tile data \p oldTileData
+     * with \p tileData of the same content (see KisTile::shareTileData()).
+     * The memento items of the tile that reference the old data, both
+     * in INDEX and in HEAD revision, are switched to the new one, so
+     * that the old data is not kept alive by the history.
+     *
+     * Must be called under the write lock of the data manager, the
+     * same way as commit().
+     */
+    void registerTileDataShared(qint32 col, qint32 row,
+                                KisTileData *oldTileData,
+                                KisTileData *tileData);
+
     /**
      * Commits changes, made in  INDEX: appends m_index into m_revisions list
      * and owes all modified tileDatas.
@@ -113,6 +127,18 @@ public:
      */
     void purgeHistory(KisMementoSP oldestMemento);
 
+    /**
+     * When enabled, the committed items that are overwritten by newer
+     * revisions are stored as compressed deltas against their
+     * successors (see KisMementoItem::encodeDelta()). It saves a lot
+     * of memory on long strokes over the same area for the cost of
+     * some CPU time on undo.
+     *
+     * The value is read from KisImageConfig on the first use.
+     */
+    static bool deltaMementosEnabled();
+    static void setDeltaMementosEnabled(bool value);
+
 protected:
     qint32 findRevisionByMemento(KisMementoSP memento) const;
     void resetRevisionHistory(KisMementoItemList list);
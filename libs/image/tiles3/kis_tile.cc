@@ -257,6 +257,8 @@ void KisTile::lockForWrite()
 #endif
     }
 
+    m_tileData->notifyContentChanged();
+
     DEBUG_LOG_ACTION("lock [W]");
 }
 
@@ -283,6 +285,47 @@ void KisTile::unlockForRead() const
 }
 
 
+bool KisTile::shareTileData(KisTileData *td)
+{
+    QMutexLocker cowLocker(&m_COWMutex);
+    QMutexLocker locker(&m_swapBarrierLock);
+
+    if (m_lockCounter > 0 || td == m_tileData) return false;
+    KIS_SAFE_ASSERT_RECOVER(td->pixelSize() == m_tileData->pixelSize()) { return false; }
+
+    /**
+     * Nobody can write into the tile while we hold the locks, so
+     * the content checked here is the one that will be replaced
+     */
+    td->blockSwapping();
+    m_tileData->blockSwapping();
+    const bool isEqual =
+        !memcmp(td->data(), m_tileData->data(),
+                KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize());
+    m_tileData->unblockSwapping();
+    td->unblockSwapping();
+
+    if (!isEqual) return false;
+
+    KisTileData *oldTileData = m_tileData;
+    td->acquire();
+    m_tileData = td;
+
+    /**
+     * The history still references the old data, switch it too,
+     * otherwise the old data would never be freed
+     */
+    KisMementoManager *mm = m_mementoManager.load();
+    if (mm) {
+        mm->registerTileDataShared(m_col, m_row, oldTileData, td);
+    }
+
+    oldTileData->release();
+
+    return true;
+}
+
+
 #include <stdio.h>
 void KisTile::debugPrintInfo()
 {
@@ -70,6 +70,27 @@ public:
      */
     void notifyAttachedToDataManager(KisMementoManager *mm);
 
+    /**
+     * Replaces the tile data of the tile with \p td if it has exactly
+     * the same content. The change is invisible for the users of the
+     * tile, so it is not registered in the memento manager. After the
+     * call both the tiles share \p td and the first write will detach
+     * them via usual copy-on-write.
+     *
+     * The content is compared while the tile is protected from the
+     * writers, so the tile may be changed concurrently between the
+     * moment the caller decided to share the data and the call
+     * itself. Returns false if the tile is locked right now or its
+     * content differs from \p td, in which case nothing is changed.
+     * The caller must guarantee that nobody writes into \p td itself.
+     *
+     * The memento items of the tile are switched to \p td as well, so
+     * the call must be done under the write lock of the data manager.
+     *
+     * \see KisTileDataDeduplicator
+     */
+    bool shareTileData(KisTileData *td);
+
 public:
 
     void debugPrintInfo();
@@ -11,15 +11,26 @@
 
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
+#include <QGlobalStatic>
+#include "kis_tile_data_slab_allocator.h"
 #include "kis_tile_data_store_iterators.h"
 
-// BPP == bytes per pixel
-#define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-#define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
+Q_GLOBAL_STATIC(KisTileDataSlabAllocator, s_slabAllocator)
 
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+namespace {
+
+void deallocateSlabData(quint8 *ptr, const qint32 pixelSize)
+{
+    /**
+     * The allocator may be destroyed on exit before the last tile
+     * data objects are, the memory will be reclaimed by the OS
+     */
+    if (s_slabAllocator.isDestroyed()) return;
+
+    s_slabAllocator->deallocate(ptr, pixelSize);
+}
+
+}
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
@@ -37,15 +48,15 @@ void SimpleCache::clear()
     quint8 *ptr = 0;
 
     while (m_4Pool.pop(ptr)) {
-        BoostPool4BPP::free(ptr);
+        deallocateSlabData(ptr, 4);
     }
 
     while (m_8Pool.pop(ptr)) {
-        BoostPool8BPP::free(ptr);
+        deallocateSlabData(ptr, 8);
     }
 
     while (m_16Pool.pop(ptr)) {
-        free(ptr);
+        deallocateSlabData(ptr, 16);
     }
 }
 
@@ -54,6 +65,7 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_accessFrequency(0),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(pixelSize),
@@ -65,6 +77,8 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
     m_data = allocateData(m_pixelSize);
 
     fillWithPixel(defPixel);
+
+    m_store->notifyTileDataContentChanged();
 }
 
 
@@ -83,6 +97,7 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_accessFrequency(0),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(rhs.m_pixelSize),
@@ -94,6 +109,15 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     m_data = allocateData(m_pixelSize);
 
     memcpy(m_data, rhs.data(), m_pixelSize * WIDTH * HEIGHT);
+
+    /**
+     * The clone has the same content, it will be marked as changed
+     * when the tile that gets it is locked for write
+     */
+    if (rhs.m_contentHashValid.loadAcquire()) {
+        m_contentHash = rhs.m_contentHash;
+        m_contentHashValid.storeRelease(1);
+    }
 }
 
 
@@ -137,17 +161,7 @@ quint8* KisTileData::allocateData(const qint32 pixelSize)
     quint8 *ptr = 0;
 
     if (!m_cache.pop(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            ptr = (quint8*)BoostPool4BPP::malloc();
-            break;
-        case 8:
-            ptr = (quint8*)BoostPool8BPP::malloc();
-            break;
-        default:
-            ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
-            break;
-        }
+        ptr = s_slabAllocator->allocate(pixelSize);
     }
 
     return ptr;
@@ -156,20 +170,21 @@ quint8* KisTileData::allocateData(const qint32 pixelSize)
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
     if (!m_cache.push(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            BoostPool4BPP::free(ptr);
-            break;
-        case 8:
-            BoostPool8BPP::free(ptr);
-            break;
-        default:
-            free(ptr);
-            break;
-        }
+        deallocateSlabData(ptr, pixelSize);
     }
 }
 
+void KisTileData::releaseUnusedMemory()
+{
+    m_cache.clear();
+    s_slabAllocator->releaseEmptySlabs();
+}
+
+KisTileDataSlabAllocator* KisTileData::slabAllocator()
+{
+    return s_slabAllocator;
+}
+
 //#define DEBUG_POOL_RELEASE
 
 #ifdef DEBUG_POOL_RELEASE
@@ -197,13 +212,6 @@ void KisTileData::releaseInternalPools()
                 delete clone;
             }
 
-            // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8) {
-
-                continue;
-            }
-
             // check if the tile has been swapped out
             if (item->m_data) {
                 const bool locked = item->m_swapLock.tryLockForWrite();
@@ -220,14 +228,21 @@ void KisTileData::releaseInternalPools()
         }
 
         if (!failedToLock) {
-            // purge the pools memory
-            m_cache.clear();
-            BoostPool4BPP::purge_memory();
-            BoostPool8BPP::purge_memory();
-
             auto it = dataObjects.begin();
             auto chunkIt = memoryChunks.constBegin();
 
+            // free the data of the migrated tiles to make their slabs empty
+            for (; it != dataObjects.end(); ++it) {
+                KisTileData *item = *it;
+                deallocateSlabData(item->m_data, item->m_pixelSize);
+                item->m_data = 0;
+            }
+
+            // purge the pools memory
+            releaseUnusedMemory();
+
+            it = dataObjects.begin();
+
             for (; it != dataObjects.end(); ++it, ++chunkIt) {
                 KisTileData *item = *it;
                 const int chunkSize = item->m_pixelSize * WIDTH * HEIGHT;
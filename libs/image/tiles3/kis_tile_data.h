@@ -13,6 +13,7 @@
  * by the store.
  */
 #include "kis_tile_data_interface.h"
+#include <QHash>
 
 
 #include "kis_tile_data_store.h"
@@ -82,13 +83,22 @@ inline void KisTileData::blockSwapping() {
         m_swapLock.unlock();
         m_store->ensureTileDataLoaded(this);
     }
-    resetAge();
+    registerAccess();
 }
 
 inline void KisTileData::unblockSwapping() {
     m_swapLock.unlock();
 }
 
+inline bool KisTileData::blockSwappingIfLoaded() {
+    if (!m_swapLock.tryLockForRead()) return false;
+    if (!m_data) {
+        m_swapLock.unlock();
+        return false;
+    }
+    return true;
+}
+
 inline KisChunk KisTileData::swapChunk() const {
     return m_swapChunk;
 }
@@ -117,6 +127,47 @@ inline void KisTileData::markOld() {
     m_age++;
 }
 
+inline int KisTileData::accessFrequency() const {
+    return m_accessFrequency.load();
+}
+inline void KisTileData::registerAccess() {
+    m_age = 0;
+
+    /**
+     * The tile data is accessed from many threads at once. The
+     * counter is only a heuristic for the swapper, so the relaxed
+     * ordering is enough, but it must never overflow the saturation
+     * value.
+     */
+    int frequency = m_accessFrequency.load();
+    while (frequency < MAX_ACCESS_FREQUENCY &&
+           !m_accessFrequency.testAndSetRelaxed(frequency, frequency + 1, frequency));
+}
+inline void KisTileData::decayAccessFrequency() {
+    int frequency = m_accessFrequency.load();
+    while (frequency > 0 &&
+           !m_accessFrequency.testAndSetRelaxed(frequency, frequency >> 1, frequency));
+}
+
+inline uint KisTileData::contentHash() {
+    if (!m_contentHashValid.loadAcquire()) {
+        m_contentHash = qHashBits(data(), WIDTH * HEIGHT * m_pixelSize, m_pixelSize);
+        m_contentHashValid.storeRelease(1);
+    }
+    return m_contentHash;
+}
+inline void KisTileData::notifyContentChanged() {
+    /**
+     * Check the flag before the atomic write to avoid bouncing the
+     * cache line on every write lock
+     */
+    if (m_contentHashValid.loadAcquire() &&
+        m_contentHashValid.testAndSetOrdered(1, 0)) {
+
+        m_store->notifyTileDataContentChanged();
+    }
+}
+
 inline qint32 KisTileData::numUsers() const {
     return m_usersCount;
 }
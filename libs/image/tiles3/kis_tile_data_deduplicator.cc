@@ -0,0 +1,88 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_deduplicator.h"
+
+#include <cstring>
+
+#include "kis_tile_data.h"
+#include "kis_tile_data_store.h"
+
+
+KisTileDataDeduplicator::KisTileDataDeduplicator()
+    : m_processedSize(0),
+      m_uniqueSize(0)
+{
+}
+
+KisTileDataDeduplicator::~KisTileDataDeduplicator()
+{
+    Q_FOREACH (const QVector<KisTileData*> &bucket, m_tileData) {
+        Q_FOREACH (KisTileData *td, bucket) {
+            td->deref();
+        }
+    }
+}
+
+KisTileData* KisTileDataDeduplicator::canonicalTileData(KisTileData *td)
+{
+    if (!td->blockSwappingIfLoaded()) return 0;
+
+    const int dataSize = KisTileData::WIDTH * KisTileData::HEIGHT * td->pixelSize();
+    const uint hash = td->contentHash();
+
+    m_processedSize += dataSize;
+
+    KisTileData *result = 0;
+    QVector<KisTileData*> &bucket = m_tileData[hash];
+
+    Q_FOREACH (KisTileData *candidate, bucket) {
+        if (candidate == td) {
+            result = candidate;
+            break;
+        }
+
+        if (candidate->pixelSize() != td->pixelSize() ||
+            !candidate->blockSwappingIfLoaded()) {
+
+            continue;
+        }
+
+        const bool isEqual = !memcmp(candidate->data(), td->data(), dataSize);
+        candidate->unblockSwapping();
+
+        if (isEqual) {
+            result = candidate;
+            break;
+        }
+    }
+
+    if (!result) {
+        td->ref();
+        bucket.append(td);
+        m_uniqueSize += dataSize;
+        result = td;
+    }
+
+    td->unblockSwapping();
+
+    return result;
+}
+
+qint64 KisTileDataDeduplicator::processedSize() const
+{
+    return m_processedSize;
+}
+
+qint64 KisTileDataDeduplicator::uniqueSize() const
+{
+    return m_uniqueSize;
+}
+
+void KisTileDataDeduplicator::publishStatistics() const
+{
+    KisTileDataStore::instance()->notifyDeduplicationFinished(m_processedSize, m_uniqueSize);
+}
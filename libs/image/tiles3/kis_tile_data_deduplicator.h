@@ -0,0 +1,71 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_TILE_DATA_DEDUPLICATOR_H
+#define __KIS_TILE_DATA_DEDUPLICATOR_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class KisTileData;
+
+
+/**
+ * KisTileDataDeduplicator finds the tile data objects with equal
+ * content, so that the tiles holding them could share a single
+ * object (see KisTile::shareTileData()). It is used for the layers
+ * duplicated by the user and for the animation frames that repeat
+ * the same drawing.
+ *
+ * The deduplicator lives for one pass only. The tile data objects
+ * registered in it must not change while the pass is in progress,
+ * so the pass should be run in an exclusive stroke. The data that
+ * has been swapped out is skipped, we never load it back just for
+ * the sake of deduplication. The hashes of the data are cached in
+ * the tile data objects (see KisTileData::contentHash()), so only
+ * the data changed since the previous pass is hashed again.
+ */
+class KRITAIMAGE_EXPORT KisTileDataDeduplicator
+{
+public:
+    KisTileDataDeduplicator();
+    ~KisTileDataDeduplicator();
+
+    /**
+     * Returns a tile data object with the same content as \p td
+     * that has been seen earlier during this pass. If there is no
+     * such object, registers \p td and returns it as is. Returns
+     * null if \p td is not present in memory right now.
+     */
+    KisTileData* canonicalTileData(KisTileData *td);
+
+    /**
+     * The total size of the tile data processed during the pass,
+     * counted per tile
+     */
+    qint64 processedSize() const;
+
+    /**
+     * The size of the unique tile data objects left after the pass
+     */
+    qint64 uniqueSize() const;
+
+    /**
+     * Passes the results of the pass to KisTileDataStore, so that
+     * they would be shown in memory statistics
+     */
+    void publishStatistics() const;
+
+private:
+    QHash<uint, QVector<KisTileData*>> m_tileData;
+    qint64 m_processedSize;
+    qint64 m_uniqueSize;
+};
+
+#endif /* __KIS_TILE_DATA_DEDUPLICATOR_H */
@@ -16,6 +16,7 @@
 
 class KisTileData;
 class KisTileDataStore;
+class KisTileDataSlabAllocator;
 
 /**
  * WARNING: Those definitions for internal use only!
@@ -42,19 +43,14 @@ public:
         QReadLocker l(&m_cacheLock);
         switch (pixelSize) {
         case 4:
-            m_4Pool.push(ptr);
-            break;
+            return pushLimited(m_4Pool, ptr);
         case 8:
-            m_8Pool.push(ptr);
-            break;
+            return pushLimited(m_8Pool, ptr);
         case 16:
-            m_16Pool.push(ptr);
-            break;
+            return pushLimited(m_16Pool, ptr);
         default:
             return false;
         }
-
-        return true;
     }
 
     bool pop(int pixelSize, quint8 *&ptr)
@@ -74,6 +70,22 @@ public:
 
     void clear();
 
+private:
+    /**
+     * The cache only smooths out the bursts of allocations, the
+     * rest of the free buffers is returned to the slab allocator,
+     * so that the empty slabs could be released
+     */
+    static const int MAX_CACHED_BUFFERS = 256;
+
+    static bool pushLimited(KisLocklessStack<quint8*> &pool, quint8 *ptr)
+    {
+        if (pool.size() >= MAX_CACHED_BUFFERS) return false;
+
+        pool.push(ptr);
+        return true;
+    }
+
 private:
     QReadWriteLock m_cacheLock;
     KisLocklessStack<quint8*> m_4Pool;
@@ -147,6 +159,14 @@ public:
     inline void blockSwapping();
     inline void unblockSwapping();
 
+    /**
+     * Blocks swapping only if the data is present in memory right
+     * now. If the data has been swapped out, returns false and
+     * doesn't block anything. Used by background routines that
+     * should never bring the swapped data back.
+     */
+    inline bool blockSwappingIfLoaded();
+
     /**
      * The position of the tile data in a swap file
      */
@@ -166,6 +186,32 @@ public:
     inline void resetAge();
     inline void markOld();
 
+    /**
+     * Approximate frequency of accesses to the tile data. It is
+     * increased on every access (see blockSwapping()) and halved by
+     * the swapper on every sweep, so the tiles accessed over and over
+     * again (e.g. the ones being painted on) stay hot, while the ones
+     * touched only once cool down after a couple of sweeps.
+     */
+    inline int accessFrequency() const;
+    inline void registerAccess();
+    inline void decayAccessFrequency();
+
+    /**
+     * The hash of the content of the tile data used by
+     * KisTileDataDeduplicator. It is calculated lazily and cached
+     * until the tile is locked for write, so the data that hasn't
+     * been changed since the previous deduplication pass is never
+     * hashed again. The swapping must be blocked by the caller.
+     */
+    inline uint contentHash();
+
+    /**
+     * Drops the cached contentHash(). Called by KisTile every time
+     * it is locked for write.
+     */
+    inline void notifyContentChanged();
+
     /**
      * Returns number of tiles (or memento items),
      * referencing the tile data.
@@ -201,13 +247,26 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
-     * allocate bigger chunks. This method should be called when one
-     * knows that we have just free'd quite a lot of memory and we
+     * glibc directly, but use slabs (see KisTileDataSlabAllocator)
+     * to allocate bigger chunks. This method should be called when
+     * one knows that we have just free'd quite a lot of memory and we
      * won't need it anymore. E.g. when a document has been closed.
+     *
+     * Apart from releasing the empty slabs, it migrates the data of
+     * the few remaining tiles to compact the slabs.
      */
     static void releaseInternalPools();
 
+    /**
+     * Flushes the cache of free buffers and returns the empty slabs
+     * to the OS. Unlike releaseInternalPools(), it is cheap and
+     * doesn't touch the existing tile data objects, so it is called
+     * regularly by KisTileDataPooler.
+     */
+    static void releaseUnusedMemory();
+
+    static KisTileDataSlabAllocator* slabAllocator();
+
 private:
     void fillWithPixel(const quint8 *defPixel);
 
@@ -270,6 +329,17 @@ private:
     //FIXME: make memory aligned
     int m_age;
 
+    /**
+     * \see accessFrequency()
+     */
+    QAtomicInt m_accessFrequency;
+
+    /**
+     * \see contentHash()
+     */
+    uint m_contentHash = 0;
+    QAtomicInt m_contentHashValid;
+
 
     /**
      * The primitive for controlling swapping of the tile.
@@ -310,6 +380,11 @@ private:
 public:
     static const qint32 WIDTH;
     static const qint32 HEIGHT;
+
+    /**
+     * The saturation value of accessFrequency()
+     */
+    static const int MAX_ACCESS_FREQUENCY = 15;
 };
 
 #endif /* KIS_TILE_DATA_INTERFACE_H_ */
@@ -203,6 +203,14 @@ void KisTileDataPooler::run()
 
         m_store->endIteration(iter);
 
+        if (!m_lastCycleHadWork) {
+            /**
+             * The pool is balanced now, so we can return the memory
+             * freed by the dropped clones and tiles back to the OS
+             */
+            KisTileData::releaseUnusedMemory();
+        }
+
         DEBUG_TILE_STATISTICS();
         DEBUG_SIMPLE_ACTION("cycle finished");
     }
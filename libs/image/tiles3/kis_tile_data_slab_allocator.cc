@@ -0,0 +1,344 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_slab_allocator.h"
+
+#include <map>
+#include <cstdlib>
+#include <cstring>
+
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <kis_debug.h>
+#include "kis_tile_data.h"
+
+
+namespace {
+
+const qint64 PREFERRED_SLAB_SIZE = 1 << 20;
+const qint32 MIN_CHUNKS_PER_SLAB = 16;
+
+quint8* allocateSlabMemory(size_t size)
+{
+#ifdef Q_OS_WIN
+    return static_cast<quint8*>(VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+    void *ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr != MAP_FAILED ? static_cast<quint8*>(ptr) : 0;
+#endif
+}
+
+void freeSlabMemory(quint8 *ptr, size_t size)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+inline qint32 tileDataSize(qint32 pixelSize)
+{
+    return pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+}
+
+}
+
+struct KisTileDataSlabAllocator::Slab
+{
+    quint8 *memory = 0;
+
+    qint32 numFree = 0;
+
+    /**
+     * The chunks at the end of the slab that have never been handed
+     * out. We don't link them into the free list beforehand to avoid
+     * touching (and committing) the pages of a new slab.
+     */
+    qint32 numUntouched = 0;
+
+    /**
+     * The first bytes of every free chunk store
+     * the pointer to the next free chunk
+     */
+    quint8 *freeList = 0;
+
+    Slab *prev = 0;
+    Slab *next = 0;
+};
+
+struct KisTileDataSlabAllocator::SizeClass
+{
+    QMutex lock;
+
+    qint32 chunkSize = 0;
+    qint32 chunksPerSlab = 0;
+    size_t slabSize = 0;
+
+    /**
+     * All the slabs of the class sorted by address,
+     * used for finding the owner of a chunk
+     */
+    std::map<quintptr, Slab*> slabs;
+
+    /**
+     * The slabs that have free chunks. The partially used slabs
+     * are kept in the beginning of the list, the empty ones in the
+     * end, so that the empty slabs are used last.
+     */
+    Slab *firstFree = 0;
+    Slab *lastFree = 0;
+
+    qint32 numEmptySlabs = 0;
+
+    bool isEmpty(Slab *slab) const {
+        return slab->numFree == chunksPerSlab;
+    }
+
+    void link(Slab *slab, bool toFront) {
+        if (toFront) {
+            slab->prev = 0;
+            slab->next = firstFree;
+            (firstFree ? firstFree->prev : lastFree) = slab;
+            firstFree = slab;
+        } else {
+            slab->prev = lastFree;
+            slab->next = 0;
+            (lastFree ? lastFree->next : firstFree) = slab;
+            lastFree = slab;
+        }
+    }
+
+    void unlink(Slab *slab) {
+        (slab->prev ? slab->prev->next : firstFree) = slab->next;
+        (slab->next ? slab->next->prev : lastFree) = slab->prev;
+        slab->prev = slab->next = 0;
+    }
+
+    Slab* createSlab() {
+        quint8 *memory = allocateSlabMemory(slabSize);
+        if (!memory) return 0;
+
+        Slab *slab = new Slab();
+        slab->memory = memory;
+        slab->numFree = chunksPerSlab;
+        slab->numUntouched = chunksPerSlab;
+
+        slabs.insert(std::make_pair(quintptr(memory), slab));
+        link(slab, false);
+        numEmptySlabs++;
+
+        return slab;
+    }
+
+    void destroySlab(Slab *slab) {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(isEmpty(slab));
+
+        unlink(slab);
+        slabs.erase(quintptr(slab->memory));
+        numEmptySlabs--;
+
+        freeSlabMemory(slab->memory, slabSize);
+        delete slab;
+    }
+};
+
+struct KisTileDataSlabAllocator::Private
+{
+    QAtomicPointer<SizeClass> sizeClasses[MAX_PIXEL_SIZE + 1];
+
+    QAtomicInteger<qint64> reservedMemory;
+    QAtomicInteger<qint64> usedMemory;
+};
+
+
+KisTileDataSlabAllocator::KisTileDataSlabAllocator()
+    : m_d(new Private)
+{
+}
+
+KisTileDataSlabAllocator::~KisTileDataSlabAllocator()
+{
+    /**
+     * The allocator may be destroyed on exit while some tile data
+     * objects are still alive, so the non-empty slabs are leaked
+     * deliberately.
+     */
+    releaseEmptySlabsImpl(0);
+
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        SizeClass *sc = m_d->sizeClasses[i].loadAcquire();
+        if (!sc) continue;
+
+        for (auto it = sc->slabs.begin(); it != sc->slabs.end(); ++it) {
+            delete it->second;
+        }
+        delete sc;
+    }
+}
+
+KisTileDataSlabAllocator::SizeClass* KisTileDataSlabAllocator::sizeClass(qint32 pixelSize)
+{
+    if (pixelSize <= 0 || pixelSize > MAX_PIXEL_SIZE) return 0;
+
+    SizeClass *sc = m_d->sizeClasses[pixelSize].loadAcquire();
+
+    if (!sc) {
+        SizeClass *newClass = new SizeClass();
+        newClass->chunkSize = tileDataSize(pixelSize);
+        newClass->chunksPerSlab = qMax(MIN_CHUNKS_PER_SLAB, qint32(PREFERRED_SLAB_SIZE / newClass->chunkSize));
+        newClass->slabSize = size_t(newClass->chunkSize) * newClass->chunksPerSlab;
+
+        if (m_d->sizeClasses[pixelSize].testAndSetOrdered(0, newClass)) {
+            sc = newClass;
+        } else {
+            delete newClass;
+            sc = m_d->sizeClasses[pixelSize].loadAcquire();
+        }
+    }
+
+    return sc;
+}
+
+quint8* KisTileDataSlabAllocator::allocate(qint32 pixelSize)
+{
+    SizeClass *sc = sizeClass(pixelSize);
+    if (!sc) {
+        return static_cast<quint8*>(malloc(tileDataSize(pixelSize)));
+    }
+
+    QMutexLocker l(&sc->lock);
+
+    Slab *slab = sc->firstFree;
+
+    if (!slab) {
+        slab = sc->createSlab();
+        if (!slab) return 0;
+
+        m_d->reservedMemory.fetchAndAddOrdered(sc->slabSize);
+    }
+
+    if (sc->isEmpty(slab)) {
+        sc->numEmptySlabs--;
+    }
+
+    quint8 *ptr = 0;
+
+    if (slab->freeList) {
+        ptr = slab->freeList;
+        memcpy(&slab->freeList, ptr, sizeof(quint8*));
+    } else {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(slab->numUntouched > 0, 0);
+        ptr = slab->memory + qint64(sc->chunksPerSlab - slab->numUntouched) * sc->chunkSize;
+        slab->numUntouched--;
+    }
+
+    slab->numFree--;
+
+    if (!slab->numFree) {
+        sc->unlink(slab);
+    }
+
+    m_d->usedMemory.fetchAndAddOrdered(sc->chunkSize);
+
+    return ptr;
+}
+
+void KisTileDataSlabAllocator::deallocate(quint8 *ptr, qint32 pixelSize)
+{
+    if (!ptr) return;
+
+    SizeClass *sc = sizeClass(pixelSize);
+    if (!sc) {
+        free(ptr);
+        return;
+    }
+
+    QMutexLocker l(&sc->lock);
+
+    auto it = sc->slabs.upper_bound(quintptr(ptr));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != sc->slabs.begin());
+    --it;
+
+    Slab *slab = it->second;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(ptr < slab->memory + sc->slabSize);
+
+    memcpy(ptr, &slab->freeList, sizeof(quint8*));
+    slab->freeList = ptr;
+    slab->numFree++;
+
+    if (slab->numFree == 1) {
+        sc->link(slab, true);
+    }
+
+    if (sc->isEmpty(slab)) {
+        sc->unlink(slab);
+        sc->link(slab, false);
+        sc->numEmptySlabs++;
+
+        // keep one empty slab in reserve, return the rest to the OS
+        if (sc->numEmptySlabs > 1) {
+            sc->destroySlab(slab);
+            m_d->reservedMemory.fetchAndSubOrdered(sc->slabSize);
+        }
+    }
+
+    m_d->usedMemory.fetchAndSubOrdered(sc->chunkSize);
+}
+
+void KisTileDataSlabAllocator::releaseEmptySlabs()
+{
+    // keep the reserve, the same way as deallocate() does
+    releaseEmptySlabsImpl(1);
+}
+
+void KisTileDataSlabAllocator::releaseEmptySlabsImpl(qint32 numReservedSlabs)
+{
+    for (int i = 0; i <= MAX_PIXEL_SIZE; i++) {
+        SizeClass *sc = m_d->sizeClasses[i].loadAcquire();
+        if (!sc) continue;
+
+        QMutexLocker l(&sc->lock);
+
+        // the empty slabs live in the end of the list
+        while (sc->numEmptySlabs > numReservedSlabs &&
+               sc->lastFree && sc->isEmpty(sc->lastFree)) {
+
+            sc->destroySlab(sc->lastFree);
+            m_d->reservedMemory.fetchAndSubOrdered(sc->slabSize);
+        }
+    }
+}
+
+qint64 KisTileDataSlabAllocator::reservedMemory() const
+{
+    return m_d->reservedMemory.loadAcquire();
+}
+
+qint64 KisTileDataSlabAllocator::usedMemory() const
+{
+    return m_d->usedMemory.loadAcquire();
+}
+
+qint32 KisTileDataSlabAllocator::numSlabs(qint32 pixelSize) const
+{
+    if (pixelSize <= 0 || pixelSize > MAX_PIXEL_SIZE) return 0;
+
+    SizeClass *sc = m_d->sizeClasses[pixelSize].loadAcquire();
+    if (!sc) return 0;
+
+    QMutexLocker l(&sc->lock);
+    return sc->slabs.size();
+}
@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_TILE_DATA_SLAB_ALLOCATOR_H
+#define KIS_TILE_DATA_SLAB_ALLOCATOR_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+
+/**
+ * Allocates the pixel buffers of the tile data objects.
+ *
+ * The buffers of every pixel size (a size class) are cut from big
+ * slabs, which are requested from the OS directly (with mmap() or
+ * VirtualAlloc()), bypassing the heap of the C library. Since all the
+ * buffers in a slab have the same size, the slabs never fragment, and
+ * as soon as all the buffers of a slab are freed, the slab is
+ * returned to the OS. One empty slab per size class is kept in
+ * reserve to avoid thrashing when a tile is allocated and freed
+ * repeatedly.
+ *
+ * The size classes are created lazily for every pixel size up to
+ * MAX_PIXEL_SIZE, which covers all the color spaces of Krita. Bigger
+ * buffers are allocated with malloc().
+ */
+class KRITAIMAGE_EXPORT KisTileDataSlabAllocator
+{
+public:
+    static const qint32 MAX_PIXEL_SIZE = 64;
+
+public:
+    KisTileDataSlabAllocator();
+    ~KisTileDataSlabAllocator();
+
+    quint8* allocate(qint32 pixelSize);
+    void deallocate(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns the empty slabs back to the OS, except the one reserved
+     * slab per size class
+     */
+    void releaseEmptySlabs();
+
+    /**
+     * The memory requested from the OS for the slabs
+     */
+    qint64 reservedMemory() const;
+
+    /**
+     * The memory handed out to the tile data objects
+     */
+    qint64 usedMemory() const;
+
+    qint32 numSlabs(qint32 pixelSize) const;
+
+private:
+    struct Slab;
+    struct SizeClass;
+
+    SizeClass* sizeClass(qint32 pixelSize);
+    void releaseEmptySlabsImpl(qint32 numReservedSlabs);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* KIS_TILE_DATA_SLAB_ALLOCATOR_H */
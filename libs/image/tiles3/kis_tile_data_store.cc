@@ -12,6 +12,7 @@
 
 #include "kis_tile_data_store.h"
 #include "kis_tile_data.h"
+#include "kis_tile.h"
 #include "kis_debug.h"
 
 #include "kis_tile_data_store_iterators.h"
@@ -58,6 +59,7 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
@@ -65,10 +67,12 @@ KisTileDataStore::KisTileDataStore()
 {
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
@@ -99,6 +103,14 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
     stats.totalMemorySize = memoryMetric() * metricCoeff + stats.poolSize;
 
     stats.swapSize = m_swappedStore.totalMemoryMetric() * metricCoeff;
+    stats.swapOutThroughput = m_swapper.swapOutThroughput();
+
+    stats.historicalDeltaSize = m_mementoDeltaSize.loadAcquire();
+    stats.historicalDeltaSavedSize =
+        m_mementoDeltaDataSize.loadAcquire() - stats.historicalDeltaSize;
+
+    stats.deduplicatedSize = m_deduplicatedSize.loadAcquire();
+    stats.deduplicatedUniqueSize = m_deduplicatedUniqueSize.loadAcquire();
 
     return stats;
 }
@@ -243,6 +255,7 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
 
             m_swappedStore.swapInTileData(td);
             registerTileDataImp(td);
+            m_numSwapIns.ref();
 
             td->m_swapLock.unlock();
         }
@@ -257,6 +270,16 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     }
 }
 
+void KisTileDataStore::prefetchTile(KisTileSP tile)
+{
+    m_prefetcher.prefetchTile(tile);
+}
+
+void KisTileDataStore::kickPrefetcher()
+{
+    m_prefetcher.kick();
+}
+
 bool KisTileDataStore::trySwapTileData(KisTileData *td)
 {
     /**
@@ -269,6 +292,7 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     if (td->data()) {
         if (m_swappedStore.trySwapOutTileData(td)) {
             unregisterTileDataImp(td);
+            m_numSwapOuts.ref();
             result = true;
         }
     }
@@ -277,6 +301,43 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+qint64 KisTileDataStore::trySwapTileData(const QVector<KisTileData*> &tds)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    QVector<KisTileData*> lockedTileData;
+    lockedTileData.reserve(tds.size());
+
+    Q_FOREACH (KisTileData *td, tds) {
+        if (!td->m_swapLock.tryLockForWrite()) continue;
+
+        if (td->data()) {
+            lockedTileData << td;
+        } else {
+            td->m_swapLock.unlock();
+        }
+    }
+
+    const QVector<KisTileData*> swappedTileData =
+        m_swappedStore.trySwapOutTileData(lockedTileData);
+
+    qint64 freedMetric = 0;
+
+    Q_FOREACH (KisTileData *td, swappedTileData) {
+        unregisterTileDataImp(td);
+        m_numSwapOuts.ref();
+        freedMetric += td->pixelSize();
+    }
+
+    Q_FOREACH (KisTileData *td, lockedTileData) {
+        td->m_swapLock.unlock();
+    }
+
+    return freedMetric;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -365,6 +426,7 @@ void KisTileDataStore::testingRereadConfig()
 {
     m_pooler.testingRereadConfig();
     m_swapper.testingRereadConfig();
+    m_prefetcher.testingRereadConfig();
     kickPooler();
 }
 
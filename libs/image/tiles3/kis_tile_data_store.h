@@ -15,6 +15,7 @@
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
@@ -42,6 +43,13 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 swapOutThroughput;
+
+        qint64 historicalDeltaSize;
+        qint64 historicalDeltaSavedSize;
+
+        qint64 deduplicatedSize;
+        qint64 deduplicatedUniqueSize;
     };
 
     MemoryStatistics memoryStatistics();
@@ -64,6 +72,22 @@ public:
         return m_numTiles.loadAcquire();
     }
 
+    /**
+     * The number of tile data objects loaded back from the swap
+     * (swap misses) and written into it since the store has been
+     * created. Used for comparing the swapper policies, see
+     * KisLowMemoryBenchmark.
+     */
+    inline qint32 numSwapIns() const
+    {
+        return m_numSwapIns.loadAcquire();
+    }
+
+    inline qint32 numSwapOuts() const
+    {
+        return m_numSwapOuts.loadAcquire();
+    }
+
     inline void checkFreeMemory()
     {
         m_swapper.checkFreeMemory();
@@ -100,6 +124,68 @@ public:
         m_swapper.kick();
     }
 
+    /**
+     * Returns true if some of the tile data objects are swapped out
+     * at the moment. Used for skipping prefetching when there is
+     * nothing to prefetch.
+     */
+    inline bool hasSwappedTiles() const
+    {
+        return m_swappedStore.numTiles() > 0;
+    }
+
+    /**
+     * Asynchronously load the data of \p tile from swap. Call
+     * kickPrefetcher() after the batch of tiles is added.
+     *
+     * \see KisTileDataPrefetcher
+     */
+    void prefetchTile(KisTileSP tile);
+    void kickPrefetcher();
+
+    /**
+     * Called by KisMementoItem when it replaces its tile data with
+     * a compressed delta (or restores it back). \p deltaSize is the
+     * size of the delta, \p dataSize is the size of the tile data
+     * it replaces.
+     */
+    inline void notifyMementoDeltaChanged(qint64 deltaSize, qint64 dataSize)
+    {
+        m_mementoDeltaSize.fetchAndAddOrdered(deltaSize);
+        m_mementoDeltaDataSize.fetchAndAddOrdered(dataSize);
+    }
+
+    /**
+     * Called by KisTileDataDeduplicator when a deduplication pass
+     * is finished. \p processedSize is the size of all the tiles
+     * processed, \p uniqueSize is the size of the tile data objects
+     * actually backing them.
+     */
+    inline void notifyDeduplicationFinished(qint64 processedSize, qint64 uniqueSize)
+    {
+        m_deduplicatedSize.storeRelease(processedSize);
+        m_deduplicatedUniqueSize.storeRelease(uniqueSize);
+    }
+
+    /**
+     * Called by KisTileData when a new tile data is created or the
+     * content of an existing one is going to be changed
+     */
+    inline void notifyTileDataContentChanged()
+    {
+        m_tileDataContentChanges.ref();
+    }
+
+    /**
+     * A counter increased on every change of the content of the
+     * tile data. If it hasn't changed since the previous
+     * deduplication pass, the next one can be skipped.
+     */
+    inline int tileDataContentChanges() const
+    {
+        return m_tileDataContentChanges.loadAcquire();
+    }
+
     /**
      * Try swap out the tile data.
      * It may fail in case the tile is being accessed
@@ -107,6 +193,14 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Try swap out a batch of tile data objects. The objects being
+     * accessed at the moment are skipped. The data is compressed in
+     * parallel (see KisSwappedDataStore). Returns the metric of the
+     * memory freed.
+     */
+    qint64 trySwapTileData(const QVector<KisTileData*> &tds);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -153,6 +247,7 @@ private:
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -167,6 +262,13 @@ private:
     QAtomicInt m_memoryMetric;
     QAtomicInt m_counter;
     QAtomicInt m_clockIndex;
+    QAtomicInt m_numSwapIns;
+    QAtomicInt m_numSwapOuts;
+    QAtomicInteger<qint64> m_mementoDeltaSize;
+    QAtomicInteger<qint64> m_mementoDeltaDataSize;
+    QAtomicInteger<qint64> m_deduplicatedSize;
+    QAtomicInteger<qint64> m_deduplicatedUniqueSize;
+    QAtomicInt m_tileDataContentChanges;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
 };
@@ -61,6 +61,15 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline qint64 trySwapOut(const QVector<KisTileData*> &tds)
+    {
+        while (m_iterator.isValid() && tds.contains(m_iterator.getValue())) {
+            m_iterator.next();
+        }
+
+        return m_store->trySwapTileData(tds);
+    }
+
 private:
     ConcurrentMap<int, KisTileData*> &m_map;
     ConcurrentMap<int, KisTileData*>::Iterator m_iterator;
@@ -136,6 +145,15 @@ public:
         return m_store->trySwapTileData(td);
     }
 
+    inline qint64 trySwapOut(const QVector<KisTileData*> &tds)
+    {
+        while (m_iterator.isValid() && tds.contains(m_iterator.getValue())) {
+            m_iterator.next();
+        }
+
+        return m_store->trySwapTileData(tds);
+    }
+
 private:
     friend class KisTileDataStore;
     inline int getFinalPosition()
@@ -176,6 +176,30 @@ private:
     }
 
     inline bool erase(quint32 idx)
+    {
+        /**
+         * The iterators read raw pointers from the map without
+         * locking raw pointer access, so the tiles must not be
+         * reclaimed while an iteration is in progress.
+         */
+        bool wasDeleted = false;
+
+        {
+            QReadLocker locker(&m_iteratorLock);
+            wasDeleted = eraseNoIteratorLock(idx);
+        }
+
+        // garbage collection must **not** be run with locks held
+        m_map.getGC().update();
+        return wasDeleted;
+    }
+
+    /**
+     * Used by the iterator, which already holds m_iteratorLock.
+     * It doesn't run the garbage collection, the caller should run
+     * it after m_iteratorLock is released.
+     */
+    inline bool eraseNoIteratorLock(quint32 idx)
     {
         m_map.getGC().lockRawPointerAccess();
 
@@ -192,7 +216,6 @@ private:
 
         m_map.getGC().unlockRawPointerAccess();
 
-        m_map.getGC().update();
         return wasDeleted;
     }
 
@@ -230,6 +253,9 @@ public:
     ~KisTileHashTableIteratorTraits2()
     {
         m_ht->m_iteratorLock.unlock();
+
+        // reclaim the tiles erased by the iterator, when the lock is released
+        m_ht->m_map.getGC().update();
     }
 
     void next()
@@ -249,7 +275,7 @@ public:
 
     void deleteCurrent()
     {
-        m_ht->erase(m_iter.getKey());
+        m_ht->eraseNoIteratorLock(m_iter.getKey());
         next();
     }
 
@@ -259,7 +285,7 @@ public:
         next();
 
         quint32 idx = m_ht->calculateHash(tile->col(), tile->row());
-        m_ht->erase(idx);
+        m_ht->eraseNoIteratorLock(idx);
         newHashTable->insert(idx, tile);
     }
 
@@ -522,11 +548,24 @@ inline KisTileData* KisTileHashTableTraits2<T>::refAndFetchDefaultTileData()
 template <class T>
 void KisTileHashTableTraits2<T>::debugPrintInfo()
 {
+    if (!numTiles()) return;
+
+    qInfo() << "==========================\n"
+             << "TileHashTable (lock-free):"
+             << "\n   def. data:\t\t" << m_defaultTileData
+             << "\n   numTiles:\t\t" << numTiles();
+    qInfo() << "==========================\n";
 }
 
 template <class T>
-void KisTileHashTableTraits2<T>::debugMaxListLength(qint32 &/*min*/, qint32 &/*max*/)
+void KisTileHashTableTraits2<T>::debugMaxListLength(qint32 &min, qint32 &max)
 {
+    /**
+     * The lock-free map uses open addressing,
+     * so there are no collision chains
+     */
+    min = 0;
+    max = 0;
 }
 
 typedef KisTileHashTableTraits2<KisTile> KisTileHashTable;
@@ -8,16 +8,19 @@
 
 #include <QRect>
 #include <QVector>
+#include <QHash>
 
 #include "kis_tile.h"
 #include "kis_tiled_data_manager.h"
 #include "kis_tile_data_wrapper.h"
 #include "kis_tiled_data_manager_p.h"
 #include "kis_memento_manager.h"
+#include "kis_tile_data_deduplicator.h"
 #include "swap/kis_legacy_tile_compressor.h"
 #include "swap/kis_tile_compressor_factory.h"
 
 #include "kis_paint_device_writer.h"
+#include "kis_image_config.h"
 
 #include "kis_global.h"
 
@@ -116,8 +119,11 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileHashTableConstIterator iter(m_hashTable);
     KisTileSP tile;
 
+    const KisTileCompressor2::CompressionMode compressionMode =
+        KisTileCompressor2::CompressionMode(KisImageConfig(true).documentTileCompressionMode());
+
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION, compressionMode);
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -174,6 +180,14 @@ bool KisTiledDataManager::read(QIODevice *stream)
         }
     }
 
+    /**
+     * Solid backgrounds and flat fills are very common in documents.
+     * The tiles are only compacted, not purged, so the tiles filled
+     * with the default pixel are kept and extent() stays the same
+     * as the one of the saved device.
+     */
+    compactUniformTiles(extent());
+
     m_mementoManager->commit();
     return readSuccess;
 }
@@ -260,9 +274,23 @@ wrongString:
     return false;
 }
 
+namespace {
+
+/**
+ * The data is uniform if it is periodic with the period of one
+ * pixel, which can be checked by a single overlapped memcmp()
+ */
+inline bool isUniformData(const quint8 *data, qint32 pixelSize, qint32 dataSize)
+{
+    return !memcmp(data, data + pixelSize, dataSize - pixelSize);
+}
+
+}
+
 void KisTiledDataManager::purge(const QRect& area)
 {
     QList<KisTileSP> tilesToDelete;
+    UniformTilesHash uniformTiles;
     {
         const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize();
         KisTileData *tileData = m_hashTable->refAndFetchDefaultTileData();
@@ -277,6 +305,8 @@ void KisTiledDataManager::purge(const QRect& area)
                 tile->lockForRead();
                 if(memcmp(defaultData, tile->data(), tileDataSize) == 0) {
                     tilesToDelete.push_back(tile);
+                } else if (isUniformData(tile->data(), pixelSize(), tileDataSize)) {
+                    uniformTiles[QByteArray((const char*)tile->data(), pixelSize())].append(tile);
                 }
                 tile->unlockForRead();
             }
@@ -291,6 +321,83 @@ void KisTiledDataManager::purge(const QRect& area)
             m_extentManager.notifyTileRemoved(tile->col(), tile->row());
         }
     }
+
+    QWriteLocker locker(&m_lock);
+    compactUniformTiles(uniformTiles);
+}
+
+void KisTiledDataManager::deduplicateTiles(KisTileDataDeduplicator &deduplicator)
+{
+    // the tiles switch their memento items to the shared data
+    QWriteLocker locker(&m_lock);
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        KisTileData *td = deduplicator.canonicalTileData(tile->tileData());
+        if (td) {
+            tile->shareTileData(td);
+        }
+        iter.next();
+    }
+}
+
+void KisTiledDataManager::compactUniformTiles(const QRect &area)
+{
+    UniformTilesHash uniformTiles;
+    {
+        const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize();
+
+        KisTileHashTableConstIterator iter(m_hashTable);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            if (tile->extent().intersects(area)) {
+                tile->lockForRead();
+                if (isUniformData(tile->data(), pixelSize(), tileDataSize)) {
+                    uniformTiles[QByteArray((const char*)tile->data(), pixelSize())].append(tile);
+                }
+                tile->unlockForRead();
+            }
+            iter.next();
+        }
+    }
+
+    compactUniformTiles(uniformTiles);
+}
+
+void KisTiledDataManager::compactUniformTiles(const UniformTilesHash &uniformTiles)
+{
+    /**
+     * All the tiles filled with the same color share a single tile
+     * data object, the same way as the default tile data is shared
+     * by all the lazily created tiles. Copy-on-write detaches a tile
+     * on the first write, so the iterators and the swapper need no
+     * special handling. The memento items of the tiles are switched
+     * to the shared data by KisTile::shareTileData(), otherwise the
+     * history would keep the old data alive.
+     *
+     * The shared data is a fresh object rather than the data of one
+     * of the tiles, because the latter can still be written into
+     * through its own tile. The tiles could also have been changed
+     * after they were scanned, so KisTile::shareTileData() compares
+     * the content again under the tile's lock and skips such tiles.
+     */
+    for (auto it = uniformTiles.constBegin(); it != uniformTiles.constEnd(); ++it) {
+        if (it.value().size() < 2) continue;
+
+        KisTileData *sharedTd =
+            KisTileDataStore::instance()->createDefaultTileData(pixelSize(),
+                                                                (const quint8*)it.key().constData());
+        sharedTd->ref();
+
+        Q_FOREACH (KisTileSP tile, it.value()) {
+            tile->shareTileData(sharedTd);
+        }
+
+        sharedTd->deref();
+    }
 }
 
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
@@ -675,6 +782,32 @@ KisRegion KisTiledDataManager::region() const
     return KisRegion(std::move(rects));
 }
 
+void KisTiledDataManager::prefetchRect(const QRect &rect) const
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    if (!store->hasSwappedTiles()) return;
+
+    const QRect prefetchRect = rect & m_extentManager.extent();
+    if (prefetchRect.isEmpty()) return;
+
+    const qint32 firstColumn = xToCol(prefetchRect.left());
+    const qint32 lastColumn = xToCol(prefetchRect.right());
+
+    const qint32 firstRow = yToRow(prefetchRect.top());
+    const qint32 lastRow = yToRow(prefetchRect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; ++row) {
+        for (qint32 column = firstColumn; column <= lastColumn; ++column) {
+            KisTileSP tile = m_hashTable->getExistingTile(column, row);
+            if (tile) {
+                store->prefetchTile(tile);
+            }
+        }
+    }
+
+    store->kickPrefetcher();
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
@@ -9,6 +9,8 @@
 
 #include <QtGlobal>
 #include <QVector>
+#include <QHash>
+#include <QByteArray>
 #include <KisRegion.h>
 
 #include <kis_shared.h>
@@ -35,6 +37,7 @@ class KisTiledIterator;
 class KisTiledRandomAccessor;
 class KisPaintDeviceWriter;
 class QIODevice;
+class KisTileDataDeduplicator;
 
 /**
  * KisTiledDataManager implements the interface that KisDataManager defines
@@ -199,8 +202,22 @@ protected:
     bool write(KisPaintDeviceWriter &store);
     bool read(QIODevice *stream);
 
+    /**
+     * Removes the tiles filled with the default pixel and makes the
+     * tiles filled with any other single color share one tile data
+     * object per color (see compactUniformTiles())
+     */
     void purge(const QRect& area);
 
+    /**
+     * Makes the tiles with equal content share the same tile data
+     * objects. \p deduplicator may be shared between several data
+     * managers to find the equal tiles among them as well. The
+     * change is not registered in the undo history, since the
+     * content of the tiles stays exactly the same.
+     */
+    void deduplicateTiles(KisTileDataDeduplicator &deduplicator);
+
     inline quint32 pixelSize() const {
         return m_pixelSize;
     }
@@ -216,6 +233,16 @@ public:
 
     KisRegion region() const;
 
+    /**
+     * Asynchronously loads from swap all the existing tiles that
+     * intersect \p rect. The call is cheap when nothing is swapped
+     * out, so it can be issued for every rect that is going to be
+     * read soon.
+     *
+     * \see KisTileDataPrefetcher
+     */
+    void prefetchRect(const QRect &rect) const;
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
@@ -358,6 +385,19 @@ private:
 
     void recalculateExtent();
 
+    typedef QHash<QByteArray, QList<KisTileSP>> UniformTilesHash;
+
+    /**
+     * Makes the uniform tiles in \p area filled with the same color
+     * share one tile data object per color. Unlike purge() it never
+     * removes any tiles, so the extent of the device is not changed.
+     *
+     * The memento items of the tiles are switched to the shared data
+     * as well, so m_lock must be held for writing.
+     */
+    void compactUniformTiles(const QRect &area);
+    void compactUniformTiles(const UniformTilesHash &uniformTiles);
+
     quint8* duplicatePixel(qint32 num, const quint8 *pixel);
 
     template<bool useOldSrcData>
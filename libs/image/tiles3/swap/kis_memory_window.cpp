@@ -11,8 +11,9 @@
 
 #define SWP_PREFIX "KRITA_SWAP_FILE_XXXXXX"
 
-KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize)
-    : m_readWindowEx(writeWindowSize / 4),
+KisMemoryWindow::KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize, bool mapWholeFile)
+    : m_mapWholeFile(mapWholeFile),
+      m_readWindowEx(writeWindowSize / 4),
       m_writeWindowEx(writeWindowSize)
 {
     m_valid = true;
@@ -49,6 +50,10 @@ KisMemoryWindow::~KisMemoryWindow()
 
 quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 {
+    if (m_mapWholeFile && adjustWholeFileWindow(readChunk)) {
+        return m_writeWindowEx.calculatePointer(readChunk);
+    }
+
     if (!adjustWindow(readChunk, &m_readWindowEx, &m_writeWindowEx)) {
         return nullptr;
     }
@@ -58,6 +63,10 @@ quint8* KisMemoryWindow::getReadChunkPtr(const KisChunkData &readChunk)
 
 quint8* KisMemoryWindow::getWriteChunkPtr(const KisChunkData &writeChunk)
 {
+    if (m_mapWholeFile && adjustWholeFileWindow(writeChunk)) {
+        return m_writeWindowEx.calculatePointer(writeChunk);
+    }
+
     if (!adjustWindow(writeChunk, &m_writeWindowEx, &m_readWindowEx)) {
         return nullptr;
     }
@@ -136,3 +145,61 @@ bool KisMemoryWindow::adjustWindow(const KisChunkData &requestedChunk,
 
 	return true;
 }
+
+bool KisMemoryWindow::adjustWholeFileWindow(const KisChunkData &requestedChunk)
+{
+    /**
+     * In the whole-file mode the write window always covers the
+     * entire file starting at offset zero, and the read window is
+     * not used at all.
+     */
+
+    if (m_writeWindowEx.window &&
+        requestedChunk.m_end <= m_writeWindowEx.chunk.m_end) {
+
+        return true;
+    }
+
+    if (m_writeWindowEx.window) {
+        m_file.unmap(m_writeWindowEx.window);
+        m_writeWindowEx.window = 0;
+    }
+
+    quint64 fileSize = m_file.size();
+
+    if (requestedChunk.m_end >= fileSize) {
+        /**
+         * Grow the file in big steps to avoid remapping it
+         * on every new chunk. The file is sparse on most of the
+         * systems, so it doesn't cost disk space until the data
+         * is actually written.
+         */
+        const quint64 growStep = qMax(m_writeWindowEx.defaultSize, fileSize / 4);
+
+        // Align by 32 bytes
+        fileSize = (requestedChunk.m_end + 1 + growStep + 32) & (~31ULL);
+
+        if (!m_file.resize(fileSize)) {
+            return false;
+        }
+    }
+
+#ifdef Q_OS_UNIX
+    // A workaround for https://bugreports.qt-project.org/browse/QTBUG-6330
+    m_file.exists();
+#endif
+
+    m_writeWindowEx.chunk.setChunk(0, fileSize);
+    m_writeWindowEx.window = m_file.map(0, fileSize);
+
+    if (!m_writeWindowEx.window) {
+        warnKrita << "KisMemoryWindow: failed to map the whole swap file of size"
+                  << fileSize << "falling back to windowed mapping";
+
+        m_writeWindowEx.chunk.setChunk(0, 0);
+        m_mapWholeFile = false;
+        return false;
+    }
+
+    return true;
+}
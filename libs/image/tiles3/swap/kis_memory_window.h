@@ -20,8 +20,13 @@ public:
     /**
      * @param swapDir If the dir doesn't exist, it'll be created, if it's empty QDir::tempPath will be used.
      * @param writeWindowSize write window size.
+     * @param mapWholeFile if true, the whole swap file is mapped at once,
+     *        so reading and writing never remap the windows. The file
+     *        grows in steps of at least \p writeWindowSize. If mapping
+     *        of the whole file fails (e.g. on a 32-bit system), the
+     *        window falls back to the usual two-windows mode.
      */
-    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE);
+    KisMemoryWindow(const QString &swapDir, quint64 writeWindowSize = DEFAULT_WINDOW_SIZE, bool mapWholeFile = false);
     ~KisMemoryWindow();
 
     inline quint8* getReadChunkPtr(KisChunk readChunk) {
@@ -35,6 +40,10 @@ public:
     quint8* getReadChunkPtr(const KisChunkData &readChunk);
     quint8* getWriteChunkPtr(const KisChunkData &writeChunk);
 
+    inline bool isWholeFileMapped() const {
+        return m_mapWholeFile;
+    }
+
 private:
     struct MappingWindow {
         MappingWindow(quint64 _defaultSize)
@@ -59,10 +68,13 @@ private:
                       MappingWindow *adjustingWindow,
                       MappingWindow *otherWindow);
 
+    bool adjustWholeFileWindow(const KisChunkData &requestedChunk);
+
 private:
     QTemporaryFile m_file;
 
     bool m_valid;
+    bool m_mapWholeFile;
     MappingWindow m_readWindowEx;
     MappingWindow m_writeWindowEx;
 };
@@ -11,8 +11,38 @@
 
 #include "kis_tile_compressor_2.h"
 
+#include <QRunnable>
+
 //#define COMPRESSOR_VERSION 2
 
+
+class KisSwapCompressionJob : public QRunnable
+{
+public:
+    KisSwapCompressionJob(KisSwappedDataStore *store,
+                          const QVector<KisTileData*> &tds,
+                          int begin, int end,
+                          KisAbstractTileCompressor *compressor)
+        : m_store(store),
+          m_tds(tds),
+          m_begin(begin),
+          m_end(end),
+          m_compressor(compressor)
+    {
+    }
+
+    void run() override {
+        m_store->compressBatch(m_tds, m_begin, m_end, m_compressor);
+    }
+
+private:
+    KisSwappedDataStore *m_store;
+    const QVector<KisTileData*> &m_tds;
+    int m_begin;
+    int m_end;
+    KisAbstractTileCompressor *m_compressor;
+};
+
 KisSwappedDataStore::KisSwappedDataStore()
     : m_memoryMetric(0)
 {
@@ -22,14 +52,27 @@ KisSwappedDataStore::KisSwappedDataStore()
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize, config.swapMapWholeFile());
 
     // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    const KisTileCompressor2::CompressionMode compressionMode =
+        KisTileCompressor2::CompressionMode(config.swapCompressionMode());
+
+    m_compressor = new KisTileCompressor2(compressionMode);
+
+    const int numThreads = config.swapCompressionThreads();
+    m_compressionPool.setMaxThreadCount(numThreads);
+
+    for (int i = 0; i < numThreads; i++) {
+        m_workerCompressors << new KisTileCompressor2(compressionMode);
+    }
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
+    m_compressionPool.waitForDone();
+    qDeleteAll(m_workerCompressors);
+
     delete m_compressor;
     delete m_swapSpace;
     delete m_allocator;
@@ -77,6 +120,89 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     return true;
 }
 
+QVector<KisTileData*> KisSwappedDataStore::trySwapOutTileData(const QVector<KisTileData*> &tds)
+{
+    QVector<KisTileData*> result;
+    if (tds.isEmpty()) return result;
+
+    QMutexLocker locker(&m_lock);
+
+    if (m_batchBuffers.size() < tds.size()) {
+        m_batchBuffers.resize(tds.size());
+    }
+    m_batchSizes.resize(tds.size());
+
+    /**
+     * Compression is CPU-bound, so we split the batch into contiguous
+     * ranges and compress them in parallel...
+     */
+    const int numJobs = qMin(tds.size(), m_workerCompressors.size());
+
+    if (numJobs <= 1) {
+        compressBatch(tds, 0, tds.size(), m_compressor);
+    } else {
+        const int jobSize = (tds.size() + numJobs - 1) / numJobs;
+
+        for (int i = 0; i < numJobs; i++) {
+            const int begin = i * jobSize;
+            const int end = qMin(begin + jobSize, tds.size());
+            if (begin >= end) break;
+
+            m_compressionPool.start(
+                new KisSwapCompressionJob(this, tds, begin, end, m_workerCompressors[i]));
+        }
+
+        m_compressionPool.waitForDone();
+    }
+
+    /**
+     * ... and write them sequentially in the order of the batch,
+     * so that the swap file is filled linearly
+     */
+    result.reserve(tds.size());
+
+    for (int i = 0; i < tds.size(); i++) {
+        KisTileData *td = tds[i];
+        const qint32 bytesWritten = m_batchSizes[i];
+
+        KisChunk chunk = m_allocator->getChunk(bytesWritten);
+        quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+        if (!ptr) {
+            qWarning() << "swap out of tile failed";
+            m_allocator->freeChunk(chunk);
+            continue;
+        }
+        memcpy(ptr, m_batchBuffers[i].constData(), bytesWritten);
+
+        td->releaseMemory();
+        td->setSwapChunk(chunk);
+
+        m_memoryMetric += td->pixelSize();
+
+        result << td;
+    }
+
+    return result;
+}
+
+void KisSwappedDataStore::compressBatch(const QVector<KisTileData*> &tds, int begin, int end,
+                                        KisAbstractTileCompressor *compressor)
+{
+    for (int i = begin; i < end; i++) {
+        KisTileData *td = tds[i];
+        Q_ASSERT(td->data());
+
+        QByteArray &buffer = m_batchBuffers[i];
+
+        const qint32 expectedBufferSize = compressor->tileDataBufferSize(td);
+        if (buffer.size() < expectedBufferSize) {
+            buffer.resize(expectedBufferSize);
+        }
+
+        compressor->compressTileData(td, (quint8*) buffer.data(), buffer.size(), m_batchSizes[i]);
+    }
+}
+
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
@@ -11,6 +11,8 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QVector>
+#include <QThreadPool>
 
 
 class QMutex;
@@ -38,6 +40,17 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Swap out a batch of tile data objects. The data is compressed
+     * in parallel by a bounded pool of worker threads, and then
+     * written into the swap file by the calling thread in the order
+     * of \a tds. Returns the objects that have been swapped out
+     * successfully.
+     * LOCKING: the locks on all the tile data objects should be
+     *          taken by the caller before making a call.
+     */
+    QVector<KisTileData*> trySwapOutTileData(const QVector<KisTileData*> &tds);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -64,10 +77,28 @@ public:
      */
     void debugStatistics();
 
+private:
+    friend class KisSwapCompressionJob;
+    void compressBatch(const QVector<KisTileData*> &tds, int begin, int end,
+                       KisAbstractTileCompressor *compressor);
+
 private:
     QByteArray m_buffer;
     KisAbstractTileCompressor *m_compressor;
 
+    /**
+     * Every worker thread uses its own compressor, because the
+     * compressors keep internal buffers
+     */
+    QVector<KisAbstractTileCompressor*> m_workerCompressors;
+    QThreadPool m_compressionPool;
+
+    /**
+     * Compressed data of the batch being swapped out
+     */
+    QVector<QByteArray> m_batchBuffers;
+    QVector<qint32> m_batchSizes;
+
     KisChunkAllocator *m_allocator;
     KisMemoryWindow *m_swapSpace;
 
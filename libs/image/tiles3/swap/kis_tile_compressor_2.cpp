@@ -6,21 +6,39 @@
 
 #include "kis_tile_compressor_2.h"
 #include "kis_lzf_compression.h"
+#include "kis_zstd_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
+const QString KisTileCompressor2::m_lzfCompressionName = "LZF";
+const QString KisTileCompressor2::m_zstdCompressionName = "ZSTD";
 
 
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(CompressionMode mode)
+    : m_lzfCompression(new KisLzfCompression()),
+      m_zstdCompression(0)
 {
-    m_compression = new KisLzfCompression();
+    if (mode != LzfCompression && KisZstdCompression::isSupported()) {
+        m_zstdCompression =
+            new KisZstdCompression(mode == HighRatioCompression ?
+                                   KisZstdCompression::HighRatioLevel :
+                                   KisZstdCompression::FastLevel);
+
+        m_compression = m_zstdCompression;
+        m_compressedDataFlag = ZSTD_COMPRESSED_DATA_FLAG;
+        m_compressionName = m_zstdCompressionName;
+    } else {
+        m_compression = m_lzfCompression;
+        m_compressedDataFlag = COMPRESSED_DATA_FLAG;
+        m_compressionName = m_lzfCompressionName;
+    }
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
-    delete m_compression;
+    delete m_zstdCompression;
+    delete m_lzfCompression;
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
@@ -63,7 +81,22 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The codec is also encoded in the first byte of the tile
+         * data, so we only check that we know how to read it
+         */
+        if (compressionName != m_lzfCompressionName &&
+            compressionName != m_zstdCompressionName) {
+
+            warnFile << "Unknown tile compression:" << compressionName;
+            return false;
+        }
+
+        if (dataSize > m_streamingBuffer.size()) {
+            warnFile << "Tile data is bigger than the tile:" << dataSize << m_streamingBuffer.size();
+            return false;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -122,8 +155,8 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = m_compressedDataFlag;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -141,12 +174,15 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
+    if(buffer[0] != RAW_DATA_FLAG) {
+        KisAbstractCompression *compression = compressionForFlag(buffer[0]);
+        if (!compression) return false;
+
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
                                                       tileData->data(),
@@ -163,6 +199,28 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
 
 }
 
+KisAbstractCompression* KisTileCompressor2::compressionForFlag(quint8 flag)
+{
+    KisAbstractCompression *compression = 0;
+
+    if (flag == COMPRESSED_DATA_FLAG) {
+        compression = m_lzfCompression;
+    } else if (flag == ZSTD_COMPRESSED_DATA_FLAG) {
+        if (!KisZstdCompression::isSupported()) {
+            warnKrita << "Cannot decompress the tile: Krita is built without zstd support";
+        } else {
+            if (!m_zstdCompression) {
+                m_zstdCompression = new KisZstdCompression();
+            }
+            compression = m_zstdCompression;
+        }
+    } else {
+        warnKrita << "Unknown tile compression flag:" << int(flag);
+    }
+
+    return compression;
+}
+
 qint32 KisTileCompressor2::tileDataBufferSize(KisTileData *tileData)
 {
     return TILE_DATA_SIZE(tileData->pixelSize()) + 1;
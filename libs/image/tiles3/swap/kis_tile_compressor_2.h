@@ -10,11 +10,29 @@
 #include "kis_abstract_tile_compressor.h"
 
 class KisAbstractCompression;
+class KisLzfCompression;
+class KisZstdCompression;
 
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    /**
+     * The codec used for *writing* the tiles. Reading doesn't
+     * depend on the mode, the codec is detected from the tile
+     * header, so tiles written in any mode (including legacy
+     * LZF tiles) can always be read back.
+     *
+     * When Krita is built without zstd, FastCompression and
+     * HighRatioCompression silently fall back to LZF.
+     */
+    enum CompressionMode {
+        LzfCompression = 0,
+        FastCompression,
+        HighRatioCompression
+    };
+
+public:
+    KisTileCompressor2(CompressionMode mode = LzfCompression);
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
@@ -37,16 +55,31 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    KisAbstractCompression* compressionForFlag(quint8 flag);
+
 private:
     static const qint8 RAW_DATA_FLAG = 0;
     static const qint8 COMPRESSED_DATA_FLAG = 1;
+    static const qint8 ZSTD_COMPRESSED_DATA_FLAG = 2;
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    /**
+     * The codec used for writing, points to one of
+     * the two objects below
+     */
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+    qint8 m_compressedDataFlag;
+    QString m_compressionName;
+
+    KisLzfCompression *m_lzfCompression;
+    KisZstdCompression *m_zstdCompression;
+
+    static const QString m_lzfCompressionName;
+    static const QString m_zstdCompressionName;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
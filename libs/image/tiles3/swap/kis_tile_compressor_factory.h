@@ -13,13 +13,18 @@
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * \p mode defines the codec used for writing the tiles, it is
+     * ignored for the legacy version. Reading doesn't depend on it.
+     */
+    static KisAbstractTileCompressorSP create(qint32 version,
+                                              KisTileCompressor2::CompressionMode mode = KisTileCompressor2::LzfCompression) {
         switch(version) {
         case 1:
             return KisAbstractTileCompressorSP(new KisLegacyTileCompressor());
             break;
         case 2:
-            return KisAbstractTileCompressorSP(new KisTileCompressor2());
+            return KisAbstractTileCompressorSP(new KisTileCompressor2(mode));
             break;
         default:
             qFatal("Unknown version of the tiles");
@@ -0,0 +1,117 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+
+#include <QSemaphore>
+
+#include "kis_lockless_stack.h"
+#include "kis_image_config.h"
+#include "tiles3/kis_tile.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_debug.h"
+
+//#define DEBUG_PREFETCHER
+
+#ifdef DEBUG_PREFETCHER
+#define DEBUG_ACTION(action) dbgKrita << action
+#else
+#define DEBUG_ACTION(action)
+#endif
+
+/**
+ * Each tile is 16 KiB for an 8-bit RGBA image, so 4096 tiles is
+ * about 64 MiB of pending data, which is much more than a canvas
+ * viewport or a single update patch can touch.
+ */
+const qint32 KisTileDataPrefetcher::MAX_QUEUE_SIZE = 4096;
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+public:
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+    KisLocklessStack<KisTileSP> queue;
+    bool enabled = true;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+    testingRereadConfig();
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::prefetchTile(KisTileSP tile)
+{
+    if (!m_d->enabled || m_d->queue.size() >= MAX_QUEUE_SIZE) return;
+
+    m_d->queue.push(tile);
+}
+
+void KisTileDataPrefetcher::kick()
+{
+    if (!m_d->queue.isEmpty()) {
+        m_d->semaphore.release();
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+
+    m_d->queue.clear();
+}
+
+void KisTileDataPrefetcher::testingRereadConfig()
+{
+    KisImageConfig config(true);
+    m_d->enabled = config.swapPrefetchEnabled();
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        KisTileSP tile;
+        int numTiles = 0;
+
+        while (m_d->queue.pop(tile)) {
+            if (m_d->shouldExitFlag) break;
+
+            /**
+             * Locking the tile for read ensures its data is loaded
+             * from swap. The tile is not swapped out immediately
+             * after unlocking, because blockSwapping() resets the
+             * age of the tile data.
+             */
+            tile->lockForRead();
+            tile->unlockForRead();
+            tile = 0;
+
+            numTiles++;
+        }
+
+        DEBUG_ACTION("Prefetched tiles:" << numTiles);
+        Q_UNUSED(numTiles);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QObject>
+#include <QThread>
+
+#include "kritaimage_export.h"
+#include "kis_shared_ptr.h"
+
+class KisTile;
+typedef KisSharedPtr<KisTile> KisTileSP;
+
+class KisTileDataStore;
+
+/**
+ * A thread that loads the tiles from swap in the background.
+ *
+ * The canvas and the update walkers know in advance which tiles
+ * they are going to read. They pass them to prefetchTile(), and the
+ * prefetcher loads them from swap while the image is still busy
+ * with compositing the previous tiles. When the consumer reaches the
+ * tile, it is already in memory and the GUI thread doesn't stall
+ * on swap-in.
+ *
+ * The prefetch queue is bounded. If the queue is full, the request
+ * is just dropped, the tile will be loaded synchronously as usual.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Requests asynchronous loading of \p tile from swap. The
+     * prefetcher holds a reference to the tile until it is
+     * loaded, so the tile may be detached from the data manager
+     * in the meantime.
+     */
+    void prefetchTile(KisTileSP tile);
+
+    /**
+     * Wakes up the prefetching thread after a batch of
+     * prefetchTile() calls
+     */
+    void kick();
+
+    void terminatePrefetcher();
+
+    void testingRereadConfig();
+
+private:
+    void run() override;
+
+private:
+    static const qint32 MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
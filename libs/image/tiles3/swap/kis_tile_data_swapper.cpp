@@ -5,6 +5,11 @@
  */
 
 #include <QSemaphore>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QPair>
+
+#include <algorithm>
 
 #include "tiles3/swap/kis_tile_data_swapper.h"
 #include "tiles3/swap/kis_tile_data_swapper_p.h"
@@ -17,6 +22,7 @@
 
 const qint32 KisTileDataSwapper::TIMEOUT = -1;
 const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
+const int KisTileDataSwapper::SWAP_BATCH_SIZE = 64;
 
 //#define DEBUG_SWAPPER
 
@@ -30,6 +36,7 @@ const qint32 KisTileDataSwapper::DELAY = 0.7 * SEC;
 
 class SoftSwapStrategy;
 class AggressiveSwapStrategy;
+class AdaptiveSwapStrategy;
 
 
 struct Q_DECL_HIDDEN KisTileDataSwapper::Private
@@ -39,7 +46,15 @@ public:
     QAtomicInt shouldExitFlag;
     KisTileDataStore *store;
     KisStoreLimits limits;
+    bool useAdaptivePolicy;
     QMutex cycleLock;
+
+    /**
+     * Set when the swapper thread has been kicked, but hasn't
+     * started the cycle yet
+     */
+    QAtomicInt isKicked;
+    QAtomicInteger<qint64> throughput;
 };
 
 KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
@@ -48,6 +63,7 @@ KisTileDataSwapper::KisTileDataSwapper(KisTileDataStore *store)
 {
     m_d->shouldExitFlag = 0;
     m_d->store = store;
+    m_d->useAdaptivePolicy = KisImageConfig(true).useAdaptiveSwapPolicy();
 }
 
 KisTileDataSwapper::~KisTileDataSwapper()
@@ -85,14 +101,35 @@ void KisTileDataSwapper::run()
         QThread::msleep(DELAY);
 
         doJob();
+        m_d->isKicked.storeRelease(0);
     }
 }
 
 void KisTileDataSwapper::checkFreeMemory()
 {
 //    dbgKrita <<"check memory: high limit -" << m_d->limits.emergencyThreshold() <<"in mem -" << m_d->store->numTilesInMemory();
-    if(m_d->store->memoryMetric() > m_d->limits.emergencyThreshold())
+    const qint64 memoryMetric = m_d->store->memoryMetric();
+
+    if (memoryMetric > m_d->limits.emergencyThreshold()) {
+        /**
+         * Backpressure: the thread allocating new tiles either runs
+         * the cycle itself or waits until the swapper thread finishes
+         * the current one.
+         */
         doJob();
+    } else if (memoryMetric > m_d->limits.hardLimitThreshold() &&
+               m_d->isKicked.testAndSetOrdered(0, 1)) {
+        /**
+         * Start swapping in background before we reach the emergency
+         * threshold and the painting threads start to stall
+         */
+        kick();
+    }
+}
+
+qint64 KisTileDataSwapper::swapOutThroughput() const
+{
+    return m_d->throughput.loadAcquire();
 }
 
 void KisTileDataSwapper::doJob()
@@ -104,6 +141,10 @@ void KisTileDataSwapper::doJob()
     QMutexLocker locker(&m_d->cycleLock);
 
     qint32 memoryMetric = m_d->store->memoryMetric();
+    const qint32 initialMemoryMetric = memoryMetric;
+
+    QElapsedTimer timer;
+    timer.start();
 
     DEBUG_ACTION("Started swap cycle");
     DEBUG_VALUE(m_d->store->numTiles());
@@ -125,10 +166,27 @@ void KisTileDataSwapper::doJob()
             qint32 hardFree =  memoryMetric - m_d->limits.hardLimit();
             DEBUG_VALUE(hardFree);
             DEBUG_ACTION("\t pass1");
-            memoryMetric -= pass<AggressiveSwapStrategy>(hardFree);
+            memoryMetric -= m_d->useAdaptivePolicy ?
+                pass<AdaptiveSwapStrategy>(hardFree) :
+                pass<AggressiveSwapStrategy>(hardFree);
             DEBUG_VALUE(memoryMetric);
         }
     }
+
+    const qint64 freedBytes =
+        qint64(initialMemoryMetric - memoryMetric) * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    if (freedBytes > 0 && elapsed > 0) {
+        const qint64 cycleThroughput = freedBytes * 1000000000 / elapsed;
+        const qint64 oldThroughput = m_d->throughput.loadAcquire();
+
+        m_d->throughput.storeRelease(oldThroughput ?
+                                     (3 * oldThroughput + cycleThroughput) / 4 :
+                                     cycleThroughput);
+
+        DEBUG_VALUE(m_d->throughput.loadAcquire());
+    }
 }
 
 
@@ -153,6 +211,19 @@ public:
     static inline bool swapOutFirst(KisTileData *td) {
         return td->age() > 0;
     }
+
+    static inline void markCandidate(KisTileData *td) {
+        td->markOld();
+    }
+
+    static inline bool isPinned(KisTileData *td) {
+        Q_UNUSED(td);
+        return false;
+    }
+
+    static inline void sortCandidates(QList<KisTileData*> &candidates) {
+        Q_UNUSED(candidates);
+    }
 };
 
 class AggressiveSwapStrategy
@@ -177,6 +248,88 @@ public:
     static inline bool swapOutFirst(KisTileData *td) {
         return td->age() > 0;
     }
+
+    static inline void markCandidate(KisTileData *td) {
+        td->markOld();
+    }
+
+    static inline bool isPinned(KisTileData *td) {
+        Q_UNUSED(td);
+        return false;
+    }
+
+    static inline void sortCandidates(QList<KisTileData*> &candidates) {
+        Q_UNUSED(candidates);
+    }
+};
+
+/**
+ * A frequency-aware version of the clock sweep (close to LRU-2 in
+ * behavior, but without keeping any timestamps). The tile data
+ * objects that were accessed only once since the last sweep are
+ * swapped out first, the rest cool down by halving their access
+ * frequency on every sweep. The tiles that are accessed over and
+ * over again, e.g. the ones in the dirty region of the current
+ * stroke and the visible part of the projection, are pinned: they
+ * are swapped out only if the store has reached the emergency
+ * threshold.
+ */
+class AdaptiveSwapStrategy
+{
+public:
+    typedef KisTileDataStoreClockIterator iterator;
+
+    static const int PINNED_FREQUENCY = 4;
+
+    static inline iterator* beginIteration(KisTileDataStore *store) {
+        return store->beginClockIteration();
+    }
+
+    static inline void endIteration(KisTileDataStore *store, iterator *iter) {
+        store->endIteration(iter);
+    }
+
+    static inline bool isInteresting(KisTileData *td) {
+        Q_UNUSED(td);
+        return true;
+    }
+
+    static inline bool swapOutFirst(KisTileData *td) {
+        return td->age() > 0 && !td->accessFrequency();
+    }
+
+    static inline void markCandidate(KisTileData *td) {
+        td->markOld();
+        td->decayAccessFrequency();
+    }
+
+    static inline bool isPinned(KisTileData *td) {
+        return td->accessFrequency() >= PINNED_FREQUENCY;
+    }
+
+    static inline void sortCandidates(QList<KisTileData*> &candidates) {
+        /**
+         * The frequencies are changed by other threads concurrently,
+         * so take a snapshot to keep the ordering consistent while
+         * sorting
+         */
+        QVector<QPair<int, KisTileData*>> sortedCandidates;
+        sortedCandidates.reserve(candidates.size());
+
+        Q_FOREACH (KisTileData *td, candidates) {
+            sortedCandidates.append(qMakePair(td->accessFrequency(), td));
+        }
+
+        std::stable_sort(sortedCandidates.begin(), sortedCandidates.end(),
+                         [] (const QPair<int, KisTileData*> &lhs,
+                             const QPair<int, KisTileData*> &rhs) {
+                             return lhs.first < rhs.first;
+                         });
+
+        for (int i = 0; i < sortedCandidates.size(); i++) {
+            candidates[i] = sortedCandidates[i].second;
+        }
+    }
 };
 
 
@@ -186,38 +339,67 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
     qint64 freedMetric = 0;
     QList<KisTileData*> additionalCandidates;
 
+    /**
+     * The tile data objects are swapped out in batches, so that
+     * the swapped data store could compress them in parallel
+     */
+    QVector<KisTileData*> batch;
+    qint64 batchMetric = 0;
+    batch.reserve(SWAP_BATCH_SIZE);
+
     typename strategy::iterator *iter =
         strategy::beginIteration(m_d->store);
 
+    auto flushBatch = [&] () {
+        freedMetric += iter->trySwapOut(batch);
+        batch.clear();
+        batchMetric = 0;
+    };
+
+    auto addToBatch = [&] (KisTileData *td) {
+        batch.append(td);
+        batchMetric += td->pixelSize();
+
+        if (batch.size() >= SWAP_BATCH_SIZE) {
+            flushBatch();
+        }
+    };
+
     KisTileData *item = 0;
 
     while (iter->hasNext()) {
         item = iter->next();
 
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + batchMetric >= needToFreeMetric) break;
 
         if (!strategy::isInteresting(item)) continue;
 
         if (strategy::swapOutFirst(item)) {
-            if (iter->trySwapOut(item)) {
-                freedMetric += item->pixelSize();
-            }
+            addToBatch(item);
         }
         else {
-            item->markOld();
+            strategy::markCandidate(item);
             additionalCandidates.append(item);
         }
 
     }
 
+    flushBatch();
+
+    strategy::sortCandidates(additionalCandidates);
+
+    const bool isEmergency =
+        m_d->store->memoryMetric() > m_d->limits.emergencyThreshold();
+
     Q_FOREACH (item, additionalCandidates) {
-        if (freedMetric >= needToFreeMetric) break;
+        if (freedMetric + batchMetric >= needToFreeMetric) break;
+        if (!isEmergency && strategy::isPinned(item)) continue;
 
-        if (iter->trySwapOut(item)) {
-            freedMetric += item->pixelSize();
-        }
+        addToBatch(item);
     }
 
+    flushBatch();
+
     strategy::endIteration(m_d->store, iter);
 
     return freedMetric;
@@ -226,4 +408,5 @@ qint64 KisTileDataSwapper::pass(qint64 needToFreeMetric)
 void KisTileDataSwapper::testingRereadConfig()
 {
     m_d->limits = KisStoreLimits();
+    m_d->useAdaptivePolicy = KisImageConfig(true).useAdaptiveSwapPolicy();
 }
@@ -28,6 +28,13 @@ public:
     void terminateSwapper();
     void checkFreeMemory();
 
+    /**
+     * The speed of the last swap cycles in bytes per second
+     * (exponentially smoothed). Zero if nothing has been
+     * swapped out yet.
+     */
+    qint64 swapOutThroughput() const;
+
     void testingRereadConfig();
 
 private:
@@ -40,6 +47,7 @@ private:
 private:
     static const qint32 TIMEOUT;
     static const qint32 DELAY;
+    static const int SWAP_BATCH_SIZE;
 
 private:
     struct Private;
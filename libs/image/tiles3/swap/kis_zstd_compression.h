@@ -0,0 +1,54 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZSTD_COMPRESSION_H
+#define __KIS_ZSTD_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+#include <QScopedPointer>
+
+/**
+ * Zstandard-based compression. The same codec covers two use cases
+ * depending on the level passed to the constructor:
+ *
+ * - negative levels are faster than LZF at a comparable ratio, which
+ *   suits swapping, where the compressor runs under memory pressure
+ *
+ * - positive levels trade speed for ratio, which suits float
+ *   tiles stored in .kra files
+ *
+ * The decompressor doesn't depend on the level, so tiles written at
+ * any level can be read back by any instance.
+ *
+ * If Krita is built without zstd, isSupported() returns false and
+ * both compress() and decompress() fail by returning 0.
+ */
+class KRITAIMAGE_EXPORT KisZstdCompression : public KisAbstractCompression
+{
+public:
+    enum Level {
+        FastLevel = -4,
+        HighRatioLevel = 9
+    };
+
+public:
+    KisZstdCompression(int level = FastLevel);
+    ~KisZstdCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+    static bool isSupported();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif /* __KIS_ZSTD_COMPRESSION_H */
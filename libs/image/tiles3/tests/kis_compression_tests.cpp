@@ -11,6 +11,7 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_zstd_compression.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -209,6 +210,34 @@ void KisCompressionTests::testLzfOverflow()
     delete compression;
 }
 
+void KisCompressionTests::testZstdRoundTrip()
+{
+    if (!KisZstdCompression::isSupported()) {
+        QSKIP("Krita is built without zstd");
+    }
+
+    KisAbstractCompression *compression = new KisZstdCompression(KisZstdCompression::FastLevel);
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    delete compression;
+
+    compression = new KisZstdCompression(KisZstdCompression::HighRatioLevel);
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::testZstdOverflow()
+{
+    if (!KisZstdCompression::isSupported()) {
+        QSKIP("Krita is built without zstd");
+    }
+
+    KisAbstractCompression *compression = new KisZstdCompression();
+    testOverflow(compression);
+    delete compression;
+}
+
 void KisCompressionTests::benchmarkMemCpy()
 {
     QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
@@ -249,6 +278,26 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     benchmarkDecompressionTwoPass(compression);
     delete compression;
 }
+void KisCompressionTests::benchmarkCompressionZstdFast()
+{
+    KisAbstractCompression *compression = new KisZstdCompression(KisZstdCompression::FastLevel);
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionZstdHighRatio()
+{
+    KisAbstractCompression *compression = new KisZstdCompression(KisZstdCompression::HighRatioLevel);
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionZstd()
+{
+    KisAbstractCompression *compression = new KisZstdCompression();
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
 
 SIMPLE_TEST_MAIN(KisCompressionTests)
 
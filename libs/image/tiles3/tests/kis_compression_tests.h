@@ -29,6 +29,8 @@ private:
 private Q_SLOTS:
     void testLzfRoundTrip();
     void testLzfOverflow();
+    void testZstdRoundTrip();
+    void testZstdOverflow();
 
     void benchmarkMemCpy();
 
@@ -36,6 +38,10 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void benchmarkCompressionZstdFast();
+    void benchmarkCompressionZstdHighRatio();
+    void benchmarkDecompressionZstd();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
@@ -42,6 +42,47 @@ void KisMemoryWindowTest::testWindow()
     QVERIFY(!memcmp(ptr, oddBuf, chunkLength));
 }
 
+void KisMemoryWindowTest::testWholeFileWindow()
+{
+    QTemporaryDir swapDir;
+    KisMemoryWindow memory(swapDir.path(), 1024, true);
+
+    const quint8 chunkLength = 10;
+
+    quint8 oddBuf1[chunkLength];
+    memset(oddBuf1, 0xee, chunkLength);
+
+    quint8 oddBuf2[chunkLength];
+    memset(oddBuf2, 0xdd, chunkLength);
+
+    KisChunkData chunk1(0, chunkLength);
+    KisChunkData chunk2(1025, chunkLength);
+    KisChunkData chunk3(16 * 1024, chunkLength);
+
+    quint8 *ptr;
+
+    ptr = memory.getWriteChunkPtr(chunk1);
+    memcpy(ptr, oddBuf1, chunkLength);
+
+    ptr = memory.getWriteChunkPtr(chunk2);
+    memcpy(ptr, oddBuf2, chunkLength);
+
+    // growing the file must keep the data written before
+    ptr = memory.getWriteChunkPtr(chunk3);
+    memcpy(ptr, oddBuf1, chunkLength);
+
+    QVERIFY(memory.isWholeFileMapped());
+
+    ptr = memory.getReadChunkPtr(chunk2);
+    QVERIFY(!memcmp(ptr, oddBuf2, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk1);
+    QVERIFY(!memcmp(ptr, oddBuf1, chunkLength));
+
+    ptr = memory.getReadChunkPtr(chunk3);
+    QVERIFY(!memcmp(ptr, oddBuf1, chunkLength));
+}
+
 void KisMemoryWindowTest::testTopReports()
 {
 
@@ -15,6 +15,7 @@ class KisMemoryWindowTest : public QObject
 
 private Q_SLOTS:
     void testWindow();
+    void testWholeFileWindow();
 
 private:
     // disabled since long-running
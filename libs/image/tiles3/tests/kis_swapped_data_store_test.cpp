@@ -119,5 +119,59 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testBatchRoundTrip()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 1000;
+    const qint32 BATCH_SIZE = 64;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(4);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setSwapCompressionThreads(4);
+
+
+    KisSwappedDataStore store;
+
+    QVector<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance());
+
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        // make the tiles not too compressible
+        td->data()[i % TILESIZE] = COLUMN2COLOR(i) + 1;
+
+        tileDataList.append(td);
+    }
+
+    for(qint32 i = 0; i < NUM_TILES; i += BATCH_SIZE) {
+        const QVector<KisTileData*> batch = tileDataList.mid(i, BATCH_SIZE);
+
+        // FIXME: take a lock of the tile data
+        QCOMPARE(store.trySwapOutTileData(batch), batch);
+    }
+
+    store.debugStatistics();
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        QVERIFY(!td->data());
+
+        // FIXME: take a lock of the tile data
+        store.swapInTileData(td);
+        QCOMPARE(td->data()[i % TILESIZE], quint8(COLUMN2COLOR(i) + 1));
+        td->data()[i % TILESIZE] = COLUMN2COLOR(i);
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE));
+    }
+
+    store.debugStatistics();
+
+    config.setSwapCompressionThreads(config.swapCompressionThreads(true));
+
+    qDeleteAll(tileDataList);
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
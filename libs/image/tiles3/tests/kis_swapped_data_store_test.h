@@ -21,6 +21,7 @@ private:
 private Q_SLOTS:
     void testRoundTrip();
     void testRandomAccess();
+    void testBatchRoundTrip();
 
 };
 
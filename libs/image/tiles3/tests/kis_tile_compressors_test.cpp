@@ -167,6 +167,73 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRoundTripFast()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::FastCompression);
+    doRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripFast()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::FastCompression);
+    doLowLevelRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripIncompressibleFast()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::FastCompression);
+    doLowLevelRoundTripIncompressible(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testRoundTripHighRatio()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::HighRatioCompression);
+    doRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testLowLevelRoundTripHighRatio()
+{
+    KisAbstractTileCompressor *compressor = new KisTileCompressor2(KisTileCompressor2::HighRatioCompression);
+    doLowLevelRoundTrip(compressor);
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testReadLzfWithZstdCompressor()
+{
+    /**
+     * Tiles written by the legacy LZF codec must still be
+     * readable by a compressor configured to write zstd
+     */
+
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    KisTileCompressor2 lzfCompressor(KisTileCompressor2::LzfCompression);
+    KisTileCompressor2 zstdCompressor(KisTileCompressor2::FastCompression);
+
+    qint32 bufferSize = lzfCompressor.tileDataBufferSize(td);
+    quint8 *buffer = new quint8[bufferSize];
+    qint32 bytesWritten;
+    lzfCompressor.compressTileData(td, buffer, bufferSize, bytesWritten);
+
+    memset(td->data(), oddPixel2, TILESIZE);
+    QVERIFY(zstdCompressor.decompressTileData(buffer, bytesWritten, td));
+    QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+
+    delete[] buffer;
+    tile->unlock();
+}
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
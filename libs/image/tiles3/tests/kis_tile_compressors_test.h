@@ -26,6 +26,15 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTripFast();
+    void testLowLevelRoundTripFast();
+    void testLowLevelRoundTripIncompressibleFast();
+
+    void testRoundTripHighRatio();
+    void testLowLevelRoundTripHighRatio();
+
+    void testReadLzfWithZstdCompressor();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
@@ -0,0 +1,127 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_data_slab_allocator_test.h"
+#include <simpletest.h>
+
+#include <QSet>
+
+#include "kis_debug.h"
+
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_slab_allocator.h"
+
+
+void KisTileDataSlabAllocatorTest::testAllocation_data()
+{
+    QTest::addColumn<int>("pixelSize");
+
+    QTest::newRow("gray-u8") << 1;
+    QTest::newRow("rgba-u8") << 4;
+    QTest::newRow("rgba-u16") << 8;
+    QTest::newRow("rgba-f32") << 16;
+    QTest::newRow("cmyka-f32") << 20;
+    QTest::newRow("rgba-f64") << 32;
+}
+
+void KisTileDataSlabAllocatorTest::testAllocation()
+{
+    QFETCH(int, pixelSize);
+
+    KisTileDataSlabAllocator allocator;
+
+    const int chunkSize = pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT;
+    const int numChunks = 100;
+
+    QVector<quint8*> chunks;
+    QSet<quint8*> uniqueChunks;
+
+    for (int i = 0; i < numChunks; i++) {
+        quint8 *ptr = allocator.allocate(pixelSize);
+        QVERIFY(ptr);
+
+        // check that the chunks don't overlap
+        memset(ptr, i, chunkSize);
+
+        chunks << ptr;
+        uniqueChunks << ptr;
+    }
+
+    QCOMPARE(uniqueChunks.size(), numChunks);
+    QCOMPARE(allocator.usedMemory(), qint64(numChunks) * chunkSize);
+    QVERIFY(allocator.reservedMemory() >= allocator.usedMemory());
+
+    for (int i = 0; i < numChunks; i++) {
+        QCOMPARE(int(chunks[i][0]), i);
+        QCOMPARE(int(chunks[i][chunkSize - 1]), i);
+    }
+
+    // free every second chunk and allocate them back
+    for (int i = 0; i < numChunks; i += 2) {
+        allocator.deallocate(chunks[i], pixelSize);
+    }
+
+    for (int i = 0; i < numChunks; i += 2) {
+        chunks[i] = allocator.allocate(pixelSize);
+        QVERIFY(uniqueChunks.contains(chunks[i]));
+    }
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        allocator.deallocate(ptr, pixelSize);
+    }
+
+    QCOMPARE(allocator.usedMemory(), qint64(0));
+}
+
+void KisTileDataSlabAllocatorTest::testEmptySlabsReleased()
+{
+    const int pixelSize = 4;
+
+    KisTileDataSlabAllocator allocator;
+
+    QVector<quint8*> chunks;
+
+    for (int i = 0; i < 1000; i++) {
+        chunks << allocator.allocate(pixelSize);
+    }
+
+    const int numSlabs = allocator.numSlabs(pixelSize);
+    QVERIFY(numSlabs > 1);
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        allocator.deallocate(ptr, pixelSize);
+    }
+
+    // only one empty slab is kept in reserve
+    QCOMPARE(allocator.numSlabs(pixelSize), 1);
+    QCOMPARE(allocator.usedMemory(), qint64(0));
+
+    const qint64 reservedMemory = allocator.reservedMemory();
+    QVERIFY(reservedMemory > 0);
+
+    // the reserve survives the explicit release as well
+    allocator.releaseEmptySlabs();
+
+    QCOMPARE(allocator.numSlabs(pixelSize), 1);
+    QCOMPARE(allocator.reservedMemory(), reservedMemory);
+}
+
+void KisTileDataSlabAllocatorTest::testBigPixels()
+{
+    const int pixelSize = KisTileDataSlabAllocator::MAX_PIXEL_SIZE + 1;
+
+    KisTileDataSlabAllocator allocator;
+
+    quint8 *ptr = allocator.allocate(pixelSize);
+    QVERIFY(ptr);
+    memset(ptr, 0, pixelSize * KisTileData::WIDTH * KisTileData::HEIGHT);
+
+    QCOMPARE(allocator.numSlabs(pixelSize), 0);
+
+    allocator.deallocate(ptr, pixelSize);
+}
+
+SIMPLE_TEST_MAIN(KisTileDataSlabAllocatorTest)
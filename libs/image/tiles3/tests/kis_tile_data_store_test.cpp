@@ -7,6 +7,8 @@
 #include "kis_tile_data_store_test.h"
 #include <simpletest.h>
 
+#include <QElapsedTimer>
+
 #include "kis_debug.h"
 
 #include "kis_image_config.h"
@@ -176,5 +178,49 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testPrefetching()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numColumns = 100;
+
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        tile->unlockForWrite();
+    }
+
+    store->debugSwapAll();
+
+    const qint32 tilesInMemoryBefore = store->numTilesInMemory();
+    QVERIFY(store->hasSwappedTiles());
+
+    dm.prefetchRect(QRect(0, 0, numColumns * KisTileData::WIDTH, KisTileData::HEIGHT));
+
+    // the tiles are loaded asynchronously, so just wait for them
+    QElapsedTimer timer;
+    timer.start();
+    while (store->numTilesInMemory() < tilesInMemoryBefore + numColumns &&
+           timer.elapsed() < 5000) {
+
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(store->numTilesInMemory(), tilesInMemoryBefore + numColumns);
+
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        tile->lockForRead();
+        QVERIFY(memoryIsFilled(COLUMN2COLOR(col), tile->data(), TILESIZE));
+        tile->unlockForRead();
+    }
+}
+
 SIMPLE_TEST_MAIN(KisTileDataStoreTest)
 
@@ -0,0 +1,291 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_tile_hash_table_test.h"
+#include <simpletest.h>
+
+#include <QThreadPool>
+#include <QRandomGenerator>
+
+#include "kis_debug.h"
+
+#include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "config-limit-long-tests.h"
+
+
+#ifdef LIMIT_LONG_TESTS
+#define NUM_CYCLES 10000
+#else
+#define NUM_CYCLES 100000
+#endif
+
+#define NUM_THREADS 16
+#define TABLE_SIDE 16
+
+
+struct TestingHashTable {
+    TestingHashTable()
+        : ht(0)
+    {
+        quint8 defaultPixel = 0;
+        KisTileData *td = KisTileDataStore::instance()->createDefaultTileData(1, &defaultPixel);
+        ht.setDefaultTileData(td);
+    }
+
+    KisTileHashTable ht;
+};
+
+int countTiles(KisTileHashTable *ht)
+{
+    int numTiles = 0;
+
+    KisTileHashTableConstIterator iter(ht);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        numTiles++;
+        iter.next();
+    }
+
+    return numTiles;
+}
+
+void KisTileHashTableTest::testOperations()
+{
+    TestingHashTable t;
+    KisTileHashTable &ht = t.ht;
+
+    QVERIFY(ht.isEmpty());
+
+    bool newTile = false;
+    KisTileSP tile = ht.getTileLazy(1, 2, newTile);
+
+    QVERIFY(newTile);
+    QCOMPARE(tile->col(), 1);
+    QCOMPARE(tile->row(), 2);
+    QCOMPARE(ht.numTiles(), 1);
+
+    QCOMPARE(ht.getTileLazy(1, 2, newTile), tile);
+    QVERIFY(!newTile);
+
+    QCOMPARE(ht.getExistingTile(1, 2), tile);
+    QVERIFY(!ht.getExistingTile(2, 1));
+
+    bool existingTile = true;
+    KisTileSP readOnlyTile = ht.getReadOnlyTileLazy(2, 1, existingTile);
+    QVERIFY(!existingTile);
+    QVERIFY(readOnlyTile);
+    QVERIFY(!ht.tileExists(2, 1));
+
+    readOnlyTile = ht.getReadOnlyTileLazy(1, 2, existingTile);
+    QVERIFY(existingTile);
+    QCOMPARE(readOnlyTile, tile);
+
+    // the (0,0) tile has a special hash value
+    KisTileSP zeroTile = ht.getTileLazy(0, 0, newTile);
+    QVERIFY(newTile);
+    QCOMPARE(ht.getExistingTile(0, 0), zeroTile);
+    QCOMPARE(ht.numTiles(), 2);
+
+    QVERIFY(ht.deleteTile(1, 2));
+    QVERIFY(!ht.deleteTile(1, 2));
+    QVERIFY(!ht.getExistingTile(1, 2));
+    QCOMPARE(ht.numTiles(), 1);
+
+    ht.addTile(tile);
+    QCOMPARE(ht.getExistingTile(1, 2), tile);
+    QCOMPARE(ht.numTiles(), 2);
+
+    ht.clear();
+    QVERIFY(ht.isEmpty());
+    QVERIFY(!ht.getExistingTile(0, 0));
+}
+
+void KisTileHashTableTest::testIteration()
+{
+    TestingHashTable t;
+    KisTileHashTable &ht = t.ht;
+
+    bool newTile = false;
+
+    for (int row = -TABLE_SIDE; row < TABLE_SIDE; row++) {
+        for (int col = -TABLE_SIDE; col < TABLE_SIDE; col++) {
+            ht.getTileLazy(col, row, newTile);
+        }
+    }
+
+    QCOMPARE(ht.numTiles(), 4 * TABLE_SIDE * TABLE_SIDE);
+    QCOMPARE(countTiles(&ht), ht.numTiles());
+
+    {
+        // delete the tiles with negative columns
+        KisTileHashTableIterator iter(&ht);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            if (tile->col() < 0) {
+                iter.deleteCurrent();
+            } else {
+                iter.next();
+            }
+        }
+    }
+
+    QCOMPARE(ht.numTiles(), 2 * TABLE_SIDE * TABLE_SIDE);
+    QCOMPARE(countTiles(&ht), ht.numTiles());
+
+    TestingHashTable t2;
+    KisTileHashTable &ht2 = t2.ht;
+
+    {
+        // move the tiles with negative rows into another table
+        KisTileHashTableIterator iter(&ht);
+        KisTileSP tile;
+
+        while ((tile = iter.tile())) {
+            if (tile->row() < 0) {
+                iter.moveCurrentToHashTable(&ht2);
+            } else {
+                iter.next();
+            }
+        }
+    }
+
+    QCOMPARE(ht.numTiles(), TABLE_SIDE * TABLE_SIDE);
+    QCOMPARE(ht2.numTiles(), TABLE_SIDE * TABLE_SIDE);
+    QCOMPARE(countTiles(&ht2), ht2.numTiles());
+
+    QVERIFY(ht2.getExistingTile(0, -1));
+    QVERIFY(!ht.getExistingTile(0, -1));
+}
+
+void KisTileHashTableTest::testCopying()
+{
+    TestingHashTable t;
+    KisTileHashTable &ht = t.ht;
+
+    bool newTile = false;
+
+    for (int i = 0; i < TABLE_SIDE; i++) {
+        ht.getTileLazy(i, i, newTile);
+    }
+
+    KisTileHashTable copy(ht, 0);
+
+    QCOMPARE(copy.numTiles(), ht.numTiles());
+    QCOMPARE(copy.defaultTileData(), ht.defaultTileData());
+
+    for (int i = 0; i < TABLE_SIDE; i++) {
+        KisTileSP srcTile = ht.getExistingTile(i, i);
+        KisTileSP dstTile = copy.getExistingTile(i, i);
+
+        QVERIFY(srcTile);
+        QVERIFY(dstTile);
+        QVERIFY(srcTile != dstTile);
+        QCOMPARE(dstTile->tileData(), srcTile->tileData());
+    }
+}
+
+class KisHashTableStressJob : public QRunnable
+{
+public:
+    KisHashTableStressJob(KisTileHashTable &ht, quint32 seed, bool allowIteration)
+        : m_ht(ht),
+          m_seed(seed),
+          m_allowIteration(allowIteration)
+    {
+    }
+
+    void run() override {
+        QRandomGenerator random(m_seed);
+
+        for (qint32 i = 0; i < NUM_CYCLES; i++) {
+            const qint32 col = random.bounded(TABLE_SIDE);
+            const qint32 row = random.bounded(TABLE_SIDE);
+            const int type = random.bounded(m_allowIteration ? 6 : 5);
+
+            bool flag = false;
+            KisTileSP tile;
+
+            switch (type) {
+            case 0:
+            case 1:
+                tile = m_ht.getTileLazy(col, row, flag);
+                KIS_ASSERT(tile);
+                KIS_ASSERT(tile->col() == col && tile->row() == row);
+
+                tile->lockForRead();
+                tile->unlockForRead();
+                break;
+            case 2:
+                tile = m_ht.getExistingTile(col, row);
+                if (tile) {
+                    KIS_ASSERT(tile->col() == col && tile->row() == row);
+                }
+                break;
+            case 3:
+                tile = m_ht.getReadOnlyTileLazy(col, row, flag);
+                KIS_ASSERT(tile);
+                break;
+            case 4:
+                m_ht.deleteTile(col, row);
+                break;
+            case 5: {
+                KisTileHashTableConstIterator iter(&m_ht);
+
+                while ((tile = iter.tile())) {
+                    KIS_ASSERT(tile->col() >= 0 && tile->col() < TABLE_SIDE);
+                    KIS_ASSERT(tile->row() >= 0 && tile->row() < TABLE_SIDE);
+                    iter.next();
+                }
+                break;
+            }
+            }
+        }
+    }
+
+private:
+    KisTileHashTable &m_ht;
+    quint32 m_seed;
+    bool m_allowIteration;
+};
+
+void runHashTableStressTest(KisTileHashTable &ht, bool allowIteration)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(NUM_THREADS);
+
+    for (qint32 i = 0; i < NUM_THREADS; i++) {
+        pool.start(new KisHashTableStressJob(ht, 1000 + i, allowIteration));
+    }
+
+    pool.waitForDone();
+}
+
+void KisTileHashTableTest::stressTestConcurrentAccess()
+{
+    TestingHashTable t;
+    KisTileHashTable &ht = t.ht;
+
+    runHashTableStressTest(ht, false);
+
+    QCOMPARE(countTiles(&ht), ht.numTiles());
+    QVERIFY(ht.numTiles() <= TABLE_SIDE * TABLE_SIDE);
+}
+
+void KisTileHashTableTest::stressTestIterationWhileModifying()
+{
+    TestingHashTable t;
+    KisTileHashTable &ht = t.ht;
+
+    runHashTableStressTest(ht, true);
+
+    QCOMPARE(countTiles(&ht), ht.numTiles());
+    QVERIFY(ht.numTiles() <= TABLE_SIDE * TABLE_SIDE);
+}
+
+SIMPLE_TEST_MAIN(KisTileHashTableTest)
@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_HASH_TABLE_TEST_H
+#define KIS_TILE_HASH_TABLE_TEST_H
+
+#include <simpletest.h>
+
+class KisTileHashTableTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testOperations();
+    void testIteration();
+    void testCopying();
+
+    void stressTestConcurrentAccess();
+    void stressTestIterationWhileModifying();
+};
+
+#endif /* KIS_TILE_HASH_TABLE_TEST_H */
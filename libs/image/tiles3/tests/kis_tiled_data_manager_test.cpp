@@ -8,6 +8,9 @@
 #include <simpletest.h>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "tiles3/kis_tile_data_deduplicator.h"
+#include "kis_datamanager.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -529,6 +532,349 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
 
 //#include <valgrind/callgrind.h>
 
+void KisTiledDataManagerTest::testDeltaMementos()
+{
+    KisMementoManager::setDeltaMementosEnabled(true);
+
+    const qint64 deltaSizeBefore =
+        KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize;
+
+    {
+        quint8 defaultPixel = 0;
+        KisTiledDataManager dm(1, &defaultPixel);
+
+        const QRect tileRect(0, 0, 64, 64);
+        const int numRevisions = 8;
+
+        QVector<QByteArray> states;
+        QVector<KisMementoSP> mementos;
+
+        auto readState = [&dm, tileRect] () {
+            QByteArray state(tileRect.width() * tileRect.height(), 0);
+            dm.readBytes((quint8*)state.data(),
+                         tileRect.x(), tileRect.y(),
+                         tileRect.width(), tileRect.height());
+            return state;
+        };
+
+        quint8 fillPixel = 128;
+        dm.clear(tileRect, &fillPixel);
+        dm.commit();
+
+        states << readState();
+
+        for (int i = 0; i < numRevisions; i++) {
+            mementos << dm.getMemento();
+
+            quint8 oddPixel = 10 + i;
+            dm.clear(QRect(i * 4, i * 4, 4, 4), &oddPixel);
+            dm.commit();
+
+            states << readState();
+        }
+
+        /**
+         * All the revisions but the HEAD differ in a few pixels only,
+         * so they should have been delta-encoded
+         */
+        QVERIFY(KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize >
+                deltaSizeBefore);
+
+        for (int i = numRevisions - 1; i >= 0; i--) {
+            dm.rollback(mementos[i]);
+            QCOMPARE(readState(), states[i]);
+        }
+
+        for (int i = 0; i < numRevisions; i++) {
+            dm.rollforward(mementos[i]);
+            QCOMPARE(readState(), states[i + 1]);
+        }
+
+        /**
+         * Undo a couple of revisions and write a new one on top of them
+         */
+        dm.rollback(mementos[numRevisions - 1]);
+        dm.rollback(mementos[numRevisions - 2]);
+        QCOMPARE(readState(), states[numRevisions - 2]);
+
+        KisMementoSP memento = dm.getMemento();
+        quint8 oddPixel = 200;
+        dm.clear(QRect(60, 60, 4, 4), &oddPixel);
+        dm.commit();
+
+        dm.rollback(memento);
+        QCOMPARE(readState(), states[numRevisions - 2]);
+
+        dm.purgeHistory(mementos[numRevisions / 2]);
+        QCOMPARE(readState(), states[numRevisions - 2]);
+    }
+
+    QCOMPARE(KisTileDataStore::instance()->memoryStatistics().historicalDeltaSize,
+             deltaSizeBefore);
+
+    KisMementoManager::setDeltaMementosEnabled(false);
+}
+
+void KisTiledDataManagerTest::testPurgeUniformTiles()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager dm(1, &defaultPixel);
+
+    const QRect dataRect(0, 0, 256, 64);
+
+    QByteArray bytes(dataRect.width() * dataRect.height(), 128);
+    dm.writeBytes((quint8*)bytes.data(), dataRect.x(), dataRect.y(), dataRect.width(), dataRect.height());
+
+    // the fourth tile is filled with the default pixel
+    dm.clear(QRect(192, 0, 64, 64), &defaultPixel);
+
+    // and the third one is not uniform
+    quint8 oddPixel = 129;
+    dm.clear(QRect(130, 10, 1, 1), &oddPixel);
+
+    QVERIFY(dm.getTile(0, 0, false)->tileData() != dm.getTile(1, 0, false)->tileData());
+
+    dm.purge(dm.extent());
+
+    QCOMPARE(dm.extent(), QRect(0, 0, 192, 64));
+
+    KisTileSP tile00 = dm.getTile(0, 0, false);
+    KisTileSP tile10 = dm.getTile(1, 0, false);
+    KisTileSP tile20 = dm.getTile(2, 0, false);
+
+    // uniform tiles share the data
+    QCOMPARE(tile00->tileData(), tile10->tileData());
+    QVERIFY(tile20->tileData() != tile10->tileData());
+
+    QVERIFY(memoryIsFilled(128, tile00->data(), TILESIZE));
+    QVERIFY(memoryIsFilled(128, tile10->data(), TILESIZE));
+
+    tile00 = tile10 = tile20 = 0;
+
+    // the first write detaches the tile
+    dm.clear(QRect(10, 10, 1, 1), &oddPixel);
+
+    tile00 = dm.getTile(0, 0, false);
+    tile10 = dm.getTile(1, 0, false);
+
+    QVERIFY(tile00->tileData() != tile10->tileData());
+    QVERIFY(memoryIsFilled(128, tile10->data(), TILESIZE));
+
+    quint8 pixel = 0;
+    dm.readBytes(&pixel, 10, 10, 1, 1);
+    QCOMPARE(pixel, oddPixel);
+    dm.readBytes(&pixel, 11, 10, 1, 1);
+    QCOMPARE(pixel, quint8(128));
+}
+
+void KisTiledDataManagerTest::testReadCompactsUniformTiles()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager srcDM(1, &defaultPixel);
+
+    quint8 fillPixel = 128;
+    QByteArray bytes(128 * 64, fillPixel);
+    srcDM.writeBytes((quint8*)bytes.data(), 0, 0, 128, 64);
+
+    // the third tile is explicitly filled with the default pixel
+    QByteArray defaultBytes(64 * 64, defaultPixel);
+    srcDM.writeBytes((quint8*)defaultBytes.data(), 128, 0, 64, 64);
+    QCOMPARE(srcDM.extent(), QRect(0, 0, 192, 64));
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(srcDM.write(writer));
+    fakeStore.startReading();
+
+    KisDataManager dstDM(1, &defaultPixel);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const qint32 numTilesBefore = store->numTiles();
+
+    QVERIFY(dstDM.read(fakeStore.device()));
+
+    // reading never drops the tiles filled with the default pixel
+    QCOMPARE(dstDM.extent(), QRect(0, 0, 192, 64));
+
+    /**
+     * The two tiles filled with the same color share one tile data,
+     * and the data they have been read into is freed, even though
+     * the history of the device references it
+     */
+    QCOMPARE(store->numTiles(), numTilesBefore + 2);
+
+    KisTileSP tile00 = dstDM.getTile(0, 0, false);
+    KisTileSP tile10 = dstDM.getTile(1, 0, false);
+
+    QCOMPARE(tile00->tileData(), tile10->tileData());
+    QVERIFY(memoryIsFilled(fillPixel, tile00->data(), TILESIZE));
+}
+
+void KisTiledDataManagerTest::testPurgeCompactsTilesWithHistory()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager dm(1, &defaultPixel);
+
+    quint8 fillPixel = 128;
+    QByteArray bytes(128 * 64, fillPixel);
+
+    KisMementoSP memento = dm.getMemento();
+    dm.writeBytes((quint8*)bytes.data(), 0, 0, 128, 64);
+    dm.commit();
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const qint32 numTilesBefore = store->numTiles();
+
+    // the data of both the tiles is referenced by the committed history
+    dm.purge(dm.extent());
+
+    QCOMPARE(store->numTiles(), numTilesBefore - 1);
+    QCOMPARE(dm.extent(), QRect(0, 0, 128, 64));
+
+    // the history is still valid
+    dm.rollback(memento);
+    QCOMPARE(dm.extent(), QRect());
+
+    dm.rollforward(memento);
+    QByteArray result(128 * 64, 0);
+    dm.readBytes((quint8*)result.data(), 0, 0, 128, 64);
+    QCOMPARE(result, bytes);
+}
+
+void KisTiledDataManagerTest::testShareTileDataChecksContent()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager dm(1, &defaultPixel);
+
+    quint8 fillPixel = 128;
+    dm.clear(QRect(0, 0, 128, 64), &fillPixel);
+
+    // the second tile changes after it has been found uniform
+    quint8 oddPixel = 129;
+    dm.clear(QRect(70, 10, 1, 1), &oddPixel);
+
+    KisTileSP tile00 = dm.getTile(0, 0, false);
+    KisTileSP tile10 = dm.getTile(1, 0, false);
+
+    KisTileData *oldTileData = tile10->tileData();
+    QVERIFY(!tile10->shareTileData(tile00->tileData()));
+    QCOMPARE(tile10->tileData(), oldTileData);
+
+    // a locked tile is never touched
+    dm.clear(QRect(70, 10, 1, 1), &fillPixel);
+    tile10->lockForRead();
+    QVERIFY(!tile10->shareTileData(tile00->tileData()));
+    tile10->unlockForRead();
+
+    QVERIFY(tile10->shareTileData(tile00->tileData()));
+    QCOMPARE(tile10->tileData(), tile00->tileData());
+}
+
+void KisTiledDataManagerTest::testDeduplicateTiles()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager dm1(1, &defaultPixel);
+    KisDataManager dm2(1, &defaultPixel);
+
+    QByteArray pattern(TILESIZE, 0);
+    for (int i = 0; i < pattern.size(); i++) {
+        pattern[i] = quint8(i % 251);
+    }
+
+    KisMementoSP memento = dm1.getMemento();
+    dm1.writeBytes((quint8*)pattern.data(), 0, 0, 64, 64);
+    dm1.writeBytes((quint8*)pattern.data(), 64, 0, 64, 64);
+    dm1.commit();
+
+    dm2.writeBytes((quint8*)pattern.data(), 0, 0, 64, 64);
+    pattern[0] = 1;
+    dm2.writeBytes((quint8*)pattern.data(), 64, 0, 64, 64);
+    pattern[0] = 0;
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+    const qint32 numTilesBefore = store->numTiles();
+
+    {
+        KisTileDataDeduplicator deduplicator;
+        dm1.deduplicateTiles(deduplicator);
+        dm2.deduplicateTiles(deduplicator);
+
+        QCOMPARE(deduplicator.processedSize(), qint64(4 * TILESIZE));
+        QCOMPARE(deduplicator.uniqueSize(), qint64(2 * TILESIZE));
+    }
+
+    /**
+     * The duplicates are really freed, though the committed history
+     * of dm1 and the uncommitted one of dm2 referenced them
+     */
+    QCOMPARE(store->numTiles(), numTilesBefore - 2);
+
+    KisTileSP tile1 = dm1.getTile(0, 0, false);
+    QCOMPARE(dm1.getTile(1, 0, false)->tileData(), tile1->tileData());
+    QCOMPARE(dm2.getTile(0, 0, false)->tileData(), tile1->tileData());
+    QVERIFY(dm2.getTile(1, 0, false)->tileData() != tile1->tileData());
+    tile1 = 0;
+
+    // the first write detaches the tile
+    quint8 oddPixel = 255;
+    dm2.clear(QRect(10, 10, 1, 1), &oddPixel);
+
+    QByteArray result(TILESIZE, 0);
+    dm1.readBytes((quint8*)result.data(), 0, 0, 64, 64);
+    QCOMPARE(result, pattern);
+    dm1.readBytes((quint8*)result.data(), 64, 0, 64, 64);
+    QCOMPARE(result, pattern);
+
+    quint8 pixel = 0;
+    dm2.readBytes(&pixel, 10, 10, 1, 1);
+    QCOMPARE(pixel, oddPixel);
+
+    // the undo history is not affected
+    dm1.rollback(memento);
+    dm1.readBytes((quint8*)result.data(), 0, 0, 64, 64);
+    QVERIFY(memoryIsFilled(defaultPixel, (quint8*)result.data(), TILESIZE));
+}
+
+void KisTiledDataManagerTest::testTileDataContentHash()
+{
+    quint8 defaultPixel = 0;
+    KisDataManager dm(1, &defaultPixel);
+
+    QByteArray pattern(TILESIZE, 0);
+    for (int i = 0; i < pattern.size(); i++) {
+        pattern[i] = quint8(i % 251);
+    }
+    dm.writeBytes((quint8*)pattern.data(), 0, 0, 64, 64);
+
+    KisTileDataStore *store = KisTileDataStore::instance();
+
+    KisTileSP tile = dm.getTile(0, 0, false);
+    KisTileData *td = tile->tileData();
+
+    td->blockSwapping();
+    const uint hash = td->contentHash();
+    td->unblockSwapping();
+
+    // reading doesn't count as a change
+    const int contentChanges = store->tileDataContentChanges();
+
+    QByteArray result(TILESIZE, 0);
+    dm.readBytes((quint8*)result.data(), 0, 0, 64, 64);
+    QCOMPARE(store->tileDataContentChanges(), contentChanges);
+
+    // writing does and drops the cached hash
+    quint8 oddPixel = 255;
+    dm.clear(QRect(10, 10, 1, 1), &oddPixel);
+    QVERIFY(store->tileDataContentChanges() != contentChanges);
+
+    tile = dm.getTile(0, 0, false);
+    QCOMPARE(tile->tileData(), td);
+
+    td->blockSwapping();
+    QVERIFY(td->contentHash() != hash);
+    td->unblockSwapping();
+}
+
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
 {
     quint8 defaultPixel = 0;
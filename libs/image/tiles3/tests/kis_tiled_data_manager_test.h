@@ -40,6 +40,13 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testDeltaMementos();
+    void testPurgeUniformTiles();
+    void testReadCompactsUniformTiles();
+    void testPurgeCompactsTilesWithHistory();
+    void testShareTileDataChecksContent();
+    void testDeduplicateTiles();
+    void testTileDataContentHash();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
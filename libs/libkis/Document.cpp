@@ -784,6 +784,24 @@ void Document::waitForDone()
     d->document->image()->waitForDone();
 }
 
+int Document::pendingStrokes() const
+{
+    if (!d->document || !d->document->image()) return 0;
+    return d->document->image()->strokesQueueStatistics().numStrokes;
+}
+
+int Document::pendingStrokeJobs() const
+{
+    if (!d->document || !d->document->image()) return 0;
+    return d->document->image()->strokesQueueStatistics().numPendingJobs;
+}
+
+bool Document::waitForPendingStrokes(int maxPendingStrokes, int timeout)
+{
+    if (!d->document || !d->document->image()) return true;
+    return d->document->image()->waitForPendingStrokes(maxPendingStrokes, timeout);
+}
+
 bool Document::tryBarrierLock()
 {
     if (!d->document || !d->document->image()) return false;
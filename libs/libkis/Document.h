@@ -729,6 +729,40 @@ print(root.childNodes())
      */
     void waitForDone();
 
+    /**
+     * @return the number of the actions queued in the image, including the
+     * one that is running at the moment. The batch scripts may use it to
+     * find out how far behind the image is.
+     */
+    int pendingStrokes() const;
+
+    /**
+     * @return the rough estimate of the number of the internal jobs
+     * the queued actions still have to execute
+     */
+    int pendingStrokeJobs() const;
+
+    /**
+     * @brief Waits until no more than @p maxPendingStrokes actions are queued
+     *
+     * Unlike waitForDone(), it lets the script queue up the next operations
+     * while the previous ones are still being processed, but still keeps the
+     * queue (and the memory it takes) bounded:
+     *
+     * @code
+     * for node in nodes:
+     *     doSomething(node)
+     *     doc.waitForPendingStrokes(4)
+     * doc.waitForDone()
+     * @endcode
+     *
+     * @param maxPendingStrokes the number of actions allowed to stay in the queue
+     * @param timeout the maximum time to wait in milliseconds, negative values
+     * mean waiting forever
+     * @return false if the timeout has expired before the queue has shrunk
+     */
+    bool waitForPendingStrokes(int maxPendingStrokes, int timeout = -1);
+
     /**
      * @brief Tries to lock the image without waiting for the jobs to finish
      *
@@ -17,6 +17,9 @@
 // #include "Ko_global.h"
 #include "KoIntegerMaths.h"
 #include "KoChannelInfo.h"
+#include "KoColorModelStandardIds.h"
+#include "KoOptimizedHistogramAccumulatorFactory.h"
+#include "kis_assert.h"
 
 static const KoColorSpace* m_labCs = 0;
 
@@ -53,6 +56,10 @@ KoBasicHistogramProducer::KoBasicHistogramProducer(const KoID& id, int nrOfBins,
     m_count = 0;
     m_from = 0.0;
     m_width = 1.0;
+
+    initAccumulator(cs,
+                    KoColorConversionTransformation::IntentAbsoluteColorimetric,
+                    KoColorConversionTransformation::Empty);
 }
 
 
@@ -66,6 +73,30 @@ void KoBasicHistogramProducer::clear()
         m_outRight[i] = 0;
         m_outLeft[i] = 0;
     }
+    m_accumulatedBins.clear();
+}
+
+void KoBasicHistogramProducer::addBinsFrom(KoHistogramProducer *producer)
+{
+    KoBasicHistogramProducer *other = dynamic_cast<KoBasicHistogramProducer*>(producer);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(other);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(other->m_channels == m_channels);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(other->m_nrOfBins == m_nrOfBins);
+
+    if (other->m_accumulatedBins.channelCount() == m_accumulatedBins.channelCount()) {
+        m_accumulatedBins.merge(other->m_accumulatedBins);
+    } else {
+        other->flushAccumulatedBins();
+    }
+
+    for (int i = 0; i < m_channels; i++) {
+        for (int j = 0; j < m_nrOfBins; j++) {
+            m_bins[i][j] += other->m_bins[i][j];
+        }
+        m_outRight[i] += other->m_outRight[i];
+        m_outLeft[i] += other->m_outLeft[i];
+    }
+    m_count += other->m_count;
 }
 
 void KoBasicHistogramProducer::makeExternalToInternal()
@@ -88,6 +119,87 @@ void KoBasicHistogramProducer::makeExternalToInternal()
     }
 }
 
+void KoBasicHistogramProducer::initAccumulator(const KoColorSpace *colorSpace,
+                                               KoColorConversionTransformation::Intent intent,
+                                               KoColorConversionTransformation::ConversionFlags flags,
+                                               const QVector<int> &positions)
+{
+    KoOptimizedHistogramAccumulatorBase::Params params;
+    params.depthId = colorSpace->colorDepthId();
+    params.channelCount = colorSpace->channelCount();
+
+    // alphaPos() returns -1 casted to unsigned for the spaces without alpha
+    const qint32 alphaPos = static_cast<qint32>(colorSpace->alphaPos());
+    params.alphaPos = alphaPos < params.channelCount ? alphaPos : -1;
+
+    m_accumulator.reset(KoOptimizedHistogramAccumulatorFactory::create(params));
+    m_accumulatedBins.reset(params.channelCount);
+    m_accumulatorColorSpace = colorSpace;
+    m_conversionIntent = intent;
+    m_conversionFlags = flags;
+
+    m_accumulatorPositions = positions;
+    if (m_accumulatorPositions.isEmpty()) {
+        for (int i = 0; i < m_channels; i++) {
+            m_accumulatorPositions.append(i);
+        }
+    }
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_accumulator);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_accumulatorPositions.size() == m_channels);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_nrOfBins == KoOptimizedHistogramAccumulatorBase::numberOfBins);
+}
+
+void KoBasicHistogramProducer::countPixels(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                                           const KoColorSpace *colorSpace,
+                                           KoOptimizedHistogramAccumulatorBase::Options options)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_accumulator);
+
+    options.skipTransparent = m_skipTransparent;
+    options.skipUnselected = m_skipUnselected;
+
+    const quint8 *data = pixels;
+
+    if (!(*colorSpace == *m_accumulatorColorSpace)) {
+        const int bufferSize = nPixels * m_accumulatorColorSpace->pixelSize();
+        if (m_conversionBuffer.size() < bufferSize) {
+            m_conversionBuffer.resize(bufferSize);
+        }
+
+        colorSpace->convertPixelsTo(pixels, m_conversionBuffer.data(), m_accumulatorColorSpace, nPixels,
+                                    m_conversionIntent, m_conversionFlags);
+        data = m_conversionBuffer.constData();
+    }
+
+    m_accumulator->accumulate(data, selectionMask, nPixels, options, m_accumulatedBins);
+}
+
+void KoBasicHistogramProducer::flushAccumulatedBins()
+{
+    if (m_accumulatedBins.isEmpty()) return;
+
+    for (int i = 0; i < m_channels; i++) {
+        const int pos = m_accumulatorPositions[i];
+
+        for (int j = 0; j < m_nrOfBins; j++) {
+            m_bins[i][j] += m_accumulatedBins.bin(pos, j);
+        }
+        m_outLeft[i] += m_accumulatedBins.outOfViewLeft(pos);
+        m_outRight[i] += m_accumulatedBins.outOfViewRight(pos);
+    }
+    m_count += m_accumulatedBins.count();
+
+    m_accumulatedBins.clear();
+}
+
+void KoBasicHistogramProducer::copySettingsTo(KoBasicHistogramProducer *producer) const
+{
+    producer->setView(m_from, m_width);
+    producer->setSkipTransparent(m_skipTransparent);
+    producer->setSkipUnselected(m_skipUnselected);
+}
+
 // ------------ U8 ---------------------
 
 KoBasicU8HistogramProducer::KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *cs)
@@ -102,38 +214,15 @@ QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 
 void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-
-    if (selectionMask) {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
+    // the bins are indexed by the channel values directly
+    countPixels(pixels, selectionMask, nPixels, cs, KoOptimizedHistogramAccumulatorBase::Options());
+}
 
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+KoHistogramProducer *KoBasicU8HistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoBasicU8HistogramProducer(m_id, m_colorSpace);
+    copySettingsTo(producer);
+    return producer;
 }
 
 // ------------ U16 ---------------------
@@ -161,51 +250,19 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     quint16 to = from + width;
     qreal factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    quint16 value = channels[i]*UINT16_MAX;
-
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+    KoOptimizedHistogramAccumulatorBase::Options options;
+    options.from = from;
+    options.to = to;
+    options.scale = factor;
+
+    countPixels(pixels, selectionMask, nPixels, cs, options);
+}
+
+KoHistogramProducer *KoBasicU16HistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoBasicU16HistogramProducer(m_id, m_colorSpace);
+    copySettingsTo(producer);
+    return producer;
 }
 
 // ------------ Float32 ---------------------
@@ -233,52 +290,19 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     float to = from + width;
     float factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
+    KoOptimizedHistogramAccumulatorBase::Options options;
+    options.from = from;
+    options.to = to;
+    options.scale = factor;
 
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
+    countPixels(pixels, selectionMask, nPixels, cs, options);
+}
 
-        }
-    }
+KoHistogramProducer *KoBasicF32HistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoBasicF32HistogramProducer(m_id, m_colorSpace);
+    copySettingsTo(producer);
+    return producer;
 }
 
 #ifdef HAVE_OPENEXR
@@ -308,50 +332,19 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
     float to = from + width;
     float factor = 255.0 / width;
 
-    quint32 dstPixelSize = m_colorSpace->pixelSize();
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-    quint8 *dst = dstPixels;
-    QVector<float> channels(m_colorSpace->channelCount());
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected  && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                m_colorSpace->normalisedChannelsValue(dst,channels);
-                for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    float value = channels[i];
-                    if (value > to)
-                        m_outRight[i]++;
-                    else if (value < from)
-                        m_outLeft[i]++;
-                    else
-                        m_bins[i][static_cast<quint8>((value - from) * factor)]++;
-                }
-                m_count++;
-            }
-            dst += dstPixelSize;
-            nPixels--;
-        }
-    }
+    KoOptimizedHistogramAccumulatorBase::Options options;
+    options.from = from;
+    options.to = to;
+    options.scale = factor;
+
+    countPixels(pixels, selectionMask, nPixels, cs, options);
+}
+
+KoHistogramProducer *KoBasicF16HalfHistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoBasicF16HalfHistogramProducer(m_id, m_colorSpace);
+    copySettingsTo(producer);
+    return producer;
 }
 #endif
 
@@ -364,6 +357,20 @@ KoGenericRGBHistogramProducer::KoGenericRGBHistogramProducer()
     m_channelsList.append(new KoChannelInfo(i18n("R"), 0, 0, KoChannelInfo::COLOR, KoChannelInfo::UINT8, 1, QColor(255, 0, 0)));
     m_channelsList.append(new KoChannelInfo(i18n("G"), 1, 1, KoChannelInfo::COLOR, KoChannelInfo::UINT8, 1, QColor(0, 255, 0)));
     m_channelsList.append(new KoChannelInfo(i18n("B"), 2, 2, KoChannelInfo::COLOR, KoChannelInfo::UINT8, 1, QColor(0, 0, 255)));
+
+    /**
+     * The pixels are converted into RGB8 the same way toQColor() does
+     * that. The pixels of RGB8 have BGRA layout.
+     */
+    initAccumulator(KoColorSpaceRegistry::instance()->rgb8(),
+                    KoColorConversionTransformation::internalRenderingIntent(),
+                    KoColorConversionTransformation::internalConversionFlags(),
+                    {2, 1, 0});
+}
+
+KoGenericRGBHistogramProducer::~KoGenericRGBHistogramProducer()
+{
+    qDeleteAll(m_channelsList);
 }
 
 QList<KoChannelInfo *> KoGenericRGBHistogramProducer::channels()
@@ -384,43 +391,14 @@ qreal KoGenericRGBHistogramProducer::maximalZoom() const
 
 void KoGenericRGBHistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
-    for (int i = 0; i < m_channels; i++) {
-        m_outRight[i] = 0;
-        m_outLeft[i] = 0;
-    }
-
-    QColor c;
-    qint32 pSize = cs->pixelSize();
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected  && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                cs->toQColor(pixels, &c);
-                m_bins[0][c.red()]++;
-                m_bins[1][c.green()]++;
-                m_bins[2][c.blue()]++;
-
-                m_count++;
-            }
-            pixels += pSize;
-            selectionMask++;
-            nPixels--;
-        }
-
-    } else {
-        while (nPixels > 0) {
-
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
-                cs->toQColor(pixels, &c);
-                m_bins[0][c.red()]++;
-                m_bins[1][c.green()]++;
-                m_bins[2][c.blue()]++;
+    countPixels(pixels, selectionMask, nPixels, cs, KoOptimizedHistogramAccumulatorBase::Options());
+}
 
-                m_count++;
-            }
-            pixels += pSize;
-            nPixels--;
-        }
-    }
+KoHistogramProducer *KoGenericRGBHistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoGenericRGBHistogramProducer();
+    copySettingsTo(producer);
+    return producer;
 }
 
 KoGenericRGBHistogramProducerFactory::KoGenericRGBHistogramProducerFactory()
@@ -442,6 +420,10 @@ KoGenericLabHistogramProducer::KoGenericLabHistogramProducer()
         m_labCs = KoColorSpaceRegistry::instance()->lab16();
     }
     m_colorSpace = m_labCs;
+
+    initAccumulator(m_colorSpace,
+                    KoColorConversionTransformation::IntentAbsoluteColorimetric,
+                    KoColorConversionTransformation::Empty);
 }
 KoGenericLabHistogramProducer::~KoGenericLabHistogramProducer()
 {
@@ -468,43 +450,21 @@ qreal KoGenericLabHistogramProducer::maximalZoom() const
 
 void KoGenericLabHistogramProducer::addRegionToBin(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,  const KoColorSpace *cs)
 {
-    for (int i = 0; i < m_channels; i++) {
-        m_outRight[i] = 0;
-        m_outLeft[i] = 0;
-    }
-
-    qint32 dstPixelSize = m_colorSpace->pixelSize();
-
-    quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
-    cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
-
-    qint32 pSize = cs->pixelSize();
-
-    if (selectionMask) {
-        while (nPixels > 0) {
-            if (!((m_skipUnselected  && *selectionMask == 0) || (m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))) {
-                m_count++;
-            }
-            pixels += pSize;
-            selectionMask++;
-            nPixels--;
-        }
-    } else {
-        quint8 *dst = dstPixels;
-        while (nPixels > 0) {
-            if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8))  {
+    // the same rounding as in scaleToU8()
+    KoOptimizedHistogramAccumulatorBase::Options options;
+    options.from = 0.0f;
+    options.to = UINT16_MAX;
+    options.scale = 255.0f / UINT16_MAX;
+    options.bias = 0.5f;
 
-                m_bins[0][m_colorSpace->scaleToU8(dst, 0)]++;
-                m_bins[1][m_colorSpace->scaleToU8(dst, 1)]++;
-                m_bins[2][m_colorSpace->scaleToU8(dst, 2)]++;
+    countPixels(pixels, selectionMask, nPixels, cs, options);
+}
 
-                m_count++;
-            }
-            dst+= dstPixelSize;
-            nPixels--;
-        }
-    }
-    delete[] dstPixels;
+KoHistogramProducer *KoGenericLabHistogramProducer::createEmptyCopy() const
+{
+    KoBasicHistogramProducer *producer = new KoGenericLabHistogramProducer();
+    copySettingsTo(producer);
+    return producer;
 }
 
 KoGenericLabHistogramProducerFactory::KoGenericLabHistogramProducerFactory()
@@ -9,6 +9,7 @@
 
 #include "KoHistogramProducer.h"
 
+#include <QSharedPointer>
 #include <QVector>
 
 #include <KoConfig.h>
@@ -17,6 +18,8 @@
 #include "KoID.h"
 #include "kritapigment_export.h"
 #include "KoColorSpaceRegistry.h"
+#include "KoColorConversionTransformation.h"
+#include "KoOptimizedHistogramAccumulatorBase.h"
 
 class KRITAPIGMENT_EXPORT KoBasicHistogramProducer : public KoHistogramProducer
 {
@@ -27,6 +30,8 @@ public:
 
     void clear() override;
 
+    void addBinsFrom(KoHistogramProducer *producer) override;
+
     void setView(qreal from, qreal size) override {
         m_from = from; m_width = size;
     }
@@ -48,18 +53,22 @@ public:
     }
 
     qint32 count() override {
+        flushAccumulatedBins();
         return m_count;
     }
 
     qint32 getBinAt(int channel, int position) override {
+        flushAccumulatedBins();
         return m_bins.at(externalToInternal(channel)).at(position);
     }
 
     qint32 outOfViewLeft(int channel) override {
+        flushAccumulatedBins();
         return m_outLeft.at(externalToInternal(channel));
     }
 
     qint32 outOfViewRight(int channel) override {
+        flushAccumulatedBins();
         return m_outRight.at(externalToInternal(channel));
     }
 
@@ -78,6 +87,30 @@ protected:
     }
     // not virtual since that is useless: we call it from constructor
     void makeExternalToInternal();
+
+    /**
+     * Sets up counting of the pixels converted into \p colorSpace.
+     * \p positions are the positions of the channels in the converted
+     * pixel that correspond to the bins, by default the channels are
+     * counted in their pixel order.
+     */
+    void initAccumulator(const KoColorSpace *colorSpace,
+                         KoColorConversionTransformation::Intent intent,
+                         KoColorConversionTransformation::ConversionFlags flags,
+                         const QVector<int> &positions = QVector<int>());
+
+    /**
+     * Converts the pixels into the color space of the accumulator, if
+     * needed, and counts them with \p options. The result is added to
+     * the bins when they are requested for the first time.
+     */
+    void countPixels(const quint8 *pixels, const quint8 *selectionMask, quint32 nPixels,
+                     const KoColorSpace *colorSpace,
+                     KoOptimizedHistogramAccumulatorBase::Options options);
+
+    void flushAccumulatedBins();
+    void copySettingsTo(KoBasicHistogramProducer *producer) const;
+
     typedef QVector<quint32> vBins;
     QVector<vBins> m_bins;
     vBins m_outLeft, m_outRight;
@@ -87,6 +120,15 @@ protected:
     const KoColorSpace *m_colorSpace;
     KoID m_id;
     QVector<qint32> m_external;
+
+private:
+    QSharedPointer<KoOptimizedHistogramAccumulatorBase> m_accumulator;
+    KoOptimizedHistogramAccumulatorBase::Bins m_accumulatedBins;
+    const KoColorSpace *m_accumulatorColorSpace {0};
+    KoColorConversionTransformation::Intent m_conversionIntent {KoColorConversionTransformation::IntentAbsoluteColorimetric};
+    KoColorConversionTransformation::ConversionFlags m_conversionFlags {KoColorConversionTransformation::Empty};
+    QVector<int> m_accumulatorPositions;
+    QVector<quint8> m_conversionBuffer;
 };
 
 class KRITAPIGMENT_EXPORT KoBasicU8HistogramProducer : public KoBasicHistogramProducer
@@ -95,6 +137,7 @@ public:
     KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU8HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override {
         return 1.0;
@@ -107,6 +150,7 @@ public:
     KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU16HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -117,6 +161,7 @@ public:
     KoBasicF32HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF32HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -129,6 +174,7 @@ public:
     KoBasicF16HalfHistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF16HalfHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -180,8 +226,9 @@ class KRITAPIGMENT_EXPORT KoGenericRGBHistogramProducer : public KoBasicHistogra
 {
 public:
     KoGenericRGBHistogramProducer();
-    ~KoGenericRGBHistogramProducer() override {}
+    ~KoGenericRGBHistogramProducer() override;
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -223,6 +270,7 @@ public:
     KoGenericLabHistogramProducer();
     ~KoGenericLabHistogramProducer() override;
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override;
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -6,10 +6,16 @@
 
 #include "KoColorConversionCache.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include <QElapsedTimer>
 #include <QHash>
 #include <QList>
 #include <QMutex>
+#include <QSharedPointer>
 #include <QThreadStorage>
+#include <QVector>
 
 #include <KoColorSpace.h>
 
@@ -61,15 +67,188 @@ struct KoColorConversionCache::CachedTransformation {
     QAtomicInt use;
 };
 
-typedef QPair<KoColorConversionCacheKey, KoCachedColorConversionTransformation> FastPathCacheItem;
+typedef QSharedPointer<KoColorConversionCache::CachedTransformation> CachedTransformationSP;
+
+namespace {
+
+/**
+ * The counters are written only by the owning thread, but read
+ * by statistics(), so they are atomic.
+ */
+struct ThreadCounters {
+    std::atomic<qint64> numHits {0};
+    std::atomic<qint64> numMisses {0};
+};
+
+/**
+ * Keeps the counters of the living threads. When a thread exits, its
+ * counters are folded into the totals and removed from the list, so
+ * the list doesn't grow with every short-lived thread.
+ */
+struct ThreadCountersRegistry {
+    void add(ThreadCounters *counters) {
+        QMutexLocker l(&lock);
+        threadCounters.append(counters);
+    }
+
+    void remove(ThreadCounters *counters) {
+        QMutexLocker l(&lock);
+        numFinishedHits += counters->numHits;
+        numFinishedMisses += counters->numMisses;
+        threadCounters.removeOne(counters);
+    }
+
+    void collect(qint64 *numHits, qint64 *numMisses) const {
+        QMutexLocker l(&lock);
+        *numHits = numFinishedHits;
+        *numMisses = numFinishedMisses;
+
+        Q_FOREACH (ThreadCounters *counters, threadCounters) {
+            *numHits += counters->numHits;
+            *numMisses += counters->numMisses;
+        }
+    }
+
+    void reset() {
+        QMutexLocker l(&lock);
+        numFinishedHits = 0;
+        numFinishedMisses = 0;
+
+        Q_FOREACH (ThreadCounters *counters, threadCounters) {
+            counters->numHits = 0;
+            counters->numMisses = 0;
+        }
+    }
+
+private:
+    mutable QMutex lock;
+    QVector<ThreadCounters*> threadCounters;
+    qint64 numFinishedHits = 0;
+    qint64 numFinishedMisses = 0;
+};
+
+/**
+ * A small most-recently-used list of the transformations requested by
+ * a thread. The color spaces are compared by pointer, so the lookup
+ * is cheap; the entries that don't match by pointer, but match by
+ * value, are found in the shared cache.
+ */
+struct ThreadCache {
+    static const int maxSize = 8;
+
+    explicit ThreadCache(ThreadCountersRegistry *_registry)
+        : registry(_registry)
+    {
+        registry->add(&counters);
+    }
+
+    /**
+     * QThreadStorage deletes the cache when the thread exits, and
+     * never after the storage itself is gone, so the registry is
+     * still alive here
+     */
+    ~ThreadCache() {
+        registry->remove(&counters);
+    }
+
+    struct Entry {
+        const KoColorSpace* src = 0;
+        const KoColorSpace* dst = 0;
+        KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::IntentPerceptual;
+        KoColorConversionTransformation::ConversionFlags conversionFlags;
+        CachedTransformationSP transfo;
+    };
+
+    CachedTransformationSP find(const KoColorSpace* src,
+                                const KoColorSpace* dst,
+                                KoColorConversionTransformation::Intent renderingIntent,
+                                KoColorConversionTransformation::ConversionFlags conversionFlags) {
+
+        for (int i = 0; i < size; i++) {
+            const Entry &entry = entries[i];
+
+            if (entry.src == src && entry.dst == dst &&
+                entry.renderingIntent == renderingIntent &&
+                entry.conversionFlags == conversionFlags) {
+
+                // move the entry to the front
+                std::rotate(entries, entries + i, entries + i + 1);
+                return entries[0].transfo;
+            }
+        }
+
+        return CachedTransformationSP();
+    }
+
+    void insert(const KoColorSpace* src,
+                const KoColorSpace* dst,
+                KoColorConversionTransformation::Intent renderingIntent,
+                KoColorConversionTransformation::ConversionFlags conversionFlags,
+                CachedTransformationSP transfo) {
+
+        if (size < maxSize) {
+            size++;
+        }
+
+        // the last entry is dropped if the cache is full
+        std::rotate(entries, entries + size - 1, entries + size);
+        entries[0] = {src, dst, renderingIntent, conversionFlags, transfo};
+    }
+
+    void clear() {
+        for (int i = 0; i < size; i++) {
+            entries[i] = Entry();
+        }
+        size = 0;
+    }
+
+    Entry entries[maxSize];
+    int size = 0;
+
+    /// the value of KoColorConversionCache::Private::generation the entries belong to
+    int generation = 0;
+
+    ThreadCounters counters;
+    ThreadCountersRegistry *registry;
+};
+
+}
 
 struct KoColorConversionCache::Private {
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*> cache;
-    QMutex cacheMutex;
+    QMultiHash< KoColorConversionCacheKey, CachedTransformationSP> cache;
+    mutable QMutex cacheMutex;
+
+    // should outlive threadCaches, the thread caches unregister from it
+    ThreadCountersRegistry threadCounters;
+    QThreadStorage<ThreadCache*> threadCaches;
+
+    /**
+     * Incremented when a color space is destroyed. The per-thread caches
+     * check it on every lookup and drop all their entries when it
+     * changes, because they may refer to the destroyed color space.
+     */
+    std::atomic<int> generation {0};
 
-    QThreadStorage<FastPathCacheItem*> fastStorage;
+    // the fields below are protected by cacheMutex
+    qint64 numCreated = 0;
+    qint64 creationTime = 0;
+
+    ThreadCache* threadCache();
 };
 
+ThreadCache* KoColorConversionCache::Private::threadCache()
+{
+    ThreadCache *cache = threadCaches.localData();
+
+    if (!cache) {
+        cache = new ThreadCache(&threadCounters);
+        cache->generation = generation;
+        threadCaches.setLocalData(cache);
+    }
+
+    return cache;
+}
+
 
 KoColorConversionCache::KoColorConversionCache() : d(new Private)
 {
@@ -77,9 +256,10 @@ KoColorConversionCache::KoColorConversionCache() : d(new Private)
 
 KoColorConversionCache::~KoColorConversionCache()
 {
-    Q_FOREACH (CachedTransformation* transfo, d->cache) {
-        delete transfo;
+    if (d->threadCaches.hasLocalData()) {
+        d->threadCaches.localData()->clear();
     }
+
     delete d;
 }
 
@@ -88,51 +268,70 @@ KoCachedColorConversionTransformation KoColorConversionCache::cachedConverter(co
                                                                               KoColorConversionTransformation::Intent _renderingIntent,
                                                                               KoColorConversionTransformation::ConversionFlags _conversionFlags)
 {
-    KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
+    ThreadCache *threadCache = d->threadCache();
 
-    FastPathCacheItem *cacheItem =
-        d->fastStorage.localData();
+    const int generation = d->generation;
+    if (threadCache->generation != generation) {
+        threadCache->clear();
+        threadCache->generation = generation;
+    }
 
-    if (cacheItem) {
-        if (cacheItem->first == key) {
-            return cacheItem->second;
-        }
+    CachedTransformationSP ct = threadCache->find(src, dst, _renderingIntent, _conversionFlags);
+
+    if (ct) {
+        threadCache->counters.numHits.fetch_add(1, std::memory_order_relaxed);
+        return KoCachedColorConversionTransformation(this, ct.data());
     }
 
-    cacheItem = 0;
+    threadCache->counters.numMisses.fetch_add(1, std::memory_order_relaxed);
+
+    KoColorConversionCacheKey key(src, dst, _renderingIntent, _conversionFlags);
 
     QMutexLocker lock(&d->cacheMutex);
-    QList< CachedTransformation* > cachedTransfos = d->cache.values(key);
+    QList<CachedTransformationSP> cachedTransfos = d->cache.values(key);
     if (cachedTransfos.size() != 0) {
-        Q_FOREACH (CachedTransformation* ct, cachedTransfos) {
-            ct->transfo->setSrcColorSpace(src);
-            ct->transfo->setDstColorSpace(dst);
+        ct = cachedTransfos.first();
+        ct->transfo->setSrcColorSpace(src);
+        ct->transfo->setDstColorSpace(dst);
+    } else {
+        QElapsedTimer timer;
+        timer.start();
 
-            cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
-            break;
-        }
-    }
-    if (!cacheItem) {
         KoColorConversionTransformation* transfo = src->createColorConverter(dst, _renderingIntent, _conversionFlags);
-        CachedTransformation* ct = new CachedTransformation(transfo);
+
+        d->creationTime += timer.nsecsElapsed();
+        d->numCreated++;
+
+        ct.reset(new CachedTransformation(transfo));
         d->cache.insert(key, ct);
-        cacheItem = new FastPathCacheItem(key, KoCachedColorConversionTransformation(this, ct));
     }
 
-    d->fastStorage.setLocalData(cacheItem);
-    return cacheItem->second;
+    /**
+     * If a color space has been destroyed while we were waiting for the
+     * lock, the transformation might belong to a color space allocated
+     * at the same address, so don't let the thread cache keep it.
+     */
+    if (d->generation == generation) {
+        threadCache->insert(src, dst, _renderingIntent, _conversionFlags, ct);
+    }
+
+    return KoCachedColorConversionTransformation(this, ct.data());
 }
 
 void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
 {
-    d->fastStorage.setLocalData(0);
-
     QMutexLocker lock(&d->cacheMutex);
-    QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator endIt = d->cache.end();
-    for (QMultiHash< KoColorConversionCacheKey, CachedTransformation*>::iterator it = d->cache.begin(); it != endIt;) {
+
+    d->generation++;
+
+    if (d->threadCaches.hasLocalData()) {
+        d->threadCaches.localData()->clear();
+    }
+
+    QMultiHash< KoColorConversionCacheKey, CachedTransformationSP>::iterator endIt = d->cache.end();
+    for (QMultiHash< KoColorConversionCacheKey, CachedTransformationSP>::iterator it = d->cache.begin(); it != endIt;) {
         if (it.key().src == cs || it.key().dst == cs) {
             Q_ASSERT(it.value()->isNotInUse()); // That's terribely evil, if that assert fails, that means that someone is using a color transformation with a color space which is currently being deleted
-            delete it.value();
             it = d->cache.erase(it);
         } else {
             ++it;
@@ -140,35 +339,52 @@ void KoColorConversionCache::colorSpaceIsDestroyed(const KoColorSpace* cs)
     }
 }
 
-//--------- KoCachedColorConversionTransformation ----------//
+KoColorConversionCache::Statistics KoColorConversionCache::statistics() const
+{
+    QMutexLocker lock(&d->cacheMutex);
 
-struct KoCachedColorConversionTransformation::Private {
-    KoColorConversionCache* cache;
-    KoColorConversionCache::CachedTransformation* transfo;
-};
+    Statistics stats;
+    stats.numCreated = d->numCreated;
+    stats.creationTime = d->creationTime;
 
+    d->threadCounters.collect(&stats.numHits, &stats.numMisses);
+
+    return stats;
+}
 
-KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoColorConversionCache* cache, KoColorConversionCache::CachedTransformation* transfo) : d(new Private)
+void KoColorConversionCache::resetStatistics()
 {
-    d->cache = cache;
-    d->transfo = transfo;
-    d->transfo->use.ref();
+    QMutexLocker lock(&d->cacheMutex);
+
+    d->numCreated = 0;
+    d->creationTime = 0;
+
+    d->threadCounters.reset();
+}
+
+//--------- KoCachedColorConversionTransformation ----------//
+
+KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(KoColorConversionCache* cache, KoColorConversionCache::CachedTransformation* transfo)
+    : m_cache(cache),
+      m_transfo(transfo)
+{
+    m_transfo->use.ref();
 }
 
-KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation& rhs) : d(new Private(*rhs.d))
+KoCachedColorConversionTransformation::KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation& rhs)
+    : m_cache(rhs.m_cache),
+      m_transfo(rhs.m_transfo)
 {
-    d->transfo->use.ref();
+    m_transfo->use.ref();
 }
 
 KoCachedColorConversionTransformation::~KoCachedColorConversionTransformation()
 {
-    Q_ASSERT(d->transfo->use > 0);
-    d->transfo->use.deref();
-    delete d;
+    Q_ASSERT(m_transfo->use > 0);
+    m_transfo->use.deref();
 }
 
 const KoColorConversionTransformation* KoCachedColorConversionTransformation::transformation() const
 {
-    return d->transfo->transfo;
+    return m_transfo->transfo;
 }
-
@@ -11,16 +11,38 @@ class KoCachedColorConversionTransformation;
 class KoColorSpace;
 
 #include "KoColorConversionTransformation.h"
+#include "kritapigment_export.h"
 
 /**
  * This class holds a cache of KoColorConversionTransformations.
  *
+ * The lookup goes through two levels. Every thread has a small cache
+ * of the transformations it has used recently, which is searched by
+ * the pointers of the color spaces without taking any locks. Only
+ * when it misses, the shared cache is searched under the mutex and,
+ * if needed, a new transformation is created.
+ *
  * This class is not part of public API, and can be changed without notice.
  */
-class KoColorConversionCache
+class KRITAPIGMENT_EXPORT KoColorConversionCache
 {
 public:
     struct CachedTransformation;
+
+    struct Statistics {
+        /// the number of requests served by the per-thread caches
+        qint64 numHits = 0;
+
+        /// the number of requests that had to take the lock
+        qint64 numMisses = 0;
+
+        /// the number of transformations created
+        qint64 numCreated = 0;
+
+        /// the total time spent creating the transformations, in nanoseconds
+        qint64 creationTime = 0;
+    };
+
 public:
     KoColorConversionCache();
     ~KoColorConversionCache();
@@ -45,6 +67,15 @@ public:
      * @param src source color space
      */
     void colorSpaceIsDestroyed(const KoColorSpace* src);
+
+    /**
+     * @return the counters of the cache summed over all the threads
+     * since the cache creation or the last call to resetStatistics()
+     */
+    Statistics statistics() const;
+
+    void resetStatistics();
+
 private:
     struct Private;
     Private* const d;
@@ -57,7 +88,7 @@ private:
  *
  * This class is not part of public API, and can be changed without notice.
  */
-class KoCachedColorConversionTransformation
+class KRITAPIGMENT_EXPORT KoCachedColorConversionTransformation
 {
     friend class KoColorConversionCache;
 private:
@@ -66,11 +97,17 @@ private:
 public:
     KoCachedColorConversionTransformation(const KoCachedColorConversionTransformation&);
     ~KoCachedColorConversionTransformation();
+
+    KoCachedColorConversionTransformation& operator=(const KoCachedColorConversionTransformation&) = delete;
 public:
     const KoColorConversionTransformation* transformation() const;
 private:
-    struct Private;
-    Private* const d;
+    /**
+     * The handle is created on every conversion, so it stores
+     * the pointers directly to avoid a heap allocation
+     */
+    KoColorConversionCache* m_cache;
+    KoColorConversionCache::CachedTransformation* m_transfo;
 };
 
 
@@ -58,6 +58,25 @@ public:
      */
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace* colorSpace) = 0;
 
+    /**
+     * Creates a producer with the same settings and empty bins. A big
+     * region can be split between several threads, each one filling its
+     * own copy, and the copies are summed up with addBinsFrom() at the end.
+     *
+     * @return the new producer or null if the producer cannot be copied
+     */
+    virtual KoHistogramProducer* createEmptyCopy() const {
+        return 0;
+    }
+
+    /**
+     * Adds the bins of \p producer, created with createEmptyCopy(), to
+     * the bins of this producer
+     */
+    virtual void addBinsFrom(KoHistogramProducer *producer) {
+        Q_UNUSED(producer);
+    }
+
     // Methods to set what exactly is being added to the bins
     virtual void setView(qreal from, qreal width) = 0;
     virtual void setSkipTransparent(bool set) {
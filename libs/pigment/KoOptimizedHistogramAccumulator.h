@@ -0,0 +1,228 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramAccumulator_H
+#define KoOptimizedHistogramAccumulator_H
+
+#include "KoOptimizedHistogramAccumulatorBase.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "KoAlwaysInline.h"
+#include "KoColorSpaceConstants.h"
+#include "KoColorSpaceMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+namespace KoHistogramAccumulatorDetail {
+
+using Options = KoOptimizedHistogramAccumulatorBase::Options;
+using Bins = KoOptimizedHistogramAccumulatorBase::Bins;
+
+template<typename _impl, typename EnableDummyType = void>
+struct Maths
+{
+    static void computeBins(const float *values, qint32 *indexes, int numPixels, const Options &options) {
+        const float maxBin = KoOptimizedHistogramAccumulatorBase::numberOfBins - 1;
+
+        for (int i = 0; i < numPixels; i++) {
+            const float value = values[i];
+
+            if (value < options.from) {
+                indexes[i] = Bins::outOfViewLeftBin;
+            } else if (value > options.to) {
+                indexes[i] = Bins::outOfViewRightBin;
+            } else {
+                // NaN goes to the first bin
+                const float pos = (value - options.from) * options.scale + options.bias;
+                indexes[i] = pos > 0.0f ? static_cast<qint32>(qMin(pos, maxBin)) : 0;
+            }
+        }
+    }
+};
+
+#ifdef HAVE_XSIMD
+
+template<typename _impl>
+struct Maths<_impl, typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static void computeBins(const float *values, qint32 *indexes, int numPixels, const Options &options) {
+        const int vectorEnd = numPixels - numPixels % static_cast<int>(float_v::size);
+
+        const float_v from(options.from);
+        const float_v to(options.to);
+        const float_v scale(options.scale);
+        const float_v bias(options.bias);
+        const float_v zero(0.0f);
+        const float_v maxBin(KoOptimizedHistogramAccumulatorBase::numberOfBins - 1);
+        const float_v leftBin(Bins::outOfViewLeftBin);
+        const float_v rightBin(Bins::outOfViewRightBin);
+
+        for (int i = 0; i < vectorEnd; i += static_cast<int>(float_v::size)) {
+            const float_v value = float_v::load_unaligned(values + i);
+
+            // max() returns its second argument for NaN
+            float_v pos = xsimd::min(xsimd::max(xsimd::fma(value - from, scale, bias), zero), maxBin);
+            pos = xsimd::select(value < from, leftBin, pos);
+            pos = xsimd::select(value > to, rightBin, pos);
+
+            xsimd::to_int(pos).store_unaligned(indexes + i);
+        }
+
+        Maths<xsimd::generic>::computeBins(values + vectorEnd, indexes + vectorEnd,
+                                           numPixels - vectorEnd, options);
+    }
+};
+
+#endif // HAVE_XSIMD
+
+}
+
+/**
+ * \see KoOptimizedHistogramAccumulatorBase
+ */
+template<typename _impl, typename channels_type>
+class KoOptimizedHistogramAccumulator : public KoOptimizedHistogramAccumulatorBase
+{
+    using Maths = KoHistogramAccumulatorDetail::Maths<_impl>;
+
+    /**
+     * The pixels are processed in chunks that fit into the stack
+     */
+    static const int chunkSize = 256;
+
+public:
+    KoOptimizedHistogramAccumulator(const Params &params)
+        : KoOptimizedHistogramAccumulatorBase(params)
+    {
+    }
+
+    void accumulate(const quint8 *pixels, const quint8 *selectionMask, qint32 numPixels,
+                    const Options &options, Bins &bins) const override
+    {
+        Q_ASSERT(bins.channelCount() == m_params.channelCount);
+
+        const int channelCount = m_params.channelCount;
+        const channels_type *src = reinterpret_cast<const channels_type*>(pixels);
+        const bool useRawValues = isIdentityView(options, std::is_same<channels_type, quint8>());
+
+        quint8 accepted[chunkSize];
+        float values[chunkSize];
+        qint32 indexes[chunkSize];
+
+        while (numPixels > 0) {
+            const int numChunkPixels = qMin(numPixels, chunkSize);
+            const int numAccepted = selectPixels(src, selectionMask, numChunkPixels, options, accepted);
+
+            /**
+             * The values of the skipped pixels are overwritten by the
+             * following ones, so only the accepted pixels are counted
+             */
+            for (int channel = 0; numAccepted && channel < channelCount; channel++) {
+                const channels_type *value = src + channel;
+                int n = 0;
+
+                if (useRawValues) {
+                    for (int i = 0; i < numChunkPixels; i++, value += channelCount) {
+                        indexes[n] = static_cast<qint32>(*value);
+                        n += accepted[i];
+                    }
+                } else {
+                    for (int i = 0; i < numChunkPixels; i++, value += channelCount) {
+                        values[n] = static_cast<float>(*value);
+                        n += accepted[i];
+                    }
+                    Maths::computeBins(values, indexes, n, options);
+                }
+
+                countIndexes(indexes, n, bins, channel);
+            }
+
+            bins.m_count += numAccepted;
+
+            src += numChunkPixels * channelCount;
+            if (selectionMask) {
+                selectionMask += numChunkPixels;
+            }
+            numPixels -= numChunkPixels;
+        }
+    }
+
+private:
+    int selectPixels(const channels_type *src, const quint8 *selectionMask, int numPixels,
+                     const Options &options, quint8 *accepted) const
+    {
+        const bool checkSelection = selectionMask && options.skipUnselected;
+        const bool checkAlpha = options.skipTransparent && m_params.alphaPos >= 0;
+
+        if (!checkSelection && !checkAlpha) {
+            memset(accepted, 1, numPixels);
+            return numPixels;
+        }
+
+        const int channelCount = m_params.channelCount;
+        const channels_type *alpha = src + m_params.alphaPos;
+        int numAccepted = 0;
+
+        for (int i = 0; i < numPixels; i++) {
+            bool isAccepted = !checkSelection || selectionMask[i];
+
+            if (checkAlpha) {
+                isAccepted &= KoColorSpaceMaths<channels_type, quint8>::scaleToA(alpha[i * channelCount]) != OPACITY_TRANSPARENT_U8;
+            }
+
+            accepted[i] = isAccepted;
+            numAccepted += isAccepted;
+        }
+
+        return numAccepted;
+    }
+
+    /**
+     * Four lanes let the CPU increment four bins at the same time,
+     * even when the neighbouring pixels have the same value
+     */
+    static ALWAYS_INLINE void countIndexes(const qint32 *indexes, int numIndexes, Bins &bins, int channel)
+    {
+        static_assert(Bins::numberOfLanes == 4, "the loop below is unrolled for four lanes");
+
+        quint32 *lane0 = bins.lane(0, channel);
+        quint32 *lane1 = bins.lane(1, channel);
+        quint32 *lane2 = bins.lane(2, channel);
+        quint32 *lane3 = bins.lane(3, channel);
+
+        int i = 0;
+        for (; i + 4 <= numIndexes; i += 4) {
+            lane0[indexes[i]]++;
+            lane1[indexes[i + 1]]++;
+            lane2[indexes[i + 2]]++;
+            lane3[indexes[i + 3]]++;
+        }
+
+        for (; i < numIndexes; i++) {
+            lane0[indexes[i]]++;
+        }
+    }
+
+    /**
+     * 8-bit values can be used as bin indexes directly when the view
+     * covers the whole range
+     */
+    static bool isIdentityView(const Options &options, std::true_type /* 8-bit channels */) {
+        return options.from == 0.0f && options.to >= 255.0f &&
+            options.scale == 1.0f && options.bias >= 0.0f && options.bias < 1.0f;
+    }
+
+    static bool isIdentityView(const Options &options, std::false_type) {
+        Q_UNUSED(options);
+        return false;
+    }
+};
+
+#endif // KoOptimizedHistogramAccumulator_H
@@ -0,0 +1,119 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramAccumulatorBase.h"
+
+#include <KoConfig.h>
+#include "KoColorModelStandardIds.h"
+
+
+KoOptimizedHistogramAccumulatorBase::Bins::Bins(int channelCount)
+{
+    reset(channelCount);
+}
+
+void KoOptimizedHistogramAccumulatorBase::Bins::reset(int channelCount)
+{
+    m_channelCount = channelCount;
+    m_data.fill(0, numberOfLanes * m_channelCount * binStride);
+    m_count = 0;
+}
+
+void KoOptimizedHistogramAccumulatorBase::Bins::clear()
+{
+    m_data.fill(0);
+    m_count = 0;
+}
+
+bool KoOptimizedHistogramAccumulatorBase::Bins::isEmpty() const
+{
+    return !m_count;
+}
+
+int KoOptimizedHistogramAccumulatorBase::Bins::channelCount() const
+{
+    return m_channelCount;
+}
+
+quint32 KoOptimizedHistogramAccumulatorBase::Bins::count() const
+{
+    return m_count;
+}
+
+quint32 KoOptimizedHistogramAccumulatorBase::Bins::bin(int channel, int index) const
+{
+    Q_ASSERT(index >= 0 && index < numberOfBins);
+    return sumOfLanes(channel, index);
+}
+
+quint32 KoOptimizedHistogramAccumulatorBase::Bins::outOfViewLeft(int channel) const
+{
+    return sumOfLanes(channel, outOfViewLeftBin);
+}
+
+quint32 KoOptimizedHistogramAccumulatorBase::Bins::outOfViewRight(int channel) const
+{
+    return sumOfLanes(channel, outOfViewRightBin);
+}
+
+void KoOptimizedHistogramAccumulatorBase::Bins::merge(const Bins &rhs)
+{
+    Q_ASSERT(rhs.m_channelCount == m_channelCount);
+
+    quint32 *dst = m_data.data();
+    const quint32 *src = rhs.m_data.constData();
+    const int size = qMin(m_data.size(), rhs.m_data.size());
+
+    for (int i = 0; i < size; i++) {
+        dst[i] += src[i];
+    }
+
+    m_count += rhs.m_count;
+}
+
+quint32 KoOptimizedHistogramAccumulatorBase::Bins::sumOfLanes(int channel, int index) const
+{
+    Q_ASSERT(channel >= 0 && channel < m_channelCount);
+
+    quint32 result = 0;
+    for (int i = 0; i < numberOfLanes; i++) {
+        result += m_data[(i * m_channelCount + channel) * binStride + index];
+    }
+    return result;
+}
+
+quint32* KoOptimizedHistogramAccumulatorBase::Bins::lane(int lane, int channel)
+{
+    return m_data.data() + (lane * m_channelCount + channel) * binStride;
+}
+
+
+KoOptimizedHistogramAccumulatorBase::KoOptimizedHistogramAccumulatorBase(const Params &params)
+    : m_params(params)
+{
+}
+
+KoOptimizedHistogramAccumulatorBase::~KoOptimizedHistogramAccumulatorBase()
+{
+}
+
+const KoOptimizedHistogramAccumulatorBase::Params &KoOptimizedHistogramAccumulatorBase::params() const
+{
+    return m_params;
+}
+
+bool KoOptimizedHistogramAccumulatorBase::isSupported(const Params &params)
+{
+    if (params.channelCount <= 0) return false;
+    if (params.alphaPos >= params.channelCount) return false;
+
+    return params.depthId == Integer8BitsColorDepthID ||
+           params.depthId == Integer16BitsColorDepthID ||
+#ifdef HAVE_OPENEXR
+           params.depthId == Float16BitsColorDepthID ||
+#endif
+           params.depthId == Float32BitsColorDepthID;
+}
@@ -0,0 +1,141 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramAccumulatorBase_H
+#define KoOptimizedHistogramAccumulatorBase_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <KoID.h>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Counts the channel values of the pixels into 256-bin histograms
+ *
+ * The accumulator computes the bins of a whole run of pixels at once:
+ * the channel values are converted into bin indexes with SIMD
+ * instructions, and the bins are incremented in several independent
+ * lanes, so that the consecutive increments of the same bin don't
+ * wait for each other. The lanes are summed up only when the result
+ * is read.
+ *
+ * The histograms are indexed by the position of the channel in the
+ * pixel, not by the order of KoColorSpace::channels().
+ *
+ * The supported depths are U8, U16, F16 and F32. The accumulator is
+ * stateless, so one instance can be shared by several threads as long
+ * as every thread fills its own Bins object.
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedHistogramAccumulator`. Use
+ * `KoOptimizedHistogramAccumulatorFactory` to create a version
+ * optimized for your CPU architecture.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramAccumulatorBase
+{
+public:
+    static const int numberOfBins = 256;
+
+    struct Params {
+        KoID depthId;
+        int channelCount = 0;
+
+        /// position of the alpha channel in the pixel, -1 if there is none
+        int alphaPos = -1;
+    };
+
+    /**
+     * Defines how the channel values are mapped to the bins. A value
+     * goes into bin `(value - from) * scale + bias` if it is in range
+     * [from, to], otherwise it is counted as out of view. The values
+     * are in the native units of the channel type.
+     */
+    struct Options {
+        float from = 0.0f;
+        float to = 255.0f;
+        float scale = 1.0f;
+        float bias = 0.0f;
+
+        bool skipTransparent = true;
+        bool skipUnselected = true;
+    };
+
+    /**
+     * The histograms collected by one thread
+     */
+    class KRITAPIGMENT_EXPORT Bins
+    {
+    public:
+        /**
+         * Every lane stores the histograms of all the channels, each
+         * one followed by the counters of the values out of view
+         */
+        static const int outOfViewLeftBin = numberOfBins;
+        static const int outOfViewRightBin = numberOfBins + 1;
+        static const int binStride = numberOfBins + 4;
+        static const int numberOfLanes = 4;
+
+    public:
+        Bins(int channelCount = 0);
+
+        void reset(int channelCount);
+        void clear();
+
+        bool isEmpty() const;
+        int channelCount() const;
+
+        /// the number of pixels that passed the selection and transparency checks
+        quint32 count() const;
+
+        quint32 bin(int channel, int index) const;
+        quint32 outOfViewLeft(int channel) const;
+        quint32 outOfViewRight(int channel) const;
+
+        /**
+         * Adds the data of \p rhs to this object. Both objects should
+         * have the same number of channels.
+         */
+        void merge(const Bins &rhs);
+
+    private:
+        template<typename _impl, typename channels_type>
+        friend class KoOptimizedHistogramAccumulator;
+
+        quint32 sumOfLanes(int channel, int index) const;
+        quint32* lane(int lane, int channel);
+
+        QVector<quint32> m_data;
+        int m_channelCount = 0;
+        quint32 m_count = 0;
+    };
+
+public:
+    KoOptimizedHistogramAccumulatorBase(const Params &params);
+    virtual ~KoOptimizedHistogramAccumulatorBase();
+
+    /**
+     * Counts \p numPixels pixels into \p bins.
+     *
+     * @param selectionMask an optional array of \p numPixels bytes, the
+     *        pixels with zero selection are skipped if
+     *        Options::skipUnselected is set
+     */
+    virtual void accumulate(const quint8 *pixels, const quint8 *selectionMask, qint32 numPixels,
+                            const Options &options, Bins &bins) const = 0;
+
+    const Params& params() const;
+
+    /**
+     * @return true if \p params describe pixels this class can count
+     */
+    static bool isSupported(const Params &params);
+
+protected:
+    Params m_params;
+};
+
+#endif // KoOptimizedHistogramAccumulatorBase_H
@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramAccumulatorFactory.h"
+
+#include "KoOptimizedHistogramAccumulatorFactoryImpl.h"
+
+
+KoOptimizedHistogramAccumulatorBase *KoOptimizedHistogramAccumulatorFactory::create(const KoOptimizedHistogramAccumulatorBase::Params &params)
+{
+    if (!KoOptimizedHistogramAccumulatorBase::isSupported(params)) return nullptr;
+
+    return createOptimizedClass<
+            KoOptimizedHistogramAccumulatorFactoryImpl>(params);
+}
@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramAccumulatorFACTORY_H
+#define KoOptimizedHistogramAccumulatorFACTORY_H
+
+#include "KoOptimizedHistogramAccumulatorBase.h"
+
+/**
+ * \see KoOptimizedHistogramAccumulatorBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramAccumulatorFactory
+{
+public:
+    /**
+     * @return an accumulator optimized for the current CPU, or nullptr
+     * if \p params describe an unsupported pixel format
+     */
+    static KoOptimizedHistogramAccumulatorBase* create(const KoOptimizedHistogramAccumulatorBase::Params &params);
+};
+
+#endif // KoOptimizedHistogramAccumulatorFACTORY_H
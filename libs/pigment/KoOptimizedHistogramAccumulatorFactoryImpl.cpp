@@ -0,0 +1,40 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedHistogramAccumulatorFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedHistogramAccumulator.h"
+
+#include <KoConfig.h>
+#include "KoColorModelStandardIds.h"
+
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+template<typename _impl>
+KoOptimizedHistogramAccumulatorBase *KoOptimizedHistogramAccumulatorFactoryImpl::create(ParamType params)
+{
+    if (params.depthId == Integer8BitsColorDepthID) {
+        return new KoOptimizedHistogramAccumulator<_impl, quint8>(params);
+    } else if (params.depthId == Integer16BitsColorDepthID) {
+        return new KoOptimizedHistogramAccumulator<_impl, quint16>(params);
+#ifdef HAVE_OPENEXR
+    } else if (params.depthId == Float16BitsColorDepthID) {
+        return new KoOptimizedHistogramAccumulator<_impl, half>(params);
+#endif
+    } else if (params.depthId == Float32BitsColorDepthID) {
+        return new KoOptimizedHistogramAccumulator<_impl, float>(params);
+    }
+
+    return nullptr;
+}
+
+template KoOptimizedHistogramAccumulatorBase *
+KoOptimizedHistogramAccumulatorFactoryImpl::create<xsimd::current_arch>(ParamType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
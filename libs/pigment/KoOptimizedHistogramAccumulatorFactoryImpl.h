@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedHistogramAccumulatorFACTORYIMPL_H
+#define KoOptimizedHistogramAccumulatorFACTORYIMPL_H
+
+#include <KoOptimizedHistogramAccumulatorBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedHistogramAccumulatorFactoryImpl
+{
+public:
+    using ParamType = const KoOptimizedHistogramAccumulatorBase::Params &;
+    using ReturnType = KoOptimizedHistogramAccumulatorBase *;
+
+    template<typename _impl>
+    static KoOptimizedHistogramAccumulatorBase* create(ParamType params);
+};
+
+#endif // KoOptimizedHistogramAccumulatorFACTORYIMPL_H
@@ -0,0 +1,237 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMatrixShaperTransform_H
+#define KoOptimizedMatrixShaperTransform_H
+
+#include "KoOptimizedMatrixShaperTransformBase.h"
+
+#include <limits>
+#include <type_traits>
+
+#include "KoAlwaysInline.h"
+#include "KoColorSpaceMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+namespace KoMatrixShaperTransformDetail {
+
+/**
+ * Integer channels are linearized with a table indexed by the channel
+ * value and encoded with a table indexed by the 16-bit linear value
+ */
+template<typename channels_type,
+         bool isInteger = std::numeric_limits<channels_type>::is_integer>
+struct Channel
+{
+    static ALWAYS_INLINE float toLinear(channels_type value, const float *table) {
+        return table ? table[value] : KoColorSpaceMaths<channels_type, float>::scaleToA(value);
+    }
+
+    static ALWAYS_INLINE channels_type fromIndex(qint32 index, const quint16 *table) {
+        return KoColorSpaceMaths<quint16, channels_type>::scaleToA(table ? table[index] : quint16(index));
+    }
+};
+
+/**
+ * Floating point channels are linear, so they are only converted
+ * to float and back
+ */
+template<typename channels_type>
+struct Channel<channels_type, false>
+{
+    static ALWAYS_INLINE float toLinear(channels_type value, const float *table) {
+        Q_UNUSED(table);
+        return KoColorSpaceMaths<channels_type, float>::scaleToA(value);
+    }
+
+    static ALWAYS_INLINE channels_type fromLinear(float value) {
+        return KoColorSpaceMaths<float, channels_type>::scaleToA(value);
+    }
+};
+
+template<typename _impl, typename EnableDummyType = void>
+struct Maths
+{
+    static void applyMatrix(const float *m, float *red, float *green, float *blue, int numPixels) {
+        for (int i = 0; i < numPixels; i++) {
+            const float r = red[i];
+            const float g = green[i];
+            const float b = blue[i];
+
+            red[i] = m[0] * r + m[1] * g + m[2] * b;
+            green[i] = m[3] * r + m[4] * g + m[5] * b;
+            blue[i] = m[6] * r + m[7] * g + m[8] * b;
+        }
+    }
+
+    static void quantize(const float *values, qint32 *indexes, int numPixels) {
+        for (int i = 0; i < numPixels; i++) {
+            // NaN goes to zero
+            const float value = values[i] > 0.0f ? qMin(values[i], 1.0f) : 0.0f;
+            indexes[i] = qRound(value * 65535.0f);
+        }
+    }
+};
+
+#ifdef HAVE_XSIMD
+
+template<typename _impl>
+struct Maths<_impl, typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+{
+    using float_v = xsimd::batch<float, _impl>;
+
+    static void applyMatrix(const float *m, float *red, float *green, float *blue, int numPixels) {
+        const int vectorEnd = numPixels - numPixels % static_cast<int>(float_v::size);
+
+        const float_v m0(m[0]), m1(m[1]), m2(m[2]);
+        const float_v m3(m[3]), m4(m[4]), m5(m[5]);
+        const float_v m6(m[6]), m7(m[7]), m8(m[8]);
+
+        for (int i = 0; i < vectorEnd; i += static_cast<int>(float_v::size)) {
+            const float_v r = float_v::load_unaligned(red + i);
+            const float_v g = float_v::load_unaligned(green + i);
+            const float_v b = float_v::load_unaligned(blue + i);
+
+            xsimd::fma(m0, r, xsimd::fma(m1, g, m2 * b)).store_unaligned(red + i);
+            xsimd::fma(m3, r, xsimd::fma(m4, g, m5 * b)).store_unaligned(green + i);
+            xsimd::fma(m6, r, xsimd::fma(m7, g, m8 * b)).store_unaligned(blue + i);
+        }
+
+        Maths<xsimd::generic>::applyMatrix(m, red + vectorEnd, green + vectorEnd, blue + vectorEnd,
+                                           numPixels - vectorEnd);
+    }
+
+    static void quantize(const float *values, qint32 *indexes, int numPixels) {
+        const int vectorEnd = numPixels - numPixels % static_cast<int>(float_v::size);
+
+        const float_v zero(0.0f);
+        const float_v one(1.0f);
+        const float_v scale(65535.0f);
+
+        for (int i = 0; i < vectorEnd; i += static_cast<int>(float_v::size)) {
+            // max() returns its second argument for NaN
+            const float_v value = xsimd::min(xsimd::max(float_v::load_unaligned(values + i), zero), one);
+            xsimd::nearbyint_as_int(value * scale).store_unaligned(indexes + i);
+        }
+
+        Maths<xsimd::generic>::quantize(values + vectorEnd, indexes + vectorEnd,
+                                        numPixels - vectorEnd);
+    }
+};
+
+#endif // HAVE_XSIMD
+
+}
+
+/**
+ * \see KoOptimizedMatrixShaperTransformBase
+ */
+template<typename _impl, typename SrcTraits, typename DstTraits>
+class KoOptimizedMatrixShaperTransform : public KoOptimizedMatrixShaperTransformBase
+{
+    using src_channels_type = typename SrcTraits::channels_type;
+    using dst_channels_type = typename DstTraits::channels_type;
+
+    using SrcChannel = KoMatrixShaperTransformDetail::Channel<src_channels_type>;
+    using DstChannel = KoMatrixShaperTransformDetail::Channel<dst_channels_type>;
+    using Maths = KoMatrixShaperTransformDetail::Maths<_impl>;
+
+    /**
+     * The pixels are converted in chunks that fit into the stack
+     */
+    static const int chunkSize = 256;
+
+public:
+    KoOptimizedMatrixShaperTransform(const Params &params)
+        : KoOptimizedMatrixShaperTransformBase(params)
+    {
+    }
+
+    void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override
+    {
+        const typename SrcTraits::Pixel *srcPixel = reinterpret_cast<const typename SrcTraits::Pixel*>(src);
+        typename DstTraits::Pixel *dstPixel = reinterpret_cast<typename DstTraits::Pixel*>(dst);
+
+        const float *srcRedTable = tableData(m_params.srcToLinear[0]);
+        const float *srcGreenTable = tableData(m_params.srcToLinear[1]);
+        const float *srcBlueTable = tableData(m_params.srcToLinear[2]);
+
+        float red[chunkSize];
+        float green[chunkSize];
+        float blue[chunkSize];
+        float alpha[chunkSize];
+
+        while (numPixels > 0) {
+            const int numChunkPixels = qMin(numPixels, chunkSize);
+
+            /**
+             * All the source pixels of the chunk are read before any
+             * destination pixel is written, so in-place conversion
+             * between the formats of the same size is safe.
+             */
+            for (int i = 0; i < numChunkPixels; i++) {
+                red[i] = SrcChannel::toLinear(srcPixel[i].red, srcRedTable);
+                green[i] = SrcChannel::toLinear(srcPixel[i].green, srcGreenTable);
+                blue[i] = SrcChannel::toLinear(srcPixel[i].blue, srcBlueTable);
+                alpha[i] = KoColorSpaceMaths<src_channels_type, float>::scaleToA(srcPixel[i].alpha);
+            }
+
+            Maths::applyMatrix(m_params.matrix, red, green, blue, numChunkPixels);
+
+            writePixels(dstPixel, red, green, blue, alpha, numChunkPixels,
+                        std::integral_constant<bool, std::numeric_limits<dst_channels_type>::is_integer>());
+
+            srcPixel += numChunkPixels;
+            dstPixel += numChunkPixels;
+            numPixels -= numChunkPixels;
+        }
+    }
+
+private:
+    void writePixels(typename DstTraits::Pixel *dstPixel,
+                     float *red, float *green, float *blue, const float *alpha,
+                     int numPixels, std::true_type /* integer destination */) const
+    {
+        const quint16 *redTable = tableData(m_params.linearToDst[0]);
+        const quint16 *greenTable = tableData(m_params.linearToDst[1]);
+        const quint16 *blueTable = tableData(m_params.linearToDst[2]);
+
+        qint32 redIndex[chunkSize];
+        qint32 greenIndex[chunkSize];
+        qint32 blueIndex[chunkSize];
+
+        Maths::quantize(red, redIndex, numPixels);
+        Maths::quantize(green, greenIndex, numPixels);
+        Maths::quantize(blue, blueIndex, numPixels);
+
+        for (int i = 0; i < numPixels; i++) {
+            dstPixel[i].red = DstChannel::fromIndex(redIndex[i], redTable);
+            dstPixel[i].green = DstChannel::fromIndex(greenIndex[i], greenTable);
+            dstPixel[i].blue = DstChannel::fromIndex(blueIndex[i], blueTable);
+            dstPixel[i].alpha = KoColorSpaceMaths<float, dst_channels_type>::scaleToA(alpha[i]);
+        }
+    }
+
+    void writePixels(typename DstTraits::Pixel *dstPixel,
+                     float *red, float *green, float *blue, const float *alpha,
+                     int numPixels, std::false_type /* floating point destination */) const
+    {
+        for (int i = 0; i < numPixels; i++) {
+            dstPixel[i].red = DstChannel::fromLinear(red[i]);
+            dstPixel[i].green = DstChannel::fromLinear(green[i]);
+            dstPixel[i].blue = DstChannel::fromLinear(blue[i]);
+            dstPixel[i].alpha = DstChannel::fromLinear(alpha[i]);
+        }
+    }
+
+    template<typename T>
+    static const T* tableData(const QVector<T> &table) {
+        return table.isEmpty() ? nullptr : table.constData();
+    }
+};
+
+#endif // KoOptimizedMatrixShaperTransform_H
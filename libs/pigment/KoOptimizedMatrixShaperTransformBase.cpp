@@ -0,0 +1,61 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMatrixShaperTransformBase.h"
+
+#include <KoConfig.h>
+#include "KoColorModelStandardIds.h"
+
+namespace {
+
+int integerTableSize(const KoID &depthId)
+{
+    if (depthId == Integer8BitsColorDepthID) {
+        return 256;
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return 65536;
+    }
+
+    return 0;
+}
+
+bool isFloatDepth(const KoID &depthId)
+{
+#ifdef HAVE_OPENEXR
+    if (depthId == Float16BitsColorDepthID) return true;
+#endif
+    return depthId == Float32BitsColorDepthID;
+}
+
+}
+
+KoOptimizedMatrixShaperTransformBase::KoOptimizedMatrixShaperTransformBase(const Params &params)
+    : m_params(params)
+{
+}
+
+KoOptimizedMatrixShaperTransformBase::~KoOptimizedMatrixShaperTransformBase()
+{
+}
+
+bool KoOptimizedMatrixShaperTransformBase::isSupported(const Params &params)
+{
+    const int srcTableSize = integerTableSize(params.srcDepthId);
+    const int dstTableSize = integerTableSize(params.dstDepthId);
+
+    if (!srcTableSize && !isFloatDepth(params.srcDepthId)) return false;
+    if (!dstTableSize && !isFloatDepth(params.dstDepthId)) return false;
+
+    for (int i = 0; i < 3; i++) {
+        const int srcSize = params.srcToLinear[i].size();
+        if (srcSize && srcSize != srcTableSize) return false;
+
+        const int dstSize = params.linearToDst[i].size();
+        if (dstSize && (!dstTableSize || dstSize != linearToDstTableSize)) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMatrixShaperTransformBase_H
+#define KoOptimizedMatrixShaperTransformBase_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <KoID.h>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Converts RGBA pixels between two matrix-shaper profiles
+ *
+ * A conversion between two matrix-shaper RGB profiles (sRGB, Rec. 2020,
+ * their linear variants and so on) consists of three steps: the source
+ * tone curves are removed, the linear values are multiplied by a 3x3
+ * matrix and the destination tone curves are applied. The color engine
+ * precomputes the matrix and the tone curves as lookup tables, and this
+ * class executes the conversion without going through the generic
+ * pipeline of the engine.
+ *
+ * The supported depths are U8, U16, F16 and F32. The integer depths use
+ * BGRA layout, the floating point ones RGBA, just like the RGB color
+ * spaces do. The tone curves of the floating point depths must be linear,
+ * because the lookup tables cannot represent values outside [0, 1].
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedMatrixShaperTransform`. Use
+ * `KoOptimizedMatrixShaperTransformFactory` to create a version
+ * optimized for your CPU architecture.
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperTransformBase
+{
+public:
+    struct Params {
+        KoID srcDepthId;
+        KoID dstDepthId;
+
+        /**
+         * Row-major matrix that converts linear source RGB into
+         * linear destination RGB
+         */
+        float matrix[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+
+        /**
+         * Linear values of the source channels (red, green, blue),
+         * indexed by the channel value. Empty tables mean that the
+         * channels are linear already.
+         */
+        QVector<float> srcToLinear[3];
+
+        /**
+         * The destination channels (red, green, blue) in 16-bit
+         * precision, indexed by the linear value scaled to 0...65535.
+         * Empty tables mean that the channels are linear.
+         */
+        QVector<quint16> linearToDst[3];
+    };
+
+    static const int linearToDstTableSize = 65536;
+
+public:
+    KoOptimizedMatrixShaperTransformBase(const Params &params);
+    virtual ~KoOptimizedMatrixShaperTransformBase();
+
+    virtual void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const = 0;
+
+    /**
+     * @return true if \p params describe a conversion this class
+     * can do
+     */
+    static bool isSupported(const Params &params);
+
+protected:
+    Params m_params;
+};
+
+#endif // KoOptimizedMatrixShaperTransformBase_H
@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMatrixShaperTransformFactory.h"
+
+#include "KoOptimizedMatrixShaperTransformFactoryImpl.h"
+
+
+KoOptimizedMatrixShaperTransformBase *KoOptimizedMatrixShaperTransformFactory::create(const KoOptimizedMatrixShaperTransformBase::Params &params)
+{
+    if (!KoOptimizedMatrixShaperTransformBase::isSupported(params)) return nullptr;
+
+    return createOptimizedClass<
+            KoOptimizedMatrixShaperTransformFactoryImpl>(params);
+}
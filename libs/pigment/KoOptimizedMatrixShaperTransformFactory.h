@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMatrixShaperTransformFACTORY_H
+#define KoOptimizedMatrixShaperTransformFACTORY_H
+
+#include "KoOptimizedMatrixShaperTransformBase.h"
+
+/**
+ * \see KoOptimizedMatrixShaperTransformBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperTransformFactory
+{
+public:
+    /**
+     * @return a transform optimized for the current CPU, or nullptr
+     * if \p params describe an unsupported conversion
+     */
+    static KoOptimizedMatrixShaperTransformBase* create(const KoOptimizedMatrixShaperTransformBase::Params &params);
+};
+
+#endif // KoOptimizedMatrixShaperTransformFACTORY_H
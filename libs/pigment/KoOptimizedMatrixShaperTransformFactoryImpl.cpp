@@ -0,0 +1,59 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMatrixShaperTransformFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedMatrixShaperTransform.h"
+
+#include <KoConfig.h>
+#include "KoColorModelStandardIds.h"
+#include "KoColorSpaceTraits.h"
+
+namespace {
+
+template<typename _impl, typename SrcTraits>
+KoOptimizedMatrixShaperTransformBase* createForSource(const KoOptimizedMatrixShaperTransformBase::Params &params)
+{
+    if (params.dstDepthId == Integer8BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperTransform<_impl, SrcTraits, KoBgrU8Traits>(params);
+    } else if (params.dstDepthId == Integer16BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperTransform<_impl, SrcTraits, KoBgrU16Traits>(params);
+#ifdef HAVE_OPENEXR
+    } else if (params.dstDepthId == Float16BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperTransform<_impl, SrcTraits, KoRgbF16Traits>(params);
+#endif
+    } else if (params.dstDepthId == Float32BitsColorDepthID) {
+        return new KoOptimizedMatrixShaperTransform<_impl, SrcTraits, KoRgbF32Traits>(params);
+    }
+
+    return nullptr;
+}
+
+}
+
+template<typename _impl>
+KoOptimizedMatrixShaperTransformBase *KoOptimizedMatrixShaperTransformFactoryImpl::create(ParamType params)
+{
+    if (params.srcDepthId == Integer8BitsColorDepthID) {
+        return createForSource<_impl, KoBgrU8Traits>(params);
+    } else if (params.srcDepthId == Integer16BitsColorDepthID) {
+        return createForSource<_impl, KoBgrU16Traits>(params);
+#ifdef HAVE_OPENEXR
+    } else if (params.srcDepthId == Float16BitsColorDepthID) {
+        return createForSource<_impl, KoRgbF16Traits>(params);
+#endif
+    } else if (params.srcDepthId == Float32BitsColorDepthID) {
+        return createForSource<_impl, KoRgbF32Traits>(params);
+    }
+
+    return nullptr;
+}
+
+template KoOptimizedMatrixShaperTransformBase *
+KoOptimizedMatrixShaperTransformFactoryImpl::create<xsimd::current_arch>(ParamType);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
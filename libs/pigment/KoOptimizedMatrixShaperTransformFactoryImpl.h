@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMatrixShaperTransformFACTORYIMPL_H
+#define KoOptimizedMatrixShaperTransformFACTORYIMPL_H
+
+#include <KoOptimizedMatrixShaperTransformBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedMatrixShaperTransformFactoryImpl
+{
+public:
+    using ParamType = const KoOptimizedMatrixShaperTransformBase::Params &;
+    using ReturnType = KoOptimizedMatrixShaperTransformBase *;
+
+    template<typename _impl>
+    static KoOptimizedMatrixShaperTransformBase* create(ParamType params);
+};
+
+#endif // KoOptimizedMatrixShaperTransformFACTORYIMPL_H
@@ -0,0 +1,321 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMixColorsOp_H
+#define KoOptimizedMixColorsOp_H
+
+#include "KoMixColorsOpImpl.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "KoColorSpaceMaths.h"
+#include "KoMultiArchBuildSupport.h"
+
+
+namespace KoMixColorsOpDetail {
+
+template<typename _impl, typename EnableDummyType = void>
+struct Maths
+{
+    /**
+     * Adds `color * alpha * weight` of every pixel to \p totals[0..2]
+     * and `alpha * weight` to \p totals[3]. If \p weights is null, all
+     * the pixels have weight 1.
+     */
+    static void accumulate(const double *color0, const double *color1, const double *color2,
+                           const double *alpha, const double *weights,
+                           int numPixels, double *totals) {
+        for (int i = 0; i < numPixels; i++) {
+            const double alphaTimesWeight = weights ? alpha[i] * weights[i] : alpha[i];
+
+            totals[0] += color0[i] * alphaTimesWeight;
+            totals[1] += color1[i] * alphaTimesWeight;
+            totals[2] += color2[i] * alphaTimesWeight;
+            totals[3] += alphaTimesWeight;
+        }
+    }
+};
+
+#ifdef HAVE_XSIMD
+
+/**
+ * 32-bit NEON has no double precision vectors, so it uses the scalar version
+ */
+template<typename _impl>
+struct Maths<_impl, typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value &&
+                                            xsimd::types::has_simd_register<double, _impl>::value>::type>
+{
+    using double_v = xsimd::batch<double, _impl>;
+
+    static void accumulate(const double *color0, const double *color1, const double *color2,
+                           const double *alpha, const double *weights,
+                           int numPixels, double *totals) {
+        const int vectorEnd = numPixels - numPixels % static_cast<int>(double_v::size);
+
+        double_v total0(0.0);
+        double_v total1(0.0);
+        double_v total2(0.0);
+        double_v totalAlpha(0.0);
+
+        for (int i = 0; i < vectorEnd; i += static_cast<int>(double_v::size)) {
+            double_v alphaTimesWeight = double_v::load_unaligned(alpha + i);
+            if (weights) {
+                alphaTimesWeight *= double_v::load_unaligned(weights + i);
+            }
+
+            total0 = xsimd::fma(double_v::load_unaligned(color0 + i), alphaTimesWeight, total0);
+            total1 = xsimd::fma(double_v::load_unaligned(color1 + i), alphaTimesWeight, total1);
+            total2 = xsimd::fma(double_v::load_unaligned(color2 + i), alphaTimesWeight, total2);
+            totalAlpha += alphaTimesWeight;
+        }
+
+        totals[0] += xsimd::reduce_add(total0);
+        totals[1] += xsimd::reduce_add(total1);
+        totals[2] += xsimd::reduce_add(total2);
+        totals[3] += xsimd::reduce_add(totalAlpha);
+
+        Maths<xsimd::generic>::accumulate(color0 + vectorEnd, color1 + vectorEnd, color2 + vectorEnd,
+                                          alpha + vectorEnd, weights ? weights + vectorEnd : nullptr,
+                                          numPixels - vectorEnd, totals);
+    }
+};
+
+#endif // HAVE_XSIMD
+
+}
+
+/**
+ * A version of KoMixColorsOpImpl for the pixels of four channels with
+ * the alpha channel at the end, e.g. RGBA, BGRA or LabA.
+ *
+ * The pixels are split into the channels, converted into doubles, and
+ * the weighted sums are computed with SIMD instructions. The integer
+ * products and their sums are exact in doubles, so the result is
+ * exactly the same as the one of KoMixColorsOpImpl. The floating point
+ * sums may differ in the last bits, because they are added up in a
+ * different order.
+ *
+ * The convenience methods mixing two colors per pixel are inherited
+ * from KoMixColorsOpImpl.
+ *
+ * Use KoOptimizedMixColorsOpFactory to create a version optimized for
+ * your CPU architecture.
+ */
+template<typename _impl, typename _CSTrait>
+class KoOptimizedMixColorsOp : public KoMixColorsOpImpl<_CSTrait>
+{
+    using channels_type = typename _CSTrait::channels_type;
+    using mix_type = typename KoColorSpaceMathsTraits<channels_type>::mixtype;
+    using MathsTraits = KoColorSpaceMathsTraits<channels_type>;
+    using Maths = KoMixColorsOpDetail::Maths<_impl>;
+
+    static_assert(_CSTrait::channels_nb == 4 && _CSTrait::alpha_pos == 3,
+                  "only four channel pixels with the alpha channel at the end are supported");
+
+    /**
+     * The pixels are processed in chunks that fit into the stack. The
+     * chunk is short enough to keep the sums of the integer channels
+     * exact in doubles: 64 * 65535 * 65535 * 32768 < 2^53
+     */
+    static const int chunkSize = 64;
+
+public:
+    KoMixColorsOp::Mixer* createMixer() const override
+    {
+        return new MixerImpl();
+    }
+
+    void mixColors(const quint8 * const* colors, const qint16 *weights, int nColors, quint8 *dst, int weightSum = 255) const override
+    {
+        MixDataResult result;
+        result.accumulateColors(PixelPointers(colors), weights, weightSum, nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 *colors, const qint16 *weights, int nColors, quint8 *dst, int weightSum = 255) const override
+    {
+        MixDataResult result;
+        result.accumulateColors(ContiguousPixels(colors), weights, weightSum, nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 * const* colors, int nColors, quint8 *dst) const override
+    {
+        MixDataResult result;
+        result.accumulateColors(PixelPointers(colors), nullptr, nColors, nColors);
+        result.computeMixedColor(dst);
+    }
+
+    void mixColors(const quint8 *colors, int nColors, quint8 *dst) const override
+    {
+        MixDataResult result;
+        result.accumulateColors(ContiguousPixels(colors), nullptr, nColors, nColors);
+        result.computeMixedColor(dst);
+    }
+
+private:
+    struct PixelPointers {
+        PixelPointers(const quint8 * const* colors)
+            : m_colors(colors)
+        {
+        }
+
+        const channels_type* pixel(int index) const {
+            return _CSTrait::nativeArray(m_colors[index]);
+        }
+
+        void skip(int numPixels) {
+            m_colors += numPixels;
+        }
+
+    private:
+        const quint8 * const * m_colors;
+    };
+
+    struct ContiguousPixels {
+        ContiguousPixels(const quint8 *colors)
+            : m_colors(_CSTrait::nativeArray(colors))
+        {
+        }
+
+        const channels_type* pixel(int index) const {
+            return m_colors + index * _CSTrait::channels_nb;
+        }
+
+        void skip(int numPixels) {
+            m_colors += numPixels * _CSTrait::channels_nb;
+        }
+
+    private:
+        const channels_type *m_colors;
+    };
+
+    class MixDataResult
+    {
+    public:
+        MixDataResult() {
+            memset(m_totals, 0, sizeof(m_totals));
+        }
+
+        /**
+         * If \p weights is null, every pixel has weight 1
+         */
+        template<class PixelSource>
+        void accumulateColors(PixelSource source, const qint16 *weights, int normalizeFactor, int nColors)
+        {
+            double color0[chunkSize];
+            double color1[chunkSize];
+            double color2[chunkSize];
+            double alpha[chunkSize];
+            double weightValues[chunkSize];
+
+            while (nColors > 0) {
+                const int numChunkPixels = qMin(nColors, chunkSize);
+
+                for (int i = 0; i < numChunkPixels; i++) {
+                    const channels_type *color = source.pixel(i);
+
+                    color0[i] = color[0];
+                    color1[i] = color[1];
+                    color2[i] = color[2];
+                    alpha[i] = color[3];
+                }
+
+                if (weights) {
+                    for (int i = 0; i < numChunkPixels; i++) {
+                        weightValues[i] = weights[i];
+                    }
+                }
+
+                double chunkTotals[4] = {0.0, 0.0, 0.0, 0.0};
+                Maths::accumulate(color0, color1, color2, alpha, weights ? weightValues : nullptr,
+                                  numChunkPixels, chunkTotals);
+
+                m_totals[0] += static_cast<mix_type>(chunkTotals[0]);
+                m_totals[1] += static_cast<mix_type>(chunkTotals[1]);
+                m_totals[2] += static_cast<mix_type>(chunkTotals[2]);
+                m_totalAlpha += static_cast<mix_type>(chunkTotals[3]);
+
+                source.skip(numChunkPixels);
+                if (weights) {
+                    weights += numChunkPixels;
+                }
+                nColors -= numChunkPixels;
+            }
+
+            m_normalizeFactor += normalizeFactor;
+        }
+
+        /**
+         * Rounds and clamps the channels the same way as
+         * KoMixColorsOpImpl does
+         */
+        void computeMixedColor(quint8 *dst) const
+        {
+            channels_type *dstColor = _CSTrait::nativeArray(dst);
+
+            if (m_totalAlpha > 0) {
+                for (int i = 0; i < 3; i++) {
+                    dstColor[i] = clampToChannel(safeDivideWithRound(m_totals[i], m_totalAlpha));
+                }
+                dstColor[3] = clampToChannel(safeDivideWithRound(m_totalAlpha, static_cast<mix_type>(m_normalizeFactor)));
+            } else {
+                memset(dst, 0, _CSTrait::pixelSize);
+            }
+        }
+
+        qint64 currentWeightsSum() const
+        {
+            return m_normalizeFactor;
+        }
+
+    private:
+        static channels_type clampToChannel(mix_type v) {
+            if (v > MathsTraits::max) {
+                v = MathsTraits::max;
+            }
+            if (v < MathsTraits::min) {
+                v = MathsTraits::min;
+            }
+            return v;
+        }
+
+    private:
+        mix_type m_totals[3];
+        mix_type m_totalAlpha = 0;
+        qint64 m_normalizeFactor = 0;
+    };
+
+    class MixerImpl : public KoMixColorsOp::Mixer
+    {
+    public:
+        void accumulate(const quint8 *data, const qint16 *weights, int weightSum, int nPixels) override
+        {
+            m_result.accumulateColors(ContiguousPixels(data), weights, weightSum, nPixels);
+        }
+
+        void accumulateAverage(const quint8 *data, int nPixels) override
+        {
+            m_result.accumulateColors(ContiguousPixels(data), nullptr, nPixels, nPixels);
+        }
+
+        void computeMixedColor(quint8 *data) override
+        {
+            m_result.computeMixedColor(data);
+        }
+
+        qint64 currentWeightsSum() const override
+        {
+            return m_result.currentWeightsSum();
+        }
+
+    private:
+        MixDataResult m_result;
+    };
+};
+
+#endif // KoOptimizedMixColorsOp_H
@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactory.h"
+
+#include "KoColorModelStandardIds.h"
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+
+KoMixColorsOp *KoOptimizedMixColorsOpFactory::create(const KoID &depthId, int numChannels, int alphaPos)
+{
+    if (numChannels != 4 || alphaPos != 3) return nullptr;
+
+    if (depthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<quint8>>(0);
+    } else if (depthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<quint16>>(0);
+    } else if (depthId == Float32BitsColorDepthID) {
+        return createOptimizedClass<KoOptimizedMixColorsOpFactoryImpl<float>>(0);
+    }
+
+    return nullptr;
+}
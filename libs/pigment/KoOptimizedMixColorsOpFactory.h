@@ -0,0 +1,31 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMixColorsOpFACTORY_H
+#define KoOptimizedMixColorsOpFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+
+class KoMixColorsOp;
+
+/**
+ * \see KoOptimizedMixColorsOp
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactory
+{
+public:
+    /**
+     * @return a mix colors op optimized for the current CPU, or nullptr
+     * if there is no optimized version for the pixel format. Only
+     * U8, U16 and F32 pixels of four channels with the alpha channel
+     * at the end are supported.
+     */
+    static KoMixColorsOp* create(const KoID &depthId, int numChannels, int alphaPos);
+};
+
+#endif // KoOptimizedMixColorsOpFACTORY_H
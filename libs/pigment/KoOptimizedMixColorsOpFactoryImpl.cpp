@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoOptimizedMixColorsOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedMixColorsOp.h"
+
+#include "KoColorSpaceTraits.h"
+
+template<typename _channels_type_>
+template<typename _impl>
+KoMixColorsOp *KoOptimizedMixColorsOpFactoryImpl<_channels_type_>::create(int)
+{
+    /**
+     * The mixing doesn't depend on the meaning of the color channels,
+     * so one generic trait covers RGBA, BGRA and LabA pixels
+     */
+    return new KoOptimizedMixColorsOp<_impl, KoColorSpaceTrait<_channels_type_, 4, 3>>();
+}
+
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint8>::create<xsimd::current_arch>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<quint16>::create<xsimd::current_arch>(int);
+template KoMixColorsOp* KoOptimizedMixColorsOpFactoryImpl<float>::create<xsimd::current_arch>(int);
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,27 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KoOptimizedMixColorsOpFACTORYIMPL_H
+#define KoOptimizedMixColorsOpFACTORYIMPL_H
+
+#include <QtGlobal>
+#include <KoMixColorsOp.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "kritapigment_export.h"
+
+template<typename _channels_type_>
+class KRITAPIGMENT_EXPORT KoOptimizedMixColorsOpFactoryImpl
+{
+public:
+    using ParamType = int;
+    using ReturnType = KoMixColorsOp *;
+
+    template<typename _impl>
+    static KoMixColorsOp* create(int);
+};
+
+#endif // KoOptimizedMixColorsOpFACTORYIMPL_H
@@ -9,6 +9,10 @@
 #include <simpletest.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoColorSpace.h>
+#include <KoColorProfile.h>
+#include <KoColorModelStandardIds.h>
+
+#include <lcms2.h>
 
 #define NB_PIXELS 1000000
 
@@ -134,4 +138,121 @@ void KoColorSpacesBenchmark::benchmarkSetAlpha2IndividualCall()
     END_BENCHMARK
 }
 
+namespace {
+const KoColorProfile* benchmarkProfile(const QString &name)
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    return name == "srgb" ? registry->p709SRGBProfile() :
+        name == "709-g10" ? registry->p709G10Profile() :
+        registry->p2020G10Profile();
+}
+
+quint32 lcmsPixelType(const QString &depthId)
+{
+    return depthId == Integer8BitsColorDepthID.id() ? TYPE_BGRA_8 :
+        depthId == Integer16BitsColorDepthID.id() ? TYPE_BGRA_16 :
+        TYPE_RGBA_FLT;
+}
+}
+
+void KoColorSpacesBenchmark::benchmarkConvertMatrixShaper_data()
+{
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstProfile");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<bool>("useLcms");
+
+    struct Conversion {
+        QString srcProfile;
+        KoID srcDepth;
+        QString dstProfile;
+        KoID dstDepth;
+    };
+
+    const QVector<Conversion> conversions({
+        {"srgb", Integer8BitsColorDepthID, "2020-g10", Integer8BitsColorDepthID},
+        {"srgb", Integer8BitsColorDepthID, "709-g10", Integer16BitsColorDepthID},
+        {"srgb", Integer16BitsColorDepthID, "2020-g10", Integer16BitsColorDepthID},
+        {"srgb", Integer8BitsColorDepthID, "2020-g10", Float32BitsColorDepthID},
+        {"2020-g10", Float32BitsColorDepthID, "srgb", Integer8BitsColorDepthID},
+        {"2020-g10", Float32BitsColorDepthID, "709-g10", Float32BitsColorDepthID}
+    });
+
+    Q_FOREACH (const Conversion &c, conversions) {
+        const QString name = QString("%1-%2-to-%3-%4")
+            .arg(c.srcProfile).arg(c.srcDepth.id())
+            .arg(c.dstProfile).arg(c.dstDepth.id());
+
+        QTest::newRow((name + "-engine").toLatin1().data())
+            << c.srcProfile << c.srcDepth.id() << c.dstProfile << c.dstDepth.id() << false;
+        QTest::newRow((name + "-lcms").toLatin1().data())
+            << c.srcProfile << c.srcDepth.id() << c.dstProfile << c.dstDepth.id() << true;
+    }
+}
+
+/**
+ * Compares the conversion done by the color engine, which uses the
+ * optimized matrix-shaper path for these profiles, with a plain LCMS
+ * transform
+ */
+void KoColorSpacesBenchmark::benchmarkConvertMatrixShaper()
+{
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstProfile);
+    QFETCH(QString, dstDepth);
+    QFETCH(bool, useLcms);
+
+    const KoColorProfile *srcKoProfile = benchmarkProfile(srcProfile);
+    const KoColorProfile *dstKoProfile = benchmarkProfile(dstProfile);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepth, srcKoProfile);
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepth, dstKoProfile);
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    QVector<quint8> src(NB_PIXELS * srcCs->pixelSize());
+    QVector<quint8> dst(NB_PIXELS * dstCs->pixelSize());
+
+    QVector<float> channels(4);
+    for (int i = 0; i < NB_PIXELS; i++) {
+        for (int j = 0; j < 4; j++) {
+            channels[j] = float((i * (j + 3)) % 1021) / 1020.0f;
+        }
+        srcCs->fromNormalisedChannelsValue(src.data() + i * srcCs->pixelSize(), channels);
+    }
+
+    if (useLcms) {
+        cmsHPROFILE srcLcmsProfile = cmsOpenProfileFromMem(srcKoProfile->rawData().constData(), srcKoProfile->rawData().size());
+        cmsHPROFILE dstLcmsProfile = cmsOpenProfileFromMem(dstKoProfile->rawData().constData(), dstKoProfile->rawData().size());
+
+        cmsHTRANSFORM transform =
+            cmsCreateTransform(srcLcmsProfile, lcmsPixelType(srcDepth),
+                               dstLcmsProfile, lcmsPixelType(dstDepth),
+                               INTENT_PERCEPTUAL,
+                               cmsFLAGS_BLACKPOINTCOMPENSATION | cmsFLAGS_COPY_ALPHA);
+
+        QBENCHMARK {
+            cmsDoTransform(transform, src.data(), dst.data(), NB_PIXELS);
+        }
+
+        cmsDeleteTransform(transform);
+        cmsCloseProfile(srcLcmsProfile);
+        cmsCloseProfile(dstLcmsProfile);
+    } else {
+        KoColorConversionTransformation *transform =
+            srcCs->createColorConverter(dstCs,
+                                        KoColorConversionTransformation::IntentPerceptual,
+                                        KoColorConversionTransformation::BlackpointCompensation);
+
+        QBENCHMARK {
+            transform->transform(src.data(), dst.data(), NB_PIXELS);
+        }
+
+        delete transform;
+    }
+}
+
 SIMPLE_TEST_MAIN(KoColorSpacesBenchmark)
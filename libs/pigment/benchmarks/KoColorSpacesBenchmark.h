@@ -27,6 +27,8 @@ private Q_SLOTS:
     void benchmarkSetAlphaIndividualCall();
     void benchmarkSetAlpha2IndividualCall_data();
     void benchmarkSetAlpha2IndividualCall();
+    void benchmarkConvertMatrixShaper_data();
+    void benchmarkConvertMatrixShaper();
 };
 
 #endif
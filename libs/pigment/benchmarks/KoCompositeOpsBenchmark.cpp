@@ -12,6 +12,7 @@
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
 
 #include <simpletest.h>
 
@@ -96,5 +97,75 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+void KoCompositeOpsBenchmark::benchmarkCompositeOps_data()
+{
+    QTest::addColumn<QString>("modelID");
+    QTest::addColumn<QString>("depthID");
+    QTest::addColumn<QString>("compositeOpID");
+
+    const QList<const KoColorSpace*> colorSpaces = {
+        KoColorSpaceRegistry::instance()->rgb8(),
+        KoColorSpaceRegistry::instance()->rgb16(),
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), 0)
+    };
+
+    Q_FOREACH (const KoColorSpace *colorSpace, colorSpaces) {
+        // F32 colorspace is not available without the LCMS engine
+        if (!colorSpace) continue;
+
+        Q_FOREACH (const KoCompositeOp *op, colorSpace->compositeOps()) {
+            const QString name = QString("%1 %2").arg(colorSpace->colorDepthId().id()).arg(op->id());
+
+            QTest::newRow(name.toLatin1().data())
+                << colorSpace->colorModelId().id()
+                << colorSpace->colorDepthId().id()
+                << op->id();
+        }
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeOps()
+{
+    QFETCH(QString, modelID);
+    QFETCH(QString, depthID);
+    QFETCH(QString, compositeOpID);
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *colorSpace = KoColorSpaceRegistry::instance()->colorSpace(modelID, depthID, 0);
+    const KoCompositeOp *compositeOp = colorSpace->compositeOp(compositeOpID);
+
+    const int numPixels = IMG_WIDTH * IMG_HEIGHT;
+    const int pixelSize = colorSpace->pixelSize();
+
+    // the U8 random data is converted into the tested colorspace to
+    // avoid NaNs and infinities in the floating point pixels
+    QVector<quint8> dstBuffer(numPixels * pixelSize);
+    QVector<quint8> srcBuffer(numPixels * pixelSize);
+
+    rgb8->convertPixelsTo(m_dstBuffer, dstBuffer.data(), colorSpace, numPixels,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags());
+    rgb8->convertPixelsTo(m_srcBuffer, srcBuffer.data(), colorSpace, numPixels,
+                          KoColorConversionTransformation::internalRenderingIntent(),
+                          KoColorConversionTransformation::internalConversionFlags());
+
+    const int rowStride = IMG_WIDTH * pixelSize;
+    const int maskRowStride = IMG_WIDTH;
+
+    QBENCHMARK {
+        for (int y = 0; y < TILES_IN_HEIGHT; y++) {
+            for (int x = 0; x < TILES_IN_WIDTH; x++) {
+                const int bufOffset = y * TILE_HEIGHT * rowStride + x * TILE_WIDTH * pixelSize;
+                const int maskOffset = y * TILE_HEIGHT * maskRowStride + x * TILE_WIDTH;
+
+                compositeOp->composite(dstBuffer.data() + bufOffset, rowStride,
+                                       srcBuffer.data() + bufOffset, rowStride,
+                                       m_mskBuffer + maskOffset, maskRowStride,
+                                       TILE_WIDTH, TILE_HEIGHT,
+                                       OPACITY_HALF);
+            }
+        }
+    }
+}
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
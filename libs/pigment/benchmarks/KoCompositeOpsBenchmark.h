@@ -22,6 +22,9 @@ private Q_SLOTS:
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
 
+    void benchmarkCompositeOps_data();
+    void benchmarkCompositeOps();
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
@@ -0,0 +1,211 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoMixColorsOpBenchmark.h"
+
+#include <QRandomGenerator>
+#include <QScopedPointer>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+#include <KoMixColorsOpImpl.h>
+#include <KoOptimizedMixColorsOpFactory.h>
+
+#include <simpletest.h>
+
+/**
+ * Enough pixels to be outside of the L1 cache, like the source
+ * pixels of a big brush dab
+ */
+const int NUM_PIXELS = 256 * 256;
+
+namespace {
+
+KoMixColorsOp* createOp(const QString &depthId, bool optimized)
+{
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        return optimized ?
+            KoOptimizedMixColorsOpFactory::create(Integer8BitsColorDepthID, 4, 3) :
+            new KoMixColorsOpImpl<KoBgrU8Traits>();
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        return optimized ?
+            KoOptimizedMixColorsOpFactory::create(Integer16BitsColorDepthID, 4, 3) :
+            new KoMixColorsOpImpl<KoBgrU16Traits>();
+    } else {
+        return optimized ?
+            KoOptimizedMixColorsOpFactory::create(Float32BitsColorDepthID, 4, 3) :
+            new KoMixColorsOpImpl<KoRgbF32Traits>();
+    }
+}
+
+int pixelSizeForDepth(const QString &depthId)
+{
+    return depthId == Integer8BitsColorDepthID.id() ? 4 :
+           depthId == Integer16BitsColorDepthID.id() ? 8 : 16;
+}
+
+QVector<quint8> randomPixels(const QString &depthId, QRandomGenerator &rng)
+{
+    QVector<quint8> pixels(NUM_PIXELS * pixelSizeForDepth(depthId));
+
+    if (depthId == Float32BitsColorDepthID.id()) {
+        float *values = reinterpret_cast<float*>(pixels.data());
+        for (int i = 0; i < NUM_PIXELS * 4; i++) {
+            values[i] = rng.generateDouble();
+        }
+    } else {
+        for (int i = 0; i < pixels.size(); i++) {
+            pixels[i] = rng.bounded(256);
+        }
+    }
+
+    return pixels;
+}
+
+QVector<qint16> randomWeights(int numWeights, QRandomGenerator &rng)
+{
+    QVector<qint16> weights(numWeights);
+    for (int i = 0; i < numWeights; i++) {
+        weights[i] = rng.bounded(256);
+    }
+    return weights;
+}
+
+QList<KoID> benchmarkedDepthIds()
+{
+    return {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+}
+
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixColors_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<int>("numColors");
+    QTest::addColumn<bool>("optimized");
+    QTest::addColumn<bool>("weighted");
+    QTest::addColumn<bool>("arrayOfPointers");
+
+    /**
+     * 4 colors is a bilinear sample, 16 colors is a typical filter
+     * kernel and 256 colors is a smudge sampling area
+     */
+    for (const KoID &depthId : benchmarkedDepthIds()) {
+        for (int numColors : {4, 16, 256}) {
+            for (int form = 0; form < 4; form++) {
+                const bool weighted = form & 0x1;
+                const bool arrayOfPointers = form & 0x2;
+
+                for (bool optimized : {false, true}) {
+                    QTest::addRow("%s-%d-%s-%s-%s",
+                                  qPrintable(depthId.id()), numColors,
+                                  weighted ? "weighted" : "uniform",
+                                  arrayOfPointers ? "pointers" : "array",
+                                  optimized ? "optimized" : "scalar")
+                        << depthId.id() << numColors << optimized << weighted << arrayOfPointers;
+                }
+            }
+        }
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixColors()
+{
+    QFETCH(QString, depthId);
+    QFETCH(int, numColors);
+    QFETCH(bool, optimized);
+    QFETCH(bool, weighted);
+    QFETCH(bool, arrayOfPointers);
+
+    QScopedPointer<KoMixColorsOp> op(createOp(depthId, optimized));
+    QVERIFY(op);
+
+    const int pixelSize = pixelSizeForDepth(depthId);
+
+    QRandomGenerator rng(42);
+
+    const QVector<quint8> pixels = randomPixels(depthId, rng);
+    const QVector<qint16> weights = randomWeights(numColors, rng);
+
+    QVector<const quint8*> pointers(NUM_PIXELS);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pointers[i] = pixels.constData() + rng.bounded(NUM_PIXELS) * pixelSize;
+    }
+
+    quint8 dst[16];
+
+    QBENCHMARK {
+        for (int i = 0; i + numColors <= NUM_PIXELS; i += numColors) {
+            if (arrayOfPointers) {
+                if (weighted) {
+                    op->mixColors(pointers.constData() + i, weights.constData(), numColors, dst);
+                } else {
+                    op->mixColors(pointers.constData() + i, numColors, dst);
+                }
+            } else {
+                const quint8 *colors = pixels.constData() + i * pixelSize;
+
+                if (weighted) {
+                    op->mixColors(colors, weights.constData(), numColors, dst);
+                } else {
+                    op->mixColors(colors, numColors, dst);
+                }
+            }
+        }
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixer_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<int>("numColors");
+    QTest::addColumn<bool>("optimized");
+
+    /**
+     * The mixer is fed either with small rows of a dab or with the
+     * whole area at once
+     */
+    for (const KoID &depthId : benchmarkedDepthIds()) {
+        for (int numColors : {64, NUM_PIXELS}) {
+            for (bool optimized : {false, true}) {
+                QTest::addRow("%s-%d-%s", qPrintable(depthId.id()), numColors, optimized ? "optimized" : "scalar")
+                    << depthId.id() << numColors << optimized;
+            }
+        }
+    }
+}
+
+void KoMixColorsOpBenchmark::benchmarkMixer()
+{
+    QFETCH(QString, depthId);
+    QFETCH(int, numColors);
+    QFETCH(bool, optimized);
+
+    QScopedPointer<KoMixColorsOp> op(createOp(depthId, optimized));
+    QVERIFY(op);
+
+    const int pixelSize = pixelSizeForDepth(depthId);
+
+    QRandomGenerator rng(42);
+
+    const QVector<quint8> pixels = randomPixels(depthId, rng);
+    const QVector<qint16> weights = randomWeights(NUM_PIXELS, rng);
+
+    quint8 dst[16];
+
+    QBENCHMARK {
+        QScopedPointer<KoMixColorsOp::Mixer> mixer(op->createMixer());
+
+        for (int i = 0; i + numColors <= NUM_PIXELS; i += numColors) {
+            mixer->accumulate(pixels.constData() + i * pixelSize, weights.constData() + i, 255, numColors);
+            mixer->accumulateAverage(pixels.constData() + i * pixelSize, numColors);
+        }
+
+        mixer->computeMixedColor(dst);
+    }
+}
+
+SIMPLE_TEST_MAIN(KoMixColorsOpBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KO_MIXCOLORSOP_BENCHMARK_H_
+#define KO_MIXCOLORSOP_BENCHMARK_H_
+
+#include <QObject>
+
+class KoMixColorsOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkMixColors_data();
+    void benchmarkMixColors();
+
+    void benchmarkMixer_data();
+    void benchmarkMixer();
+};
+
+#endif
@@ -53,6 +53,12 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return new KoCompositeOpCopy2<Traits>(cs);
     }
+    static KoCompositeOp* createGenericOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return 0;
+    }
 };
 
 template<>
@@ -70,6 +76,9 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+    static KoCompositeOp* createGenericOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericOp32(cs, id, category);
+    }
 };
 
 template<>
@@ -86,6 +95,12 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+    static KoCompositeOp* createGenericOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return 0;
+    }
 };
 
 template<>
@@ -103,6 +118,9 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp128(cs);
     }
+    static KoCompositeOp* createGenericOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericOp128(cs, id, category);
+    }
 };
 
 template<>
@@ -120,6 +138,9 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOpU64(cs);
     }
+    static KoCompositeOp* createGenericOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericOpU64(cs, id, category);
+    }
 };
 
 
@@ -132,7 +153,11 @@ struct AddGeneralOps<Traits, true>
 
      template<CompositeFunc func>
      static void add(KoColorSpace* cs, const QString& id, const QString& category) {
-         cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func>(cs, id, category));
+         KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericOp(cs, id, category);
+         if (!op) {
+             op = new KoCompositeOpGenericSC<Traits, func>(cs, id, category);
+         }
+         cs->addCompositeOp(op);
      }
 
      static void add(KoColorSpace* cs) {
@@ -7,6 +7,8 @@
 #include "KoOptimizedCompositeOpFactoryPerArch.h"
 #include "KoOptimizedCompositeOpFactory.h"
 
+#include <KoColorSpaceTraits.h>
+
 KoCompositeOp* KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard32(const KoColorSpace *cs)
 {
     return createOptimizedClass<
@@ -78,3 +80,18 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp32(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits> >({cs, id, category});
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOpU64(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits> >({cs, id, category});
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericOp128(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits> >({cs, id, category});
+}
@@ -11,6 +11,7 @@
 
 class KoCompositeOp;
 class KoColorSpace;
+class QString;
 
 /**
  * The creation of the optimized composite ops is moved into a separate
@@ -39,6 +40,18 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+    /**
+     * Create vectorized versions of the separable composite ops
+     * (KoCompositeOpGenericSC). Only the most popular blending modes
+     * have a vectorized version. For the rest of the modes, or when
+     * the CPU doesn't support vector instructions, the functions
+     * return null, so the caller should fall back to the scalar
+     * KoCompositeOpGenericSC.
+     */
+    static KoCompositeOp* createGenericOp32(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericOpU64(const KoColorSpace *cs, const QString &id, const QString &category);
+    static KoCompositeOp* createGenericOp128(const KoColorSpace *cs, const QString &id, const QString &category);
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -13,8 +13,10 @@
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
 #include "KoOptimizedCompositeOpCopy128.h"
+#include "KoOptimizedCompositeOpGeneric.h"
 
 #include <KoCompositeOpRegistry.h>
+#include <KoColorSpaceTraits.h>
 
 template<>
 template<>
@@ -114,4 +116,28 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyU64>
     return new KoOptimizedCompositeOpAlphaDarkenCreamyU64<xsimd::current_arch>(param);
 }
 
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::create<xsimd::current_arch>(ParamType param)
+{
+    return createOptimizedCompositeOpGeneric<xsimd::current_arch, KoBgrU8Traits>(param.colorSpace, param.id, param.category);
+}
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::create<xsimd::current_arch>(ParamType param)
+{
+    return createOptimizedCompositeOpGeneric<xsimd::current_arch, KoBgrU16Traits>(param.colorSpace, param.id, param.category);
+}
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::create<xsimd::current_arch>(ParamType param)
+{
+    return createOptimizedCompositeOpGeneric<xsimd::current_arch, KoRgbF32Traits>(param.colorSpace, param.id, param.category);
+}
+
 #endif // XSIMD_UNIVERSAL_BUILD_PASS
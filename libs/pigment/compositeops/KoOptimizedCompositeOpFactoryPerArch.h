@@ -9,6 +9,8 @@
 #define KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H
 
 #include <compositeops/KoMultiArchBuildSupport.h>
+#include <QString>
+
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -57,4 +59,24 @@ struct KoOptimizedCompositeOpFactoryPerArch {
     static ReturnType create(ParamType param);
 };
 
+struct KoOptimizedGenericCompositeOpParams {
+    const KoColorSpace *colorSpace;
+    QString id;
+    QString category;
+};
+
+/**
+ * Creates the vectorized versions of the separable composite ops
+ * (KoCompositeOpGenericSC) for the colorspace with traits \p Traits.
+ * Returns null if the op has no vectorized implementation.
+ */
+template<class Traits>
+struct KoOptimizedGenericCompositeOpFactoryPerArch {
+    using ParamType = const KoOptimizedGenericCompositeOpParams &;
+    using ReturnType = KoCompositeOp *;
+
+    template <typename _impl>
+    static ReturnType create(ParamType param);
+};
+
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORYPERARCH_H */
@@ -110,3 +110,34 @@ KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyU64>
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+/**
+ * The scalar versions of the separable ops are created by
+ * addStandardCompositeOps() directly
+ */
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU8Traits>::create<xsimd::generic>(ParamType param)
+{
+    Q_UNUSED(param);
+    return nullptr;
+}
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoBgrU16Traits>::create<xsimd::generic>(ParamType param)
+{
+    Q_UNUSED(param);
+    return nullptr;
+}
+
+template<>
+template<>
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::ReturnType
+KoOptimizedGenericCompositeOpFactoryPerArch<KoRgbF32Traits>::create<xsimd::generic>(ParamType param)
+{
+    Q_UNUSED(param);
+    return nullptr;
+}
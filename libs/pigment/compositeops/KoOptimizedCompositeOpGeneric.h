@@ -0,0 +1,487 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
+
+#include <type_traits>
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Helpers for the vectorized blending functions. Integer channels are
+ * passed to the functions normalized into 0.0...1.0 range and the
+ * result is clamped back into this range, exactly like Arithmetic::clamp()
+ * does. Floating point channels are not clamped at all.
+ */
+template<typename channels_type>
+struct KoStreamedBlendMaths {
+    template<class float_v>
+    static ALWAYS_INLINE float_v clamp(const float_v &x) {
+        return xsimd::min(xsimd::max(x, float_v(0.0f)), float_v(1.0f));
+    }
+
+    template<class float_v>
+    static ALWAYS_INLINE float_v clampInfinite(const float_v &x) {
+        return x;
+    }
+
+    static ALWAYS_INLINE float maxValue() {
+        return 1.0f;
+    }
+
+    static ALWAYS_INLINE float halfValue() {
+        return float(KoColorSpaceMathsTraits<channels_type>::halfValue) /
+            float(KoColorSpaceMathsTraits<channels_type>::unitValue);
+    }
+};
+
+template<>
+struct KoStreamedBlendMaths<float> {
+    template<class float_v>
+    static ALWAYS_INLINE float_v clamp(const float_v &x) {
+        return x;
+    }
+
+    /**
+     * Dividing by small numbers can make the result become infinity or
+     * NaN, so we replace them with the maximum value, like the scalar
+     * versions of color dodge and burn do.
+     */
+    template<class float_v>
+    static ALWAYS_INLINE float_v clampInfinite(const float_v &x) {
+        const float_v maxValue(KoColorSpaceMathsTraits<float>::max);
+        return xsimd::select(xsimd::abs(x) <= maxValue, x, maxValue);
+    }
+
+    static ALWAYS_INLINE float maxValue() {
+        return KoColorSpaceMathsTraits<float>::max;
+    }
+
+    static ALWAYS_INLINE float halfValue() {
+        return KoColorSpaceMathsTraits<float>::halfValue;
+    }
+};
+
+/**
+ * Vectorized versions of the separable blending functions from
+ * KoCompositeOpFunctions.h. Every function provides the scalar
+ * version, which is used for the unaligned pixels and when the
+ * channel flags are set, and the vector version, which is used
+ * for the rest.
+ */
+namespace KoStreamedBlendFunctions
+{
+
+#define KO_STREAMED_BLEND_FUNCTION(name, scalarFunc)              \
+    template<typename T>                                           \
+    struct name {                                                  \
+        using Maths = KoStreamedBlendMaths<T>;                     \
+        static inline T scalar(T src, T dst) {                     \
+            return scalarFunc<T>(src, dst);                        \
+        }                                                          \
+        template<class float_v>                                    \
+        static ALWAYS_INLINE float_v vector(const float_v &src,    \
+                                            const float_v &dst);   \
+    };                                                             \
+    template<typename T>                                           \
+    template<class float_v>                                        \
+    ALWAYS_INLINE float_v name<T>::vector(const float_v &src, const float_v &dst)
+
+KO_STREAMED_BLEND_FUNCTION(Multiply, cfMultiply)
+{
+    return src * dst;
+}
+
+KO_STREAMED_BLEND_FUNCTION(Screen, cfScreen)
+{
+    return src + dst - src * dst;
+}
+
+KO_STREAMED_BLEND_FUNCTION(DarkenOnly, cfDarkenOnly)
+{
+    return xsimd::min(src, dst);
+}
+
+KO_STREAMED_BLEND_FUNCTION(LightenOnly, cfLightenOnly)
+{
+    return xsimd::max(src, dst);
+}
+
+KO_STREAMED_BLEND_FUNCTION(Addition, cfAddition)
+{
+    return Maths::clamp(src + dst);
+}
+
+KO_STREAMED_BLEND_FUNCTION(Subtract, cfSubtract)
+{
+    return Maths::clamp(dst - src);
+}
+
+KO_STREAMED_BLEND_FUNCTION(InverseSubtract, cfInverseSubtract)
+{
+    return Maths::clamp(dst - (float_v(1.0f) - src));
+}
+
+KO_STREAMED_BLEND_FUNCTION(Difference, cfDifference)
+{
+    return xsimd::max(src, dst) - xsimd::min(src, dst);
+}
+
+KO_STREAMED_BLEND_FUNCTION(Exclusion, cfExclusion)
+{
+    const float_v x = src * dst;
+    return Maths::clamp(dst + src - (x + x));
+}
+
+KO_STREAMED_BLEND_FUNCTION(LinearBurn, cfLinearBurn)
+{
+    return Maths::clamp(src + dst - float_v(1.0f));
+}
+
+KO_STREAMED_BLEND_FUNCTION(LinearLight, cfLinearLight)
+{
+    return Maths::clamp(src + src + dst - float_v(1.0f));
+}
+
+KO_STREAMED_BLEND_FUNCTION(GrainMerge, cfGrainMerge)
+{
+    return Maths::clamp(dst + src - float_v(Maths::halfValue()));
+}
+
+KO_STREAMED_BLEND_FUNCTION(GrainExtract, cfGrainExtract)
+{
+    return Maths::clamp(dst - src + float_v(Maths::halfValue()));
+}
+
+KO_STREAMED_BLEND_FUNCTION(Allanon, cfAllanon)
+{
+    return (src + dst) * float_v(Maths::halfValue());
+}
+
+KO_STREAMED_BLEND_FUNCTION(HardLight, cfHardLight)
+{
+    const float_v src2 = src + src;
+    const float_v screenSrc = src2 - float_v(1.0f);
+
+    return xsimd::select(src > float_v(Maths::halfValue()),
+                         screenSrc + dst - screenSrc * dst,
+                         src2 * dst);
+}
+
+KO_STREAMED_BLEND_FUNCTION(Overlay, cfOverlay)
+{
+    return HardLight<T>::vector(dst, src);
+}
+
+KO_STREAMED_BLEND_FUNCTION(SoftLight, cfSoftLight)
+{
+    const float_v oneValue(1.0f);
+    const float_v src2 = src + src;
+
+    return Maths::clamp(
+        xsimd::select(src > float_v(0.5f),
+                      dst + (src2 - oneValue) * (xsimd::sqrt(dst) - dst),
+                      dst - (oneValue - src2) * dst * (oneValue - dst)));
+}
+
+KO_STREAMED_BLEND_FUNCTION(ColorDodge, cfColorDodge)
+{
+    const float_v zeroValue(0.0f);
+    const float_v oneValue(1.0f);
+
+    const float_v result =
+        xsimd::select(src == oneValue,
+                      xsimd::select(dst == zeroValue, zeroValue, float_v(Maths::maxValue())),
+                      dst / (oneValue - src));
+
+    return Maths::clampInfinite(Maths::clamp(result));
+}
+
+KO_STREAMED_BLEND_FUNCTION(ColorBurn, cfColorBurn)
+{
+    const float_v zeroValue(0.0f);
+    const float_v oneValue(1.0f);
+
+    const float_v result =
+        xsimd::select(src == zeroValue,
+                      xsimd::select(dst == oneValue, zeroValue, float_v(Maths::maxValue())),
+                      (oneValue - dst) / src);
+
+    return oneValue - Maths::clampInfinite(Maths::clamp(result));
+}
+
+#undef KO_STREAMED_BLEND_FUNCTION
+
+} // namespace KoStreamedBlendFunctions
+
+
+template<class Traits, template<typename> class BlendFunction, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor {
+    using channels_type = typename Traits::channels_type;
+    using ScalarOp = KoCompositeOpGenericSC<Traits, &BlendFunction<channels_type>::scalar>;
+
+    static const qint32 alpha_pos = Traits::alpha_pos;
+    static const qint32 pixel_size = Traits::pixelSize;
+
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags),
+              opacity(Arithmetic::scale<channels_type>(params.opacity))
+        {
+        }
+        const QBitArray &channelFlags;
+        const channels_type opacity;
+    };
+
+    /**
+     * Implements the same math as KoCompositeOpGenericSC, but for
+     * float_v::size pixels at once
+     */
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        static_assert(allChannelsFlag, "the vector version doesn't support channel flags");
+
+        float_v src_alpha;
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        // The source cannot change the colors in the destination,
+        // since its fully transparent
+        if (xsimd::all(src_alpha == zeroValue)) {
+            return;
+        }
+
+        float_v dst_alpha;
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const bool isIntegerChannel = !std::is_floating_point<channels_type>::value;
+        const float_v unitValue(float(KoColorSpaceMathsTraits<channels_type>::unitValue));
+        const float_v unitValueRec1(1.0f / float(KoColorSpaceMathsTraits<channels_type>::unitValue));
+
+        if (isIntegerChannel) {
+            src_c1 *= unitValueRec1;
+            src_c2 *= unitValueRec1;
+            src_c3 *= unitValueRec1;
+            dst_c1 *= unitValueRec1;
+            dst_c2 *= unitValueRec1;
+            dst_c3 *= unitValueRec1;
+        }
+
+        float_v res_c1 = BlendFunction<channels_type>::vector(src_c1, dst_c1);
+        float_v res_c2 = BlendFunction<channels_type>::vector(src_c2, dst_c2);
+        float_v res_c3 = BlendFunction<channels_type>::vector(src_c3, dst_c3);
+
+        float_v new_alpha;
+
+        if (alphaLocked) {
+            new_alpha = dst_alpha;
+
+            res_c1 = (res_c1 - dst_c1) * src_alpha + dst_c1;
+            res_c2 = (res_c2 - dst_c2) * src_alpha + dst_c2;
+            res_c3 = (res_c3 - dst_c3) * src_alpha + dst_c3;
+
+            // the pixels with null alpha are not touched by the op
+            const float_m empty_dst_pixels_mask = dst_alpha == zeroValue;
+            if (xsimd::any(empty_dst_pixels_mask)) {
+                res_c1 = xsimd::select(empty_dst_pixels_mask, dst_c1, res_c1);
+                res_c2 = xsimd::select(empty_dst_pixels_mask, dst_c2, res_c2);
+                res_c3 = xsimd::select(empty_dst_pixels_mask, dst_c3, res_c3);
+            }
+        } else {
+            new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+            const float_v src_weight = src_alpha * (oneValue - dst_alpha);
+            const float_v dst_weight = dst_alpha * (oneValue - src_alpha);
+            const float_v blend_weight = src_alpha * dst_alpha;
+
+            /**
+             * The value of new_alpha can have *some* zero values,
+             * which will result in NaN values while division. These
+             * pixels keep their colors, like in the scalar version.
+             */
+            const float_m empty_result_mask = new_alpha == zeroValue;
+
+            res_c1 = (dst_weight * dst_c1 + src_weight * src_c1 + blend_weight * res_c1) / new_alpha;
+            res_c2 = (dst_weight * dst_c2 + src_weight * src_c2 + blend_weight * res_c2) / new_alpha;
+            res_c3 = (dst_weight * dst_c3 + src_weight * src_c3 + blend_weight * res_c3) / new_alpha;
+
+            if (xsimd::any(empty_result_mask)) {
+                res_c1 = xsimd::select(empty_result_mask, dst_c1, res_c1);
+                res_c2 = xsimd::select(empty_result_mask, dst_c2, res_c2);
+                res_c3 = xsimd::select(empty_result_mask, dst_c3, res_c3);
+            }
+        }
+
+        if (isIntegerChannel) {
+            res_c1 *= unitValue;
+            res_c2 *= unitValue;
+            res_c3 *= unitValue;
+        }
+
+        dataWrapper.write(dst, res_c1, res_c2, res_c3, new_alpha);
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(opacity);
+
+        using namespace Arithmetic;
+
+        const channels_type *s = reinterpret_cast<const channels_type*>(src);
+        channels_type *d = reinterpret_cast<channels_type*>(dst);
+
+        const channels_type srcAlpha = s[alpha_pos];
+        const channels_type dstAlpha = d[alpha_pos];
+        const channels_type mskAlpha = haveMask ? scale<channels_type>(*mask) : unitValue<channels_type>();
+
+        if (!allChannelsFlag && dstAlpha == zeroValue<channels_type>()) {
+            KoStreamedMathFunctions::clearPixel<pixel_size>(dst);
+        }
+
+        const channels_type newDstAlpha =
+            ScalarOp::template composeColorChannels<alphaLocked, allChannelsFlag>(
+                s, srcAlpha, d, dstAlpha, mskAlpha, oparams.opacity, oparams.channelFlags);
+
+        d[alpha_pos] = alphaLocked ? dstAlpha : newDstAlpha;
+    }
+};
+
+/**
+ * An optimized version of KoCompositeOpGenericSC for the use in
+ * RGBA colorspaces with 8-bit, 16-bit and 32-bit float channels and
+ * the alpha channel placed at the end of the pixel: C1_C2_C3_A.
+ */
+template<typename _impl, class Traits, template<typename> class BlendFunction>
+class KoOptimizedCompositeOpGeneric : public KoCompositeOp
+{
+    static const qint32 pixel_size = Traits::pixelSize;
+
+    template<bool alphaLocked, bool allChannelsFlag>
+    using Compositor = GenericSCCompositor<Traits, BlendFunction, alphaLocked, allChannelsFlag>;
+
+public:
+    KoOptimizedCompositeOpGeneric(const KoColorSpace* cs, const QString& id, const QString& category)
+        : KoCompositeOp(cs, id, category) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, Compositor<false, true>, pixel_size>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite<haveMask, false, Compositor<true, true>, pixel_size>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, Compositor<false, false>, pixel_size>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, Compositor<true, false>, pixel_size>(params);
+            }
+        }
+    }
+};
+
+/**
+ * Creates a vectorized version of the separable composite op \p id
+ * or returns null if the op has no vectorized implementation
+ */
+template<typename _impl, class Traits>
+KoCompositeOp* createOptimizedCompositeOpGeneric(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    using namespace KoStreamedBlendFunctions;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Multiply>(cs, id, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Screen>(cs, id, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Overlay>(cs, id, category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, HardLight>(cs, id, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, SoftLight>(cs, id, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, DarkenOnly>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, LightenOnly>(cs, id, category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Addition>(cs, id, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Subtract>(cs, id, category);
+    } else if (id == COMPOSITE_INVERSE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, InverseSubtract>(cs, id, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Difference>(cs, id, category);
+    } else if (id == COMPOSITE_EXCLUSION) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Exclusion>(cs, id, category);
+    } else if (id == COMPOSITE_LINEAR_BURN) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, LinearBurn>(cs, id, category);
+    } else if (id == COMPOSITE_LINEAR_LIGHT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, LinearLight>(cs, id, category);
+    } else if (id == COMPOSITE_GRAIN_MERGE) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, GrainMerge>(cs, id, category);
+    } else if (id == COMPOSITE_GRAIN_EXTRACT) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, GrainExtract>(cs, id, category);
+    } else if (id == COMPOSITE_ALLANON) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, Allanon>(cs, id, category);
+    } else if (id == COMPOSITE_DODGE) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, ColorDodge>(cs, id, category);
+    } else if (id == COMPOSITE_BURN) {
+        return new KoOptimizedCompositeOpGeneric<_impl, Traits, ColorBurn>(cs, id, category);
+    }
+
+    return nullptr;
+}
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERIC_H_
@@ -0,0 +1,148 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestKoColorConversionCache.h"
+
+#include <QThread>
+#include <simpletest.h>
+
+#include "KoColorConversionCache.h"
+#include "KoColorSpaceRegistry.h"
+
+namespace {
+const KoColorConversionTransformation* lookup(KoColorConversionCache *cache,
+                                              const KoColorSpace *src,
+                                              const KoColorSpace *dst)
+{
+    return cache->cachedConverter(src, dst,
+                                  KoColorConversionTransformation::internalRenderingIntent(),
+                                  KoColorConversionTransformation::internalConversionFlags()).transformation();
+}
+}
+
+void TestKoColorConversionCache::testCachedConverter()
+{
+    KoColorConversionCache cache;
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+
+    const KoColorConversionTransformation *transfo1 = lookup(&cache, rgb8, rgb16);
+    const KoColorConversionTransformation *transfo2 = lookup(&cache, rgb8, rgb16);
+
+    QVERIFY(transfo1);
+    QCOMPARE(transfo1, transfo2);
+
+    KoColorConversionCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numHits, qint64(1));
+    QCOMPARE(stats.numMisses, qint64(1));
+    QCOMPARE(stats.numCreated, qint64(1));
+    QVERIFY(stats.creationTime > 0);
+
+    cache.resetStatistics();
+
+    stats = cache.statistics();
+    QCOMPARE(stats.numHits, qint64(0));
+    QCOMPARE(stats.numMisses, qint64(0));
+    QCOMPARE(stats.numCreated, qint64(0));
+    QCOMPARE(stats.creationTime, qint64(0));
+}
+
+void TestKoColorConversionCache::testSeveralConvertersPerThread()
+{
+    KoColorConversionCache cache;
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *lab16 = KoColorSpaceRegistry::instance()->lab16();
+
+    for (int i = 0; i < 10; i++) {
+        lookup(&cache, rgb8, rgb16);
+        lookup(&cache, rgb16, rgb8);
+        lookup(&cache, rgb8, lab16);
+        lookup(&cache, lab16, rgb8);
+    }
+
+    // the alternating conversions don't evict each other
+    const KoColorConversionCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numMisses, qint64(4));
+    QCOMPARE(stats.numHits, qint64(36));
+    QCOMPARE(stats.numCreated, qint64(4));
+}
+
+void TestKoColorConversionCache::testConcurrentLookup()
+{
+    KoColorConversionCache cache;
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+
+    const KoColorConversionTransformation *reference = lookup(&cache, rgb8, rgb16);
+
+    const int numThreads = 8;
+    const int numLookups = 1000;
+
+    QVector<QThread*> threads;
+    QAtomicInt numMismatches;
+
+    for (int i = 0; i < numThreads; i++) {
+        threads << QThread::create([&] () {
+            for (int j = 0; j < numLookups; j++) {
+                if (lookup(&cache, rgb8, rgb16) != reference) {
+                    numMismatches.ref();
+                }
+            }
+        });
+    }
+
+    Q_FOREACH (QThread *thread, threads) {
+        thread->start();
+    }
+
+    Q_FOREACH (QThread *thread, threads) {
+        thread->wait();
+    }
+
+    qDeleteAll(threads);
+
+    QCOMPARE(int(numMismatches), 0);
+
+    // every thread misses only on its first lookup, the counters
+    // of the exited threads are kept in the totals
+    KoColorConversionCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numMisses, qint64(1 + numThreads));
+    QCOMPARE(stats.numHits, qint64(numThreads * (numLookups - 1)));
+    QCOMPARE(stats.numCreated, qint64(1));
+
+    cache.resetStatistics();
+
+    stats = cache.statistics();
+    QCOMPARE(stats.numMisses, qint64(0));
+    QCOMPARE(stats.numHits, qint64(0));
+}
+
+void TestKoColorConversionCache::testColorSpaceIsDestroyed()
+{
+    KoColorConversionCache cache;
+
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *rgb16 = KoColorSpaceRegistry::instance()->rgb16();
+
+    lookup(&cache, rgb8, rgb16);
+    lookup(&cache, rgb8, rgb16);
+
+    cache.colorSpaceIsDestroyed(rgb16);
+
+    // the transformation is dropped from both levels of the cache
+    lookup(&cache, rgb8, rgb16);
+
+    const KoColorConversionCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numMisses, qint64(2));
+    QCOMPARE(stats.numHits, qint64(1));
+    QCOMPARE(stats.numCreated, qint64(2));
+}
+
+SIMPLE_TEST_MAIN(TestKoColorConversionCache)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TestKoColorConversionCache_H
+#define TestKoColorConversionCache_H
+
+#include <QObject>
+
+class TestKoColorConversionCache : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCachedConverter();
+    void testSeveralConvertersPerThread();
+    void testConcurrentLookup();
+    void testColorSpaceIsDestroyed();
+};
+
+#endif
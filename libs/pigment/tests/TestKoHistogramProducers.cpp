@@ -0,0 +1,236 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestKoHistogramProducers.h"
+
+#include <QRandomGenerator>
+#include <simpletest.h>
+
+#include "KoBasicHistogramProducers.h"
+#include "KoChannelInfo.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoOptimizedHistogramAccumulatorFactory.h"
+
+namespace {
+
+template<typename channels_type>
+void fillRandomPixels(QVector<quint8> &data, int numValues, QRandomGenerator &rng)
+{
+    data.resize(numValues * sizeof(channels_type));
+    channels_type *values = reinterpret_cast<channels_type*>(data.data());
+
+    for (int i = 0; i < numValues; i++) {
+        const float value = rng.generateDouble() * 1.2 - 0.1;
+        values[i] = KoColorSpaceMaths<float, channels_type>::scaleToA(value);
+    }
+}
+
+/**
+ * Straightforward implementation of the binning rules of
+ * KoOptimizedHistogramAccumulatorBase::Options
+ */
+template<typename channels_type>
+void referenceHistogram(const QVector<quint8> &data, const quint8 *selectionMask,
+                        int numPixels, int channelCount, int alphaPos,
+                        const KoOptimizedHistogramAccumulatorBase::Options &options,
+                        QVector<QVector<quint32>> &bins, quint32 &count)
+{
+    const channels_type *values = reinterpret_cast<const channels_type*>(data.constData());
+
+    bins.fill(QVector<quint32>(258, 0), channelCount);
+    count = 0;
+
+    for (int i = 0; i < numPixels; i++) {
+        const channels_type *pixel = values + i * channelCount;
+
+        if (options.skipUnselected && selectionMask && !selectionMask[i]) continue;
+        if (options.skipTransparent &&
+            KoColorSpaceMaths<channels_type, quint8>::scaleToA(pixel[alphaPos]) == 0) continue;
+
+        for (int c = 0; c < channelCount; c++) {
+            const float value = pixel[c];
+
+            if (value < options.from) {
+                bins[c][256]++;
+            } else if (value > options.to) {
+                bins[c][257]++;
+            } else {
+                const float pos = (value - options.from) * options.scale + options.bias;
+                bins[c][qBound(0, int(pos), 255)]++;
+            }
+        }
+        count++;
+    }
+}
+
+}
+
+void TestKoHistogramProducers::testAccumulator_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<float>("unitValue");
+    QTest::addColumn<float>("viewFrom");
+    QTest::addColumn<float>("viewWidth");
+
+    QTest::newRow("u8") << Integer8BitsColorDepthID.id() << 255.0f << 0.0f << 1.0f;
+    QTest::newRow("u8-zoomed") << Integer8BitsColorDepthID.id() << 255.0f << 0.25f << 0.5f;
+    QTest::newRow("u16") << Integer16BitsColorDepthID.id() << 65535.0f << 0.0f << 1.0f;
+    QTest::newRow("u16-zoomed") << Integer16BitsColorDepthID.id() << 65535.0f << 0.25f << 0.5f;
+    QTest::newRow("f32") << Float32BitsColorDepthID.id() << 1.0f << 0.0f << 1.0f;
+    QTest::newRow("f32-zoomed") << Float32BitsColorDepthID.id() << 1.0f << 0.25f << 0.5f;
+}
+
+void TestKoHistogramProducers::testAccumulator()
+{
+    QFETCH(QString, depthId);
+    QFETCH(float, unitValue);
+    QFETCH(float, viewFrom);
+    QFETCH(float, viewWidth);
+
+    const int channelCount = 4;
+    const int alphaPos = 3;
+    const int numPixels = 1031;
+
+    KoOptimizedHistogramAccumulatorBase::Params params;
+    params.depthId = KoID(depthId);
+    params.channelCount = channelCount;
+    params.alphaPos = alphaPos;
+
+    QScopedPointer<KoOptimizedHistogramAccumulatorBase> accumulator(
+        KoOptimizedHistogramAccumulatorFactory::create(params));
+    QVERIFY(accumulator);
+
+    QRandomGenerator rng(1);
+
+    QVector<quint8> data;
+    if (params.depthId == Integer8BitsColorDepthID) {
+        fillRandomPixels<quint8>(data, numPixels * channelCount, rng);
+    } else if (params.depthId == Integer16BitsColorDepthID) {
+        fillRandomPixels<quint16>(data, numPixels * channelCount, rng);
+    } else {
+        fillRandomPixels<float>(data, numPixels * channelCount, rng);
+    }
+
+    QVector<quint8> selection(numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        selection[i] = rng.bounded(3) ? 255 : 0;
+    }
+
+    KoOptimizedHistogramAccumulatorBase::Options options;
+    options.from = viewFrom * unitValue;
+    options.to = (viewFrom + viewWidth) * unitValue;
+    options.scale = 255.0f / (viewWidth * unitValue);
+
+    // split the pixels in two runs to check the continuation
+    const int firstRun = 300;
+    const int pixelSize = data.size() / numPixels;
+
+    KoOptimizedHistogramAccumulatorBase::Bins bins(channelCount);
+    accumulator->accumulate(data.constData(), selection.constData(), firstRun, options, bins);
+    accumulator->accumulate(data.constData() + firstRun * pixelSize, selection.constData() + firstRun,
+                            numPixels - firstRun, options, bins);
+
+    QVector<QVector<quint32>> refBins;
+    quint32 refCount = 0;
+
+    if (params.depthId == Integer8BitsColorDepthID) {
+        referenceHistogram<quint8>(data, selection.constData(), numPixels, channelCount, alphaPos, options, refBins, refCount);
+    } else if (params.depthId == Integer16BitsColorDepthID) {
+        referenceHistogram<quint16>(data, selection.constData(), numPixels, channelCount, alphaPos, options, refBins, refCount);
+    } else {
+        referenceHistogram<float>(data, selection.constData(), numPixels, channelCount, alphaPos, options, refBins, refCount);
+    }
+
+    QVERIFY(refCount > 0);
+    QCOMPARE(bins.count(), refCount);
+
+    for (int c = 0; c < channelCount; c++) {
+        for (int i = 0; i < KoOptimizedHistogramAccumulatorBase::numberOfBins; i++) {
+            QCOMPARE(bins.bin(c, i), refBins[c][i]);
+        }
+        QCOMPARE(bins.outOfViewLeft(c), refBins[c][256]);
+        QCOMPARE(bins.outOfViewRight(c), refBins[c][257]);
+    }
+}
+
+void TestKoHistogramProducers::testSkipTransparent()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KoBasicU8HistogramProducer producer(KoID("RGB8HISTO", "RGB8 Histogram"), cs);
+
+    const quint8 pixels[] = {
+        10, 20, 30, 255,
+        10, 20, 30, 0,
+        40, 50, 60, 128,
+    };
+
+    producer.addRegionToBin(pixels, 0, 3, cs);
+
+    QCOMPARE(producer.count(), 2);
+
+    // the bins are ordered in the same way as channels()
+    for (int i = 0; i < int(cs->channelCount()); i++) {
+        KoChannelInfo *channel = cs->channels()[i];
+        const int pos = channel->pos();
+
+        QCOMPARE(producer.getBinAt(i, pixels[pos]), 1);
+        QCOMPARE(producer.getBinAt(i, pixels[2 * 4 + pos]), 1);
+    }
+
+    producer.setSkipTransparent(false);
+    producer.clear();
+    producer.addRegionToBin(pixels, 0, 3, cs);
+
+    QCOMPARE(producer.count(), 3);
+}
+
+void TestKoHistogramProducers::testMergeCopies()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+    KoBasicU16HistogramProducer producer(KoID("RGB16HISTO", "RGB16 Histogram"), cs);
+    producer.setView(0.25, 0.5);
+
+    const int numPixels = 4096;
+    QRandomGenerator rng(2);
+
+    QVector<quint8> data;
+    fillRandomPixels<quint16>(data, numPixels * 4, rng);
+
+    producer.addRegionToBin(data.constData(), 0, numPixels, cs);
+
+    QScopedPointer<KoHistogramProducer> merged(producer.createEmptyCopy());
+    QScopedPointer<KoHistogramProducer> copy1(producer.createEmptyCopy());
+    QScopedPointer<KoHistogramProducer> copy2(producer.createEmptyCopy());
+
+    QVERIFY(merged);
+    QCOMPARE(merged->viewFrom(), producer.viewFrom());
+    QCOMPARE(merged->viewWidth(), producer.viewWidth());
+    QCOMPARE(merged->count(), 0);
+
+    const int half = numPixels / 2;
+    copy1->addRegionToBin(data.constData(), 0, half, cs);
+    copy2->addRegionToBin(data.constData() + half * cs->pixelSize(), 0, numPixels - half, cs);
+
+    // one copy is read before the merge, another one is not
+    QVERIFY(copy1->count() > 0);
+
+    merged->addBinsFrom(copy1.data());
+    merged->addBinsFrom(copy2.data());
+
+    QCOMPARE(merged->count(), producer.count());
+
+    for (int c = 0; c < producer.channels().size(); c++) {
+        for (int i = 0; i < producer.numberOfBins(); i++) {
+            QCOMPARE(merged->getBinAt(c, i), producer.getBinAt(c, i));
+        }
+        QCOMPARE(merged->outOfViewLeft(c), producer.outOfViewLeft(c));
+        QCOMPARE(merged->outOfViewRight(c), producer.outOfViewRight(c));
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKoHistogramProducers)
@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TestKoHistogramProducers_H
+#define TestKoHistogramProducers_H
+
+#include <QObject>
+
+class TestKoHistogramProducers : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAccumulator_data();
+    void testAccumulator();
+    void testSkipTransparent();
+    void testMergeCopies();
+};
+
+#endif
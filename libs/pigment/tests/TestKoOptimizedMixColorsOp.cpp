@@ -0,0 +1,226 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestKoOptimizedMixColorsOp.h"
+
+#include <limits>
+
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <simpletest.h>
+
+#include "KoColorModelStandardIds.h"
+#include "KoColorSpaceMaths.h"
+#include "KoColorSpaceTraits.h"
+#include "KoMixColorsOpImpl.h"
+#include "KoOptimizedMixColorsOpFactory.h"
+
+namespace {
+
+template<typename channels_type>
+QVector<quint8> randomPixels(int numPixels, QRandomGenerator &rng)
+{
+    QVector<quint8> data(numPixels * 4 * sizeof(channels_type));
+    channels_type *values = reinterpret_cast<channels_type*>(data.data());
+
+    for (int i = 0; i < numPixels * 4; i++) {
+        // every fourth pixel is fully transparent
+        const bool isTransparentAlpha = i % 4 == 3 && (i / 4) % 4 == 0;
+        const float value = isTransparentAlpha ? 0.0f : rng.generateDouble();
+        values[i] = KoColorSpaceMaths<float, channels_type>::scaleToA(value);
+    }
+
+    return data;
+}
+
+QVector<qint16> randomWeights(int numPixels, bool allowNegative, QRandomGenerator &rng)
+{
+    QVector<qint16> weights(numPixels);
+
+    for (int i = 0; i < numPixels; i++) {
+        weights[i] = allowNegative ?
+            static_cast<qint16>(rng.bounded(-32768, 32768)) :
+            static_cast<qint16>(rng.bounded(256));
+    }
+
+    return weights;
+}
+
+template<typename channels_type>
+void comparePixels(const quint8 *actual, const quint8 *expected)
+{
+    const channels_type *actualValues = reinterpret_cast<const channels_type*>(actual);
+    const channels_type *expectedValues = reinterpret_cast<const channels_type*>(expected);
+
+    for (int i = 0; i < 4; i++) {
+        if (std::numeric_limits<channels_type>::is_integer) {
+            QCOMPARE(actualValues[i], expectedValues[i]);
+        } else {
+            // the floating point sums are added up in a different order
+            QVERIFY2(qAbs(actualValues[i] - expectedValues[i]) <= 1e-5 * qMax(channels_type(1), qAbs(expectedValues[i])),
+                     qPrintable(QString("channel %1: %2 vs %3").arg(i).arg(double(actualValues[i])).arg(double(expectedValues[i]))));
+        }
+    }
+}
+
+template<typename channels_type>
+void testMixColorsImpl(const KoID &depthId, int numPixels, bool allowNegativeWeights)
+{
+    using Trait = KoColorSpaceTrait<channels_type, 4, 3>;
+
+    QRandomGenerator rng(numPixels);
+
+    const QVector<quint8> pixels = randomPixels<channels_type>(numPixels, rng);
+    const QVector<qint16> weights = randomWeights(numPixels, allowNegativeWeights, rng);
+    const int weightSum = 255;
+
+    QVector<const quint8*> pointers(numPixels);
+    for (int i = 0; i < numPixels; i++) {
+        // shuffle the pointers to make sure they are not treated as an array
+        pointers[i] = pixels.constData() + ((i * 7) % numPixels) * Trait::pixelSize;
+    }
+
+    QScopedPointer<KoMixColorsOp> optimizedOp(KoOptimizedMixColorsOpFactory::create(depthId, 4, 3));
+    QVERIFY(optimizedOp);
+    KoMixColorsOpImpl<Trait> scalarOp;
+
+    quint8 actual[Trait::pixelSize];
+    quint8 expected[Trait::pixelSize];
+
+    optimizedOp->mixColors(pixels.constData(), weights.constData(), numPixels, actual, weightSum);
+    scalarOp.mixColors(pixels.constData(), weights.constData(), numPixels, expected, weightSum);
+    comparePixels<channels_type>(actual, expected);
+
+    optimizedOp->mixColors(pointers.constData(), weights.constData(), numPixels, actual, weightSum);
+    scalarOp.mixColors(pointers.constData(), weights.constData(), numPixels, expected, weightSum);
+    comparePixels<channels_type>(actual, expected);
+
+    optimizedOp->mixColors(pixels.constData(), numPixels, actual);
+    scalarOp.mixColors(pixels.constData(), numPixels, expected);
+    comparePixels<channels_type>(actual, expected);
+
+    optimizedOp->mixColors(pointers.constData(), numPixels, actual);
+    scalarOp.mixColors(pointers.constData(), numPixels, expected);
+    comparePixels<channels_type>(actual, expected);
+}
+
+template<typename channels_type>
+void testMixerImpl(const KoID &depthId, int numPixels)
+{
+    using Trait = KoColorSpaceTrait<channels_type, 4, 3>;
+
+    QRandomGenerator rng(numPixels);
+
+    const QVector<quint8> pixels = randomPixels<channels_type>(numPixels, rng);
+    const QVector<qint16> weights = randomWeights(numPixels, false, rng);
+
+    QScopedPointer<KoMixColorsOp> optimizedOp(KoOptimizedMixColorsOpFactory::create(depthId, 4, 3));
+    QVERIFY(optimizedOp);
+    KoMixColorsOpImpl<Trait> scalarOp;
+
+    QScopedPointer<KoMixColorsOp::Mixer> optimizedMixer(optimizedOp->createMixer());
+    QScopedPointer<KoMixColorsOp::Mixer> scalarMixer(scalarOp.createMixer());
+
+    // accumulate the pixels in uneven parts, alternating weighted and uniform ones
+    int offset = 0;
+    for (int part = 0; offset < numPixels; part++) {
+        const int numPartPixels = qMin(numPixels - offset, 3 + part * 17);
+        const quint8 *data = pixels.constData() + offset * Trait::pixelSize;
+
+        if (part % 2) {
+            optimizedMixer->accumulateAverage(data, numPartPixels);
+            scalarMixer->accumulateAverage(data, numPartPixels);
+        } else {
+            optimizedMixer->accumulate(data, weights.constData() + offset, 255, numPartPixels);
+            scalarMixer->accumulate(data, weights.constData() + offset, 255, numPartPixels);
+        }
+
+        offset += numPartPixels;
+    }
+
+    QCOMPARE(optimizedMixer->currentWeightsSum(), scalarMixer->currentWeightsSum());
+
+    quint8 actual[Trait::pixelSize];
+    quint8 expected[Trait::pixelSize];
+
+    optimizedMixer->computeMixedColor(actual);
+    scalarMixer->computeMixedColor(expected);
+    comparePixels<channels_type>(actual, expected);
+}
+
+}
+
+void TestKoOptimizedMixColorsOp::testMixColors_data()
+{
+    QTest::addColumn<QString>("depthId");
+    QTest::addColumn<int>("numPixels");
+    QTest::addColumn<bool>("allowNegativeWeights");
+
+    const QList<KoID> depthIds = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    for (const KoID &depthId : depthIds) {
+        for (int numPixels : {1, 2, 7, 64, 65, 1000}) {
+            QTest::addRow("%s-%d", qPrintable(depthId.id()), numPixels) << depthId.id() << numPixels << false;
+        }
+
+        /**
+         * The results of the floating point channels are too
+         * sensitive to the summation order when the weights cancel
+         * out, so only the integer results are compared
+         */
+        if (depthId != Float32BitsColorDepthID) {
+            QTest::addRow("%s-negative-weights", qPrintable(depthId.id())) << depthId.id() << 1000 << true;
+        }
+    }
+}
+
+void TestKoOptimizedMixColorsOp::testMixColors()
+{
+    QFETCH(QString, depthId);
+    QFETCH(int, numPixels);
+    QFETCH(bool, allowNegativeWeights);
+
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        testMixColorsImpl<quint8>(Integer8BitsColorDepthID, numPixels, allowNegativeWeights);
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        testMixColorsImpl<quint16>(Integer16BitsColorDepthID, numPixels, allowNegativeWeights);
+    } else {
+        testMixColorsImpl<float>(Float32BitsColorDepthID, numPixels, allowNegativeWeights);
+    }
+}
+
+void TestKoOptimizedMixColorsOp::testMixer_data()
+{
+    QTest::addColumn<QString>("depthId");
+
+    QTest::newRow("U8") << Integer8BitsColorDepthID.id();
+    QTest::newRow("U16") << Integer16BitsColorDepthID.id();
+    QTest::newRow("F32") << Float32BitsColorDepthID.id();
+}
+
+void TestKoOptimizedMixColorsOp::testMixer()
+{
+    QFETCH(QString, depthId);
+
+    const int numPixels = 5000;
+
+    if (depthId == Integer8BitsColorDepthID.id()) {
+        testMixerImpl<quint8>(Integer8BitsColorDepthID, numPixels);
+    } else if (depthId == Integer16BitsColorDepthID.id()) {
+        testMixerImpl<quint16>(Integer16BitsColorDepthID, numPixels);
+    } else {
+        testMixerImpl<float>(Float32BitsColorDepthID, numPixels);
+    }
+}
+
+void TestKoOptimizedMixColorsOp::testUnsupportedFormats()
+{
+    QVERIFY(!KoOptimizedMixColorsOpFactory::create(Integer8BitsColorDepthID, 5, 4));
+    QVERIFY(!KoOptimizedMixColorsOpFactory::create(Integer16BitsColorDepthID, 2, 1));
+    QVERIFY(!KoOptimizedMixColorsOpFactory::create(Float16BitsColorDepthID, 4, 3));
+}
+
+SIMPLE_TEST_MAIN(TestKoOptimizedMixColorsOp)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TestKoOptimizedMixColorsOp_H
+#define TestKoOptimizedMixColorsOp_H
+
+#include <QObject>
+
+class TestKoOptimizedMixColorsOp : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testMixColors_data();
+    void testMixColors();
+    void testMixer_data();
+    void testMixer();
+    void testUnsupportedFormats();
+};
+
+#endif
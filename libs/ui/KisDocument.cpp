@@ -112,6 +112,7 @@
 #include "kis_grid_config.h"
 #include "kis_guides_config.h"
 #include "kis_image_barrier_lock_adapter.h"
+#include "kis_image_config.h"
 #include "KisReferenceImagesLayer.h"
 #include "dialogs/KisRecoverNamedAutosaveDialog.h"
 
@@ -1438,6 +1439,9 @@ void KisDocument::slotPerformIdleRoutines()
 {
     d->image->explicitRegenerateLevelOfDetail();
 
+    if (KisImageConfig(true).tileDeduplicationEnabled()) {
+        d->image->deduplicateTileData();
+    }
 
     /// TODO: automatic purging is disabled for now: it modifies
     ///       data managers without creating a transaction, which breaks
@@ -40,6 +40,8 @@
 #include "kis_coordinates_converter.h"
 #include "kis_prescaled_projection.h"
 #include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
 #include "kis_image_barrier_locker.h"
 #include "kis_undo_adapter.h"
 #include "flake/kis_shape_layer.h"
@@ -633,6 +635,8 @@ void KisCanvas2::disconnectImage()
     image->immediateLockForReadOnly();
     disconnect(image.data(), 0, this, 0);
     image->unlock();
+
+    image->setViewportPriorityRect(this, QRect());
 }
 
 void KisCanvas2::connectCurrentCanvas()
@@ -1079,11 +1083,31 @@ void KisCanvas2::notifyZoomChanged()
     }
 
     notifyLevelOfDetailChange();
+    prefetchAroundViewport();
     updateCanvas(); // update the canvas, because that isn't done when zooming using KoZoomAction
 
     m_d->regionOfInterestUpdateCompressor.start();
 }
 
+void KisCanvas2::prefetchAroundViewport()
+{
+    /**
+     * The user is panning or zooming, so ask the swap to load the
+     * parts of the projection around the viewport before the canvas
+     * reaches them. Both the QPainter and the OpenGL canvases read
+     * the same projection. The call is a no-op when nothing is
+     * swapped out.
+     */
+    KisImageSP image = this->image();
+    if (!image) return;
+
+    const QRect visibleRect = m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect();
+    const int margin = qMax(visibleRect.width(), visibleRect.height()) / 2;
+
+    KisPaintDeviceSP projection = image->projection();
+    projection->dataManager()->prefetchRect(visibleRect.adjusted(-margin, -margin, margin, margin) & image->bounds());
+}
+
 QRect KisCanvas2::regionOfInterest() const
 {
     return m_d->regionOfInterest;
@@ -1103,6 +1127,17 @@ void KisCanvas2::slotUpdateRegionOfInterest()
     if (m_d->regionOfInterest != oldRegionOfInterest) {
         emit sigRegionOfInterestChanged(m_d->regionOfInterest);
     }
+
+    /**
+     * The updates of the visible part of the image are processed
+     * before the other ones, so the canvas is refreshed first
+     */
+    KisImageSP image = m_d->view->image();
+    if (image) {
+        const QRect visibleRect =
+            m_d->coordinatesConverter->widgetRectInImagePixels().toAlignedRect() & imageRect;
+        image->setViewportPriorityRect(this, visibleRect);
+    }
 }
 
 void KisCanvas2::slotReferenceImagesChanged()
@@ -1205,6 +1240,10 @@ void KisCanvas2::documentOffsetMoved(const QPoint &documentOffset)
     if (!m_d->currentCanvasIsOpenGL)
         m_d->prescaledProjection->viewportMoved(moveOffset);
 
+    if (!moveOffset.isNull()) {
+        prefetchAroundViewport();
+    }
+
     emit documentOffsetUpdateFinished();
 
     updateCanvas();
@@ -325,6 +325,12 @@ private:
 
     void notifyLevelOfDetailChange();
 
+    /**
+     * Asynchronously loads from swap the areas of the image
+     * around the current viewport
+     */
+    void prefetchAroundViewport();
+
     // Completes construction of canvas.
     // To be called by KisView in its constructor, once it has been setup enough
     // (to be defined what that means) for things KisCanvas2 expects from KisView
@@ -283,7 +283,7 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.projectionsSize),
                   format.formatByteSize(stats.lodSize));
 
-    const QString memoryStatsMsg =
+    QString memoryStatsMsg =
             i18nc("tooltip on statusbar memory reporting button (total stats)",
                   "Memory used:\t %1 / %2\n"
                   "  image data:\t %3 / %4\n"
@@ -303,6 +303,32 @@ void KisStatusBar::updateMemoryStatus()
                   format.formatByteSize(stats.historicalMemorySize),
                   format.formatByteSize(stats.swapSize));
 
+    if (stats.swapSize > 0 && stats.swapOutThroughput > 0) {
+        memoryStatsMsg += "\n" +
+            i18nc("tooltip on statusbar memory reporting button (swapping speed)",
+                  "Swap-out speed:\t %1/s",
+                  format.formatByteSize(stats.swapOutThroughput));
+    }
+
+    if (stats.historicalDeltaSize > 0) {
+        memoryStatsMsg += "\n" +
+            i18nc("tooltip on statusbar memory reporting button (delta-encoded undo stats)",
+                  "Undo deltas:\t %1 (saved %2)",
+                  format.formatByteSize(stats.historicalDeltaSize),
+                  format.formatByteSize(stats.historicalDeltaSavedSize));
+    }
+
+    if (stats.deduplicatedUniqueSize > 0 &&
+        stats.deduplicatedSize > stats.deduplicatedUniqueSize) {
+
+        memoryStatsMsg += "\n" +
+            i18nc("tooltip on statusbar memory reporting button (tile deduplication stats)",
+                  "Deduplicated:\t %1 in %2 (%3:1)",
+                  format.formatByteSize(stats.deduplicatedSize),
+                  format.formatByteSize(stats.deduplicatedUniqueSize),
+                  QString::number(qreal(stats.deduplicatedSize) / stats.deduplicatedUniqueSize, 'f', 2));
+    }
+
     QString longStats = imageStatsMsg + "\n" + memoryStatsMsg;
 
     QString shortStats = format.formatByteSize(stats.imageSize);
@@ -19,6 +19,7 @@
 #include "kis_debug.h"
 #include <KisViewManager.h>
 #include "KisRepaintDebugger.h"
+#include "KisPerfTracer.h"
 
 #include <QPointer>
 #include "KisOpenGLModeProber.h"
@@ -188,6 +189,9 @@ void KisOpenGLCanvas2::paintGL()
 {
     const QRect updateRect = d->updateRect ? *d->updateRect : QRect();
 
+    KisPerfTracer::Scope traceScope("canvas", "frame");
+    traceScope.addRectArgs(updateRect.isEmpty() ? rect() : updateRect);
+
     if (!OPENGL_SUCCESS) {
         KisConfig cfg(false);
         cfg.writeEntry("canvasState", "OPENGL_PAINT_STARTED");
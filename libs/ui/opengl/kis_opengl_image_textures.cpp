@@ -32,6 +32,7 @@
 #include <QVector3D>
 #include "kis_painting_tweaks.h"
 #include "KisOpenGLBufferCreationGuard.h"
+#include "KisPerfTracer.h"
 
 #ifdef HAVE_OPENEXR
 #include <half.h>
@@ -320,6 +321,10 @@ KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCacheNoConversion(const QRec
 KisOpenGLUpdateInfoSP KisOpenGLImageTextures::updateCacheImpl(const QRect& rect, KisImageSP srcImage, bool convertColorSpace)
 {
     if (!m_initialized) return new KisOpenGLUpdateInfo();
+
+    KisPerfTracer::Scope traceScope("canvas", "build texture update");
+    traceScope.addRectArgs(rect);
+
     return m_updateInfoBuilder.buildUpdateInfo(rect, srcImage, convertColorSpace);
 }
 
@@ -333,6 +338,12 @@ void KisOpenGLImageTextures::recalculateCache(KisUpdateInfoSP info, bool blockMi
     KisOpenGLUpdateInfoSP glInfo = dynamic_cast<KisOpenGLUpdateInfo*>(info.data());
     if(!glInfo) return;
 
+    KisPerfTracer::Scope traceScope("canvas", "texture upload");
+    if (traceScope.isActive()) {
+        traceScope.addRectArgs(glInfo->dirtyImageRect());
+        traceScope.addArg("tiles", glInfo->tileList.size());
+    }
+
     QScopedPointer<KisOpenGLSync> sync;
     int numProcessedTiles = 0;
 
@@ -235,22 +235,24 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
 
             QVector<KisRunnableStrokeJobData*> processJobs;
 
-            if (shared->filter()->supportsThreading()) {
-                // Split stroke into patches...
-                QSize size = KritaUtils::optimalPatchSize();
-                QVector<QRect> patches = KritaUtils::splitRectIntoPatches(shared->processRect, size);
-
-                Q_FOREACH (const QRect &patch, patches) {
-                    if (!patch.isEmpty()) {
-                        addJobConcurrent(processJobs, [patch, shared, progress](){
-                            shared->filter()->processImpl(shared->filterDevice, patch,
-                                                          shared->filterConfig().data(),
-                                                          progress->updater());
-                        });
-                    }
-                }
-            } else {
-                if (!shared->processRect.isEmpty()) {
+            if (!shared->processRect.isEmpty()) {
+                if (shared->filter()->supportsThreading()) {
+                    /**
+                     * The patches are split right in the processing job,
+                     * so the idle workers of the updater context pick
+                     * them up on demand, while the busy ones keep on
+                     * doing their own work
+                     */
+                    addJobSequential(processJobs, [this, shared, progress](){
+                        runnableJobsInterface()->runSplitJob(shared->processRect,
+                            [shared, progress] (const QRect &patch) {
+                                shared->filter()->processImpl(shared->filterDevice, patch,
+                                                              shared->filterConfig().data(),
+                                                              progress->updater());
+                            },
+                            KritaUtils::optimalPatchSize());
+                    });
+                } else {
                     addJobSequential(processJobs, [shared, progress](){
                         shared->filter()->processImpl(shared->filterDevice, shared->processRect,
                                                       shared->filterConfig().data(),
@@ -8,6 +8,9 @@
 #include "IccColorSpaceEngine.h"
 
 #include "KoColorModelStandardIds.h"
+#include "KoOptimizedMatrixShaperTransformFactory.h"
+
+#include <QScopedPointer>
 
 #include <klocalizedstring.h>
 
@@ -136,6 +139,257 @@ private:
     mutable cmsHTRANSFORM m_transform;
 };
 
+// -- KoLcmsMatrixShaperConversionTransformation --
+
+namespace {
+
+/**
+ * @return the depth of the layouts KoOptimizedMatrixShaperTransform
+ * can handle, or an empty id
+ */
+KoID matrixShaperDepthId(quint32 colorSpaceType)
+{
+    switch (colorSpaceType) {
+    case TYPE_BGRA_8:
+        return Integer8BitsColorDepthID;
+    case TYPE_BGRA_16:
+        return Integer16BitsColorDepthID;
+#ifdef TYPE_RGBA_HALF_FLT
+    case TYPE_RGBA_HALF_FLT:
+        return Float16BitsColorDepthID;
+#endif
+    case TYPE_RGBA_FLT:
+        return Float32BitsColorDepthID;
+    }
+
+    return KoID();
+}
+
+bool isFloatDepth(const KoID &depthId)
+{
+    return depthId == Float16BitsColorDepthID || depthId == Float32BitsColorDepthID;
+}
+
+struct MatrixShaperTags {
+    /// the columns are the colorants, i.e. it converts linear RGB into PCS XYZ
+    double matrix[3][3];
+    cmsToneCurve *curves[3];
+};
+
+/**
+ * Reads the colorants and the tone curves of a matrix-shaper RGB profile.
+ * Fails if LCMS would use a LUT-based pipeline of the profile for
+ * \p intent or if the black point of the profile is not zero, which
+ * makes black point compensation a no-op.
+ */
+bool readMatrixShaperTags(cmsHPROFILE profile, bool usedAsInput,
+                          KoColorConversionTransformation::Intent intent,
+                          MatrixShaperTags *tags)
+{
+    if (cmsGetColorSpace(profile) != cmsSigRgbData) return false;
+    if (!cmsIsMatrixShaper(profile)) return false;
+    if (cmsIsCLUT(profile, intent, usedAsInput ? LCMS_USED_AS_INPUT : LCMS_USED_AS_OUTPUT)) return false;
+
+    const cmsTagSignature colorantTags[] = {cmsSigRedColorantTag, cmsSigGreenColorantTag, cmsSigBlueColorantTag};
+    const cmsTagSignature curveTags[] = {cmsSigRedTRCTag, cmsSigGreenTRCTag, cmsSigBlueTRCTag};
+
+    for (int i = 0; i < 3; i++) {
+        const cmsCIEXYZ *colorant = static_cast<const cmsCIEXYZ*>(cmsReadTag(profile, colorantTags[i]));
+        cmsToneCurve *curve = static_cast<cmsToneCurve*>(cmsReadTag(profile, curveTags[i]));
+        if (!colorant || !curve) return false;
+
+        if (qAbs(cmsEvalToneCurveFloat(curve, 0.0f)) > 1e-6f) return false;
+
+        tags->matrix[0][i] = colorant->X;
+        tags->matrix[1][i] = colorant->Y;
+        tags->matrix[2][i] = colorant->Z;
+        tags->curves[i] = curve;
+    }
+
+    return true;
+}
+
+bool invertMatrix(const double m[3][3], double result[3][3])
+{
+    const double det =
+        m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+        m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+        m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+
+    if (qAbs(det) < 1e-12) return false;
+
+    result[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+    result[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+    result[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+    result[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+    result[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+    result[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+    result[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+    result[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+    result[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+
+    return true;
+}
+
+bool curvesAreLinear(const MatrixShaperTags &tags)
+{
+    return cmsIsToneCurveLinear(tags.curves[0]) &&
+        cmsIsToneCurveLinear(tags.curves[1]) &&
+        cmsIsToneCurveLinear(tags.curves[2]);
+}
+
+/**
+ * The channels usually share the same curve, so let them share
+ * the table as well
+ */
+template <typename T>
+void shareEqualTables(QVector<T> tables[3])
+{
+    for (int i = 1; i < 3; i++) {
+        for (int j = 0; j < i; j++) {
+            if (tables[i] == tables[j]) {
+                tables[i] = tables[j];
+                break;
+            }
+        }
+    }
+}
+
+void fillSourceTables(const MatrixShaperTags &tags, int tableSize, QVector<float> tables[3])
+{
+    for (int i = 0; i < 3; i++) {
+        tables[i].resize(tableSize);
+
+        const float scale = 1.0f / (tableSize - 1);
+        for (int value = 0; value < tableSize; value++) {
+            tables[i][value] = cmsEvalToneCurveFloat(tags.curves[i], value * scale);
+        }
+    }
+
+    shareEqualTables(tables);
+}
+
+void fillDestinationTables(const MatrixShaperTags &tags, QVector<quint16> tables[3])
+{
+    const int tableSize = KoOptimizedMatrixShaperTransformBase::linearToDstTableSize;
+
+    for (int i = 0; i < 3; i++) {
+        cmsToneCurve *reverseCurve = cmsReverseToneCurve(tags.curves[i]);
+        tables[i].resize(tableSize);
+
+        const float scale = 1.0f / (tableSize - 1);
+        for (int index = 0; index < tableSize; index++) {
+            const float value = cmsEvalToneCurveFloat(reverseCurve, index * scale);
+            tables[i][index] = quint16(qBound(0, qRound(value * 65535.0f), 65535));
+        }
+
+        cmsFreeToneCurve(reverseCurve);
+    }
+
+    shareEqualTables(tables);
+}
+
+}
+
+/**
+ * Converts the pixels between two matrix-shaper RGB profiles without
+ * going through cmsDoTransform(): the tone curves are precomputed as
+ * lookup tables and the colorants are merged into a single 3x3 matrix,
+ * which is applied with SIMD instructions.
+ *
+ * The conversion is equivalent to the one done by LCMS for all intents
+ * except the absolute colorimetric one. The floating point color spaces
+ * are supported only with linear tone curves, because the tables cannot
+ * represent unbounded values.
+ */
+class KoLcmsMatrixShaperConversionTransformation : public KoColorConversionTransformation
+{
+public:
+    static KoColorConversionTransformation* tryCreate(const KoColorSpace *srcCs, quint32 srcColorSpaceType, LcmsColorProfileContainer *srcProfile,
+                                                      const KoColorSpace *dstCs, quint32 dstColorSpaceType, LcmsColorProfileContainer *dstProfile,
+                                                      Intent renderingIntent,
+                                                      ConversionFlags conversionFlags)
+    {
+        if (renderingIntent == IntentAbsoluteColorimetric ||
+            conversionFlags.testFlag(GamutCheck) ||
+            conversionFlags.testFlag(SoftProofing)) {
+
+            return 0;
+        }
+
+        KoOptimizedMatrixShaperTransformBase::Params params;
+        params.srcDepthId = matrixShaperDepthId(srcColorSpaceType);
+        params.dstDepthId = matrixShaperDepthId(dstColorSpaceType);
+
+        if (params.srcDepthId.id().isEmpty() || params.dstDepthId.id().isEmpty()) return 0;
+
+        MatrixShaperTags srcTags;
+        MatrixShaperTags dstTags;
+        double dstInverseMatrix[3][3];
+
+        if (!readMatrixShaperTags(srcProfile->lcmsProfile(), true, renderingIntent, &srcTags) ||
+            !readMatrixShaperTags(dstProfile->lcmsProfile(), false, renderingIntent, &dstTags) ||
+            !invertMatrix(dstTags.matrix, dstInverseMatrix)) {
+
+            return 0;
+        }
+
+        const bool srcIsLinear = curvesAreLinear(srcTags);
+        const bool dstIsLinear = curvesAreLinear(dstTags);
+
+        if ((isFloatDepth(params.srcDepthId) && !srcIsLinear) ||
+            (isFloatDepth(params.dstDepthId) && !dstIsLinear)) {
+
+            return 0;
+        }
+
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                double value = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    value += dstInverseMatrix[row][k] * srcTags.matrix[k][column];
+                }
+                params.matrix[row * 3 + column] = value;
+            }
+        }
+
+        if (!srcIsLinear) {
+            fillSourceTables(srcTags, params.srcDepthId == Integer8BitsColorDepthID ? 256 : 65536,
+                             params.srcToLinear);
+        }
+
+        if (!dstIsLinear) {
+            fillDestinationTables(dstTags, params.linearToDst);
+        }
+
+        KoOptimizedMatrixShaperTransformBase *transform =
+            KoOptimizedMatrixShaperTransformFactory::create(params);
+
+        return transform ?
+            new KoLcmsMatrixShaperConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags, transform) :
+            0;
+    }
+
+public:
+    void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override
+    {
+        m_transform->transform(src, dst, numPixels);
+    }
+
+private:
+    KoLcmsMatrixShaperConversionTransformation(const KoColorSpace *srcCs, const KoColorSpace *dstCs,
+                                               Intent renderingIntent,
+                                               ConversionFlags conversionFlags,
+                                               KoOptimizedMatrixShaperTransformBase *transform)
+        : KoColorConversionTransformation(srcCs, dstCs, renderingIntent, conversionFlags)
+        , m_transform(transform)
+    {
+    }
+
+private:
+    QScopedPointer<KoOptimizedMatrixShaperTransformBase> m_transform;
+};
+
 struct IccColorSpaceEngine::Private {
 };
 
@@ -245,6 +499,16 @@ KoColorConversionTransformation *IccColorSpaceEngine::createColorTransformation(
     Q_ASSERT(srcColorSpace);
     Q_ASSERT(dstColorSpace);
 
+    KoColorConversionTransformation *transformation =
+        KoLcmsMatrixShaperConversionTransformation::tryCreate(
+                srcColorSpace, computeColorSpaceType(srcColorSpace),
+                dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
+                dynamic_cast<const IccColorProfile *>(dstColorSpace->profile())->asLcms(), renderingIntent, conversionFlags);
+
+    if (transformation) {
+        return transformation;
+    }
+
     return new KoLcmsColorConversionTransformation(
                 srcColorSpace, computeColorSpaceType(srcColorSpace),
                 dynamic_cast<const IccColorProfile *>(srcColorSpace->profile())->asLcms(), dstColorSpace, computeColorSpaceType(dstColorSpace),
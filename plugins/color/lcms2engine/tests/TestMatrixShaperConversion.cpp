@@ -0,0 +1,164 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestMatrixShaperConversion.h"
+
+#include <random>
+
+#include <simpletest.h>
+#include <lcms2.h>
+
+#include "kis_debug.h"
+
+#include "KoColorProfile.h"
+#include "KoColorSpace.h"
+#include "KoColorSpaceRegistry.h"
+#include "KoColorModelStandardIds.h"
+
+namespace {
+
+const KoColorProfile* profileById(int id)
+{
+    KoColorSpaceRegistry *registry = KoColorSpaceRegistry::instance();
+
+    switch (id) {
+    case 0:
+        return registry->p709SRGBProfile();
+    case 1:
+        return registry->p709G10Profile();
+    default:
+        return registry->p2020G10Profile();
+    }
+}
+
+quint32 lcmsType(const KoID &depthId)
+{
+    return depthId == Integer8BitsColorDepthID ? TYPE_BGRA_8 :
+        depthId == Integer16BitsColorDepthID ? TYPE_BGRA_16 :
+        TYPE_RGBA_FLT;
+}
+
+void fillRandomPixels(const KoColorSpace *cs, quint8 *data, int numPixels)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int j = 0; j < 4; j++) {
+            channels[j] = distribution(generator);
+        }
+        cs->fromNormalisedChannelsValue(data + i * cs->pixelSize(), channels);
+    }
+}
+
+}
+
+void TestMatrixShaperConversion::testCompareWithLcms_data()
+{
+    QTest::addColumn<int>("srcProfileId");
+    QTest::addColumn<int>("dstProfileId");
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<int>("intent");
+
+    const QList<KoID> depths({Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID});
+    const QStringList profileNames({"srgb", "709-g10", "2020-g10"});
+
+    for (int srcProfileId = 0; srcProfileId < 3; srcProfileId++) {
+        for (int dstProfileId = 0; dstProfileId < 3; dstProfileId++) {
+            if (srcProfileId == dstProfileId) continue;
+
+            Q_FOREACH (const KoID &srcDepth, depths) {
+                Q_FOREACH (const KoID &dstDepth, depths) {
+                    for (int intent = 0; intent < 2; intent++) {
+                        const QString name = QString("%1-%2-to-%3-%4-intent%5")
+                            .arg(profileNames[srcProfileId]).arg(srcDepth.id())
+                            .arg(profileNames[dstProfileId]).arg(dstDepth.id())
+                            .arg(intent);
+
+                        QTest::newRow(name.toLatin1().data())
+                            << srcProfileId << dstProfileId
+                            << srcDepth.id() << dstDepth.id()
+                            << intent;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TestMatrixShaperConversion::testCompareWithLcms()
+{
+    QFETCH(int, srcProfileId);
+    QFETCH(int, dstProfileId);
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstDepth);
+    QFETCH(int, intent);
+
+    const KoColorProfile *srcProfile = profileById(srcProfileId);
+    const KoColorProfile *dstProfile = profileById(dstProfileId);
+    QVERIFY(srcProfile);
+    QVERIFY(dstProfile);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepth, srcProfile);
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepth, dstProfile);
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    const int numPixels = 4096 + 7;
+
+    QVector<quint8> src(numPixels * srcCs->pixelSize());
+    QVector<quint8> dst(numPixels * dstCs->pixelSize());
+    QVector<quint8> reference(numPixels * dstCs->pixelSize());
+
+    fillRandomPixels(srcCs, src.data(), numPixels);
+
+    srcCs->convertPixelsTo(src.data(), dst.data(), dstCs, numPixels,
+                           KoColorConversionTransformation::Intent(intent),
+                           KoColorConversionTransformation::BlackpointCompensation);
+
+    cmsHPROFILE srcLcmsProfile = cmsOpenProfileFromMem(srcProfile->rawData().constData(), srcProfile->rawData().size());
+    cmsHPROFILE dstLcmsProfile = cmsOpenProfileFromMem(dstProfile->rawData().constData(), dstProfile->rawData().size());
+    QVERIFY(srcLcmsProfile);
+    QVERIFY(dstLcmsProfile);
+
+    cmsHTRANSFORM transform =
+        cmsCreateTransform(srcLcmsProfile, lcmsType(KoID(srcDepth)),
+                           dstLcmsProfile, lcmsType(KoID(dstDepth)),
+                           intent,
+                           cmsFLAGS_NOOPTIMIZE | cmsFLAGS_BLACKPOINTCOMPENSATION | cmsFLAGS_COPY_ALPHA);
+    QVERIFY(transform);
+
+    cmsDoTransform(transform, src.data(), reference.data(), numPixels);
+
+    cmsDeleteTransform(transform);
+    cmsCloseProfile(srcLcmsProfile);
+    cmsCloseProfile(dstLcmsProfile);
+
+    QVector<float> channels(4);
+    QVector<float> referenceChannels(4);
+
+    const float tolerance = dstDepth == Integer8BitsColorDepthID.id() ? 1.5f / 255.0f : 0.002f;
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCs->normalisedChannelsValue(dst.data() + i * dstCs->pixelSize(), channels);
+        dstCs->normalisedChannelsValue(reference.data() + i * dstCs->pixelSize(), referenceChannels);
+
+        for (int j = 0; j < 4; j++) {
+            const float error = qAbs(channels[j] - referenceChannels[j]);
+
+            // unbounded float values are compared relatively
+            if (error > tolerance * qMax(1.0f, qAbs(referenceChannels[j]))) {
+                qDebug() << ppVar(i) << ppVar(j) << ppVar(channels) << ppVar(referenceChannels);
+                QFAIL("the converted pixel differs from LCMS");
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(TestMatrixShaperConversion)
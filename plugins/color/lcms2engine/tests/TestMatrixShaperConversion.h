@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita Developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTMATRIXSHAPERCONVERSION_H
+#define TESTMATRIXSHAPERCONVERSION_H
+
+#include <QObject>
+
+class TestMatrixShaperConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCompareWithLcms_data();
+    void testCompareWithLcms();
+};
+
+#endif // TESTMATRIXSHAPERCONVERSION_H
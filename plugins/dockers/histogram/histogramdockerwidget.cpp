@@ -18,6 +18,8 @@
 #include "KoChannelInfo.h"
 #include "kis_paint_device.h"
 #include "KoColorSpace.h"
+#include "KoColorModelStandardIds.h"
+#include "KoOptimizedHistogramAccumulatorFactory.h"
 #include "kis_iterator_ng.h"
 #include "krita_utils.h"
 #include "kis_canvas2.h"
@@ -60,6 +62,8 @@ HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
 
 void HistogramComputationStrokeStrategy::initStrokeCallback()
 {
+    initAccumulator(m_image->projection()->colorSpace());
+
     QVector<KisStrokeJobData*> jobsData;
     int i = 0;
     QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(m_image->bounds(), KritaUtils::optimalPatchSize());
@@ -92,6 +96,39 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
 
     initiateVector(m_results[d_pd->jobId], cs);
 
+    if (m_accumulator &&
+        m_accumulator->params().depthId == cs->colorDepthId() &&
+        m_accumulator->params().channelCount == (int)channelCount) {
+
+        KoOptimizedHistogramAccumulatorBase::Bins bins(channelCount);
+
+        // for speed only every nSkip'th row is sampled
+        const int rowStep = nSkip;
+        const int firstRow = calculate.top() + (rowStep - calculate.top() % rowStep) % rowStep;
+
+        for (int y = firstRow; y <= calculate.bottom(); y += rowStep) {
+            KisHLineConstIteratorSP it = m_dev->createHLineConstIteratorNG(calculate.x(), y, calculate.width());
+
+            int numConseqPixels = 0;
+            do {
+                numConseqPixels = it->nConseqPixels();
+                m_accumulator->accumulate(it->rawDataConst(), 0, numConseqPixels, m_accumulatorOptions, bins);
+            } while (it->nextPixels(numConseqPixels));
+        }
+
+        // scaleToU8() clamps the values out of range to the edge bins
+        HistVector &result = m_results[d_pd->jobId];
+        for (int chan = 0; chan < (int)channelCount; ++chan) {
+            for (int bin = 0; bin < KoOptimizedHistogramAccumulatorBase::numberOfBins; ++bin) {
+                result[chan][bin] = bins.bin(chan, bin);
+            }
+            result[chan].front() += bins.outOfViewLeft(chan);
+            result[chan].back() += bins.outOfViewRight(chan);
+        }
+
+        return;
+    }
+
     quint32 toSkip = nSkip;
 
     KisSequentialConstIterator it(m_dev, calculate);
@@ -151,6 +188,30 @@ void HistogramComputationStrokeStrategy::cancelStrokeCallback()
 {
 }
 
+void HistogramComputationStrokeStrategy::initAccumulator(const KoColorSpace *colorSpace)
+{
+    KoOptimizedHistogramAccumulatorBase::Params params;
+    params.depthId = colorSpace->colorDepthId();
+    params.channelCount = colorSpace->channelCount();
+
+    m_accumulator.reset(KoOptimizedHistogramAccumulatorFactory::create(params));
+
+    // the bins are computed with the same rounding as scaleToU8() does
+    float unitValue = 1.0f;
+    if (params.depthId == Integer8BitsColorDepthID) {
+        unitValue = 255.0f;
+    } else if (params.depthId == Integer16BitsColorDepthID) {
+        unitValue = 65535.0f;
+    }
+
+    m_accumulatorOptions.from = 0.0f;
+    m_accumulatorOptions.to = unitValue;
+    m_accumulatorOptions.scale = 255.0f / unitValue;
+    m_accumulatorOptions.bias = 0.5f;
+    m_accumulatorOptions.skipTransparent = false;
+    m_accumulatorOptions.skipUnselected = false;
+}
+
 void HistogramComputationStrokeStrategy::initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
 {
     int channelCount = colorSpace->channelCount();
@@ -12,9 +12,11 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QSharedPointer>
 #include "kis_types.h"
 #include <vector>
 #include <kis_simple_stroke_strategy.h>
+#include <KoOptimizedHistogramAccumulatorBase.h>
 
 class KisCanvas2;
 class KoColorSpace;
@@ -48,6 +50,7 @@ private:
     void cancelStrokeCallback() override;
 
     void initiateVector(HistVector &vec, const KoColorSpace* colorSpace);
+    void initAccumulator(const KoColorSpace *colorSpace);
 
 Q_SIGNALS:
     //Emitted when thumbnail is updated and overviewImage is fully generated.
@@ -59,6 +62,8 @@ private:
     const QScopedPointer<Private> m_d;
     KisImageSP m_image;
     std::vector<HistVector> m_results;
+    QSharedPointer<KoOptimizedHistogramAccumulatorBase> m_accumulator;
+    KoOptimizedHistogramAccumulatorBase::Options m_accumulatorOptions;
 };
 
 
@@ -35,6 +35,7 @@ KisGaussianBlurFilter::KisGaussianBlurFilter() : KisFilter(id(), FiltersCategory
     setSupportsAdjustmentLayers(true);
     setSupportsLevelOfDetail(true);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
+    setCostHint(4.0);
 }
 
 KisConfigWidget * KisGaussianBlurFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP, bool usedForMasks) const
@@ -36,6 +36,7 @@ KisMotionBlurFilter::KisMotionBlurFilter() : KisFilter(id(), FiltersCategoryBlur
     setSupportsAdjustmentLayers(true);
     setSupportsLevelOfDetail(true);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
+    setCostHint(4.0);
 }
 
 KisConfigWidget * KisMotionBlurFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP, bool) const
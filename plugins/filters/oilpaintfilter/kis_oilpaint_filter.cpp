@@ -46,6 +46,7 @@ KisOilPaintFilter::KisOilPaintFilter() : KisFilter(id(), FiltersCategoryArtistic
     setSupportsPainting(true);
     setSupportsThreading(false);
     setSupportsAdjustmentLayers(true);
+    setCostHint(16.0);
 }
 
 void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
@@ -43,6 +43,7 @@ KisUnsharpFilter::KisUnsharpFilter() : KisFilter(id(), FiltersCategoryEnhanceId,
      */
     setSupportsLevelOfDetail(false);
     setColorSpaceIndependence(FULLY_INDEPENDENT);
+    setCostHint(4.0);
 }
 
 KisConfigWidget * KisUnsharpFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP, bool) const